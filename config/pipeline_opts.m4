@@ -66,3 +66,58 @@ AS_IF([test "x$with_pipeline_lockless" == xyes],[
 AS_IF([test "x$with_pipeline_lockless" != xyes], [
 	AC_MSG_RESULT(no)
 ])
+
+#Pipeline incremental checksums
+AC_ARG_WITH([pipeline-incremental-checksums], AS_HELP_STRING([--with-pipeline-incremental-checksums], [accumulate checksum deltas of set-field actions in ROFL-pipeline and let the platform apply them once (platform_packet_update_checksums()) [default=no]]))
+AC_MSG_CHECKING(whether to compile ROFL-pipeline with incremental checksum updates)
+AS_IF([test "x$with_pipeline_incremental_checksums" == xyes],[
+	AC_SUBST([ROFL_PIPELINE_INCREMENTAL_CHECKSUMS], ["#define ROFL_PIPELINE_INCREMENTAL_CHECKSUMS 1"])
+	AC_MSG_RESULT(yes)
+])
+AS_IF([test "x$with_pipeline_incremental_checksums" != xyes], [
+	AC_MSG_RESULT(no)
+])
+
+#Pipeline deferred set-fields
+AC_ARG_WITH([pipeline-deferred-set-fields], AS_HELP_STRING([--with-pipeline-deferred-set-fields], [defer set-field actions in ROFL-pipeline until the packet is output or mangled otherwise [default=no]]))
+AC_MSG_CHECKING(whether to compile ROFL-pipeline with deferred set-fields)
+AS_IF([test "x$with_pipeline_deferred_set_fields" == xyes],[
+	AC_SUBST([ROFL_PIPELINE_DEFERRED_SET_FIELDS], ["#define ROFL_PIPELINE_DEFERRED_SET_FIELDS 1"])
+	AC_MSG_RESULT(yes)
+])
+AS_IF([test "x$with_pipeline_deferred_set_fields" != xyes], [
+	AC_MSG_RESULT(no)
+])
+
+#Pipeline shared replicas
+AC_ARG_WITH([pipeline-shared-replicas], AS_HELP_STRING([--with-pipeline-shared-replicas], [replicate packets for OUTPUT actions in ROFL-pipeline sharing the packet buffer (platform_packet_replicate_shared()) [default=no]]))
+AC_MSG_CHECKING(whether to compile ROFL-pipeline with shared packet replicas)
+AS_IF([test "x$with_pipeline_shared_replicas" == xyes],[
+	AC_SUBST([ROFL_PIPELINE_SHARED_REPLICAS], ["#define ROFL_PIPELINE_SHARED_REPLICAS 1"])
+	AC_MSG_RESULT(yes)
+])
+AS_IF([test "x$with_pipeline_shared_replicas" != xyes], [
+	AC_MSG_RESULT(no)
+])
+
+#Pipeline TX bursts
+AC_ARG_WITH([pipeline-tx-bursts], AS_HELP_STRING([--with-pipeline-tx-bursts], [stage the packets output in ROFL-pipeline per thread and port, and output them in bursts (platform_packet_output_burst()) [default=no]]))
+AC_MSG_CHECKING(whether to compile ROFL-pipeline with TX bursts)
+AS_IF([test "x$with_pipeline_tx_bursts" == xyes],[
+	AC_SUBST([ROFL_PIPELINE_TX_BURSTS], ["#define ROFL_PIPELINE_TX_BURSTS 1"])
+	AC_MSG_RESULT(yes)
+])
+AS_IF([test "x$with_pipeline_tx_bursts" != xyes], [
+	AC_MSG_RESULT(no)
+])
+
+#Pipeline FLOOD/ALL expansion
+AC_ARG_WITH([pipeline-flood-expansion], AS_HELP_STRING([--with-pipeline-flood-expansion], [expand the outputs to the FLOOD and ALL meta ports in ROFL-pipeline, using the pre-computed port sets of the switch [default=no]]))
+AC_MSG_CHECKING(whether to compile ROFL-pipeline with FLOOD/ALL expansion)
+AS_IF([test "x$with_pipeline_flood_expansion" == xyes],[
+	AC_SUBST([ROFL_PIPELINE_FLOOD_EXPANSION], ["#define ROFL_PIPELINE_FLOOD_EXPANSION 1"])
+	AC_MSG_RESULT(yes)
+])
+AS_IF([test "x$with_pipeline_flood_expansion" != xyes], [
+	AC_MSG_RESULT(no)
+])
@@ -251,8 +251,8 @@ hal_result_t hal_driver_bring_port_down_by_num(uint64_t dpid, unsigned int port_
 
 /**
  * @brief Retrieve a snapshot of the monitoring state. If rev is 0, or the current monitoring 
- * has changed (monitoring->rev != rev), a new snapshot of the monitoring state is made. Warning: this 
- * is expensive.
+ * has changed (monitoring->rev != rev), the current snapshot of the monitoring state is returned
+ * (see monitoring_get_snapshot_if_changed()). Snapshots are shared and MUST NOT be modified.
  * @ingroup hal_driver
  *
  * @param rev Last seen revision. Set to 0 to always get a new snapshot 
@@ -285,7 +285,37 @@ hal_fm_result_t hal_driver_of1x_process_flow_mod_delete(uint64_t dpid, uint8_t t
  * @return A pointer to an of1x_flow_msg_t struct or NULL on error. This pointer can be safely accessed and
  * modified, and MUST be destroyed via of1x_destroy_stats_flow_msg() once used.
  */
-of1x_stats_flow_msg_t* hal_driver_of1x_get_flow_stats(uint64_t dpid, uint8_t table_id, uint32_t cookie, uint32_t cookie_mask, uint32_t out_port, uint32_t out_group, of1x_match_group_t *const matches);
+of1x_stats_flow_msg_t* hal_driver_of1x_get_flow_stats(uint64_t dpid, uint8_t table_id, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, of1x_match_group_t *const matches);
+
+/**
+ * @brief   Initializes a flow stats iterator (paginated flow stats) given a set of matches
+ * @ingroup hal_driver_of1x
+ *
+ * @param dpid 		Datapath ID of the switch
+ * @param iter 		Iterator (caller allocated)
+ * @param table_id 	Table id to get the flows of
+ * @param cookie	Cookie to be applied
+ * @param cookie_mask	Mask for the cookie
+ * @param out_port 	Out port that entry must include
+ * @param out_group 	Out group that entry must include
+ * @param matches	Matches. MUST be valid until the iteration is over
+ */
+hal_result_t hal_driver_of1x_flow_stats_iter_init(uint64_t dpid, of1x_flow_stats_iter_t* iter, uint8_t table_id, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, of1x_match_group_t *const matches);
+
+/**
+ * @brief   Retrieves the next page of flow stats of an iterator
+ * @ingroup hal_driver_of1x
+ *
+ * The switch flow tables are only locked while the page is filled. 
+ *
+ * @param dpid 		Datapath ID of the switch
+ * @param iter 		Iterator initialized with hal_driver_of1x_flow_stats_iter_init()
+ * @param page 		Caller provided buffer of page_size entries
+ * @param page_size 	Size of the page
+ * @param num_of_entries Number of entries filled; 0 when the iteration is over. The entries
+ * MUST be released via of1x_flow_stats_iter_release_page() once used.
+ */
+hal_result_t hal_driver_of1x_flow_stats_iter_next_page(uint64_t dpid, of1x_flow_stats_iter_t* iter, of1x_stats_single_flow_msg_t* page, unsigned int page_size, unsigned int* num_of_entries);
 
 /**
  * @brief   Recovers the aggregated flow stats given a set of matches
@@ -302,7 +332,7 @@ of1x_stats_flow_msg_t* hal_driver_of1x_get_flow_stats(uint64_t dpid, uint8_t tab
  * @return A pointer to an of1x_flow_aggregate_msg_t struct or NULL on error. This pointer can be
  * safely accessed and modified, and MUST be destroyed via of1x_destroy_stats_flow_aggregate_msg() once used.
  */
-of1x_stats_flow_aggregate_msg_t* hal_driver_of1x_get_flow_aggregate_stats(uint64_t dpid, uint8_t table_id, uint32_t cookie, uint32_t cookie_mask, uint32_t out_port, uint32_t out_group, of1x_match_group_t *const matches);
+of1x_stats_flow_aggregate_msg_t* hal_driver_of1x_get_flow_aggregate_stats(uint64_t dpid, uint8_t table_id, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, of1x_match_group_t *const matches);
 
 /**
  * @brief   Instructs driver to add a new GROUP
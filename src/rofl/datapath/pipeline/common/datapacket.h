@@ -11,6 +11,8 @@
 
 //OF1.X
 #include "../openflow/openflow1x/pipeline/of1x_action.h"
+#include "../openflow/openflow1x/pipeline/of1x_packet_key.h"
+#include "../openflow/openflow1x/pipeline/of1x_checksum.h"
 //Add more here...
 
 /**
@@ -33,6 +35,20 @@ typedef union of_write_actions{
 	//Add more here...	
 }of_write_actions_t;
 
+/* Packet key */
+typedef union of_packet_key{
+	//OF1.X
+	of1x_packet_key_t of1x;
+	//Add more here...
+}of_packet_key_t;
+
+/* Pending checksum deltas */
+typedef union of_checksum_deltas{
+	//OF1.X
+	of1x_checksum_deltas_t of1x;
+	//Add more here...
+}of_checksum_deltas_t;
+
 //Typedef to void. This is dependant to the version of the pipeline
 typedef void platform_datapacket_state_t; 
 
@@ -48,40 +64,66 @@ typedef void platform_datapacket_state_t;
 */
 typedef struct datapacket{
 
-	//Packet identifier
-	uint64_t id;
+	/*
+	* Hot state; accessed on every packet. Keep it within the first
+	* cache line (64 bytes).
+	*/
 
 	//Pointer to the switch which is processing the packet
 	of_switch_t const* sw;
 
-	//Generic OpenFlow metadata and write actions 
+	/** 
+	* @brief Platform specific state. 
+	* 
+	* This is not OF related state and platform  specific, and may be
+	* used by the library user to keep platform specific state.
+	* This may typically be, at least, a reference to the packet
+	* buffer in the platform.
+	*/
+	platform_datapacket_state_t* platform_state;
+
+	//Generic OpenFlow metadata
 	uint64_t __metadata;	
-	of_write_actions_t write_actions;
 	
 	//OpenFlow 1.3 cookie
 	uint64_t __cookie;
 
+	//Cached packet size in bytes (0 if it must be retrieved from the platform)
+	uint32_t __size_bytes;
+
 	/**
 	* Flag indicating if it is a replica of the original packet
 	* (used for multi-output matches)
 	*/
 	bool is_replica;
-	
-	/** 
-	* @brief Platform specific state. 
-	* 
-	* This is not OF related state and platform  specific, and may be
-	* used by the library user to keep platform specific state.
-	* This may typically be, at least, a reference to the packet
-	* buffer in the platform.
+
+	//Checksum deltas of the header rewrites not yet applied
+	of_checksum_deltas_t checksum;
+
+	/*
+	* Warm state; only the header of the key is reset per packet
 	*/
-	platform_datapacket_state_t* platform_state;
+
+	//Packet key (lazily extracted matching fields)
+	of_packet_key_t key;
+
+	/*
+	* Cold state; write actions are large and rarely used (only the
+	* header is reset per packet)
+	*/
+
+	//Generic OpenFlow write actions
+	of_write_actions_t write_actions;
+
+	//Packet identifier
+	uint64_t id;
 
 }datapacket_t;
 
 static inline void __init_packet_metadata(datapacket_t *const pkt){
 	pkt->__metadata = 0ULL;
 	pkt->__cookie = 0ULL;
+	pkt->__size_bytes = 0;
 };
 
 #endif //DATAPACKET
@@ -64,6 +64,7 @@ void __init_utern128(utern_t* tern, uint128__t value, uint128__t mask){ //uint12
 * Contained 
 */
 //Extensive tern is a more generic (with a less restrictive mask or equal) to tern
+//NOTE: values are pre-masked (see initializers)
 bool __utern_is_contained(const utern_t* extensive_tern, const utern_t* tern){
 	
 	switch(extensive_tern->type){
@@ -71,26 +72,26 @@ bool __utern_is_contained(const utern_t* extensive_tern, const utern_t* tern){
 		case UTERN8_T:
 			//if(((extensive_tern->mask.u8 ^ tern->mask.u8) & extensive_tern->mask.u8) > 0)
 			//	return false;
-			return (extensive_tern->value.u8 & extensive_tern->mask.u8) == (tern->value.u8 & extensive_tern->mask.u8);
+			return extensive_tern->value.u8 == (tern->value.u8 & extensive_tern->mask.u8);
 			break;
 		case UTERN16_T:
 			//if(((extensive_tern->mask.u16 ^ tern->mask.u16) & extensive_tern->mask.u16) > 0)
 			//	return false;
-			return (extensive_tern->value.u16 & extensive_tern->mask.u16) == (tern->value.u16 & extensive_tern->mask.u16);
+			return extensive_tern->value.u16 == (tern->value.u16 & extensive_tern->mask.u16);
 			break;
 		case UTERN32_T:
 			//if(((extensive_tern->mask.u32 ^ tern->mask.u32) & extensive_tern->mask.u32) > 0)
 			//	return false;
-			return (extensive_tern->value.u32 & extensive_tern->mask.u32) == (tern->value.u32 & extensive_tern->mask.u32);
+			return extensive_tern->value.u32 == (tern->value.u32 & extensive_tern->mask.u32);
 			break;
 		case UTERN64_T:
 			if(((extensive_tern->mask.u64 ^ tern->mask.u64) & extensive_tern->mask.u64) > 0)
 				return false;
-			return (extensive_tern->value.u64 & extensive_tern->mask.u64) == (tern->value.u64 & extensive_tern->mask.u64);
+			return extensive_tern->value.u64 == (tern->value.u64 & extensive_tern->mask.u64);
 			break;
 		case UTERN128_T:
-			return ( (UINT128__T_LO(extensive_tern->value.u128) & UINT128__T_LO(extensive_tern->mask.u128)) == (UINT128__T_LO(tern->value.u128) & UINT128__T_LO(extensive_tern->mask.u128)) ) &&
-				((UINT128__T_HI(extensive_tern->value.u128) & UINT128__T_HI(extensive_tern->mask.u128)) == (UINT128__T_HI(tern->value.u128) & UINT128__T_HI(extensive_tern->mask.u128))	);
+			return ( UINT128__T_LO(extensive_tern->value.u128) == (UINT128__T_LO(tern->value.u128) & UINT128__T_LO(extensive_tern->mask.u128)) ) &&
+				( UINT128__T_HI(extensive_tern->value.u128) == (UINT128__T_HI(tern->value.u128) & UINT128__T_HI(extensive_tern->mask.u128)) );
 			break;
 		default:
 			assert(0); //we should never reach this point
@@ -127,7 +128,7 @@ bool __utern_equals(const utern_t* tern1, const utern_t* tern2){
 }
 
 //This function shall find the common and contiguous shared ternary portion of two ternary values
-//Masks go from left to right in memory
+//Masks go from left to right in memory. Values are pre-masked, and so is the common value
 bool __utern_get_alike(const utern_t* tern1, const utern_t* tern2, utern_t* common){
 
 	int i;
@@ -149,8 +150,7 @@ bool __utern_get_alike(const utern_t* tern1, const utern_t* tern2, utern_t* comm
 						continue;
 
 					//Check
-					if( (tern1->value.u8 & tern1->mask.u8 & __u8_alike_masks[i]) ==
-						(tern2->value.u8 & tern2->mask.u8 & __u8_alike_masks[i] ) ){
+					if( (tern1->value.u8 & __u8_alike_masks[i]) == (tern2->value.u8 & __u8_alike_masks[i]) ){
 						value.u8 = tern1->value.u8 & __u8_alike_masks[i];
 						mask.u8 = tern1->mask.u8 & __u8_alike_masks[i];
 
@@ -169,8 +169,7 @@ bool __utern_get_alike(const utern_t* tern1, const utern_t* tern2, utern_t* comm
 					if( (tern1->mask.u16 & __u16_alike_masks[i])  != (tern2->mask.u16 & __u16_alike_masks[i]) )
 						continue;
 
-					if( (tern1->value.u16 & tern1->mask.u16 & __u16_alike_masks[i]) ==
-						(tern2->value.u16 & tern2->mask.u16 & __u16_alike_masks[i] ) ){
+					if( (tern1->value.u16 & __u16_alike_masks[i]) == (tern2->value.u16 & __u16_alike_masks[i]) ){
 						value.u16 = tern1->value.u16 & __u16_alike_masks[i];
 						mask.u16 = tern1->mask.u16 & __u16_alike_masks[i];
 
@@ -189,8 +188,7 @@ bool __utern_get_alike(const utern_t* tern1, const utern_t* tern2, utern_t* comm
 					if( (tern1->mask.u32 & __u32_alike_masks[i])  != (tern2->mask.u32 & __u32_alike_masks[i]) )
 						continue;
 
-					if( (tern1->value.u32 & tern1->mask.u32 & __u32_alike_masks[i]) ==
-						(tern2->value.u32 & tern2->mask.u32 & __u32_alike_masks[i] ) ){
+					if( (tern1->value.u32 & __u32_alike_masks[i]) == (tern2->value.u32 & __u32_alike_masks[i]) ){
 						value.u32 = tern1->value.u32 & __u32_alike_masks[i];
 						mask.u32 = tern1->mask.u32 & __u32_alike_masks[i];
 
@@ -209,8 +207,7 @@ bool __utern_get_alike(const utern_t* tern1, const utern_t* tern2, utern_t* comm
 					if( (tern1->mask.u64 & __u64_alike_masks[i])  != (tern2->mask.u64 & __u64_alike_masks[i]) )
 						continue;
 
-					if( (tern1->value.u64 & tern1->mask.u64 & __u64_alike_masks[i]) ==
-						(tern2->value.u64 & tern2->mask.u64 & __u64_alike_masks[i] ) ){
+					if( (tern1->value.u64 & __u64_alike_masks[i]) == (tern2->value.u64 & __u64_alike_masks[i]) ){
 						value.u64 = tern1->value.u64 & __u64_alike_masks[i];
 						mask.u64 = tern1->mask.u64 & __u64_alike_masks[i];
 
@@ -11,6 +11,12 @@
 #include "rofl_datapath.h"
 #include "wrap_types.h"
 
+#if defined(__SSE4_1__)
+	#include <smmintrin.h>
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
 /**
 * @author Marc Sune<marc.sune (at) bisdn.de>
 * @author Victor Alvarez<victor.alvarez (at) bisdn.de>
@@ -31,7 +37,7 @@ typedef enum utern_type {
 
 typedef struct utern{
 	utern_type_t type;
-	wrap_uint_t value;
+	wrap_uint_t value; //Invariant: value == (value & mask); see __init_utern*()
 	wrap_uint_t mask;
 } utern_t;
 
@@ -50,31 +56,51 @@ void __init_utern64(utern_t* tern, uint64_t value, uint64_t mask);
 void __init_utern128(utern_t* tern, uint128__t value, uint128__t mask);
 
 //Comparison
+//NOTE: values are always stored pre-masked (value & mask), so only the packet value needs to be masked
 static inline bool __utern_compare8(const utern_t* tern, const uint8_t* value){
 	if(!value)
 		return false;
-	return (tern->value.u8 & tern->mask.u8) == (*value & tern->mask.u8); 
+	return (*value & tern->mask.u8) == tern->value.u8; 
 }
 static inline bool __utern_compare16(const utern_t* tern, const uint16_t* value){
 	if(!value)
 		return false;
-	return (tern->value.u16 & tern->mask.u16) == (*value & tern->mask.u16); 
+	return (*value & tern->mask.u16) == tern->value.u16; 
 }
 static inline bool __utern_compare32(const utern_t* tern, const uint32_t* value){
 	if(!value)
 		return false;
-	return (tern->value.u32 & tern->mask.u32) == (*value & tern->mask.u32); 
+	return (*value & tern->mask.u32) == tern->value.u32; 
 }
 static inline bool __utern_compare64(const utern_t* tern, const uint64_t* value){
 	if(!value)
 		return false;
-	return (tern->value.u64 & tern->mask.u64) == (*value & tern->mask.u64); 
+	return (*value & tern->mask.u64) == tern->value.u64; 
 }
 static inline bool __utern_compare128(const utern_t* tern, const uint128__t* value){
+#if defined(__SSE4_1__)
+	__m128i diff;
+
+	if(!value)
+		return false;
+
+	//((value ^ tern_value) & mask) == 0
+	diff = _mm_xor_si128(_mm_loadu_si128((const __m128i*)value), _mm_loadu_si128((const __m128i*)&tern->value.u128));
+	return _mm_testz_si128(diff, _mm_loadu_si128((const __m128i*)&tern->mask.u128));
+#elif defined(__SSE2__)
+	__m128i masked;
+
+	if(!value)
+		return false;
+
+	masked = _mm_and_si128(_mm_loadu_si128((const __m128i*)value), _mm_loadu_si128((const __m128i*)&tern->mask.u128));
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(masked, _mm_loadu_si128((const __m128i*)&tern->value.u128))) == 0xFFFF;
+#else
 	if(!value)
 		return false;
-	return ( (UINT128__T_HI(tern->value.u128) & UINT128__T_HI(tern->mask.u128)) == (UINT128__T_HI(*value) & UINT128__T_HI(tern->mask.u128)) )&&
-			( (UINT128__T_LO(tern->value.u128) & UINT128__T_LO(tern->mask.u128)) == (UINT128__T_LO(*value) & UINT128__T_LO(tern->mask.u128)) );
+	return ( (UINT128__T_HI(*value) & UINT128__T_HI(tern->mask.u128)) == UINT128__T_HI(tern->value.u128) ) &&
+			( (UINT128__T_LO(*value) & UINT128__T_LO(tern->mask.u128)) == UINT128__T_LO(tern->value.u128) );
+#endif
 }
 //Check if two ternary values are equal
 bool __utern_equals(const utern_t* tern1, const utern_t* tern2);
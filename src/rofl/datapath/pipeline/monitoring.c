@@ -239,6 +239,12 @@ void __monitoring_destroy(monitoring_state_t* monitoring){
 	//Destroy the inner-most monitored entity
 	__monitoring_remove_monitored_entity(monitoring, &monitoring->chassis, true);	
 
+	//Release the published snapshot
+	if(monitoring->published){
+		monitoring_destroy_snapshot(monitoring->published);
+		monitoring->published = NULL;
+	}
+
 	//Release dynamic memory allocated	
 	if(monitoring->rwlock)
 		platform_rwlock_destroy(monitoring->rwlock);
@@ -339,8 +345,8 @@ void monitoring_dump(monitoring_state_t* monitoring){
 // Snapshots
 //
 
-//Get a snapshot
-monitoring_snapshot_state_t* monitoring_get_snapshot(monitoring_state_t* monitoring){
+//Clones the current monitoring state
+static monitoring_snapshot_state_t* __monitoring_clone_state(monitoring_state_t* monitoring){
 
 	monitoring_snapshot_state_t* sn;
 
@@ -357,10 +363,13 @@ monitoring_snapshot_state_t* monitoring_get_snapshot(monitoring_state_t* monitor
 
 	//Set auxilary pointers to null
 	sn->mutex = sn->rwlock = NULL;	
+	sn->published = NULL;
 
 	//Clone monitored data
 	if(__clone_root_monitored_entity(monitoring, &sn->chassis, &monitoring->chassis) != ROFL_SUCCESS){
 		assert(0);
+		if(monitoring->rwlock)
+			platform_rwlock_rdunlock(monitoring->rwlock);	
 		platform_free_shared(sn);
 		return NULL;
 	}
@@ -371,6 +380,51 @@ monitoring_snapshot_state_t* monitoring_get_snapshot(monitoring_state_t* monitor
 
 	//Mark as snapshot
 	sn->is_snapshot = true;
+	refcnt_init(&sn->refs);
+
+	return sn;
+}
+
+//Get a snapshot
+monitoring_snapshot_state_t* monitoring_get_snapshot(monitoring_state_t* monitoring){
+
+	monitoring_snapshot_state_t *sn, *old;
+
+	//Snapshots are immutable; just take a reference
+	if(monitoring->is_snapshot)
+		return monitoring_clone_snapshot(monitoring);
+
+	//Fast path; the published snapshot is up to date
+	platform_mutex_lock(monitoring->mutex);
+	sn = monitoring->published;
+	if(sn && sn->last_rev == monitoring->last_rev){
+		refcnt_get(&sn->refs);
+		platform_mutex_unlock(monitoring->mutex);
+		return sn;
+	}
+	platform_mutex_unlock(monitoring->mutex);
+
+	//Clone it (outside the mutex; writers may use it via platform_atomic_inc64())
+	sn = __monitoring_clone_state(monitoring);
+	if(!sn)
+		return NULL;
+
+	//Publish it, unless a newer (or the same) revision was published meanwhile
+	platform_mutex_lock(monitoring->mutex);
+	old = monitoring->published;
+	if(old && old->last_rev >= sn->last_rev){
+		refcnt_get(&old->refs);
+		platform_mutex_unlock(monitoring->mutex);
+		monitoring_destroy_snapshot(sn);
+		return old;
+	}
+	refcnt_get(&sn->refs); //One for the caller, one for the monitoring state
+	monitoring->published = sn;
+	platform_mutex_unlock(monitoring->mutex);
+
+	//Release the previous one
+	if(old)
+		monitoring_destroy_snapshot(old);
 
 	return sn;
 }
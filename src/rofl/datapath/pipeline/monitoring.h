@@ -18,6 +18,7 @@
 #include <inttypes.h>
 #include <time.h>
 #include "platform/lock.h"
+#include "threading.h"
 
 //fwd decl
 struct monitored_entity;
@@ -186,8 +187,14 @@ typedef struct monitoring_state{
 	*/
 	platform_rwlock_t* rwlock;
 	
-	//Not used at all (except for platform_atomic_inc64())
+	//Protects the published snapshot (and platform_atomic_inc64())
 	platform_mutex_t* mutex;
+
+	//Last published snapshot (live state only)
+	struct monitoring_state* published;
+
+	//Snapshot references (snapshots only)
+	refcnt_t refs;
 }monitoring_state_t;
 
 //Alias
@@ -231,30 +238,48 @@ static inline bool monitoring_has_changed(monitoring_state_t* state, uint64_t* l
 /**
 * @brief Get a snapshot of the current monitoring state.
 *
-* This function may be expensive, as it involves a deep copy in dynamic
-* memory of all the monitored data.
+* Snapshots are immutable and shared (refcounted). The monitoring state keeps
+* the last published snapshot; if the monitoring state has not changed since
+* (same rev), it is returned in O(1). Otherwise, the monitored data is deep
+* copied once (atomically, over the read lock) and published.
 *
-* The monitoring is copied atomically (platform_rdlock) over the read lock
 * The monitoring snapshots needs to be destroyed by calling monitoring_destroy_snapshot()
+* and MUST NOT be modified.
 *
 * @ingroup  mgmt
 */
 monitoring_snapshot_state_t* monitoring_get_snapshot(monitoring_state_t* monitoring);
 
 /**
-* @brief Clone a monitoring snapshot 
+* @brief Get a snapshot of the current monitoring state, only if it has changed since last_seen_rev
+*
+* @param last_seen_rev Last seen revision. Set to 0 to always get a snapshot
+* @return A snapshot (see monitoring_get_snapshot()) or NULL if there have been no changes (same rev)
+* @ingroup  mgmt
+*/
+static inline monitoring_snapshot_state_t* monitoring_get_snapshot_if_changed(monitoring_state_t* monitoring, uint64_t last_seen_rev){
+	if(last_seen_rev && !monitoring_has_changed(monitoring, &last_seen_rev))
+		return NULL;
+	return monitoring_get_snapshot(monitoring);
+}
+
+/**
+* @brief Clone a monitoring snapshot (no copy is made; a reference is taken)
 * @ingroup  mgmt
 */
 static inline monitoring_snapshot_state_t* monitoring_clone_snapshot(monitoring_snapshot_state_t* orig){
-	return monitoring_get_snapshot(orig);
+	refcnt_get(&orig->refs);
+	return orig;
 }
 
 /**
 * @brief Destroy a snapshot previously generated via monitoring_get_snapshot() routine. 
+* The snapshot is released once all its references have been destroyed.
 * @ingroup  mgmt
 */
 static inline void monitoring_destroy_snapshot(monitoring_snapshot_state_t* snapshot){
-	__monitoring_destroy((monitoring_state_t*)snapshot);
+	if(refcnt_put(&snapshot->refs))
+		__monitoring_destroy((monitoring_state_t*)snapshot);
 }
 
 /**
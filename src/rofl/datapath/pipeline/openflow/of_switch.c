@@ -107,6 +107,18 @@ rofl_result_t __of_detach_all_ports_from_switch(of_switch_t* sw){
 	}
 }
 
+void of_switch_port_config_changed(of_switch_t* sw){
+	switch(sw->of_ver){
+		case OF_VERSION_10: 
+		case OF_VERSION_12: 
+		case OF_VERSION_13: 
+			of1x_switch_port_config_changed((of1x_switch_t*)sw); 
+			break;
+		default: 
+			break;
+	}
+}
+
 rofl_result_t of_get_switch_matching_algorithms(of_version_t of_version, const char * const** name_list, int *count){
 
 	switch (of_version) {
@@ -136,6 +148,16 @@ of_switch_snapshot_t* __of_switch_get_snapshot(of_switch_t* sw){
 			return NULL;
 	}
 }
+of_switch_snapshot_t* __of_switch_get_delta_snapshot(of_switch_t* sw, of_switch_snapshot_t* base){
+	switch (sw->of_ver){
+		case OF_VERSION_10:
+		case OF_VERSION_12:
+		case OF_VERSION_13:
+			return (of_switch_snapshot_t*)__of1x_switch_get_delta_snapshot((of1x_switch_t*)sw, (of1x_switch_snapshot_t*)base);
+		default:
+			return NULL;
+	}
+}
 void of_switch_destroy_snapshot(of_switch_snapshot_t* snapshot){
 	switch (snapshot->of_ver){
 		case OF_VERSION_10:
@@ -73,6 +73,9 @@ typedef struct of_switch{
 	* the case of sw switches.
 	*/
 	of_switch_platform_state_t* platform_state;
+
+	//Stable id in the physical switch (index in the table of logical switches)
+	unsigned int psw_id;
 	/* End of common part */
 
 	//Version specific content...
@@ -125,6 +128,9 @@ rofl_result_t of_reconfigure_switch(of_switch_t* sw, of_version_t version);
 * The platform has to periodically call of_process_pipeline_tables_timeout_expirations() 
 * (usually via some background thread). The optimal period is around 500ms. 
 *
+* This call also triggers the (optional) periodic maintenance of the matching
+* algorithms of the tables (e.g. offline rebuild of lookup structures).
+*
 * @param sw The switch which has to check flow entry expirations 
 * 
 */
@@ -137,6 +143,16 @@ rofl_result_t __of_detach_port_from_switch_by_port_num(of_switch_t* sw, unsigned
 rofl_result_t __of_detach_port_from_switch(of_switch_t* sw, switch_port_t* port);
 rofl_result_t __of_detach_all_ports_from_switch(of_switch_t* sw);
 
+/**
+* @brief Notifies the switch that the configuration (up, forward_packets or
+* no_flood) of an attached port has changed.
+* @ingroup core 
+*
+* Recomputes the pre-computed FLOOD and ALL port sets of the switch. It MUST be
+* called by the platform on every such change.
+*/
+void of_switch_port_config_changed(of_switch_t* sw);
+
 /**
 * @brief Retrieves the list of available matching algorithms available for OF version of_version. 
 * @ingroup core 
@@ -151,6 +167,9 @@ rofl_result_t of_get_switch_matching_algorithms(of_version_t of_version, const c
 //Creates a snapshot of the running of LSI 
 of_switch_snapshot_t* __of_switch_get_snapshot(of_switch_t* sw);
 
+//Creates a snapshot of the running LSI, sharing what did not change since base
+of_switch_snapshot_t* __of_switch_get_delta_snapshot(of_switch_t* sw, of_switch_snapshot_t* base);
+
 /**
 * Destroy a previously generated snapshot
 * @ingroup mgmt 
@@ -9,6 +9,7 @@
 #include "rofl_datapath.h" 
 #include "../util/pp_guard.h" //Never forget to include the guard
 #include "of_switch.h"
+#include "../switch_port_pp.h"
 #include "openflow1x/pipeline/of1x_pipeline_pp.h"
 
 #include "../util/logging.h"
@@ -71,6 +72,32 @@ static inline rofl_result_t of_process_packet_pipeline(const unsigned int tid, c
 	return ROFL_SUCCESS;
 }	
 
+/**
+* @brief Flushes the packets output by the tid, pending to be transmitted.
+* @ingroup core_pp 
+*
+* If rofl-datapath is compiled with --with-pipeline-tx-bursts, packets output
+* to (non-meta) ports by a tid other than ROFL_PIPELINE_LOCKED_TID are staged
+* per port, and handed to the platform via platform_packet_output_burst() when
+* ROFL_PIPELINE_TX_BURST_SIZE packets have been staged for a port or on this call.
+* The platform MUST call it at the end of every burst of packets processed by the
+* tid (for every switch), and before detaching ports. It is a no-op otherwise.
+*
+* @param tid Thread ID. 
+* @param sw The switch which processed the packets 
+*/
+static inline void of_process_packet_pipeline_flush(const unsigned int tid, const of_switch_t* sw){
+
+#ifdef DEBUG
+	if(unlikely(tid >= ROFL_PIPELINE_MAX_TIDS)){
+		ROFL_PIPELINE_ERR("Invalid tid: %ui. ROFL_PIPELINE_MAX_TIDS is %u\n", tid, ROFL_PIPELINE_MAX_TIDS);
+		assert(0);
+	}
+#endif
+
+	__of1x_tx_burst_flush(tid, (const struct of1x_switch*)sw);
+}
+
 //C++ extern C
 ROFL_END_DECLS
 
@@ -3,8 +3,10 @@
 #include "../../switch_port.h"
 #include "../../platform/lock.h"
 #include "../../platform/memory.h"
+#include "../../platform/packet.h"
 #include "../../platform/likely.h"
 #include "../../util/logging.h"
+#include "../../threading.h"
 #include "../of_switch.h"
 #include "of1x_async_events_hooks.h"
 
@@ -28,36 +30,80 @@ of1x_switch_t* of1x_init_switch(const char* name, of_version_t version, uint64_t
 	
 	//Initialize platform state to NULL
 	sw->platform_state=NULL;
+	sw->revision=0;
+
+	//No ports to flood
+	sw->port_sets_idx=0;
+	sw->flood_ports[0].num_of_ports=sw->all_ports[0].num_of_ports=0;
+#ifdef ROFL_PIPELINE_LOCKLESS
+	tid_init_presence_mask(&sw->port_sets_presence_mask);
+#else
+	if(NULL == (sw->port_sets_rwlock = platform_rwlock_init(NULL))){
+		platform_free_shared(sw);
+		return NULL;
+	}
+#endif
+
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	//No staged packets
+	if(NULL == (sw->tx_bursts = tid_alloc_slots(sizeof(__of1x_tx_bursts_t), &sw->tx_bursts_mem))){
+#ifndef ROFL_PIPELINE_LOCKLESS
+		platform_rwlock_destroy(sw->port_sets_rwlock);
+#endif
+		platform_free_shared(sw);
+		return NULL;
+	}
+#endif
 	
 	//Mutex
 	if(NULL == (sw->mutex = platform_mutex_init(NULL))){
-		platform_free_shared(sw);
-		return NULL; 
+		goto INIT_ERROR;
 	}
 	
 	//Setup pipeline	
 	if(__of1x_init_pipeline(sw, num_of_tables, list) != ROFL_SUCCESS){
-		platform_free_shared(sw);
-		return NULL;
+		goto INIT_ERROR;
 	}
 	
 	//Allow the platform to add specific configurations to the switch
 	if(platform_post_init_of1x_switch(sw) != ROFL_SUCCESS){
 		__of1x_destroy_pipeline(&sw->pipeline);	
-		platform_free_shared(sw);
-		return NULL;
+		goto INIT_ERROR;
 	}
 
 	return sw;
+
+INIT_ERROR:
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	platform_free_shared(sw->tx_bursts_mem);
+#endif
+#ifndef ROFL_PIPELINE_LOCKLESS
+	platform_rwlock_destroy(sw->port_sets_rwlock);
+#endif
+	platform_free_shared(sw);
+	return NULL;
 }
 
 rofl_result_t __of1x_destroy_switch(of1x_switch_t* sw){
 
 	rofl_result_t result;
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	unsigned int i, j, k;
+#endif
 
 	//Allow the platform to do specific things before deletion 
 	if(platform_pre_destroy_of1x_switch(sw) != ROFL_SUCCESS)
 		return ROFL_FAILURE;
+
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	//Drop packets that were not flushed
+	for(i=0;i<ROFL_PIPELINE_MAX_TIDS;i++){
+		for(j=0;j<sw->tx_bursts[i].num_of_ports;j++){
+			for(k=0;k<sw->tx_bursts[i].ports[j].num_of_pkts;k++)
+				platform_packet_drop(sw->tx_bursts[i].ports[j].pkts[k]);
+		}
+	}
+#endif
 		
 	result = __of1x_destroy_pipeline(&sw->pipeline);
 
@@ -67,6 +113,12 @@ rofl_result_t __of1x_destroy_switch(of1x_switch_t* sw){
 	//TODO: rwlock
 	
 	platform_mutex_destroy(sw->mutex);
+#ifndef ROFL_PIPELINE_LOCKLESS
+	platform_rwlock_destroy(sw->port_sets_rwlock);
+#endif
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	platform_free_shared(sw->tx_bursts_mem);
+#endif
 	platform_free_shared(sw);
 	
 	return ROFL_SUCCESS;
@@ -91,10 +143,69 @@ rofl_result_t __of1x_reconfigure_switch(of1x_switch_t* sw, of_version_t version)
 
 	//Set switch to the new version and return
 	sw->of_ver = version;
+	sw->revision++;
 	return ROFL_SUCCESS; 
 }
 
 /* Port management */
+
+//Recompute FLOOD and ALL port sets. sw->mutex MUST be held
+static void __of1x_update_port_sets(of1x_switch_t* sw){
+
+	unsigned int i, idx;
+	switch_port_t* port;
+	of1x_port_set_t *flood, *all;
+
+	//Ports attached, detached or reconfigured
+	sw->revision++;
+
+	//Spare sets were the current ones before the last update; wait for their readers
+#ifdef ROFL_PIPELINE_LOCKLESS
+	tid_wait_all_not_present(&sw->port_sets_presence_mask);
+#else
+	platform_rwlock_wrlock(sw->port_sets_rwlock);
+	platform_rwlock_wrunlock(sw->port_sets_rwlock);
+#endif
+
+	//Fill in the spare sets
+	idx = (sw->port_sets_idx+1)%2;
+	flood = &sw->flood_ports[idx];
+	all = &sw->all_ports[idx];
+	flood->num_of_ports = all->num_of_ports = 0;
+
+	for(i=1;i<LOGICAL_SWITCH_MAX_LOG_PORTS;i++){
+		port = sw->logical_ports[i].port;
+		
+		if(sw->logical_ports[i].attachment_state != LOGICAL_PORT_STATE_ATTACHED || !port)
+			continue;	
+		if(!port->up || !port->forward_packets)
+			continue;
+
+		all->port_nums[all->num_of_ports++] = i;
+		if(!port->no_flood)
+			flood->port_nums[flood->num_of_ports++] = i;
+	}
+
+	//Make sure the sets are filled in before they are visible to the pipeline
+	tid_memory_barrier();
+	sw->port_sets_idx = idx;
+}
+
+void of1x_switch_port_config_changed(of1x_switch_t* sw){
+
+	unsigned int i;
+
+	platform_mutex_lock(sw->mutex);
+
+	for(i=1;i<LOGICAL_SWITCH_MAX_LOG_PORTS;i++){
+		if(sw->logical_ports[i].port)
+			sw->logical_ports[i].port->revision++;
+	}
+	__of1x_update_port_sets(sw);
+
+	platform_mutex_unlock(sw->mutex);
+}
+
 rofl_result_t __of1x_attach_port_to_switch_at_port_num(of1x_switch_t* sw, unsigned int port_num, switch_port_t* port){
 
 	if( unlikely(port==NULL) || unlikely(port_num==0) || unlikely(port_num >= LOGICAL_SWITCH_MAX_LOG_PORTS) )
@@ -117,6 +228,8 @@ rofl_result_t __of1x_attach_port_to_switch_at_port_num(of1x_switch_t* sw, unsign
 	port->attached_sw = (of_switch_t*)sw;
 	port->of_port_num = port_num; 
 
+	__of1x_update_port_sets(sw);
+
 	//Return success
 	platform_mutex_unlock(sw->mutex);
 	return ROFL_SUCCESS;
@@ -142,6 +255,8 @@ rofl_result_t __of1x_attach_port_to_switch(of1x_switch_t* sw, switch_port_t* por
 			//Initialize port
 			port->attached_sw = (of_switch_t*)sw;
 			port->of_port_num = i; 
+
+			__of1x_update_port_sets(sw);
 				
 			//Return success
 			platform_mutex_unlock(sw->mutex);
@@ -176,6 +291,8 @@ rofl_result_t __of1x_detach_port_from_switch_by_port_num(of1x_switch_t* sw, unsi
 	sw->logical_ports[port_num].attachment_state = LOGICAL_PORT_STATE_FREE;
 	sw->logical_ports[port_num].port = NULL;
 	sw->num_of_ports--;
+
+	__of1x_update_port_sets(sw);
 	
 	//return success
 	platform_mutex_unlock(sw->mutex);
@@ -206,6 +323,8 @@ rofl_result_t __of1x_detach_port_from_switch(of1x_switch_t* sw, switch_port_t* p
 			sw->logical_ports[i].port = NULL;
 			sw->num_of_ports--;
 
+			__of1x_update_port_sets(sw);
+
 			platform_mutex_unlock(sw->mutex);
 			return ROFL_SUCCESS;
 		}
@@ -235,6 +354,8 @@ rofl_result_t __of1x_detach_all_ports_from_switch(of1x_switch_t* sw){
 		sw->logical_ports[i].attachment_state = LOGICAL_PORT_STATE_FREE;
 		sw->logical_ports[i].port = NULL;
 	}	
+
+	__of1x_update_port_sets(sw);
 	
 	//Not found 
 	platform_mutex_unlock(sw->mutex);
@@ -271,8 +392,13 @@ void of1x_full_dump_switch(of1x_switch_t* sw, bool nbo){
 
 //Creates a snapshot of the running of LSI 
 of1x_switch_snapshot_t* __of1x_switch_get_snapshot(of1x_switch_t* sw){
+	return __of1x_switch_get_delta_snapshot(sw, NULL);
+}
+
+of1x_switch_snapshot_t* __of1x_switch_get_delta_snapshot(of1x_switch_t* sw, of1x_switch_snapshot_t* base){
 
 	int i;
+	switch_port_t* port;
 
 	//Allocate a snapshot
 	of1x_switch_snapshot_t* sn = platform_malloc_shared(sizeof(of1x_switch_snapshot_t));
@@ -282,16 +408,35 @@ of1x_switch_snapshot_t* __of1x_switch_get_snapshot(of1x_switch_t* sw){
 
 	//Serialize actions over the switch
 	platform_mutex_lock(sw->mutex);
+
+	//Base must be a snapshot of this LSI
+	if(base && (base->dpid != sw->dpid || base->of_ver != sw->of_ver))
+		base = NULL;
 	
 	//Copy contents
 	memcpy(sn, sw, sizeof(of1x_switch_snapshot_t));
 
 	//Cleanup the stuff that should not be exported
 	sn->mutex = sn->platform_state = NULL;
+#ifndef ROFL_PIPELINE_LOCKLESS
+	sn->port_sets_rwlock = NULL;
+#endif
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	sn->tx_bursts = NULL;
+	sn->tx_bursts_mem = NULL;
+#endif
 	
 	//Snapshot ports
 	for(i=0;i<LOGICAL_SWITCH_MAX_LOG_PORTS;i++){
 		if(sw->logical_ports[i].port){
+			//Unchanged since base (same attachment and port revision); share it
+			port = (base && base->revision == sw->revision)? base->logical_ports[i].port : NULL;
+			if(port && port->revision == sw->logical_ports[i].port->revision){
+				refcnt_get(&port->refs);
+				sn->logical_ports[i].port = port;
+				continue;
+			}
+
 			//Exists, snapshot it
 			sn->logical_ports[i].port = __switch_port_get_snapshot(sw->logical_ports[i].port);
 			if(!sn->logical_ports[i].port)
@@ -300,7 +445,7 @@ of1x_switch_snapshot_t* __of1x_switch_get_snapshot(of1x_switch_t* sw){
 	}
 	
 	//Snapshot pipeline	
-	if(__of1x_pipeline_get_snapshot(&sw->pipeline, &sn->pipeline) != ROFL_SUCCESS)
+	if(__of1x_pipeline_get_delta_snapshot(&sw->pipeline, (base)? &base->pipeline : NULL, &sn->pipeline) != ROFL_SUCCESS)
 		goto pipeline_snapshoting_error;	
 
 	platform_mutex_unlock(sw->mutex);
@@ -310,9 +455,10 @@ of1x_switch_snapshot_t* __of1x_switch_get_snapshot(of1x_switch_t* sw){
 pipeline_snapshoting_error:
 	//There is no need to do nothing, since
 	//call should have already cleanup his own memory
+	i = LOGICAL_SWITCH_MAX_LOG_PORTS;
 ports_only_snapshoting_error:
-	//Delete snapshotted ports
-	for(;i>0;i--){
+	//Delete (release) snapshotted ports
+	for(--i;i>=0;i--){
 		if(sn->logical_ports[i].port)
 			switch_port_destroy_snapshot(sn->logical_ports[i].port);
 	}
@@ -9,6 +9,8 @@
 #include <string.h>
 #include "rofl_datapath.h"
 #include "../of_switch.h"
+#include "../../platform/lock.h"
+#include "../../threading.h"
 #include "pipeline/of1x_pipeline.h"
 
 /**
@@ -21,6 +23,44 @@
 
 #define OF1XP_NO_BUFFER	0xffffffff
 
+/**
+* @ingroup core_of1x 
+* Set of logical port numbers of the switch (e.g. ports to flood)
+*/
+typedef struct of1x_port_set{
+	unsigned int num_of_ports;
+	unsigned int port_nums[LOGICAL_SWITCH_MAX_LOG_PORTS];
+}of1x_port_set_t;
+
+#ifdef ROFL_PIPELINE_TX_BURSTS
+
+#ifndef ROFL_PIPELINE_TX_BURST_SIZE
+	#define ROFL_PIPELINE_TX_BURST_SIZE 32 //Max. number of packets staged per port (and TID)
+#endif
+
+#ifndef ROFL_PIPELINE_TX_BURST_MAX_PORTS
+	#define ROFL_PIPELINE_TX_BURST_MAX_PORTS 8 //Max. number of ports with staged packets (per TID)
+#endif
+
+/**
+* TX staging buffer of a port
+*/
+typedef struct __of1x_tx_burst{
+	switch_port_t* port;
+	unsigned int num_of_pkts;
+	datapacket_t* pkts[ROFL_PIPELINE_TX_BURST_SIZE];
+}__of1x_tx_burst_t;
+
+/**
+* TX staging buffers of a TID
+*/
+typedef struct __of1x_tx_bursts{
+	unsigned int num_of_ports;
+	__of1x_tx_burst_t ports[ROFL_PIPELINE_TX_BURST_MAX_PORTS];
+}__tid_aligned __of1x_tx_bursts_t;
+
+#endif //ROFL_PIPELINE_TX_BURSTS
+
 /**
 * @ingroup core_of1x 
 * OpenFlow-enabled v1.0, 1.2 and 1.3.2 switch abstraction
@@ -41,6 +81,9 @@ typedef struct of1x_switch{
  	
 	//Platform agnostic pointer
 	of_switch_platform_state_t* platform_state;
+
+	//Stable id in the physical switch (index in the table of logical switches)
+	unsigned int psw_id;
 	/* End of common part */
 
 	//pipeline
@@ -49,6 +92,27 @@ typedef struct of1x_switch{
 	//Mutex
 	platform_mutex_t* mutex;
 
+	//Revision; incremented on port attachment, detachment and (re)configuration
+	uint64_t revision;
+
+	//Pre-computed FLOOD and ALL port sets (double buffered)
+	unsigned int port_sets_idx;
+	of1x_port_set_t flood_ports[2];
+	of1x_port_set_t all_ports[2];
+
+	//Readers of the port sets (the spare sets are only refilled once they are gone)
+#ifdef ROFL_PIPELINE_LOCKLESS
+	tid_presence_t port_sets_presence_mask;
+#else
+	platform_rwlock_t* port_sets_rwlock;
+#endif
+
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	//Per TID TX staging buffers (ROFL_PIPELINE_MAX_TIDS slots, out of line)
+	__of1x_tx_bursts_t* tx_bursts;
+	void* tx_bursts_mem;
+#endif
+
 }of1x_switch_t;
 
 /**
@@ -84,6 +148,62 @@ rofl_result_t __of1x_detach_port_from_switch_by_port_num(of1x_switch_t* sw, unsi
 rofl_result_t __of1x_detach_port_from_switch(of1x_switch_t* sw, switch_port_t* port);
 rofl_result_t __of1x_detach_all_ports_from_switch(of1x_switch_t* sw);
 
+/**
+* @brief Recomputes the FLOOD and ALL port sets of the switch.  
+* @ingroup core_of1x 
+*
+* The port sets are recomputed on port attachment and detachment. This MUST
+* be called by the platform whenever the up, forward_packets or no_flood flags
+* of an attached port are modified.
+*/
+void of1x_switch_port_config_changed(of1x_switch_t* sw);
+
+/**
+* @brief Starts reading the port sets of the switch (see of1x_get_flood_port_set() and of1x_get_all_port_set())
+* @ingroup core_of1x 
+*
+* The sets returned MUST only be used until of1x_port_sets_read_end() is called.
+*/
+static inline void of1x_port_sets_read_begin(const unsigned int tid, const of1x_switch_t* sw){
+#ifdef ROFL_PIPELINE_LOCKLESS
+	tid_mark_as_present(tid, (volatile tid_presence_t*)&sw->port_sets_presence_mask);
+#else
+	(void)tid;
+	platform_rwlock_rdlock(sw->port_sets_rwlock);
+#endif
+}
+
+/**
+* @brief Finishes reading the port sets of the switch
+* @ingroup core_of1x 
+*/
+static inline void of1x_port_sets_read_end(const unsigned int tid, const of1x_switch_t* sw){
+#ifdef ROFL_PIPELINE_LOCKLESS
+	tid_mark_as_not_present(tid, (volatile tid_presence_t*)&sw->port_sets_presence_mask);
+#else
+	(void)tid;
+	platform_rwlock_rdunlock(sw->port_sets_rwlock);
+#endif
+}
+
+/**
+* @brief Ports that packets to the FLOOD meta port shall be sent to (up, forwarding and not marked as no_flood)
+* @ingroup core_of1x 
+* @warning The incoming port of the packet is NOT excluded. MUST be called within of1x_port_sets_read_begin()/end()
+*/
+static inline const of1x_port_set_t* of1x_get_flood_port_set(const of1x_switch_t* sw){
+	return &sw->flood_ports[sw->port_sets_idx];
+}
+
+/**
+* @brief Ports that packets to the ALL meta port shall be sent to (up and forwarding)
+* @ingroup core_of1x 
+* @warning The incoming port of the packet is NOT excluded. MUST be called within of1x_port_sets_read_begin()/end()
+*/
+static inline const of1x_port_set_t* of1x_get_all_port_set(const of1x_switch_t* sw){
+	return &sw->all_ports[sw->port_sets_idx];
+}
+
 /* Dump */
 /**
 * @brief Dumps the OpenFlow v1.0, 1.2 and 1.3.2 forwarding instance, for debugging purposes.  
@@ -103,6 +223,9 @@ void of1x_full_dump_switch(of1x_switch_t* sw, bool nbo);
 //Creates a snapshot of the running of LSI 
 of1x_switch_snapshot_t* __of1x_switch_get_snapshot(of1x_switch_t* sw);
 
+//Creates a snapshot of the running LSI, sharing what did not change since base
+of1x_switch_snapshot_t* __of1x_switch_get_delta_snapshot(of1x_switch_t* sw, of1x_switch_snapshot_t* base);
+
 //Destroy a previously generated snapshot
 void __of1x_switch_destroy_snapshot(of1x_switch_snapshot_t* snapshot);
 
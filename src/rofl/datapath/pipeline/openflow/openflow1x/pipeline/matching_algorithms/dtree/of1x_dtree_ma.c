@@ -0,0 +1,690 @@
+#include "of1x_dtree_ma.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../of1x_pipeline.h"
+#include "../../of1x_flow_table.h"
+#include "../../of1x_flow_entry.h"
+#include "../../of1x_match.h"
+#include "../../of1x_group_table.h"
+#include "../../of1x_instruction.h"
+#include "../../../of1x_async_events_hooks.h"
+#include "../../../../../common/endianness.h"
+#include "../../../../../platform/lock.h"
+#include "../../../../../platform/likely.h"
+#include "../../../../../platform/memory.h"
+#include "../../../../../util/logging.h"
+#include "../matching_algorithms.h"
+#include "../loop/of1x_loop_ma.h"
+
+#define DTREE_DESCRIPTION "The dtree algorithm uses a decision tree over the 5-tuple (IPv4 src/dst, IP proto, L4 ports), built offline during table maintenance. Suited for large ACL tables. Entries added between rebuilds are looked up linearly"
+
+//Build parameters
+#define DTREE_BINTH 8		//Max. number of rules in a leaf (if it can still be cut)
+#define DTREE_SPFAC 4		//Space factor (max. rule replication per cut)
+#define DTREE_MAX_CUT_BITS 8	//Max. 256 children per node
+#define DTREE_MAX_DEPTH 24
+#define DTREE_BUDGET_FACTOR 16	//Max. leaf rule references per rule
+
+static const uint8_t dtree_dim_bits[DTREE_DIM_MAX] = {32, 32, 8, 16, 16};
+
+//Projection of a rule over the dimensions
+typedef struct dtree_range{
+	uint32_t lo[DTREE_DIM_MAX];
+	uint32_t hi[DTREE_DIM_MAX];
+}dtree_range_t;
+
+//Builder
+typedef struct dtree_builder{
+	dtree_node_t* nodes;
+	uint32_t num_of_nodes;
+	uint32_t max_nodes;
+
+	uint32_t* leaf_rules;
+	uint32_t num_of_leaf_rules;
+	uint32_t max_leaf_rules;
+
+	dtree_range_t* ranges;
+
+	//Max. number of leaf rule references
+	uint32_t budget;
+}dtree_builder_t;
+
+static inline uint32_t dtree_region_hi(uint32_t lo, uint8_t bits){
+	return lo | (uint32_t)(((uint64_t)1 << bits) - 1);
+}
+
+//
+// Constructors and destructors
+//
+rofl_result_t of1x_init_dtree(struct of1x_flow_table *const table){
+
+	table->matching_aux[0] = (void*)platform_malloc_shared(sizeof(dtree_state_t));
+
+	if(unlikely(table->matching_aux[0] == NULL))
+		return ROFL_FAILURE;
+
+	//Cleanup everything
+	memset(table->matching_aux[0], 0, sizeof(dtree_state_t));
+
+	return ROFL_SUCCESS;
+}
+
+static void dtree_destroy_tree(dtree_t* tree){
+	if(!tree)
+		return;
+
+	if(tree->nodes_mem)
+		platform_free_shared(tree->nodes_mem);
+	if(tree->leaf_rules)
+		platform_free_shared(tree->leaf_rules);
+	if(tree->rules)
+		platform_free_shared(tree->rules);
+	platform_free_shared(tree);
+}
+
+rofl_result_t of1x_destroy_dtree(struct of1x_flow_table *const table){
+
+	of1x_flow_entry_t* entry;
+	dtree_state_t* state = (dtree_state_t*)table->matching_aux[0];
+
+	//Release entries' state
+	for(entry = table->entries; entry; entry = entry->next){
+		if(entry->platform_state){
+			platform_free_shared(entry->platform_state);
+			entry->platform_state = NULL;
+		}
+	}
+
+	dtree_destroy_tree(state->tree);
+	platform_free_shared(state);
+	table->matching_aux[0] = NULL;
+
+	//Destroy entries
+	return of1x_destroy_loop(table);
+}
+
+//
+// Tree build
+//
+
+//Grows a builder array (elements are preserved)
+static void* dtree_grow(void* buf, size_t elem_size, uint32_t used, uint32_t* max, uint32_t needed){
+
+	void* tmp;
+	uint32_t new_max;
+
+	if(needed <= *max)
+		return buf;
+
+	new_max = (*max)? *max : 64;
+	while(new_max < needed)
+		new_max *= 2;
+
+	tmp = platform_malloc_shared(elem_size*new_max);
+	if(unlikely(tmp == NULL))
+		return NULL;
+
+	if(buf){
+		memcpy(tmp, buf, elem_size*used);
+		platform_free_shared(buf);
+	}
+	*max = new_max;
+
+	return tmp;
+}
+
+//Intersect the range of a dimension with value/mask
+static inline void dtree_range_intersect(dtree_range_t* r, enum dtree_dim dim, uint32_t value, uint32_t mask, uint32_t dim_max){
+	uint32_t lo = value & mask;
+	uint32_t hi = (value | ~mask) & dim_max;
+
+	if(lo > r->lo[dim])
+		r->lo[dim] = lo;
+	if(hi < r->hi[dim])
+		r->hi[dim] = hi;
+}
+
+/*
+* Calculates the projection of the entry over the tree dimensions. Note that
+* (regardless of the mask being a prefix or not) all the values matching
+* value/mask are within [value&mask, value|~mask].
+*/
+static void dtree_get_range(of1x_flow_entry_t* entry, dtree_range_t* r){
+
+	unsigned int i;
+	of1x_match_t* match;
+
+	for(i=0;i<DTREE_DIM_MAX;i++){
+		r->lo[i] = 0;
+		r->hi[i] = dtree_region_hi(0, dtree_dim_bits[i]);
+	}
+
+	for(match = entry->matches.head; match; match = match->next){
+		switch(match->type){
+			case OF1X_MATCH_IPV4_SRC:
+			case OF1X_MATCH_NW_SRC:
+			case OF1X_MATCH_ARP_SPA:
+				dtree_range_intersect(r, DTREE_DIM_IP_SRC, NTOHB32(match->__tern.value.u32), NTOHB32(match->__tern.mask.u32), 0xFFFFFFFF);
+				break;
+			case OF1X_MATCH_IPV4_DST:
+			case OF1X_MATCH_NW_DST:
+			case OF1X_MATCH_ARP_TPA:
+				dtree_range_intersect(r, DTREE_DIM_IP_DST, NTOHB32(match->__tern.value.u32), NTOHB32(match->__tern.mask.u32), 0xFFFFFFFF);
+				break;
+			case OF1X_MATCH_IP_PROTO:
+			case OF1X_MATCH_NW_PROTO:
+				dtree_range_intersect(r, DTREE_DIM_IP_PROTO, match->__tern.value.u8, match->__tern.mask.u8, 0xFF);
+				break;
+			case OF1X_MATCH_TCP_SRC:
+			case OF1X_MATCH_UDP_SRC:
+			case OF1X_MATCH_SCTP_SRC:
+			case OF1X_MATCH_TP_SRC:
+				dtree_range_intersect(r, DTREE_DIM_TP_SRC, NTOHB16(match->__tern.value.u16), NTOHB16(match->__tern.mask.u16), 0xFFFF);
+				break;
+			case OF1X_MATCH_TCP_DST:
+			case OF1X_MATCH_UDP_DST:
+			case OF1X_MATCH_SCTP_DST:
+			case OF1X_MATCH_TP_DST:
+				dtree_range_intersect(r, DTREE_DIM_TP_DST, NTOHB16(match->__tern.value.u16), NTOHB16(match->__tern.mask.u16), 0xFFFF);
+				break;
+			default:
+				//Not a tree dimension; verified at the leaf
+				break;
+		}
+	}
+}
+
+//Turn node idx into a leaf containing rules
+static rofl_result_t dtree_make_leaf(dtree_builder_t* b, uint32_t idx, const uint32_t* rules, uint32_t num_of_rules){
+
+	uint32_t* leaf_rules;
+
+	//On failure, the current array is kept (and released by the caller)
+	leaf_rules = (uint32_t*)dtree_grow(b->leaf_rules, sizeof(uint32_t), b->num_of_leaf_rules, &b->max_leaf_rules, b->num_of_leaf_rules + num_of_rules + 1);
+	if(unlikely(leaf_rules == NULL))
+		return ROFL_FAILURE;
+	b->leaf_rules = leaf_rules;
+
+	b->nodes[idx].dim = DTREE_LEAF;
+	b->nodes[idx].shift = 0;
+	b->nodes[idx].mask = 0;
+	b->nodes[idx].base = b->num_of_leaf_rules;
+
+	if(num_of_rules)
+		memcpy(&b->leaf_rules[b->num_of_leaf_rules], rules, sizeof(uint32_t)*num_of_rules);
+	b->num_of_leaf_rules += num_of_rules;
+	b->leaf_rules[b->num_of_leaf_rules++] = DTREE_NO_RULE;
+
+	return ROFL_SUCCESS;
+}
+
+//Child index range [*first, *last] spanned by a rule
+static inline bool dtree_get_children_span(const dtree_range_t* r, unsigned int dim, uint32_t lo, uint8_t bits, uint8_t shift, uint32_t* first, uint32_t* last){
+	uint32_t hi = dtree_region_hi(lo, bits);
+	uint32_t a = (r->lo[dim] > lo)? r->lo[dim] : lo;
+	uint32_t b = (r->hi[dim] < hi)? r->hi[dim] : hi;
+
+	if(a > b)
+		return false;
+
+	*first = (a - lo) >> shift;
+	*last = (b - lo) >> shift;
+	return true;
+}
+
+/*
+* Builds (recursively) the subtree of node idx, for the region [lo, lo+2^bits)
+* in every dimension, which contains (ordered) rules.
+*/
+static rofl_result_t dtree_build_node(dtree_builder_t* b, uint32_t idx, uint32_t* lo, uint8_t* bits, const uint32_t* rules, uint32_t num_of_rules, unsigned int depth){
+
+	unsigned int d, i, dim=DTREE_DIM_MAX, cut_bits, c;
+	uint32_t score, best_score=0, total, first, last, num_of_children, child_base, min_child;
+	uint32_t *child_rules, *counts, child_num, saved_lo;
+	uint8_t saved_bits, shift;
+	dtree_node_t* nodes;
+	rofl_result_t res = ROFL_SUCCESS;
+
+	if(num_of_rules <= DTREE_BINTH || depth >= DTREE_MAX_DEPTH || b->num_of_leaf_rules >= b->budget)
+		return dtree_make_leaf(b, idx, rules, num_of_rules);
+
+	//Select the dimension: the one in which more rules do not span the whole region
+	for(d=0;d<DTREE_DIM_MAX;d++){
+		if(bits[d] == 0)
+			continue;
+		for(i=0, score=0;i<num_of_rules;i++){
+			const dtree_range_t* r = &b->ranges[rules[i]];
+			if(r->lo[d] > lo[d] || r->hi[d] < dtree_region_hi(lo[d], bits[d]))
+				score++;
+		}
+		if(score > best_score){
+			best_score = score;
+			dim = d;
+		}
+	}
+
+	if(dim == DTREE_DIM_MAX)
+		return dtree_make_leaf(b, idx, rules, num_of_rules);
+
+	//Select the number of cuts (power of 2) within the space factor
+	for(c=1, cut_bits=1; c <= DTREE_MAX_CUT_BITS && c <= bits[dim]; c++){
+		shift = bits[dim] - c;
+		for(i=0, total=0;i<num_of_rules;i++){
+			if(dtree_get_children_span(&b->ranges[rules[i]], dim, lo[dim], bits[dim], shift, &first, &last))
+				total += last - first + 1;
+		}
+		if(c > 1 && (total + (1U << c)) > DTREE_SPFAC*num_of_rules)
+			break;
+		cut_bits = c;
+	}
+
+	shift = bits[dim] - cut_bits;
+	num_of_children = 1U << cut_bits;
+
+	//Count the rules per child
+	counts = (uint32_t*)platform_malloc_shared(sizeof(uint32_t)*num_of_children);
+	child_rules = (uint32_t*)platform_malloc_shared(sizeof(uint32_t)*num_of_rules);
+	if(unlikely(counts == NULL) || unlikely(child_rules == NULL)){
+		res = ROFL_FAILURE;
+		goto BUILD_NODE_END;
+	}
+	memset(counts, 0, sizeof(uint32_t)*num_of_children);
+
+	for(i=0;i<num_of_rules;i++){
+		if(dtree_get_children_span(&b->ranges[rules[i]], dim, lo[dim], bits[dim], shift, &first, &last)){
+			for(;first <= last; first++)
+				counts[first]++;
+		}
+	}
+	for(i=0, min_child=num_of_rules;i<num_of_children;i++){
+		if(counts[i] < min_child)
+			min_child = counts[i];
+	}
+
+	//All the rules span all the children (no progress); stop cutting
+	if(min_child == num_of_rules){
+		res = dtree_make_leaf(b, idx, rules, num_of_rules);
+		goto BUILD_NODE_END;
+	}
+
+	//Allocate the (contiguous) children
+	nodes = (dtree_node_t*)dtree_grow(b->nodes, sizeof(dtree_node_t), b->num_of_nodes, &b->max_nodes, b->num_of_nodes + num_of_children);
+	if(unlikely(nodes == NULL)){
+		res = ROFL_FAILURE;
+		goto BUILD_NODE_END;
+	}
+	b->nodes = nodes;
+	child_base = b->num_of_nodes;
+	b->num_of_nodes += num_of_children;
+
+	b->nodes[idx].dim = dim;
+	b->nodes[idx].shift = shift;
+	b->nodes[idx].mask = num_of_children - 1;
+	b->nodes[idx].base = child_base;
+
+	//Recurse
+	saved_lo = lo[dim];
+	saved_bits = bits[dim];
+	for(i=0;i<num_of_children && res == ROFL_SUCCESS;i++){
+
+		//Rules (ordered) of the child
+		for(d=0, child_num=0;d<num_of_rules;d++){
+			if(dtree_get_children_span(&b->ranges[rules[d]], dim, saved_lo, saved_bits, shift, &first, &last) && first <= i && i <= last)
+				child_rules[child_num++] = rules[d];
+		}
+
+		lo[dim] = saved_lo + (i << shift);
+		bits[dim] = shift;
+		res = dtree_build_node(b, child_base + i, lo, bits, child_rules, child_num, depth+1);
+	}
+	lo[dim] = saved_lo;
+	bits[dim] = saved_bits;
+
+BUILD_NODE_END:
+	if(counts)
+		platform_free_shared(counts);
+	if(child_rules)
+		platform_free_shared(child_rules);
+	return res;
+}
+
+/*
+* Takes a snapshot of the current table entries: the (unpublished) tree with the
+* rule ids, following the table order (priority), and their projections.
+* Table mutex MUST be held
+*/
+static dtree_t* dtree_snapshot(of1x_flow_table_t *const table, dtree_range_t** ranges){
+
+	uint32_t i;
+	of1x_flow_entry_t* entry;
+	dtree_t* tree;
+
+	tree = (dtree_t*)platform_malloc_shared(sizeof(dtree_t));
+	if(unlikely(tree == NULL))
+		return NULL;
+	memset(tree, 0, sizeof(dtree_t));
+
+	tree->num_of_rules = table->num_of_entries;
+	tree->rules = (of1x_flow_entry_t**)platform_malloc_shared(sizeof(of1x_flow_entry_t*)*tree->num_of_rules);
+	*ranges = (dtree_range_t*)platform_malloc_shared(sizeof(dtree_range_t)*tree->num_of_rules);
+
+	if(unlikely(tree->rules == NULL) || unlikely(*ranges == NULL)){
+		if(*ranges)
+			platform_free_shared(*ranges);
+		*ranges = NULL;
+		dtree_destroy_tree(tree);
+		return NULL;
+	}
+
+	for(entry = table->entries, i=0; entry && i < tree->num_of_rules; entry = entry->next, i++){
+		tree->rules[i] = entry;
+		((dtree_entry_ps_t*)entry->platform_state)->build_rule_id = i;
+		dtree_get_range(entry, &(*ranges)[i]);
+	}
+	assert(i == tree->num_of_rules);
+
+	return tree;
+}
+
+/*
+* Builds the nodes of a snapshot tree. This is done without holding any lock;
+* only the projections are used (tree->rules may be concurrently invalidated).
+*/
+static rofl_result_t dtree_build(dtree_t* tree, dtree_range_t* ranges){
+
+	uint32_t i, d, num_of_rules=0, *rules=NULL;
+	uint32_t lo[DTREE_DIM_MAX];
+	uint8_t bits[DTREE_DIM_MAX];
+	dtree_builder_t b;
+
+	memset(&b, 0, sizeof(b));
+	b.ranges = ranges;
+
+	rules = (uint32_t*)platform_malloc_shared(sizeof(uint32_t)*tree->num_of_rules);
+	b.nodes = (dtree_node_t*)dtree_grow(NULL, sizeof(dtree_node_t), 0, &b.max_nodes, 1);
+
+	if(unlikely(rules == NULL) || unlikely(b.nodes == NULL))
+		goto BUILD_ERROR;
+
+	//Rules that can never match are left out of the tree
+	for(i=0;i<tree->num_of_rules;i++){
+		for(d=0;d<DTREE_DIM_MAX;d++){
+			if(ranges[i].lo[d] > ranges[i].hi[d])
+				break;
+		}
+		if(d == DTREE_DIM_MAX)
+			rules[num_of_rules++] = i;
+	}
+
+	//Root
+	for(i=0;i<DTREE_DIM_MAX;i++){
+		lo[i] = 0;
+		bits[i] = dtree_dim_bits[i];
+	}
+	b.num_of_nodes = 1;
+	b.budget = DTREE_BUDGET_FACTOR*tree->num_of_rules + 1024;
+
+	if(dtree_build_node(&b, 0, lo, bits, rules, num_of_rules, 0) != ROFL_SUCCESS)
+		goto BUILD_ERROR;
+
+	//Copy the nodes to a cache aligned array
+	tree->nodes_mem = platform_malloc_shared(sizeof(dtree_node_t)*b.num_of_nodes + DTREE_CACHE_LINE_SIZE);
+	if(unlikely(tree->nodes_mem == NULL))
+		goto BUILD_ERROR;
+	tree->nodes = (dtree_node_t*)(((uintptr_t)tree->nodes_mem + DTREE_CACHE_LINE_SIZE - 1) & ~((uintptr_t)DTREE_CACHE_LINE_SIZE - 1));
+	memcpy(tree->nodes, b.nodes, sizeof(dtree_node_t)*b.num_of_nodes);
+	tree->num_of_nodes = b.num_of_nodes;
+
+	tree->leaf_rules = b.leaf_rules;
+	tree->num_of_leaf_rules = b.num_of_leaf_rules;
+
+	platform_free_shared(b.nodes);
+	platform_free_shared(rules);
+
+	return ROFL_SUCCESS;
+
+BUILD_ERROR:
+	if(b.nodes)
+		platform_free_shared(b.nodes);
+	if(b.leaf_rules)
+		platform_free_shared(b.leaf_rules);
+	if(rules)
+		platform_free_shared(rules);
+	return ROFL_FAILURE;
+}
+
+rofl_result_t of1x_rebuild_dtree(struct of1x_flow_table *const table){
+
+	rofl_result_t res = ROFL_SUCCESS;
+	dtree_t *tree=NULL, *old;
+	dtree_range_t* ranges=NULL;
+	dtree_entry_ps_t *ps;
+	of1x_flow_entry_t* entry;
+	dtree_state_t* state = (dtree_state_t*)table->matching_aux[0];
+
+	//Snapshot (serialized with flowmods)
+	platform_mutex_lock(table->mutex);
+
+	if(!state->dirty || state->building){
+		platform_mutex_unlock(table->mutex);
+		return ROFL_SUCCESS;
+	}
+
+	if(table->num_of_entries){
+		tree = dtree_snapshot(table, &ranges);
+		if(unlikely(tree == NULL)){
+			//Keep on using the current tree and the side list
+			ROFL_PIPELINE_ERR("[dtree] Unable to snapshot the entries of table %u (%p)\n", table->number, table);
+			platform_mutex_unlock(table->mutex);
+			return ROFL_FAILURE;
+		}
+	}
+
+	//Changes from now on are tracked for the next build
+	state->building = tree;
+	state->dirty = false;
+
+	platform_mutex_unlock(table->mutex);
+
+	//Build, without stalling flowmods
+	if(tree){
+		res = dtree_build(tree, ranges);
+		platform_free_shared(ranges);
+	}
+
+	platform_mutex_lock(table->mutex);
+
+	state->building = NULL;
+
+	if(unlikely(res != ROFL_SUCCESS)){
+		//Keep on using the current tree and the side list
+		for(entry = table->entries; entry; entry = entry->next)
+			((dtree_entry_ps_t*)entry->platform_state)->build_rule_id = DTREE_NO_RULE;
+		state->dirty = true;
+		platform_mutex_unlock(table->mutex);
+
+		ROFL_PIPELINE_ERR("[dtree] Unable to build the tree of table %u (%p)\n", table->number, table);
+		dtree_destroy_tree(tree);
+		return ROFL_FAILURE;
+	}
+
+	/*
+	* Publish. Entries removed during the build have already been invalidated
+	* in the new tree, and entries added during the build stay in the side list.
+	*/
+	platform_rwlock_wrlock(table->rwlock);
+	old = state->tree;
+	state->tree = tree;
+
+	for(entry = table->entries; entry; entry = entry->next){
+		ps = (dtree_entry_ps_t*)entry->platform_state;
+
+		if(ps->build_rule_id == DTREE_NO_RULE){
+			assert(ps->rule_id == DTREE_NO_RULE);
+			continue;
+		}
+
+		if(ps->rule_id == DTREE_NO_RULE){
+			//Remove from the side list (next is kept for in-flight readers)
+			if(ps->next)
+				ps->next->prev = ps->prev;
+			if(ps->prev)
+				ps->prev->next = ps->next;
+			else
+				state->side = ps->next;
+			state->num_of_side_entries--;
+		}
+		ps->rule_id = ps->build_rule_id;
+		ps->build_rule_id = DTREE_NO_RULE;
+	}
+	platform_rwlock_wrunlock(table->rwlock);
+
+#ifdef ROFL_PIPELINE_LOCKLESS
+	tid_wait_all_not_present(&table->tid_presence_mask);
+#endif
+
+	platform_mutex_unlock(table->mutex);
+
+	//Nobody is using the old tree anymore
+	dtree_destroy_tree(old);
+
+	return ROFL_SUCCESS;
+}
+
+//
+//Hooks
+//
+void of1x_add_hook_dtree(of1x_flow_entry_t *const entry){
+
+	dtree_entry_ps_t *ps, *it, *prev;
+	dtree_state_t* state = (dtree_state_t*)entry->table->matching_aux[0];
+
+	ps = (dtree_entry_ps_t*)platform_malloc_shared(sizeof(dtree_entry_ps_t));
+
+	if(unlikely(ps == NULL)){
+		assert(0);
+		return;
+	}
+
+	ps->rule_id = DTREE_NO_RULE;
+	ps->build_rule_id = DTREE_NO_RULE;
+	ps->entry = entry;
+
+	//Look for the position in the side list
+	for(it = state->side, prev=NULL; it; prev = it, it = it->next){
+		if(__of1x_dtree_entry_precedes(entry, it->entry))
+			break;
+	}
+	ps->prev = prev;
+	ps->next = it;
+
+	//Prevent readers to jump in
+	platform_rwlock_wrlock(entry->table->rwlock);
+
+	if(it)
+		it->prev = ps;
+	if(prev)
+		prev->next = ps;
+	else
+		state->side = ps;
+
+	state->num_of_side_entries++;
+	state->dirty = true;
+	entry->platform_state = (void*)ps;
+
+	platform_rwlock_wrunlock(entry->table->rwlock);
+}
+
+void of1x_modify_hook_dtree(of1x_flow_entry_t *const entry){
+	//Matches are never modified; we don't care
+}
+
+void of1x_remove_hook_dtree(of1x_flow_entry_t *const entry){
+
+	dtree_entry_ps_t* ps = (dtree_entry_ps_t*)entry->platform_state;
+	dtree_state_t* state = (dtree_state_t*)entry->table->matching_aux[0];
+
+	if(unlikely(ps == NULL)){
+		assert(0);
+		return;
+	}
+
+	//Prevent readers to jump in
+	platform_rwlock_wrlock(entry->table->rwlock);
+
+	if(ps->rule_id != DTREE_NO_RULE){
+		//Invalidate in the tree
+		state->tree->rules[ps->rule_id] = NULL;
+	}else{
+		//Remove from the side list
+		if(ps->next)
+			ps->next->prev = ps->prev;
+		if(ps->prev)
+			ps->prev->next = ps->next;
+		else
+			state->side = ps->next;
+		state->num_of_side_entries--;
+	}
+	state->dirty = true;
+
+	//Invalidate in the tree being built (not yet visible to readers)
+	if(state->building && ps->build_rule_id != DTREE_NO_RULE)
+		state->building->rules[ps->build_rule_id] = NULL;
+
+	platform_rwlock_wrunlock(entry->table->rwlock);
+
+#ifdef ROFL_PIPELINE_LOCKLESS
+	tid_wait_all_not_present(&entry->table->tid_presence_mask);
+#endif
+
+	platform_free_shared(ps);
+	entry->platform_state = NULL;
+}
+
+//
+// Main routines
+//
+rofl_of1x_fm_result_t of1x_add_flow_entry_dtree(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, bool check_overlap, bool reset_counts, bool check_cookie){
+	//Call loop with the right hooks
+	return __of1x_add_flow_entry_loop(table, entry, check_overlap, reset_counts, check_cookie, of1x_add_hook_dtree, of1x_remove_hook_dtree);
+}
+
+rofl_of1x_fm_result_t of1x_modify_flow_entry_dtree(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, const enum of1x_flow_removal_strictness strict, bool reset_counts){
+	//Call loop with the right hooks
+	return __of1x_modify_flow_entry_loop(table, entry, strict, reset_counts, of1x_add_hook_dtree, of1x_modify_hook_dtree, of1x_remove_hook_dtree);
+}
+
+rofl_of1x_fm_result_t of1x_remove_flow_entry_dtree(of1x_flow_table_t *const table , of1x_flow_entry_t *const entry, of1x_flow_entry_t *const specific_entry, const enum of1x_flow_removal_strictness strict, uint32_t out_port, uint32_t out_group, of1x_flow_remove_reason_t reason, of1x_mutex_acquisition_required_t mutex_acquired){
+	//Call loop with the right hooks
+	return __of1x_remove_flow_entry_loop(table, entry, specific_entry, strict, out_port, out_group, reason, mutex_acquired, of1x_remove_hook_dtree);
+}
+
+//Define the matching algorithm struct
+OF1X_REGISTER_MATCHING_ALGORITHM(dtree) = {
+	//Init and destroy hooks
+	.init_hook = of1x_init_dtree,
+	.destroy_hook = of1x_destroy_dtree,
+
+	//Maintenance (tree rebuild)
+	.maintenance_hook = of1x_rebuild_dtree,
+
+	//Flow mods
+	.add_flow_entry_hook = of1x_add_flow_entry_dtree,
+	.modify_flow_entry_hook = of1x_modify_flow_entry_dtree,
+	.remove_flow_entry_hook = of1x_remove_flow_entry_dtree,
+
+	//Stats
+	.get_flow_stats_hook = of1x_get_flow_stats_loop,
+	.get_flow_stats_page_hook = of1x_get_flow_stats_page_loop,
+	.walk_flow_entries_hook = of1x_walk_flow_entries_loop,
+	.get_flow_aggregate_stats_hook = of1x_get_flow_aggregate_stats_loop,
+
+	//Find group related entries
+	.find_entry_using_group_hook = of1x_find_entry_using_group_loop,
+
+	//Dumping
+	.dump_hook = NULL,
+	.description = DTREE_DESCRIPTION,
+};
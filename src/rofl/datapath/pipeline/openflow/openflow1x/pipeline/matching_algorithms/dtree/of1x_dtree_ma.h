@@ -0,0 +1,129 @@
+#ifndef __OF1X_DTREE_MATCH_H__
+#define __OF1X_DTREE_MATCH_H__
+
+#include "rofl_datapath.h"
+#include "../matching_algorithms.h"
+#include "../../of1x_flow_table.h"
+
+/**
+* @file of1x_dtree_ma.h
+*
+* @brief Decision-tree (HiCuts/HyperCuts style) matching algorithm
+*
+* The tree is cut over the classic 5-tuple dimensions (IPv4 src/dst, IP proto,
+* L4 src/dst). It is NOT built in the packet processing path nor in the
+* flowmod path, but offline, during the periodic maintenance of the table
+* (see maintenance_hook), from a snapshot of the entries in the table. The
+* table mutex is only held to take the snapshot and to publish the new tree,
+* so flowmods are not stalled during the build.
+*
+* Entries added after the last build are kept in a small side list (ordered
+* by priority), which is looked up linearly until the next rebuild. Removed
+* entries are simply invalidated in the tree rule array.
+*
+* The tree is only a pre-filter; rules in the leafs are always fully verified
+* against the packet, so any combination of matches is supported.
+*/
+
+//Dimensions of the tree
+enum dtree_dim{
+	DTREE_DIM_IP_SRC = 0,
+	DTREE_DIM_IP_DST = 1,
+	DTREE_DIM_IP_PROTO = 2,
+	DTREE_DIM_TP_SRC = 3,
+	DTREE_DIM_TP_DST = 4,
+
+	DTREE_DIM_MAX
+};
+
+//Node dim value of leafs
+#define DTREE_LEAF 0xFF
+
+//Rule id of entries not (yet) in the tree and leaf rule list terminator
+#define DTREE_NO_RULE 0xFFFFFFFF
+
+#define DTREE_CACHE_LINE_SIZE 64
+
+/**
+* Tree node. Children of a node are contiguous in the node array; the child
+* for a key is base + ((key[dim] >> shift) & mask). For leafs, base is the
+* offset of the first rule id in the leaf_rules array (DTREE_NO_RULE terminated).
+*/
+typedef struct dtree_node{
+	uint8_t dim;
+	uint8_t shift;
+	uint16_t mask;
+	uint32_t base;
+}dtree_node_t;
+
+//Tree (immutable once published)
+typedef struct dtree{
+	//Node array (cache aligned), root is nodes[0]
+	dtree_node_t* nodes;
+	uint32_t num_of_nodes;
+
+	//Leaf rule ids (in priority order)
+	uint32_t* leaf_rules;
+	uint32_t num_of_leaf_rules;
+
+	//Entries indexed by rule id. Removed entries are set to NULL
+	of1x_flow_entry_t** rules;
+	uint32_t num_of_rules;
+
+	//Raw node array memory
+	void* nodes_mem;
+}dtree_t;
+
+//Platform state of an entry
+typedef struct dtree_entry_ps{
+	//Rule id in the current tree or DTREE_NO_RULE if in the side list
+	uint32_t rule_id;
+
+	//Rule id in the tree being built or DTREE_NO_RULE if not in the snapshot
+	uint32_t build_rule_id;
+
+	//Entry
+	of1x_flow_entry_t* entry;
+
+	//Side list
+	struct dtree_entry_ps* prev;
+	struct dtree_entry_ps* next;
+}dtree_entry_ps_t;
+
+//State
+typedef struct dtree_state{
+	//Current tree
+	dtree_t* tree;
+
+	//Tree being built (not yet published), if any
+	dtree_t* building;
+
+	//Entries added since the last build (ordered by priority)
+	dtree_entry_ps_t* side;
+	unsigned int num_of_side_entries;
+
+	//Table modified since the last build
+	bool dirty;
+}dtree_state_t;
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+/*
+* Precedence as per the table order (priority, then number of matches). On
+* ties, a (newer) side list entry takes precedence.
+*/
+static inline bool __of1x_dtree_entry_precedes(const of1x_flow_entry_t* a, const of1x_flow_entry_t* b){
+	return (a->priority > b->priority) || (a->priority == b->priority && a->matches.num_elements >= b->matches.num_elements);
+}
+
+/**
+* Rebuilds the tree of the table, if it has been modified since the last
+* build. This is the maintenance hook of the algorithm.
+*/
+rofl_result_t of1x_rebuild_dtree(struct of1x_flow_table *const table);
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //DTREE_MATCH
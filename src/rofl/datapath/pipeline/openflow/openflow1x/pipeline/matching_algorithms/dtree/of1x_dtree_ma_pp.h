@@ -0,0 +1,135 @@
+#ifndef __OF1X_DTREE_MATCH_PP_H__
+#define __OF1X_DTREE_MATCH_PP_H__
+
+#include "rofl_datapath.h"
+#include "../../../../../util/pp_guard.h" //Never forget to include the guard
+#include "../../../../../common/endianness.h"
+#include "../../of1x_pipeline.h"
+#include "../../of1x_flow_table.h"
+#include "../../of1x_flow_entry.h"
+#include "../../of1x_match_pp.h"
+#include "../../of1x_packet_key_pp.h"
+#include "../../of1x_group_table.h"
+#include "../../of1x_instruction_pp.h"
+#include "../../../of1x_async_events_hooks.h"
+#include "../../../../../platform/lock.h"
+#include "../../../../../platform/likely.h"
+#include "../../../../../platform/memory.h"
+#include "of1x_dtree_ma.h"
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+//Full check of the entry matches
+static inline bool __of1x_dtree_check_entry(datapacket_t *const pkt, of1x_flow_entry_t* entry){
+	of1x_match_t* it;
+
+	for(it=entry->matches.head; it; it=it->next){
+		if(!__of1x_check_match(pkt, it))
+			return false;
+	}
+	return true;
+}
+
+/*
+* Fill in the tree key (HBO) out of the canonical packet key. Fields not
+* present in the packet are set to 0; this is safe since the tree is only a
+* pre-filter.
+*/
+static inline void __of1x_dtree_get_key(datapacket_t *const pkt, uint32_t* key){
+
+	of1x_packet_key_t* pkt_key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_ARP | OF1X_PKT_KEY_L3 | OF1X_PKT_KEY_L4);
+	uint64_t present = pkt_key->present;
+
+	key[DTREE_DIM_IP_SRC] = key[DTREE_DIM_IP_DST] = key[DTREE_DIM_IP_PROTO] = 0;
+	key[DTREE_DIM_TP_SRC] = key[DTREE_DIM_TP_DST] = 0;
+
+	//IPv4 or ARP (NW_SRC, NW_DST and NW_PROTO in OF1.0)
+	if(present & OF1X_PKT_KEY_F_IPV4_SRC)
+		key[DTREE_DIM_IP_SRC] = NTOHB32(pkt_key->ipv4_src);
+	else if(present & OF1X_PKT_KEY_F_ARP_SPA)
+		key[DTREE_DIM_IP_SRC] = NTOHB32(pkt_key->arp_spa);
+
+	if(present & OF1X_PKT_KEY_F_IPV4_DST)
+		key[DTREE_DIM_IP_DST] = NTOHB32(pkt_key->ipv4_dst);
+	else if(present & OF1X_PKT_KEY_F_ARP_TPA)
+		key[DTREE_DIM_IP_DST] = NTOHB32(pkt_key->arp_tpa);
+
+	if(present & OF1X_PKT_KEY_F_IP_PROTO)
+		key[DTREE_DIM_IP_PROTO] = pkt_key->ip_proto;
+	else if(present & OF1X_PKT_KEY_F_ARP_OP)
+		key[DTREE_DIM_IP_PROTO] = NTOHB16(pkt_key->arp_opcode) & 0xFF;
+
+	//TCP, UDP, SCTP or ICMPv4 (TP_SRC/TP_DST in OF1.0)
+	if(present & OF1X_PKT_KEY_F_TP_SRC)
+		key[DTREE_DIM_TP_SRC] = NTOHB16(pkt_key->tp_src);
+	else if(present & OF1X_PKT_KEY_F_ICMPV4_TYPE)
+		key[DTREE_DIM_TP_SRC] = pkt_key->icmpv4_type;
+
+	if(present & OF1X_PKT_KEY_F_TP_DST)
+		key[DTREE_DIM_TP_DST] = NTOHB16(pkt_key->tp_dst);
+	else if(present & OF1X_PKT_KEY_F_ICMPV4_CODE)
+		key[DTREE_DIM_TP_DST] = pkt_key->icmpv4_code;
+}
+
+/* FLOW entry lookup entry point */
+static inline of1x_flow_entry_t* of1x_find_best_match_dtree_ma(of1x_flow_table_t *const table, datapacket_t *const pkt){
+
+	uint32_t key[DTREE_DIM_MAX];
+	const dtree_node_t* node;
+	const uint32_t* rule;
+	of1x_flow_entry_t *entry, *best_match = NULL;
+	dtree_entry_ps_t* ps;
+	dtree_state_t* state = (dtree_state_t*)table->matching_aux[0];
+	dtree_t* tree;
+
+#ifndef ROFL_PIPELINE_LOCKLESS
+	//Prevent writers to change structure during matching
+	platform_rwlock_rdlock(table->rwlock);
+#endif
+
+	tree = state->tree;
+
+	if(tree){
+		__of1x_dtree_get_key(pkt, key);
+
+		//Walk down the tree
+		node = tree->nodes;
+		while(node->dim != DTREE_LEAF)
+			node = &tree->nodes[node->base + ((key[node->dim] >> node->shift) & node->mask)];
+
+		//Leaf rules are sorted by priority; first full match => best match
+		for(rule = &tree->leaf_rules[node->base]; *rule != DTREE_NO_RULE; rule++){
+			entry = tree->rules[*rule];
+			if(entry && __of1x_dtree_check_entry(pkt, entry)){
+				best_match = entry;
+				break;
+			}
+		}
+	}
+
+	//Side list (entries added since the last build)
+	for(ps = state->side; ps; ps = ps->next){
+		if(best_match && !__of1x_dtree_entry_precedes(ps->entry, best_match))
+			break;
+		if(__of1x_dtree_check_entry(pkt, ps->entry)){
+			best_match = ps->entry;
+			break;
+		}
+	}
+
+#ifndef ROFL_PIPELINE_LOCKLESS
+	//Lock writers to modify the entry while packet processing. WARNING!!!! this must be released by the pipeline, once packet is processed!
+	if(best_match)
+		platform_rwlock_rdlock(best_match->rwlock);
+
+	//Green light for writers
+	platform_rwlock_rdunlock(table->rwlock);
+#endif
+	return best_match;
+}
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //OF1X_DTREE_MATCH_PP
@@ -181,8 +181,8 @@ void of1x_add_hook_l2hash(of1x_flow_entry_t *const entry){
 	if(vlan){
 		//VLAN
 		l2hash_vlan_key_t key;
-		key.vid = vlan->__tern.value.u16 & vlan->__tern.mask.u16;	
-		key.eth_dst = eth_dst->__tern.value.u64 & eth_dst->__tern.mask.u64;
+		key.vid = vlan->__tern.value.u16;	
+		key.eth_dst = eth_dst->__tern.value.u64;
 		//calculate hash	
 		hash = l2hash_ht_hash96((const char*)&key, sizeof(l2hash_vlan_key_t)); 		
 		//Fill in ps
@@ -200,7 +200,7 @@ void of1x_add_hook_l2hash(of1x_flow_entry_t *const entry){
 	}else{
 		//NO-VLAN
 		l2hash_novlan_key_t key;
-		key.eth_dst = eth_dst->__tern.value.u64 & eth_dst->__tern.mask.u64;
+		key.eth_dst = eth_dst->__tern.value.u64;
 		//calculate hash	
 		hash = l2hash_ht_hash64((const char*)&key, sizeof(l2hash_novlan_key_t));
 
@@ -266,12 +266,12 @@ rofl_of1x_fm_result_t of1x_add_flow_entry_l2hash(of1x_flow_table_t *const table,
 		return ROFL_OF1X_FM_FAILURE;
 
 	//Call loop with the right hooks
-	return __of1x_add_flow_entry_loop(table, entry, check_overlap, reset_counts, check_cookie, of1x_add_hook_l2hash);
+	return __of1x_add_flow_entry_loop(table, entry, check_overlap, reset_counts, check_cookie, of1x_add_hook_l2hash, of1x_remove_hook_l2hash);
 }
 
 rofl_of1x_fm_result_t of1x_modify_flow_entry_l2hash(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, const enum of1x_flow_removal_strictness strict, bool reset_counts){
 	//Call loop with the right hooks
-	return __of1x_modify_flow_entry_loop(table, entry, strict, reset_counts, of1x_add_hook_l2hash, of1x_modify_hook_l2hash);
+	return __of1x_modify_flow_entry_loop(table, entry, strict, reset_counts, of1x_add_hook_l2hash, of1x_modify_hook_l2hash, of1x_remove_hook_l2hash);
 }
 
 rofl_of1x_fm_result_t of1x_remove_flow_entry_l2hash(of1x_flow_table_t *const table , of1x_flow_entry_t *const entry, of1x_flow_entry_t *const specific_entry, const enum of1x_flow_removal_strictness strict, uint32_t out_port, uint32_t out_group, of1x_flow_remove_reason_t reason, of1x_mutex_acquisition_required_t mutex_acquired){
@@ -292,6 +292,8 @@ OF1X_REGISTER_MATCHING_ALGORITHM(l2hash) = {
 
 	//Stats
 	.get_flow_stats_hook = of1x_get_flow_stats_loop,
+	.get_flow_stats_page_hook = of1x_get_flow_stats_page_loop,
+	.walk_flow_entries_hook = of1x_walk_flow_entries_loop,
 	.get_flow_aggregate_stats_hook = of1x_get_flow_aggregate_stats_loop,
 
 	//Find group related entries	
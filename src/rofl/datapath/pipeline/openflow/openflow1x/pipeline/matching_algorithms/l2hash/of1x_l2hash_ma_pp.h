@@ -6,6 +6,7 @@
 #include "../../of1x_flow_table.h"
 #include "../../of1x_flow_entry.h"
 #include "../../of1x_match_pp.h"
+#include "../../of1x_packet_key_pp.h"
 #include "../../of1x_group_table.h"
 #include "../../of1x_instruction_pp.h"
 #include "../../../of1x_async_events_hooks.h"
@@ -46,18 +47,17 @@ static inline of1x_flow_entry_t* of1x_find_best_match_l2hash_ma(of1x_flow_table_
 	l2hash_vlan_key_t key_vlan;
 	of1x_flow_entry_t *best_match = NULL, *tmp=NULL;
 	l2hash_ht_entry_t* ht_entry;
-	uint16_t* vid;
+	of1x_packet_key_t* pkt_key;
 
 	//Table hash table 
 	l2hash_state_t* state = (l2hash_state_t*)table->matching_aux[0];
 	
-	//Recover keys	
-	key_novlan.eth_dst = key_vlan.eth_dst = *platform_packet_get_eth_dst(pkt) & OF1X_6_BYTE_MASK;
+	//Recover keys (from the packet key; fields may have been set by previous tables)
+	pkt_key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2);
+	key_novlan.eth_dst = key_vlan.eth_dst = pkt_key->eth_dst & OF1X_6_BYTE_MASK;
 
-	vid = platform_packet_get_vlan_vid(pkt);
-
-	if(vid)
-		key_vlan.vid = *vid&OF1X_VLAN_ID_MASK;
+	if(pkt_key->present & OF1X_PKT_KEY_F_VLAN_VID)
+		key_vlan.vid = pkt_key->vlan_vid&OF1X_VLAN_ID_MASK;
 
 	//Check no-VLAN table-hash
 	if(state->no_vlan.num_of_entries > 0){
@@ -110,10 +110,15 @@ static rofl_of1x_fm_result_t of1x_remove_flow_entry_table_specific_imp(of1x_flow
 			specific_entry->next->prev = specific_entry->prev;
 	}
 	table->num_of_entries--;
+	table->revision++;
 	
 	//Green light to readers and other writers			
 	platform_rwlock_wrunlock(table->rwlock);
 
+	//Secondary indexes and running aggregates
+	__of1x_flow_index_remove(table, specific_entry);
+	__of1x_stats_flow_aggregates_remove_entry(table, specific_entry);
+
 	// let the platform do the necessary cleanup
 	if(ma_hook_ptr)
 		(*ma_hook_ptr)(specific_entry);
@@ -132,7 +137,7 @@ static rofl_of1x_fm_result_t of1x_remove_flow_entry_table_specific_imp(of1x_flow
 * Adds flow_entry to the main table. This function is NOT thread safe, and mutual exclusion should be 
 * acquired BEFORE this function being called, using table->mutex var. 
 */
-rofl_of1x_fm_result_t of1x_add_flow_entry_table_imp(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, bool check_overlap, bool reset_counts, bool check_cookie, void (*ma_hook_ptr)(of1x_flow_entry_t*)){
+rofl_of1x_fm_result_t of1x_add_flow_entry_table_imp(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, bool check_overlap, bool reset_counts, bool check_cookie, void (*ma_hook_ptr)(of1x_flow_entry_t*), void (*ma_remove_hook_ptr)(of1x_flow_entry_t*)){
 	of1x_flow_entry_t *it, *prev, *existing=NULL;
 	
 	if(unlikely(table->num_of_entries == OF1X_MAX_NUMBER_OF_TABLE_ENTRIES)){
@@ -148,6 +153,10 @@ rofl_of1x_fm_result_t of1x_add_flow_entry_table_imp(of1x_flow_table_t *const tab
 		entry->table = table;
 
 		table->num_of_entries++;
+		table->revision++;
+		entry->__seq = table->revision;
+		__of1x_flow_index_add(table, entry);
+		__of1x_stats_flow_aggregates_add_entry(table, entry);
 
 		// let the platform do the necessary add operations
 		if(ma_hook_ptr)
@@ -213,9 +222,13 @@ rofl_of1x_fm_result_t of1x_add_flow_entry_table_imp(of1x_flow_table_t *const tab
 
 			//Increment the number of entries in the table (safe since we have the mutex acquired)
 			table->num_of_entries++;
+			table->revision++;
+			entry->__seq = table->revision;
 	
 			//Point entry table to us
 			entry->table = table;
+			__of1x_flow_index_add(table, entry);
+			__of1x_stats_flow_aggregates_add_entry(table, entry);
 
 			//Delete old entry
 			if(existing){
@@ -224,7 +237,7 @@ rofl_of1x_fm_result_t of1x_add_flow_entry_table_imp(of1x_flow_table_t *const tab
 				tid_wait_all_not_present(&table->tid_presence_mask);	
 #endif
 
-				if(of1x_remove_flow_entry_table_specific_imp(table,existing, OF1X_FLOW_REMOVE_NO_REASON, ma_hook_ptr) != ROFL_OF1X_FM_SUCCESS){
+				if(of1x_remove_flow_entry_table_specific_imp(table,existing, OF1X_FLOW_REMOVE_NO_REASON, ma_remove_hook_ptr) != ROFL_OF1X_FM_SUCCESS){
 					assert(0);
 				}
 			}
@@ -266,6 +279,10 @@ rofl_of1x_fm_result_t of1x_add_flow_entry_table_imp(of1x_flow_table_t *const tab
 	
 	//Increment the number of entries in the table (safe since we have the mutex acquired)
 	table->num_of_entries++;
+	table->revision++;
+	entry->__seq = table->revision;
+	__of1x_flow_index_add(table, entry);
+	__of1x_stats_flow_aggregates_add_entry(table, entry);
 
 	//Delete old entry
 	if(existing){
@@ -274,7 +291,7 @@ rofl_of1x_fm_result_t of1x_add_flow_entry_table_imp(of1x_flow_table_t *const tab
 		tid_wait_all_not_present(&table->tid_presence_mask);	
 #endif
 		
-		if(unlikely(of1x_remove_flow_entry_table_specific_imp(table,existing, OF1X_FLOW_REMOVE_NO_REASON, ma_hook_ptr) != ROFL_OF1X_FM_SUCCESS)){
+		if(unlikely(of1x_remove_flow_entry_table_specific_imp(table,existing, OF1X_FLOW_REMOVE_NO_REASON, ma_remove_hook_ptr) != ROFL_OF1X_FM_SUCCESS)){
 			assert(0);
 		}
 	}
@@ -370,14 +387,14 @@ static inline rofl_of1x_fm_result_t of1x_remove_flow_entry_table_imp(of1x_flow_t
 }
 
 /* Conveniently wraps call with mutex.  */
-rofl_of1x_fm_result_t __of1x_add_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, bool check_overlap, bool reset_counts, bool check_cookie, void (*ma_hook_ptr)(of1x_flow_entry_t*)){
+rofl_of1x_fm_result_t __of1x_add_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, bool check_overlap, bool reset_counts, bool check_cookie, void (*ma_hook_ptr)(of1x_flow_entry_t*), void (*ma_remove_hook_ptr)(of1x_flow_entry_t*)){
 
 	rofl_of1x_fm_result_t return_value;
 
 	//Allow single add/remove operation over the table
 	platform_mutex_lock(table->mutex);
 	
-	return_value = of1x_add_flow_entry_table_imp(table, entry, check_overlap, reset_counts, check_cookie, ma_hook_ptr);
+	return_value = of1x_add_flow_entry_table_imp(table, entry, check_overlap, reset_counts, check_cookie, ma_hook_ptr, ma_remove_hook_ptr);
 
 	//Green light to other threads
 	platform_mutex_unlock(table->mutex);
@@ -385,10 +402,10 @@ rofl_of1x_fm_result_t __of1x_add_flow_entry_loop(of1x_flow_table_t *const table,
 	return return_value;
 }
 rofl_of1x_fm_result_t of1x_add_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, bool check_overlap, bool reset_counts, bool check_cookie){
-	return __of1x_add_flow_entry_loop(table, entry, check_overlap, reset_counts, check_cookie, NULL);
+	return __of1x_add_flow_entry_loop(table, entry, check_overlap, reset_counts, check_cookie, NULL, NULL);
 }
 
-rofl_of1x_fm_result_t __of1x_modify_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, const enum of1x_flow_removal_strictness strict, bool reset_counts, void (*ma_add_hook_ptr)(of1x_flow_entry_t*), void (*ma_modify_hook_ptr)(of1x_flow_entry_t*)){
+rofl_of1x_fm_result_t __of1x_modify_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, const enum of1x_flow_removal_strictness strict, bool reset_counts, void (*ma_add_hook_ptr)(of1x_flow_entry_t*), void (*ma_modify_hook_ptr)(of1x_flow_entry_t*), void (*ma_remove_hook_ptr)(of1x_flow_entry_t*)){
 
 	int moded=0; 
 	of1x_flow_entry_t *it;
@@ -440,7 +457,7 @@ rofl_of1x_fm_result_t __of1x_modify_flow_entry_loop(of1x_flow_table_t *const tab
 
 	//According to spec
 	if(moded == 0)
-		return __of1x_add_flow_entry_loop(table, entry, false, reset_counts, false, ma_add_hook_ptr);
+		return __of1x_add_flow_entry_loop(table, entry, false, reset_counts, false, ma_add_hook_ptr, ma_remove_hook_ptr);
 
 	ROFL_PIPELINE_DEBUG("[flowmod-modify(%p)] Deleting modifying flowmod \n", entry);
 	
@@ -451,7 +468,7 @@ rofl_of1x_fm_result_t __of1x_modify_flow_entry_loop(of1x_flow_table_t *const tab
 }
 
 rofl_of1x_fm_result_t of1x_modify_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, const enum of1x_flow_removal_strictness strict, bool reset_counts){
-	return __of1x_modify_flow_entry_loop(table, entry, strict, reset_counts, NULL, NULL);
+	return __of1x_modify_flow_entry_loop(table, entry, strict, reset_counts, NULL, NULL, NULL);
 
 }
 
@@ -534,6 +551,125 @@ rofl_result_t of1x_get_flow_stats_loop(struct of1x_flow_table *const table,
 	return ROFL_SUCCESS;
 }
 
+/*
+* Checks whether the entry precedes (or is) the last entry visited by the
+* iterator, as per the table order: priority, number of matches and newest first
+*/
+static inline bool __of1x_loop_entry_visited(const struct of1x_flow_stats_iter* iter, const of1x_flow_entry_t* entry){
+	if(entry->priority != iter->__last_priority)
+		return entry->priority > iter->__last_priority;
+	if(entry->matches.num_elements != iter->__last_num_matches)
+		return entry->matches.num_elements > iter->__last_num_matches;
+	return entry->__seq >= iter->__last_seq;
+}
+
+//Resumes the iteration (table mutex held)
+static inline of1x_flow_entry_t* __of1x_loop_iter_resume(struct of1x_flow_table *const table, const struct of1x_flow_stats_iter* iter){
+
+	of1x_flow_entry_t* entry;
+
+	if(iter->__num_visited && iter->__revision == table->revision)
+		return (of1x_flow_entry_t*)iter->__pos[0];
+
+	//First page or table modified; skip the entries up to the last visited one
+	for(entry = table->entries; entry && iter->__num_visited && __of1x_loop_entry_visited(iter, entry); entry = entry->next);
+
+	return entry;
+}
+
+static inline void __of1x_loop_iter_visit(struct of1x_flow_stats_iter* iter, const of1x_flow_entry_t* entry){
+	iter->__num_visited++;
+	iter->__last_priority = entry->priority;
+	iter->__last_num_matches = entry->matches.num_elements;
+	iter->__last_seq = entry->__seq;
+}
+
+//Saves the position (table mutex held)
+static inline void __of1x_loop_iter_save(struct of1x_flow_table *const table, struct of1x_flow_stats_iter* iter, of1x_flow_entry_t* entry){
+	iter->__pos[0] = entry;
+	iter->__revision = table->revision;
+	iter->__table_done = (entry == NULL);
+}
+
+rofl_result_t of1x_get_flow_stats_page_loop(struct of1x_flow_table *const table,
+		struct of1x_flow_stats_iter* iter,
+		of1x_stats_single_flow_msg_t* page,
+		unsigned int page_size,
+		unsigned int* num_of_entries){
+
+	of1x_flow_entry_t* entry, flow_stats_entry;
+	rofl_result_t res = ROFL_SUCCESS;
+	bool check_cookie;
+
+	*num_of_entries = 0;
+
+	if( unlikely(iter==NULL) || unlikely(page==NULL) || unlikely(table==NULL) )
+		return ROFL_FAILURE;
+
+	//Create a flow_stats_entry
+	platform_memset(&flow_stats_entry,0,sizeof(of1x_flow_entry_t));
+	flow_stats_entry.matches = *iter->matches;
+	flow_stats_entry.cookie = iter->cookie;
+	flow_stats_entry.cookie_mask = iter->cookie_mask;
+	check_cookie = ( table->pipeline->sw->of_ver != OF_VERSION_10 ); //Ignore cookie in OF1.0
+
+	//Entries are only removed (freed) by writers, which hold the mutex
+	platform_mutex_lock(table->mutex);
+
+	for(entry = __of1x_loop_iter_resume(table, iter); entry!=NULL && *num_of_entries < page_size; entry = entry->next){
+
+		__of1x_loop_iter_visit(iter, entry);
+
+		//Check if is contained 
+		if(!__of1x_flow_entry_check_contained(&flow_stats_entry, entry, false, check_cookie, iter->out_port, iter->out_group, true))
+			continue;
+
+		// update statistics from platform
+		platform_of1x_update_stats_hook(entry);
+
+		if(__of1x_fill_stats_single_flow_msg(entry, &page[*num_of_entries]) != ROFL_SUCCESS){
+			res = ROFL_FAILURE;
+			break;
+		}
+		(*num_of_entries)++;
+	}
+
+	//Save the position
+	__of1x_loop_iter_save(table, iter, entry);
+
+	platform_mutex_unlock(table->mutex);
+
+	return res;
+}
+
+rofl_result_t of1x_walk_flow_entries_loop(struct of1x_flow_table *const table,
+		struct of1x_flow_stats_iter* iter,
+		unsigned int max_entries,
+		of1x_flow_entry_walk_fn_t fn,
+		void* arg){
+
+	unsigned int i;
+	of1x_flow_entry_t* entry;
+
+	if( unlikely(table==NULL) || unlikely(iter==NULL) || unlikely(fn==NULL) )
+		return ROFL_FAILURE;
+
+	//Entries are only removed (freed) by writers, which hold the mutex
+	platform_mutex_lock(table->mutex);
+
+	for(entry = __of1x_loop_iter_resume(table, iter), i=0; entry!=NULL && i < max_entries; entry = entry->next, i++){
+		__of1x_loop_iter_visit(iter, entry);
+		fn(entry, arg);
+	}
+
+	//Save the position
+	__of1x_loop_iter_save(table, iter, entry);
+
+	platform_mutex_unlock(table->mutex);
+
+	return ROFL_SUCCESS;
+}
+
 rofl_result_t of1x_get_flow_aggregate_stats_loop(struct of1x_flow_table *const table,
 		uint64_t cookie,
 		uint64_t cookie_mask,
@@ -643,6 +779,8 @@ OF1X_REGISTER_MATCHING_ALGORITHM(loop) = {
 
 	//Stats
 	.get_flow_stats_hook = of1x_get_flow_stats_loop,
+	.get_flow_stats_page_hook = of1x_get_flow_stats_page_loop,
+	.walk_flow_entries_hook = of1x_walk_flow_entries_loop,
 	.get_flow_aggregate_stats_hook = of1x_get_flow_aggregate_stats_loop,
 
 	//Find group related entries	
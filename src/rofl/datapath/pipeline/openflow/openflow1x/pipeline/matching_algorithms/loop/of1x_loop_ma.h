@@ -8,11 +8,11 @@
 //C++ extern C
 ROFL_BEGIN_DECLS
 
-rofl_of1x_fm_result_t __of1x_add_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, bool check_overlap, bool reset_counts, bool check_cookie, void (*ma_hook_ptr)(of1x_flow_entry_t*));
+rofl_of1x_fm_result_t __of1x_add_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, bool check_overlap, bool reset_counts, bool check_cookie, void (*ma_hook_ptr)(of1x_flow_entry_t*), void (*ma_remove_hook_ptr)(of1x_flow_entry_t*));
 
 rofl_of1x_fm_result_t of1x_add_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, bool check_overlap, bool reset_counts, bool check_cookie);
 
-rofl_of1x_fm_result_t __of1x_modify_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, const enum of1x_flow_removal_strictness strict, bool reset_counts, void (*ma_add_hook_ptr)(of1x_flow_entry_t*), void (*ma_modify_hook_ptr)(of1x_flow_entry_t*));
+rofl_of1x_fm_result_t __of1x_modify_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, const enum of1x_flow_removal_strictness strict, bool reset_counts, void (*ma_add_hook_ptr)(of1x_flow_entry_t*), void (*ma_modify_hook_ptr)(of1x_flow_entry_t*), void (*ma_remove_hook_ptr)(of1x_flow_entry_t*));
 
 rofl_of1x_fm_result_t of1x_modify_flow_entry_loop(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, const enum of1x_flow_removal_strictness strict, bool reset_counts);
 
@@ -29,6 +29,18 @@ rofl_result_t of1x_get_flow_stats_loop(struct of1x_flow_table *const table,
 		of1x_match_group_t *const matches,
 		of1x_stats_flow_msg_t* msg);
 
+rofl_result_t of1x_get_flow_stats_page_loop(struct of1x_flow_table *const table,
+		struct of1x_flow_stats_iter* iter,
+		of1x_stats_single_flow_msg_t* page,
+		unsigned int page_size,
+		unsigned int* num_of_entries);
+
+rofl_result_t of1x_walk_flow_entries_loop(struct of1x_flow_table *const table,
+		struct of1x_flow_stats_iter* iter,
+		unsigned int max_entries,
+		of1x_flow_entry_walk_fn_t fn,
+		void* arg);
+
 rofl_result_t of1x_get_flow_aggregate_stats_loop(struct of1x_flow_table *const table,
 		uint64_t cookie,
 		uint64_t cookie_mask,
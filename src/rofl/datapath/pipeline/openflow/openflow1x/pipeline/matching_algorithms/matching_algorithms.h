@@ -38,6 +38,11 @@ enum of1x_mutex_acquisition_required;
 
 #define OF1X_MATCHING_ALGORITHMS_MAX_DESCRIPTION_LENGTH 256
 
+/**
+* Flow entry callback (walk_flow_entries_hook)
+*/
+typedef void (*of1x_flow_entry_walk_fn_t)(of1x_flow_entry_t* entry, void* arg);
+
 /**
 * Registers a matching algorithm
 */
@@ -78,6 +83,20 @@ typedef struct of1x_matching_algorithm_functions{
 	rofl_result_t
 	(*destroy_hook)(struct of1x_flow_table *const table); //Mutual exclusion will already be taken by the of1x_flow_table destructor
 
+	/**
+	* @ingroup core_ma_of1x
+	* @brief Periodic maintenance of the matching algorithm table state (optional).
+	*
+	* Called from the context that processes the flow entry expirations
+	* (of_process_pipeline_tables_timeout_expirations(), usually a platform
+	* background thread), and never from the packet processing path. Algorithms
+	* may use it to (re)build expensive lookup structures offline.
+	*
+	* The hook MUST acquire the table mutex itself.
+	*/
+	rofl_result_t
+	(*maintenance_hook)(struct of1x_flow_table *const table);
+
 
 	// flow management
 	/**
@@ -197,8 +216,39 @@ typedef struct of1x_matching_algorithm_functions{
 			of1x_match_group_t *const matches,
 			of1x_stats_flow_msg_t* msg);
 
+	/**
+	* @ingroup core_ma_of1x 
+	* Fills (part of) a page of flow stats (flow stats iterator). The table MUST only be locked
+	* during the call. The MA shall resume from iter->__pos if the table revision is unchanged,
+	* and otherwise after the last visited entry (iter->__last_*), if the entries are traversed
+	* in table order, or skipping the first iter->__num_visited entries of the table. 
+	* iter->__table_done MUST be set when all the entries of the table have been visited.
+	* num_of_entries is set to the number of entries filled (also on failure).
+	*/
+	rofl_result_t
+	(*get_flow_stats_page_hook)(struct of1x_flow_table *const table,
+			struct of1x_flow_stats_iter* iter,
+			of1x_stats_single_flow_msg_t* page,
+			unsigned int page_size,
+			unsigned int* num_of_entries);
+
 
 
+	/**
+	* @ingroup core_ma_of1x 
+	* Calls fn for the next (up to) max_entries entries of the table, resuming from iter as
+	* get_flow_stats_page_hook does (the filter of iter is ignored). The hook MUST acquire the
+	* table mutex itself, only during the call, and fn is called with it held. 
+	* iter->__table_done MUST be set when all the entries of the table have been visited.
+	* Used by the background contexts (e.g. stats service, running aggregates).
+	*/
+	rofl_result_t
+	(*walk_flow_entries_hook)(struct of1x_flow_table *const table,
+			struct of1x_flow_stats_iter* iter,
+			unsigned int max_entries,
+			of1x_flow_entry_walk_fn_t fn,
+			void* arg);
+
 	/**
 	* @ingroup core_ma_of1x 
 	* Retrieves aggregate flow stats according to spec 
@@ -1,11 +1,13 @@
 #include "of1x_trie_ma.h"
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <assert.h>
 #include "../../of1x_pipeline.h"
 #include "../../of1x_flow_table.h"
 #include "../../of1x_flow_entry.h"
 #include "../../of1x_match.h"
+#include "../../of1x_packet_key.h"
 #include "../../of1x_group_table.h"
 #include "../../of1x_instruction.h"
 #include "../../../of1x_async_events_hooks.h"
@@ -17,6 +19,245 @@
 
 #define TRIE_DESCRIPTION "Trie algorithm performs the lookup using a patricia trie"
 
+//
+// Lookup node pool
+//
+
+typedef struct of1x_trie_field{
+	uint8_t layer;
+	uint8_t offset;
+	uint8_t width;
+	uint64_t flag;
+}of1x_trie_field_t;
+
+#define OF1X_TRIE_FIELD(layer, field, flag) { layer, offsetof(of1x_packet_key_t, field), sizeof(((of1x_packet_key_t*)0)->field), flag }
+
+//Matches checked against the packet key (the rest use __of1x_check_match())
+static const of1x_trie_field_t of1x_trie_fields[OF1X_MATCH_MAX] = {
+	[OF1X_MATCH_IN_PORT] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L2, port_in, OF1X_PKT_KEY_F_IN_PORT),
+	[OF1X_MATCH_IN_PHY_PORT] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L2, phy_port_in, OF1X_PKT_KEY_F_IN_PHY_PORT),
+	[OF1X_MATCH_ETH_DST] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L2, eth_dst, OF1X_PKT_KEY_F_ETH_DST),
+	[OF1X_MATCH_ETH_SRC] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L2, eth_src, OF1X_PKT_KEY_F_ETH_SRC),
+	[OF1X_MATCH_ETH_TYPE] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L2, eth_type, OF1X_PKT_KEY_F_ETH_TYPE),
+	[OF1X_MATCH_VLAN_PCP] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L2, vlan_pcp, OF1X_PKT_KEY_F_VLAN_PCP),
+	[OF1X_MATCH_MPLS_LABEL] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_MPLS, mpls_label, OF1X_PKT_KEY_F_MPLS_LABEL),
+	[OF1X_MATCH_MPLS_TC] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_MPLS, mpls_tc, OF1X_PKT_KEY_F_MPLS_TC),
+	[OF1X_MATCH_MPLS_BOS] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_MPLS, mpls_bos, OF1X_PKT_KEY_F_MPLS_BOS),
+	[OF1X_MATCH_ARP_OP] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_ARP, arp_opcode, OF1X_PKT_KEY_F_ARP_OP),
+	[OF1X_MATCH_ARP_SHA] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_ARP, arp_sha, OF1X_PKT_KEY_F_ARP_SHA),
+	[OF1X_MATCH_ARP_SPA] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_ARP, arp_spa, OF1X_PKT_KEY_F_ARP_SPA),
+	[OF1X_MATCH_ARP_THA] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_ARP, arp_tha, OF1X_PKT_KEY_F_ARP_THA),
+	[OF1X_MATCH_ARP_TPA] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_ARP, arp_tpa, OF1X_PKT_KEY_F_ARP_TPA),
+	[OF1X_MATCH_IP_PROTO] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L3, ip_proto, OF1X_PKT_KEY_F_IP_PROTO),
+	[OF1X_MATCH_IP_ECN] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L3, ip_ecn, OF1X_PKT_KEY_F_IP_ECN),
+	[OF1X_MATCH_IP_DSCP] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L3, ip_dscp, OF1X_PKT_KEY_F_IP_DSCP),
+	[OF1X_MATCH_IPV4_SRC] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L3, ipv4_src, OF1X_PKT_KEY_F_IPV4_SRC),
+	[OF1X_MATCH_IPV4_DST] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L3, ipv4_dst, OF1X_PKT_KEY_F_IPV4_DST),
+	[OF1X_MATCH_IPV6_FLABEL] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L3, ipv6_flabel, OF1X_PKT_KEY_F_IPV6_FLABEL),
+	[OF1X_MATCH_TCP_SRC] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, tp_src, OF1X_PKT_KEY_F_TCP_SRC),
+	[OF1X_MATCH_TCP_DST] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, tp_dst, OF1X_PKT_KEY_F_TCP_DST),
+	[OF1X_MATCH_UDP_SRC] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, tp_src, OF1X_PKT_KEY_F_UDP_SRC),
+	[OF1X_MATCH_UDP_DST] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, tp_dst, OF1X_PKT_KEY_F_UDP_DST),
+	[OF1X_MATCH_SCTP_SRC] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, tp_src, OF1X_PKT_KEY_F_SCTP_SRC),
+	[OF1X_MATCH_SCTP_DST] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, tp_dst, OF1X_PKT_KEY_F_SCTP_DST),
+	[OF1X_MATCH_ICMPV4_TYPE] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, icmpv4_type, OF1X_PKT_KEY_F_ICMPV4_TYPE),
+	[OF1X_MATCH_ICMPV4_CODE] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, icmpv4_code, OF1X_PKT_KEY_F_ICMPV4_CODE),
+	[OF1X_MATCH_IPV6_ND_SLL] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, ipv6_nd_sll, OF1X_PKT_KEY_F_IPV6_ND_SLL),
+	[OF1X_MATCH_IPV6_ND_TLL] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, ipv6_nd_tll, OF1X_PKT_KEY_F_IPV6_ND_TLL),
+	[OF1X_MATCH_ICMPV6_TYPE] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, icmpv6_type, OF1X_PKT_KEY_F_ICMPV6_TYPE),
+	[OF1X_MATCH_ICMPV6_CODE] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L4, icmpv6_code, OF1X_PKT_KEY_F_ICMPV6_CODE),
+	[OF1X_MATCH_PBB_ISID] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L2, pbb_isid, OF1X_PKT_KEY_F_PBB_ISID),
+	[OF1X_MATCH_TUNNEL_ID] = OF1X_TRIE_FIELD(OF1X_PKT_KEY_L2, tunnel_id, OF1X_PKT_KEY_F_TUNNEL_ID),
+};
+
+static void of1x_destroy_pool_trie(of1x_trie_pool_t* pool){
+	if(!pool)
+		return;
+	if(pool->mem)
+		platform_free_shared(pool->mem);
+	platform_free_shared(pool);
+}
+
+//Count the nodes, and how many of them need a full match check
+static void of1x_count_leafs_trie(of1x_trie_leaf_t* l, uint32_t* num_of_nodes, uint32_t* num_of_matches){
+	for(; l; l = l->next){
+		(*num_of_nodes)++;
+		if(of1x_trie_fields[l->match.type].width == 0)
+			(*num_of_matches)++;
+		of1x_count_leafs_trie(l->inner, num_of_nodes, num_of_matches);
+	}
+}
+
+//Fill-in the nodes (pre-order)
+static void of1x_compile_leafs_trie(of1x_trie_pool_t* pool, of1x_trie_leaf_t* l, uint32_t* n, uint32_t* m){
+
+	of1x_trie_node_t* node;
+	const of1x_trie_field_t* field;
+	const utern_t* tern;
+
+	for(; l; l = l->next){
+		l->node = *n;
+		node = &pool->nodes[(*n)++];
+		field = &of1x_trie_fields[l->match.type];
+		tern = &l->match.__tern;
+
+		node->entry = l->entry;
+		node->prio = (l->entry)? l->entry->priority : 0;
+		node->imp = l->imp;
+		node->layer = field->layer;
+		node->offset = field->offset;
+		node->width = field->width;
+		node->bit = (field->flag)? __builtin_ctzll(field->flag) : 0;
+
+		switch(field->width){
+			case 1: node->value = tern->value.u8;
+				node->mask = tern->mask.u8;
+				break;
+			case 2: node->value = tern->value.u16;
+				node->mask = tern->mask.u16;
+				break;
+			case 4: node->value = tern->value.u32;
+				node->mask = tern->mask.u32;
+				break;
+			case 8: node->value = tern->value.u64;
+				node->mask = tern->mask.u64;
+				break;
+			default:
+				//Copy the match
+				pool->matches[*m] = l->match;
+				node->value = (*m)++;
+				node->mask = 0x0ULL;
+				break;
+		}
+
+		of1x_compile_leafs_trie(pool, l->inner, n, m);
+
+		//Skip the inner leafs
+		node->skip = *n;
+	}
+}
+
+static rofl_result_t of1x_compile_pool_trie(of1x_trie_t* trie, of1x_trie_pool_t** pool_ptr){
+
+	uint32_t num_of_nodes=0, num_of_matches=0, n=0, m=0;
+	size_t nodes_size;
+	of1x_trie_pool_t* pool;
+
+	*pool_ptr = NULL;
+
+	of1x_count_leafs_trie(trie->root, &num_of_nodes, &num_of_matches);
+	if(!num_of_nodes && !trie->entry)
+		return ROFL_SUCCESS;
+
+	pool = (of1x_trie_pool_t*)platform_malloc_shared(sizeof(of1x_trie_pool_t));
+	if(unlikely(pool == NULL))
+		return ROFL_FAILURE;
+
+	nodes_size = sizeof(of1x_trie_node_t)*num_of_nodes;
+	nodes_size = (nodes_size + OF1X_TRIE_CACHE_LINE_SIZE - 1) & ~((size_t)OF1X_TRIE_CACHE_LINE_SIZE - 1);
+	pool->mem = platform_malloc_shared(nodes_size + sizeof(of1x_match_t)*num_of_matches + OF1X_TRIE_CACHE_LINE_SIZE);
+	if(unlikely(pool->mem == NULL)){
+		platform_free_shared(pool);
+		return ROFL_FAILURE;
+	}
+
+	pool->entry = trie->entry;
+	pool->num_of_nodes = num_of_nodes;
+	pool->nodes = (of1x_trie_node_t*)(((uintptr_t)pool->mem + OF1X_TRIE_CACHE_LINE_SIZE - 1) & ~((uintptr_t)OF1X_TRIE_CACHE_LINE_SIZE - 1));
+	pool->matches = (of1x_match_t*)((uint8_t*)pool->nodes + nodes_size);
+
+	of1x_compile_leafs_trie(pool, trie->root, &n, &m);
+	assert(n == num_of_nodes && m == num_of_matches);
+
+	*pool_ptr = pool;
+	return ROFL_SUCCESS;
+}
+
+//Waits until no lookup can be using a previously published pool
+static void of1x_sync_readers_trie(of1x_flow_table_t *const table){
+#ifdef ROFL_PIPELINE_LOCKLESS
+	tid_wait_all_not_present(&table->tid_presence_mask);
+#else
+	//Lookups hold the rdlock while the pool is in use
+	platform_rwlock_wrlock(table->rwlock);
+	platform_rwlock_wrunlock(table->rwlock);
+#endif
+}
+
+/*
+* Recompiles and publishes the pool (pointer swap), and then reclaims the
+* previous one. Only the table mutex must be held; lookups are never blocked
+* while searching, allocating or compiling.
+*
+* On failure the previous pool is kept published, untouched.
+*/
+static rofl_result_t of1x_update_pool_trie(of1x_flow_table_t *const table, of1x_trie_t* trie){
+
+	of1x_trie_pool_t *pool, *old;
+
+	if(unlikely(of1x_compile_pool_trie(trie, &pool) != ROFL_SUCCESS)){
+		ROFL_PIPELINE_ERR("[trie] Unable to compile the node pool of table %u (%p)\n", table->number, table);
+		return ROFL_FAILURE;
+	}
+
+	old = trie->pool;
+
+	//Make sure the pool is visible before the pointer
+	tid_memory_barrier();
+	trie->pool = pool;
+
+	of1x_sync_readers_trie(table);
+	of1x_destroy_pool_trie(old);
+
+	//All the entries are now in the pool
+	trie->num_of_side_entries = 0;
+	trie->dirty = false;
+
+	return ROFL_SUCCESS;
+}
+
+//Appends a just added entry to the side array (there must be room)
+static void of1x_add_side_entry_trie(of1x_trie_t* trie, of1x_flow_entry_t* entry){
+
+	assert(trie->num_of_side_entries < OF1X_TRIE_MAX_SIDE_ENTRIES);
+
+	trie->side[trie->num_of_side_entries] = entry;
+
+	//Make sure the slot is visible before the counter
+	tid_memory_barrier();
+	trie->num_of_side_entries++;
+	trie->dirty = true;
+}
+
+/*
+* Replaces the references of the lookup structures to an entry that has just
+* been unlinked from leaf l (NULL for entries with no matches). Readers must
+* be synchronized before the entry is destroyed.
+*/
+static void of1x_unlink_entry_trie(of1x_trie_t* trie, of1x_trie_leaf_t* l,
+						of1x_flow_entry_t* entry,
+						of1x_flow_entry_t* replacement){
+	unsigned int i;
+	of1x_trie_pool_t* pool = trie->pool;
+
+	for(i=0; i < trie->num_of_side_entries; i++){
+		if(trie->side[i] == entry)
+			trie->side[i] = replacement;
+	}
+
+	//Point to the (new) head; higher priority entries are in the side array
+	if(pool){
+		if(!l){
+			if(pool->entry == entry)
+				pool->entry = trie->entry;
+		}else if(l->node != OF1X_TRIE_NO_NODE && pool->nodes[l->node].entry == entry){
+			pool->nodes[l->node].entry = l->entry;
+		}
+	}
+
+	trie->dirty = true;
+}
+
 //
 // Constructors and destructors
 //
@@ -29,6 +270,9 @@ rofl_result_t of1x_init_trie(struct of1x_flow_table *const table){
 	//Set values
 	trie->entry = NULL;
 	trie->root = NULL;
+	trie->pool = NULL;
+	trie->num_of_side_entries = 0;
+	trie->dirty = false;
 
 	return ROFL_SUCCESS;
 }
@@ -64,8 +308,9 @@ rofl_result_t of1x_destroy_trie(struct of1x_flow_table *const table){
 	of1x_flow_entry_t *entry, *tmp;
 	of1x_trie_t* trie = (of1x_trie_t*)table->matching_aux[0];
 
-	//Free all the leafs
+	//Free all the leafs and the node pool
 	of1x_destroy_leaf(trie->root);
+	of1x_destroy_pool_trie(trie->pool);
 
 	//Destroy entry/ies
 	entry = trie->entry;
@@ -341,6 +586,7 @@ static of1x_trie_leaf_t*  __of1x_create_new_branch_trie(int m_it, of1x_flow_entr
 
 		//Init
 		memset(tmp, 0, sizeof(of1x_trie_leaf_t));
+		tmp->node = OF1X_TRIE_NO_NODE;
 
 		//Copy match (cannot fail)
 		if(!__of1x_get_alike_match(m, m, &tmp->match)){
@@ -432,6 +678,7 @@ static rofl_of1x_fm_result_t __of1x_insert_intermediate_leaf_trie(of1x_trie_t* t
 		return ROFL_OF1X_FM_FAILURE;
 	}
 	memset(intermediate, 0, sizeof(of1x_trie_leaf_t));
+	intermediate->node = OF1X_TRIE_NO_NODE;
 
 	//Get the common part
 	if(!__of1x_get_alike_match(&l->match, m, &intermediate->match)){
@@ -716,12 +963,7 @@ bool __of1x_prune_leafs_trie(of1x_flow_table_t *const table, of1x_trie_t* trie,
 		aux = aux->parent;
 	}
 
-	//Make sure we don't have any thread processing packets
-#ifdef ROFL_PIPELINE_LOCKLESS
-	tid_wait_all_not_present(&table->tid_presence_mask);
-#endif
-
-	//Isolate
+	//Isolate (lookups only access the pool)
 	to_prune->next = to_prune->prev = NULL;
 
 	//Destroy the entire branch
@@ -745,12 +987,10 @@ rofl_of1x_fm_result_t of1x_add_flow_entry_trie(of1x_flow_table_t *const table,
 	struct of1x_trie_leaf *prev, *next;
 	of1x_flow_entry_t *curr_entry, *to_be_removed=NULL, **ll_head;
 
-	//Allow single add/remove operation over the table
+	//Allow single add/remove operation over the table. Lookups only
+	//access the published pool, so they are not excluded
 	platform_mutex_lock(table->mutex);
 
-	//Do not allow stats during insertion
-	platform_rwlock_wrlock(table->rwlock);
-
 	/*
 	* Check overlap
 	*/
@@ -840,8 +1080,19 @@ rofl_of1x_fm_result_t of1x_add_flow_entry_trie(of1x_flow_table_t *const table,
 			//Remove the previous
 			__of1x_remove_ll_prio_trie(ll_head, curr_entry);
 
+			//Publish the new entry (same priority, so no recompilation needed)
+			of1x_unlink_entry_trie(trie, prev, curr_entry, entry);
+
 			//Mark the entry to be removed
 			to_be_removed = curr_entry;
+			table->revision++;
+
+			//Secondary indexes and running aggregates
+			entry->table = table;
+			__of1x_flow_index_add(table, entry);
+			__of1x_stats_flow_aggregates_add_entry(table, entry);
+			__of1x_flow_index_remove(table, curr_entry);
+			__of1x_stats_flow_aggregates_remove_entry(table, curr_entry);
 
 			//Update stats
 			if(!reset_counts){
@@ -862,33 +1113,47 @@ rofl_of1x_fm_result_t of1x_add_flow_entry_trie(of1x_flow_table_t *const table,
 			//Call the platform hook
 			platform_of1x_modify_entry_hook(curr_entry, entry, reset_counts);
 
+			//Wait for the lookups that might still be using the previous one
+			of1x_sync_readers_trie(table);
+
 			goto ADD_END;
 		}
 		curr_entry = curr_entry->next;
 	}while(1);
 
 	//If we got in here, we have to add the entry (no existing entries)
+
+	//Make room in the side array (nothing has been modified yet if this fails)
+	if(trie->num_of_side_entries == OF1X_TRIE_MAX_SIDE_ENTRIES &&
+			of1x_update_pool_trie(table, trie) != ROFL_SUCCESS){
+		res = ROFL_OF1X_FM_FAILURE;
+		goto ADD_END;
+	}
+
 	res = __of1x_add_leafs_trie(trie, entry);
 
 	if(res == ROFL_OF1X_FM_SUCCESS){
+		//Publish
+		of1x_add_side_entry_trie(trie, entry);
+
 		//Call the platform
 		plaftorm_of1x_add_entry_hook(entry);
 		table->num_of_entries++;
+		table->revision++;
+		entry->__seq = table->revision;
+		__of1x_flow_index_add(table, entry);
+		__of1x_stats_flow_aggregates_add_entry(table, entry);
 	}
 
 	//Set table pointer
 	entry->table = table;
 
 ADD_END:
-	platform_rwlock_wrunlock(table->rwlock);
 	platform_mutex_unlock(table->mutex);
 
-	if(to_be_removed){
-#ifdef ROFL_PIPELINE_LOCKLESS
-		tid_wait_all_not_present(&table->tid_presence_mask);
-#endif
+	//Lookups are no longer using it
+	if(to_be_removed)
 		of1x_destroy_flow_entry(to_be_removed);
-	}
 
 	return res;
 }
@@ -905,12 +1170,10 @@ rofl_of1x_fm_result_t of1x_modify_flow_entry_trie(of1x_flow_table_t *const table
 	bool check_cookie = ( table->pipeline->sw->of_ver != OF_VERSION_10 ); //Ignore cookie in OF1.0
 	unsigned int moded=0;
 
-	//Allow single add/remove operation over the table
+	//Allow single add/remove operation over the table (entries are
+	//updated under their own lock; the trie structure does not change)
 	platform_mutex_lock(table->mutex);
 
-	//Do not allow stats during insertion
-	platform_rwlock_wrlock(table->rwlock);
-
 	//Point to the root of the tree
 	prev = NULL;
 	next = trie->root;
@@ -967,7 +1230,6 @@ MODIFY_NEXT:
 	}while(1);
 
 MODIFY_END:
-	platform_rwlock_wrunlock(table->rwlock);
 	platform_mutex_unlock(table->mutex);
 
 #ifdef ROFL_PIPELINE_LOCKLESS
@@ -994,6 +1256,7 @@ rofl_of1x_fm_result_t of1x_remove_flow_entry_trie(of1x_flow_table_t *const table
 
 	struct of1x_trie_leaf *prev, *next;
 	of1x_flow_entry_t *it, *aux, *tmp_next;
+	of1x_flow_entry_t *removed=NULL, *removed_tail=NULL;
 	of1x_trie_t* trie = (of1x_trie_t*)table->matching_aux[0];
 
 	rofl_of1x_fm_result_t res = ROFL_OF1X_FM_SUCCESS;
@@ -1008,9 +1271,6 @@ rofl_of1x_fm_result_t of1x_remove_flow_entry_trie(of1x_flow_table_t *const table
 	if(!mutex_acquired)
 		platform_mutex_lock(table->mutex);
 
-	//Do not allow stats during insertion
-	platform_rwlock_wrlock(table->rwlock);
-
 	//Point to the root of the tree
 	prev = NULL;
 	next = trie->root;
@@ -1075,17 +1335,15 @@ rofl_of1x_fm_result_t of1x_remove_flow_entry_trie(of1x_flow_table_t *const table
 			__of1x_remove_ll_prio_trie(&prev->entry, it);
 		else
 			__of1x_remove_ll_prio_trie(&trie->entry, it);
+		of1x_unlink_entry_trie(trie, prev, it, NULL);
 
-		//Wait for all cores to be aware
-#ifdef ROFL_PIPELINE_LOCKLESS
-		tid_wait_all_not_present(&table->tid_presence_mask);
-#endif
-		r = __of1x_destroy_flow_entry_with_reason(it, reason);
-
-		if(r != ROFL_SUCCESS){
-			res = ROFL_OF1X_FM_FAILURE;
-			goto REMOVE_END;
-		}
+		//Defer destruction until the lookups are no longer using it
+		it->next = NULL;
+		if(removed_tail)
+			removed_tail->next = it;
+		else
+			removed = it;
+		removed_tail = it;
 
 		//Prune (collapse) trie
 		if(__of1x_prune_leafs_trie(table, trie, prev)){
@@ -1096,6 +1354,9 @@ rofl_of1x_fm_result_t of1x_remove_flow_entry_trie(of1x_flow_table_t *const table
 		}
 
 		table->num_of_entries--;
+		table->revision++;
+		__of1x_flow_index_remove(table, it);
+		__of1x_stats_flow_aggregates_remove_entry(table, it);
 
 		it = tmp_next;
 		continue;
@@ -1106,7 +1367,24 @@ REMOVE_NEXT:
 
 
 REMOVE_END:
-	platform_rwlock_wrunlock(table->rwlock);
+	if(removed){
+		//Release the pool of an empty table (cannot fail), otherwise
+		//wait for the lookups that might still be using the entries
+		if(!trie->root && !trie->entry)
+			of1x_update_pool_trie(table, trie);
+		else
+			of1x_sync_readers_trie(table);
+
+		while(removed){
+			it = removed;
+			removed = removed->next;
+			r = __of1x_destroy_flow_entry_with_reason(it, reason);
+
+			if(r != ROFL_SUCCESS)
+				res = ROFL_OF1X_FM_FAILURE;
+		}
+	}
+
 	if(!mutex_acquired)
 		platform_mutex_unlock(table->mutex);
 
@@ -1138,8 +1416,8 @@ rofl_result_t of1x_get_flow_stats_trie(struct of1x_flow_table *const table,
 	flow_stats_entry.cookie_mask = cookie_mask;
 	check_cookie = ( table->pipeline->sw->of_ver != OF_VERSION_10 ); //Ignore cookie in OF1.0
 
-	//Mark table as being read
-	platform_rwlock_rdlock(table->rwlock);
+	//Leafs are only modified by writers, which hold the mutex
+	platform_mutex_lock(table->mutex);
 
 	//Point to the root of the tree
 	prev = NULL;
@@ -1188,11 +1466,178 @@ STATS_NEXT:
 FLOW_STATS_END:
 
 	//Release the table
-	platform_rwlock_rdunlock(table->rwlock);
+	platform_mutex_unlock(table->mutex);
 
 	return res;
 }
 
+//Resumes the iteration (table mutex held); returns the number of entries to skip
+static inline uint64_t __of1x_trie_iter_resume(struct of1x_flow_table *const table, const struct of1x_flow_stats_iter* iter, of1x_flow_entry_t** it, struct of1x_trie_leaf** prev, struct of1x_trie_leaf** next){
+
+	of1x_trie_t* trie = (of1x_trie_t*)table->matching_aux[0];
+
+	if(iter->__num_visited && iter->__revision == table->revision){
+		*it = (of1x_flow_entry_t*)iter->__pos[0];
+		*prev = (struct of1x_trie_leaf*)iter->__pos[1];
+		*next = (struct of1x_trie_leaf*)iter->__pos[2];
+		return 0;
+	}
+
+	//First page or table modified; skip the entries already visited
+	*prev = NULL;
+	*next = trie->root;
+	*it = trie->entry;
+	return iter->__num_visited;
+}
+
+//Saves the position (table mutex held)
+static inline void __of1x_trie_iter_save(struct of1x_flow_table *const table, struct of1x_flow_stats_iter* iter, of1x_flow_entry_t* it, struct of1x_trie_leaf* prev, struct of1x_trie_leaf* next){
+	iter->__pos[0] = it;
+	iter->__pos[1] = prev;
+	iter->__pos[2] = next;
+	iter->__revision = table->revision;
+	iter->__table_done = (it == NULL);
+}
+
+rofl_result_t of1x_get_flow_stats_page_trie(struct of1x_flow_table *const table,
+		struct of1x_flow_stats_iter* iter,
+		of1x_stats_single_flow_msg_t* page,
+		unsigned int page_size,
+		unsigned int* num_of_entries){
+
+	struct of1x_trie_leaf *prev, *next;
+	bool check_cookie;
+	of1x_flow_entry_t flow_stats_entry, *it;
+	uint64_t skip;
+	rofl_result_t res = ROFL_SUCCESS;
+
+	*num_of_entries = 0;
+
+	if( unlikely(iter==NULL) || unlikely(page==NULL) || unlikely(table==NULL) )
+		return ROFL_FAILURE;
+
+	//Flow stats entry for easy comparison
+	platform_memset(&flow_stats_entry, 0, sizeof(of1x_flow_entry_t));
+	flow_stats_entry.matches = *iter->matches;
+	flow_stats_entry.cookie = iter->cookie;
+	flow_stats_entry.cookie_mask = iter->cookie_mask;
+	check_cookie = ( table->pipeline->sw->of_ver != OF_VERSION_10 ); //Ignore cookie in OF1.0
+
+	//Leafs are only modified by writers, which hold the mutex
+	platform_mutex_lock(table->mutex);
+
+	skip = __of1x_trie_iter_resume(table, iter, &it, &prev, &next);
+
+	do{
+		//Get next matching entry
+		if(!it)
+			it = of1x_find_reen_trie(&flow_stats_entry.matches, &prev, &next,
+										false,
+										false,
+										true);
+		//If no more entries are found, we are done
+		if(!it)
+			break;
+
+		if(skip){
+			skip--;
+			goto STATS_PAGE_NEXT;
+		}
+
+		//Page is full
+		if(*num_of_entries == page_size)
+			break;
+
+		iter->__num_visited++;
+
+		//Check if it is really contained and out port/group
+		if(__of1x_flow_entry_check_contained(&flow_stats_entry, it, false,
+									check_cookie,
+									iter->out_port,
+									iter->out_group,
+									true) == false)
+			goto STATS_PAGE_NEXT;
+
+		//Update statistics from platform
+		platform_of1x_update_stats_hook(it);
+
+		if(__of1x_fill_stats_single_flow_msg(it, &page[*num_of_entries]) != ROFL_SUCCESS){
+			res = ROFL_FAILURE;
+			break;
+		}
+		(*num_of_entries)++;
+
+STATS_PAGE_NEXT:
+		it = it->next;
+	}while(1);
+
+	//Save the position
+	__of1x_trie_iter_save(table, iter, it, prev, next);
+
+	//Release the table
+	platform_mutex_unlock(table->mutex);
+
+	return res;
+}
+
+rofl_result_t of1x_walk_flow_entries_trie(struct of1x_flow_table *const table,
+		struct of1x_flow_stats_iter* iter,
+		unsigned int max_entries,
+		of1x_flow_entry_walk_fn_t fn,
+		void* arg){
+
+	struct of1x_trie_leaf *prev, *next;
+	of1x_match_group_t matches;
+	of1x_flow_entry_t *it;
+	uint64_t skip;
+	unsigned int i = 0;
+
+	if( unlikely(table==NULL) || unlikely(iter==NULL) || unlikely(fn==NULL) )
+		return ROFL_FAILURE;
+
+	//Empty matches group (all)
+	__of1x_init_match_group(&matches);
+
+	//Leafs are only modified by writers, which hold the mutex
+	platform_mutex_lock(table->mutex);
+
+	skip = __of1x_trie_iter_resume(table, iter, &it, &prev, &next);
+
+	do{
+		//Get next entry (all)
+		if(!it)
+			it = of1x_find_reen_trie(&matches, &prev, &next,
+										true,
+										false,
+										false);
+		//If no more entries are found, we are done
+		if(!it)
+			break;
+
+		if(skip){
+			skip--;
+		}else{
+			//Batch is done
+			if(i == max_entries)
+				break;
+
+			iter->__num_visited++;
+			i++;
+			fn(it, arg);
+		}
+
+		it = it->next;
+	}while(1);
+
+	//Save the position
+	__of1x_trie_iter_save(table, iter, it, prev, next);
+
+	//Release the table
+	platform_mutex_unlock(table->mutex);
+
+	return ROFL_SUCCESS;
+}
+
 rofl_result_t of1x_get_flow_aggregate_stats_trie(struct of1x_flow_table *const table,
 		uint64_t cookie,
 		uint64_t cookie_mask,
@@ -1216,8 +1661,8 @@ rofl_result_t of1x_get_flow_aggregate_stats_trie(struct of1x_flow_table *const t
 	flow_stats_entry.cookie_mask = cookie_mask;
 	check_cookie = ( table->pipeline->sw->of_ver != OF_VERSION_10 ); //Ignore cookie in OF1.0
 
-	//Mark table as being read
-	platform_rwlock_rdlock(table->rwlock);
+	//Leafs are only modified by writers, which hold the mutex
+	platform_mutex_lock(table->mutex);
 
 	//Point to the root of the tree
 	prev = NULL;
@@ -1262,7 +1707,7 @@ AGGREGATE_STATS_NEXT:
 	}while(1);
 
 	//Release the table
-	platform_rwlock_rdunlock(table->rwlock);
+	platform_mutex_unlock(table->mutex);
 
 	return ROFL_SUCCESS;
 }
@@ -1278,8 +1723,8 @@ of1x_flow_entry_t* of1x_find_entry_using_group_trie(of1x_flow_table_t *const tab
 	of1x_match_group_t matches;
 	__of1x_init_match_group(&matches);
 
-	//Prevent writers to change structure during matching
-	platform_rwlock_rdlock(table->rwlock);
+	//Prevent writers to change structure during the search
+	platform_mutex_lock(table->mutex);
 
 	//Point to the root of the tree
 	prev = NULL;
@@ -1310,7 +1755,7 @@ of1x_flow_entry_t* of1x_find_entry_using_group_trie(of1x_flow_table_t *const tab
 	}while(1);
 
 FIND_GROUP_END:
-	platform_rwlock_rdunlock(table->rwlock);
+	platform_mutex_unlock(table->mutex);
 
 	return found;
 }
@@ -1405,12 +1850,29 @@ void of1x_dump_trie(struct of1x_flow_table *const table, bool raw_nbo){
 }
 
 
+rofl_result_t of1x_rebuild_trie(struct of1x_flow_table *const table){
+
+	rofl_result_t res = ROFL_SUCCESS;
+	of1x_trie_t* trie = (of1x_trie_t*)table->matching_aux[0];
+
+	//Serialize with flowmods
+	platform_mutex_lock(table->mutex);
+	if(trie->dirty)
+		res = of1x_update_pool_trie(table, trie);
+	platform_mutex_unlock(table->mutex);
+
+	return res;
+}
+
 //Define the matching algorithm struct
 OF1X_REGISTER_MATCHING_ALGORITHM(trie) = {
 	//Init and destroy hooks
 	.init_hook = of1x_init_trie,
 	.destroy_hook = of1x_destroy_trie,
 
+	//Maintenance (pool recompilation)
+	.maintenance_hook = of1x_rebuild_trie,
+
 	//Flow mods
 	.add_flow_entry_hook = of1x_add_flow_entry_trie,
 	.modify_flow_entry_hook = of1x_modify_flow_entry_trie,
@@ -1418,6 +1880,8 @@ OF1X_REGISTER_MATCHING_ALGORITHM(trie) = {
 
 	//Stats
 	.get_flow_stats_hook = of1x_get_flow_stats_trie,
+	.get_flow_stats_page_hook = of1x_get_flow_stats_page_trie,
+	.walk_flow_entries_hook = of1x_walk_flow_entries_trie,
 	.get_flow_aggregate_stats_hook = of1x_get_flow_aggregate_stats_trie,
 
 	//Find group related entries
@@ -4,6 +4,7 @@
 #include "rofl_datapath.h"
 #include "../matching_algorithms.h"
 #include "../../of1x_flow_table.h"
+#include "../../of1x_packet_key.h"
 
 
 //Data structures
@@ -28,20 +29,98 @@ typedef struct of1x_trie_leaf{
 
 	//Parent
 	struct of1x_trie_leaf* parent;
+
+	//Node in the published pool, or OF1X_TRIE_NO_NODE if added afterwards
+	uint32_t node;
 }of1x_trie_leaf_t;
 
+#define OF1X_TRIE_CACHE_LINE_SIZE 64
+
+//Node index of leafs not (yet) compiled
+#define OF1X_TRIE_NO_NODE 0xFFFFFFFF
+
+//Max number of entries added between pool compilations
+#define OF1X_TRIE_MAX_SIDE_ENTRIES 32
+
+/**
+* Compact lookup node. Nodes are laid out in a contiguous array in pre-order
+* (inner leafs follow their parent), so only the index of the node to
+* continue with on mismatch (skip) needs to be stored.
+*/
+typedef struct of1x_trie_node{
+	//Pre-masked value and mask. If width is 0, value is the index of the match in the pool matches array
+	uint64_t value;
+	uint64_t mask;
+
+	//Flow entry/ies (ordered by priority) and priority of the first one
+	of1x_flow_entry_t* entry;
+	uint32_t prio;
+
+	//Inner max priority
+	uint32_t imp;
+
+	//Next sibling, or next sibling of the closest ancestor having one
+	uint32_t skip;
+
+	//Packet key field (layer, offset, width in bytes and presence bit)
+	uint8_t layer;
+	uint8_t offset;
+	uint8_t width;
+	uint8_t bit;
+}of1x_trie_node_t;
+
+/**
+* Compiled trie. The packet path only reads the pool; the leafs are private
+* to the writers (table mutex).
+*
+* The pool is not recompiled on every flowmod. Entries added afterwards are
+* kept in a small side array, looked up linearly, and the references to
+* removed entries are patched in place (node entry only). The pool is
+* recompiled when the side array is full, and during the periodic
+* maintenance of the table (see of1x_rebuild_trie()).
+*/
+typedef struct of1x_trie_pool{
+	//Entries with no matches (ordered by priority)
+	of1x_flow_entry_t* entry;
+
+	uint32_t num_of_nodes;
+
+	//Nodes (cache aligned)
+	of1x_trie_node_t* nodes;
+
+	//Matches that are not checked against the packet key
+	of1x_match_t* matches;
+
+	//Raw memory
+	void* mem;
+}of1x_trie_pool_t;
+
 typedef struct of1x_trie{
 	//Root leaf
 	of1x_trie_leaf_t* root;
 
 	//Entries with no matches (ordered by priority)
 	of1x_flow_entry_t* entry;
+
+	//Published lookup node pool; NULL if the table is empty
+	of1x_trie_pool_t* pool;
+
+	//Entries added since the last compilation (removed ones are set to NULL)
+	of1x_flow_entry_t* side[OF1X_TRIE_MAX_SIDE_ENTRIES];
+	unsigned int num_of_side_entries;
+
+	//Leafs modified since the last compilation
+	bool dirty;
 }of1x_trie_t;
 
 //C++ extern C
 ROFL_BEGIN_DECLS
 
-//Nothing needed here
+/**
+* Recompiles the node pool of the table, if it has been modified since the
+* last compilation. This is the maintenance hook of the algorithm.
+*/
+rofl_result_t of1x_rebuild_trie(struct of1x_flow_table *const table);
 
 //C++ extern C
 ROFL_END_DECLS
@@ -6,6 +6,7 @@
 #include "../../of1x_flow_table.h"
 #include "../../of1x_flow_entry.h"
 #include "../../of1x_match_pp.h"
+#include "../../of1x_packet_key_pp.h"
 #include "../../of1x_group_table.h"
 #include "../../of1x_instruction_pp.h"
 #include "../../../of1x_async_events_hooks.h"
@@ -17,72 +18,96 @@
 //C++ extern C
 ROFL_BEGIN_DECLS
 
-//#define USE_NON_RECURSIVE
-
-#ifndef USE_NON_RECURSIVE
+//Check node against the packet
+static inline bool __of1x_check_node_trie(datapacket_t *const pkt,
+					const of1x_trie_pool_t* pool,
+					const of1x_trie_node_t* node){
+	of1x_packet_key_t* key;
+	const uint8_t* field;
+	uint64_t value;
+
+	//Not part of the packet key
+	if(node->width == 0)
+		return __of1x_check_match(pkt, &pool->matches[node->value]);
+
+	key = __of1x_get_packet_key(pkt, node->layer);
+	if(!(key->present & (0x1ULL << node->bit)))
+		return false;
+
+	field = (const uint8_t*)key + node->offset;
+	switch(node->width){
+		case 1: value = *field;
+			break;
+		case 2: value = *(const uint16_t*)field;
+			break;
+		case 4: value = *(const uint32_t*)field;
+			break;
+		default: value = *(const uint64_t*)field;
+			break;
+	}
+	return (value & node->mask) == node->value;
+}
 
-// NOTE: this can never be inlined. Just putting it here
-static inline void of1x_check_leaf_trie(datapacket_t *const pkt,
-					struct of1x_trie_leaf* leaf,
+//Iterative lookup over the node pool
+static inline void of1x_check_pool_trie(datapacket_t *const pkt,
+					const of1x_trie_pool_t* pool,
 					of1x_flow_entry_t** best_match){
-	if(unlikely(leaf == NULL))
-		return;
-
-	//Check inner
-	if(!(*best_match) || (leaf->imp > (*best_match)->priority)){
-		//Check match
-		if(__of1x_check_match(pkt, &leaf->match)){
-			if(leaf->entry)
-				*best_match = leaf->entry;
-			if(leaf->inner)
-				of1x_check_leaf_trie(pkt,
-							leaf->inner,
-							best_match);
-		}
-	}
+	uint32_t i, prio;
+	const of1x_trie_node_t* node;
+	of1x_flow_entry_t* entry;
 
-	if(leaf->next)
-		of1x_check_leaf_trie(pkt, leaf->next,
-							best_match);
-}
+	prio = (*best_match)? (*best_match)->priority : 0;
 
-#else
+	for(i=0; i < pool->num_of_nodes;){
+		node = &pool->nodes[i];
 
-static inline void of1x_check_leaf_trie(datapacket_t *const pkt,
-					struct of1x_trie_leaf* leaf,
-					of1x_flow_entry_t** best_match){
-	if(unlikely(leaf == NULL))
-		return;
-
-CHECK_LEAF:
-	//Check inner
-	if(!(*best_match) || (leaf->imp > (*best_match)->priority)){
-		//Check match
-		if(__of1x_check_match(pkt, &leaf->match)){
-			if(leaf->entry)
-				*best_match = leaf->entry;
-			if(leaf->inner){
-				leaf = leaf->inner;
-				goto CHECK_LEAF;
+		//Next node on mismatch (inner leafs are contiguous)
+		__builtin_prefetch(&pool->nodes[node->skip]);
+
+		if( (!(*best_match) || (node->imp > prio)) &&
+				__of1x_check_node_trie(pkt, pool, node)){
+			//Entry references are patched by the writers; prio is the compiled one
+			entry = node->entry;
+			if(entry && (!(*best_match) || (node->prio > prio && entry->priority > prio))){
+				*best_match = entry;
+				prio = entry->priority;
 			}
+			//Go inner (or next, if none)
+			i++;
+		}else{
+			i = node->skip;
 		}
 	}
+}
 
-	if(leaf->next){
-		leaf = leaf->next;
-		goto CHECK_LEAF;
-	}else{
-		do{
-			leaf = leaf->parent;
-			if(leaf && leaf->next){
-				leaf = leaf->next;
-				goto CHECK_LEAF;
-			}
-		}while(leaf);
+//Check an entry against the packet
+static inline bool __of1x_check_entry_trie(datapacket_t *const pkt, const of1x_flow_entry_t* entry){
+	of1x_match_t* it;
+
+	for(it = entry->matches.head; it; it = it->next){
+		if(!__of1x_check_match(pkt, it))
+			return false;
 	}
+	return true;
 }
 
-#endif //!USE_NON_RECURSIVE
+//Linear lookup over the entries added since the last compilation
+static inline void of1x_check_side_trie(datapacket_t *const pkt,
+					of1x_trie_t* trie,
+					of1x_flow_entry_t** best_match){
+	unsigned int i, num_of_side_entries;
+	of1x_flow_entry_t* entry;
+
+	//Slots are written before the counter is incremented
+	num_of_side_entries = trie->num_of_side_entries;
+
+	for(i=0; i < num_of_side_entries; i++){
+		entry = trie->side[i];
+		if(entry && (!(*best_match) || entry->priority > (*best_match)->priority) &&
+				__of1x_check_entry_trie(pkt, entry))
+			*best_match = entry;
+	}
+}
 
 /* FLOW entry lookup entry point */
 static inline of1x_flow_entry_t* of1x_find_best_match_trie_ma(of1x_flow_table_t *const table,
@@ -90,18 +115,24 @@ static inline of1x_flow_entry_t* of1x_find_best_match_trie_ma(of1x_flow_table_t
 
 	struct of1x_trie* trie = ((of1x_trie_t*)table->matching_aux[0]);
 	of1x_flow_entry_t* best_match;
-	struct of1x_trie_leaf* leaf = trie->root;
+	of1x_trie_pool_t* pool;
 
 #ifndef ROFL_PIPELINE_LOCKLESS
-	//Prevent writers to change structure during matching
+	//Prevent the pool to be reclaimed during matching (writers only wrlock after the swap)
 	platform_rwlock_rdlock(table->rwlock);
 #endif //!ROFL_PIPELINE_LOCKLESS
 
-	//Entries with no matches
-	best_match = trie->entry;
+	pool = trie->pool;
+	best_match = NULL;
+
+	if(likely(pool != NULL)){
+		//Entries with no matches
+		best_match = pool->entry;
+		of1x_check_pool_trie(pkt, pool, &best_match);
+	}
 
-	//Start recursion
-	of1x_check_leaf_trie(pkt, leaf, &best_match);
+	if(trie->num_of_side_entries)
+		of1x_check_side_trie(pkt, trie, &best_match);
 
 #ifndef ROFL_PIPELINE_LOCKLESS
 	if(best_match){
@@ -0,0 +1,420 @@
+#include "of1x_vscan_ma.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../of1x_pipeline.h"
+#include "../../of1x_flow_table.h"
+#include "../../of1x_flow_entry.h"
+#include "../../of1x_match.h"
+#include "../../of1x_group_table.h"
+#include "../../of1x_instruction.h"
+#include "../../../of1x_async_events_hooks.h"
+#include "../../../../../platform/lock.h"
+#include "../../../../../platform/likely.h"
+#include "../../../../../platform/memory.h"
+#include "../../../../../util/logging.h"
+#include "../matching_algorithms.h"
+#include "../loop/of1x_loop_ma.h"
+
+#define VSCAN_DESCRIPTION "The vscan algorithm compiles the entries' matches into fixed width key/mask vectors, stored as a structure of arrays, and does a brute force (SIMD if available) linear scan over them. Suited for small and medium tables (up to ~2k entries)"
+
+//
+// Constructors and destructors
+//
+rofl_result_t of1x_init_vscan(struct of1x_flow_table *const table){
+
+	table->matching_aux[0] = (void*)platform_malloc_shared(sizeof(vscan_state_t));
+
+	if(unlikely(table->matching_aux[0] == NULL))
+		return ROFL_FAILURE;
+
+	//Cleanup everything
+	memset(table->matching_aux[0], 0, sizeof(vscan_state_t));
+
+	return ROFL_SUCCESS;
+}
+
+static void vscan_destroy_vectors(vscan_vectors_t* vectors){
+	if(!vectors)
+		return;
+
+	if(vectors->mem)
+		platform_free_shared(vectors->mem);
+	if(vectors->entries)
+		platform_free_shared(vectors->entries);
+	if(vectors->full_check)
+		platform_free_shared(vectors->full_check);
+	platform_free_shared(vectors);
+}
+
+rofl_result_t of1x_destroy_vscan(struct of1x_flow_table *const table){
+
+	of1x_flow_entry_t* entry;
+	vscan_state_t* state = (vscan_state_t*)table->matching_aux[0];
+
+	//Release entries' state
+	for(entry = table->entries; entry; entry = entry->next){
+		if(entry->platform_state){
+			platform_free_shared(entry->platform_state);
+			entry->platform_state = NULL;
+		}
+	}
+
+	vscan_destroy_vectors(state->vectors);
+	platform_free_shared(state);
+	table->matching_aux[0] = NULL;
+
+	//Destroy entries
+	return of1x_destroy_loop(table);
+}
+
+//
+// Vector compilation
+//
+
+static inline void vscan_set_field(uint64_t* value, uint64_t* mask, enum vscan_key_word w, unsigned int shift, uint64_t v, uint64_t m, uint64_t flag){
+	value[w] |= (v & m) << shift;
+	mask[w] |= m << shift;
+	value[VSCAN_W_FLAGS] |= flag;
+	mask[VSCAN_W_FLAGS] |= flag;
+}
+
+/*
+* Compiles the matches of an entry into a key value/mask vector. Returns true
+* if the entry has matches that are not part of the key (full verification).
+*/
+static bool vscan_compile_entry(of1x_flow_entry_t* entry, uint64_t* value, uint64_t* mask){
+
+	bool full_check = false;
+	of1x_match_t* it;
+	utern_t* tern;
+
+	memset(value, 0, sizeof(uint64_t)*VSCAN_KEY_WORDS);
+	memset(mask, 0, sizeof(uint64_t)*VSCAN_KEY_WORDS);
+
+	for(it = entry->matches.head; it; it = it->next){
+		tern = &it->__tern;
+
+		switch(it->type){
+			case OF1X_MATCH_IN_PORT: vscan_set_field(value, mask, VSCAN_W_PORT_ETH, 0, tern->value.u32, tern->mask.u32, VSCAN_F_IN_PORT);
+				break;
+			case OF1X_MATCH_METADATA: vscan_set_field(value, mask, VSCAN_W_METADATA, 0, tern->value.u64, tern->mask.u64, VSCAN_F_METADATA);
+				break;
+			case OF1X_MATCH_ETH_DST: vscan_set_field(value, mask, VSCAN_W_ETH_DST, 0, tern->value.u64, tern->mask.u64, VSCAN_F_ETH_DST);
+				break;
+			case OF1X_MATCH_ETH_SRC: vscan_set_field(value, mask, VSCAN_W_ETH_SRC, 0, tern->value.u64, tern->mask.u64, VSCAN_F_ETH_SRC);
+				break;
+			case OF1X_MATCH_ETH_TYPE: vscan_set_field(value, mask, VSCAN_W_PORT_ETH, 32, tern->value.u16, tern->mask.u16, VSCAN_F_ETH_TYPE);
+				break;
+			case OF1X_MATCH_VLAN_VID:
+				if(it->vlan_present == OF1X_MATCH_VLAN_SPECIFIC){
+					vscan_set_field(value, mask, VSCAN_W_PORT_ETH, 48, tern->value.u16, tern->mask.u16, VSCAN_F_VLAN_VID);
+				}else{
+					//Only the presence of the tag
+					mask[VSCAN_W_FLAGS] |= VSCAN_F_VLAN;
+					if(it->vlan_present == OF1X_MATCH_VLAN_ANY)
+						value[VSCAN_W_FLAGS] |= VSCAN_F_VLAN;
+				}
+				break;
+			case OF1X_MATCH_VLAN_PCP: vscan_set_field(value, mask, VSCAN_W_MISC, 0, tern->value.u8, tern->mask.u8, VSCAN_F_VLAN_PCP);
+				break;
+			case OF1X_MATCH_IP_PROTO: vscan_set_field(value, mask, VSCAN_W_MISC, 8, tern->value.u8, tern->mask.u8, VSCAN_F_IP_PROTO);
+				break;
+			case OF1X_MATCH_IP_DSCP: vscan_set_field(value, mask, VSCAN_W_MISC, 16, tern->value.u8, tern->mask.u8, VSCAN_F_IP_DSCP);
+				break;
+			case OF1X_MATCH_IP_ECN: vscan_set_field(value, mask, VSCAN_W_MISC, 24, tern->value.u8, tern->mask.u8, VSCAN_F_IP_ECN);
+				break;
+			case OF1X_MATCH_IPV4_SRC: vscan_set_field(value, mask, VSCAN_W_NW, 0, tern->value.u32, tern->mask.u32, VSCAN_F_IPV4_SRC);
+				break;
+			case OF1X_MATCH_IPV4_DST: vscan_set_field(value, mask, VSCAN_W_NW, 32, tern->value.u32, tern->mask.u32, VSCAN_F_IPV4_DST);
+				break;
+			case OF1X_MATCH_ARP_OP: vscan_set_field(value, mask, VSCAN_W_MISC, 48, tern->value.u16, tern->mask.u16, VSCAN_F_ARP_OP);
+				break;
+			case OF1X_MATCH_ARP_SPA: vscan_set_field(value, mask, VSCAN_W_NW, 0, tern->value.u32, tern->mask.u32, VSCAN_F_ARP_SPA);
+				break;
+			case OF1X_MATCH_ARP_TPA: vscan_set_field(value, mask, VSCAN_W_NW, 32, tern->value.u32, tern->mask.u32, VSCAN_F_ARP_TPA);
+				break;
+			case OF1X_MATCH_TCP_SRC: vscan_set_field(value, mask, VSCAN_W_TP, 0, tern->value.u16, tern->mask.u16, VSCAN_F_TCP_SRC);
+				break;
+			case OF1X_MATCH_TCP_DST: vscan_set_field(value, mask, VSCAN_W_TP, 16, tern->value.u16, tern->mask.u16, VSCAN_F_TCP_DST);
+				break;
+			case OF1X_MATCH_UDP_SRC: vscan_set_field(value, mask, VSCAN_W_TP, 0, tern->value.u16, tern->mask.u16, VSCAN_F_UDP_SRC);
+				break;
+			case OF1X_MATCH_UDP_DST: vscan_set_field(value, mask, VSCAN_W_TP, 16, tern->value.u16, tern->mask.u16, VSCAN_F_UDP_DST);
+				break;
+			case OF1X_MATCH_SCTP_SRC: vscan_set_field(value, mask, VSCAN_W_TP, 0, tern->value.u16, tern->mask.u16, VSCAN_F_SCTP_SRC);
+				break;
+			case OF1X_MATCH_SCTP_DST: vscan_set_field(value, mask, VSCAN_W_TP, 16, tern->value.u16, tern->mask.u16, VSCAN_F_SCTP_DST);
+				break;
+			case OF1X_MATCH_ICMPV4_TYPE: vscan_set_field(value, mask, VSCAN_W_MISC, 32, tern->value.u8, tern->mask.u8, VSCAN_F_ICMPV4_TYPE);
+				break;
+			case OF1X_MATCH_ICMPV4_CODE: vscan_set_field(value, mask, VSCAN_W_MISC, 40, tern->value.u8, tern->mask.u8, VSCAN_F_ICMPV4_CODE);
+				break;
+			default:
+				//Not part of the key
+				full_check = true;
+				break;
+		}
+	}
+
+	return full_check;
+}
+
+//Compiles the vectors of the current table entries. Table mutex MUST be held
+static rofl_result_t vscan_compile(of1x_flow_table_t *const table, vscan_vectors_t** vectors_ptr){
+
+	unsigned int i, j, w, capacity, num_of_entries = table->num_of_entries;
+	uint64_t *value=NULL, *mask=NULL;
+	uint8_t used_words = 0x1 << VSCAN_W_FLAGS;
+	of1x_flow_entry_t* entry;
+	vscan_vectors_t* vectors = NULL;
+
+	*vectors_ptr = NULL;
+
+	if(!num_of_entries)
+		return ROFL_SUCCESS;
+
+	//Compile the entries (AoS)
+	value = (uint64_t*)platform_malloc_shared(sizeof(uint64_t)*VSCAN_KEY_WORDS*num_of_entries);
+	mask = (uint64_t*)platform_malloc_shared(sizeof(uint64_t)*VSCAN_KEY_WORDS*num_of_entries);
+	vectors = (vscan_vectors_t*)platform_malloc_shared(sizeof(vscan_vectors_t));
+
+	if(unlikely(value == NULL) || unlikely(mask == NULL) || unlikely(vectors == NULL))
+		goto COMPILE_ERROR;
+	memset(vectors, 0, sizeof(vscan_vectors_t));
+
+	vectors->num_of_entries = num_of_entries;
+	vectors->num_of_blocks = (num_of_entries + VSCAN_BLOCK_SIZE - 1) / VSCAN_BLOCK_SIZE;
+	capacity = vectors->num_of_blocks*VSCAN_BLOCK_SIZE;
+
+	vectors->entries = (of1x_flow_entry_t**)platform_malloc_shared(sizeof(of1x_flow_entry_t*)*capacity);
+	vectors->full_check = (uint64_t*)platform_malloc_shared(sizeof(uint64_t)*vectors->num_of_blocks);
+	if(unlikely(vectors->entries == NULL) || unlikely(vectors->full_check == NULL))
+		goto COMPILE_ERROR;
+	memset(vectors->entries, 0, sizeof(of1x_flow_entry_t*)*capacity);
+	memset(vectors->full_check, 0, sizeof(uint64_t)*vectors->num_of_blocks);
+
+	for(entry = table->entries, i=0; entry && i < num_of_entries; entry = entry->next, i++){
+		vectors->entries[i] = entry;
+		if(vscan_compile_entry(entry, &value[i*VSCAN_KEY_WORDS], &mask[i*VSCAN_KEY_WORDS]))
+			vectors->full_check[i/VSCAN_BLOCK_SIZE] |= 0x1ULL << (i%VSCAN_BLOCK_SIZE);
+
+		for(w=0;w<VSCAN_KEY_WORDS;w++){
+			if(mask[i*VSCAN_KEY_WORDS+w])
+				used_words |= 0x1 << w;
+		}
+	}
+	assert(i == num_of_entries);
+
+	//Only the words used by any entry are compared (flags always first)
+	for(w=0;w<VSCAN_KEY_WORDS;w++){
+		if(used_words & (0x1 << w))
+			vectors->words[vectors->num_of_words++] = w;
+	}
+
+	//Transpose to SoA (cache aligned)
+	vectors->mem = platform_malloc_shared(sizeof(uint64_t)*2*vectors->num_of_words*capacity + VSCAN_CACHE_LINE_SIZE);
+	if(unlikely(vectors->mem == NULL))
+		goto COMPILE_ERROR;
+	vectors->values = (uint64_t*)(((uintptr_t)vectors->mem + VSCAN_CACHE_LINE_SIZE - 1) & ~((uintptr_t)VSCAN_CACHE_LINE_SIZE - 1));
+	vectors->masks = vectors->values + vectors->num_of_words*capacity;
+
+	for(j=0;j<vectors->num_of_words;j++){
+		w = vectors->words[j];
+		for(i=0;i<num_of_entries;i++){
+			vectors->values[j*capacity+i] = value[i*VSCAN_KEY_WORDS+w];
+			vectors->masks[j*capacity+i] = mask[i*VSCAN_KEY_WORDS+w];
+		}
+		//Padding slots never match (the flags word never compares to all 1s with a 0 mask)
+		for(;i<capacity;i++){
+			vectors->values[j*capacity+i] = (w == VSCAN_W_FLAGS)? ~0x0ULL : 0x0ULL;
+			vectors->masks[j*capacity+i] = 0x0ULL;
+		}
+	}
+
+	platform_free_shared(value);
+	platform_free_shared(mask);
+
+	*vectors_ptr = vectors;
+	return ROFL_SUCCESS;
+
+COMPILE_ERROR:
+	if(value)
+		platform_free_shared(value);
+	if(mask)
+		platform_free_shared(mask);
+	vscan_destroy_vectors(vectors);
+	return ROFL_FAILURE;
+}
+
+//Recompiles and publishes the vectors of the table, if modified. Table mutex MUST be held
+static void vscan_update(of1x_flow_table_t *const table){
+
+	unsigned int i;
+	vscan_vectors_t *vectors, *old;
+	vscan_state_t* state = (vscan_state_t*)table->matching_aux[0];
+
+	if(!state->dirty)
+		return;
+
+	if(unlikely(vscan_compile(table, &vectors) != ROFL_SUCCESS)){
+		//Fall back to the linear lookup until the next (successful) compilation
+		ROFL_PIPELINE_ERR("[vscan] Unable to compile the vectors of table %u (%p); falling back to linear lookup\n", table->number, table);
+		vectors = NULL;
+	}else{
+		state->dirty = false;
+	}
+
+	//Publish
+	platform_rwlock_wrlock(table->rwlock);
+	old = state->vectors;
+	state->vectors = vectors;
+	platform_rwlock_wrunlock(table->rwlock);
+
+#ifdef ROFL_PIPELINE_LOCKLESS
+	tid_wait_all_not_present(&table->tid_presence_mask);
+#endif
+
+	//Nobody is using the old vectors anymore (safe; removals hold the mutex)
+	if(vectors){
+		for(i=0;i<vectors->num_of_entries;i++)
+			((vscan_entry_ps_t*)vectors->entries[i]->platform_state)->slot = i;
+	}else{
+		for(i=0;old && i<old->num_of_entries;i++){
+			if(old->entries[i])
+				((vscan_entry_ps_t*)old->entries[i]->platform_state)->slot = VSCAN_NO_SLOT;
+		}
+	}
+
+	vscan_destroy_vectors(old);
+}
+
+rofl_result_t of1x_compact_vscan(struct of1x_flow_table *const table){
+
+	vscan_state_t* state = (vscan_state_t*)table->matching_aux[0];
+
+	//Serialize with flowmods
+	platform_mutex_lock(table->mutex);
+	vscan_update(table);
+	platform_mutex_unlock(table->mutex);
+
+	return (state->dirty)? ROFL_FAILURE : ROFL_SUCCESS;
+}
+
+//
+//Hooks
+//
+void of1x_add_hook_vscan(of1x_flow_entry_t *const entry){
+
+	vscan_entry_ps_t* ps;
+	vscan_state_t* state = (vscan_state_t*)entry->table->matching_aux[0];
+
+	ps = (vscan_entry_ps_t*)platform_malloc_shared(sizeof(vscan_entry_ps_t));
+
+	if(unlikely(ps == NULL)){
+		assert(0);
+		return;
+	}
+
+	//Compiled once the flowmod is done
+	ps->slot = VSCAN_NO_SLOT;
+	entry->platform_state = (void*)ps;
+	state->dirty = true;
+}
+
+void of1x_modify_hook_vscan(of1x_flow_entry_t *const entry){
+	//Matches are never modified; we don't care
+}
+
+void of1x_remove_hook_vscan(of1x_flow_entry_t *const entry){
+
+	vscan_entry_ps_t* ps = (vscan_entry_ps_t*)entry->platform_state;
+	vscan_state_t* state = (vscan_state_t*)entry->table->matching_aux[0];
+
+	if(unlikely(ps == NULL)){
+		assert(0);
+		return;
+	}
+
+	//Entry is already unlinked from the table; invalidate it in the vectors
+	if(ps->slot != VSCAN_NO_SLOT){
+		platform_rwlock_wrlock(entry->table->rwlock);
+		state->vectors->entries[ps->slot] = NULL;
+		platform_rwlock_wrunlock(entry->table->rwlock);
+
+#ifdef ROFL_PIPELINE_LOCKLESS
+		tid_wait_all_not_present(&entry->table->tid_presence_mask);
+#endif
+	}
+	state->dirty = true;
+
+	platform_free_shared(ps);
+	entry->platform_state = NULL;
+}
+
+//
+// Main routines
+//
+rofl_of1x_fm_result_t of1x_add_flow_entry_vscan(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, bool check_overlap, bool reset_counts, bool check_cookie){
+
+	rofl_of1x_fm_result_t res;
+
+	//Call loop with the right hooks
+	res = __of1x_add_flow_entry_loop(table, entry, check_overlap, reset_counts, check_cookie, of1x_add_hook_vscan, of1x_remove_hook_vscan);
+
+	//Recompile (once per flowmod)
+	platform_mutex_lock(table->mutex);
+	vscan_update(table);
+	platform_mutex_unlock(table->mutex);
+
+	return res;
+}
+
+rofl_of1x_fm_result_t of1x_modify_flow_entry_vscan(of1x_flow_table_t *const table, of1x_flow_entry_t *const entry, const enum of1x_flow_removal_strictness strict, bool reset_counts){
+
+	rofl_of1x_fm_result_t res;
+
+	//Call loop with the right hooks
+	res = __of1x_modify_flow_entry_loop(table, entry, strict, reset_counts, of1x_add_hook_vscan, of1x_modify_hook_vscan, of1x_remove_hook_vscan);
+
+	//Recompile (once per flowmod), if the table was modified
+	platform_mutex_lock(table->mutex);
+	vscan_update(table);
+	platform_mutex_unlock(table->mutex);
+
+	return res;
+}
+
+rofl_of1x_fm_result_t of1x_remove_flow_entry_vscan(of1x_flow_table_t *const table , of1x_flow_entry_t *const entry, of1x_flow_entry_t *const specific_entry, const enum of1x_flow_removal_strictness strict, uint32_t out_port, uint32_t out_group, of1x_flow_remove_reason_t reason, of1x_mutex_acquisition_required_t mutex_acquired){
+	//Call loop with the right hooks
+	return __of1x_remove_flow_entry_loop(table, entry, specific_entry, strict, out_port, out_group, reason, mutex_acquired, of1x_remove_hook_vscan);
+}
+
+//Define the matching algorithm struct
+OF1X_REGISTER_MATCHING_ALGORITHM(vscan) = {
+	//Init and destroy hooks
+	.init_hook = of1x_init_vscan,
+	.destroy_hook = of1x_destroy_vscan,
+
+	//Maintenance (vector compaction)
+	.maintenance_hook = of1x_compact_vscan,
+
+	//Flow mods
+	.add_flow_entry_hook = of1x_add_flow_entry_vscan,
+	.modify_flow_entry_hook = of1x_modify_flow_entry_vscan,
+	.remove_flow_entry_hook = of1x_remove_flow_entry_vscan,
+
+	//Stats
+	.get_flow_stats_hook = of1x_get_flow_stats_loop,
+	.get_flow_stats_page_hook = of1x_get_flow_stats_page_loop,
+	.walk_flow_entries_hook = of1x_walk_flow_entries_loop,
+	.get_flow_aggregate_stats_hook = of1x_get_flow_aggregate_stats_loop,
+
+	//Find group related entries
+	.find_entry_using_group_hook = of1x_find_entry_using_group_loop,
+
+	//Dumping
+	.dump_hook = NULL,
+	.description = VSCAN_DESCRIPTION,
+};
@@ -0,0 +1,131 @@
+#ifndef __OF1X_VSCAN_MATCH_H__
+#define __OF1X_VSCAN_MATCH_H__
+
+#include "rofl_datapath.h"
+#include "../matching_algorithms.h"
+#include "../../of1x_flow_table.h"
+#include "../../of1x_packet_key.h"
+
+/**
+* @file of1x_vscan_ma.h
+*
+* @brief Vectorised linear scan (brute force) matching algorithm
+*
+* The matches of each entry are compiled into a fixed width (64 bytes) key
+* value/mask vector over a packet key, which is extracted only once per
+* lookup. Vectors are stored as a structure of arrays (one array per key word,
+* in table order), so that the lookup streams through them comparing the key
+* against blocks of 64 entries at a time, using AVX-512/AVX2 if the pipeline
+* is compiled with support for them, or the scalar fallback otherwise.
+*
+* Entries with matches that are not part of the key are fully verified, once
+* they are candidates.
+*
+* Vectors are recompiled once per add/modify flowmod, so this algorithm is
+* suited for small and medium tables (up to ~2k entries). Removed entries are
+* just invalidated in the vectors, which are compacted during the periodic
+* maintenance of the table (see maintenance_hook).
+*/
+
+//Packet key words
+enum vscan_key_word{
+	VSCAN_W_FLAGS = 0,	//Field presence flags
+	VSCAN_W_METADATA = 1,
+	VSCAN_W_ETH_DST = 2,
+	VSCAN_W_ETH_SRC = 3,
+	VSCAN_W_PORT_ETH = 4,	//port_in(32) | eth_type(16) | vlan_vid(16)
+	VSCAN_W_NW = 5,		//ipv4_src or arp_spa(32) | ipv4_dst or arp_tpa(32)
+	VSCAN_W_MISC = 6,	//vlan_pcp | ip_proto | ip_dscp | ip_ecn | icmpv4_type | icmpv4_code | arp_op(16)
+	VSCAN_W_TP = 7,		//tcp, udp or sctp src(16) | dst(16)
+
+	VSCAN_KEY_WORDS
+};
+
+//Field presence flags; the packet key presence bitmap (see of1x_packet_key.h) plus metadata
+#define VSCAN_F_METADATA	(1ULL << 63)
+#define VSCAN_F_IN_PORT		OF1X_PKT_KEY_F_IN_PORT
+#define VSCAN_F_ETH_DST		OF1X_PKT_KEY_F_ETH_DST
+#define VSCAN_F_ETH_SRC		OF1X_PKT_KEY_F_ETH_SRC
+#define VSCAN_F_ETH_TYPE	OF1X_PKT_KEY_F_ETH_TYPE
+#define VSCAN_F_VLAN		OF1X_PKT_KEY_F_VLAN
+#define VSCAN_F_VLAN_VID	OF1X_PKT_KEY_F_VLAN_VID
+#define VSCAN_F_VLAN_PCP	OF1X_PKT_KEY_F_VLAN_PCP
+#define VSCAN_F_IP_PROTO	OF1X_PKT_KEY_F_IP_PROTO
+#define VSCAN_F_IP_DSCP		OF1X_PKT_KEY_F_IP_DSCP
+#define VSCAN_F_IP_ECN		OF1X_PKT_KEY_F_IP_ECN
+#define VSCAN_F_IPV4_SRC	OF1X_PKT_KEY_F_IPV4_SRC
+#define VSCAN_F_IPV4_DST	OF1X_PKT_KEY_F_IPV4_DST
+#define VSCAN_F_ARP_OP		OF1X_PKT_KEY_F_ARP_OP
+#define VSCAN_F_ARP_SPA		OF1X_PKT_KEY_F_ARP_SPA
+#define VSCAN_F_ARP_TPA		OF1X_PKT_KEY_F_ARP_TPA
+#define VSCAN_F_TCP_SRC		OF1X_PKT_KEY_F_TCP_SRC
+#define VSCAN_F_TCP_DST		OF1X_PKT_KEY_F_TCP_DST
+#define VSCAN_F_UDP_SRC		OF1X_PKT_KEY_F_UDP_SRC
+#define VSCAN_F_UDP_DST		OF1X_PKT_KEY_F_UDP_DST
+#define VSCAN_F_SCTP_SRC	OF1X_PKT_KEY_F_SCTP_SRC
+#define VSCAN_F_SCTP_DST	OF1X_PKT_KEY_F_SCTP_DST
+#define VSCAN_F_ICMPV4_TYPE	OF1X_PKT_KEY_F_ICMPV4_TYPE
+#define VSCAN_F_ICMPV4_CODE	OF1X_PKT_KEY_F_ICMPV4_CODE
+
+//Entries per block (one bit per entry in the block match bitmap)
+#define VSCAN_BLOCK_SIZE 64
+
+#define VSCAN_CACHE_LINE_SIZE 64
+
+/**
+* Compiled vectors of a table (immutable once published). The value and mask
+* arrays hold num_of_words arrays of num_of_blocks*VSCAN_BLOCK_SIZE elements
+* each, one per key word used by any of the entries (words[]). Values are
+* pre-masked. Padding slots never match.
+*/
+typedef struct vscan_vectors{
+	//Key words in use
+	uint8_t words[VSCAN_KEY_WORDS];
+	unsigned int num_of_words;
+
+	unsigned int num_of_entries;
+	unsigned int num_of_blocks;
+
+	//SoA arrays (cache aligned)
+	uint64_t* values;
+	uint64_t* masks;
+
+	//Entries (table order) and bitmap of the ones that need full verification
+	of1x_flow_entry_t** entries;
+	uint64_t* full_check;
+
+	//Raw memory
+	void* mem;
+}vscan_vectors_t;
+
+//Slot of entries not (yet) in the vectors
+#define VSCAN_NO_SLOT 0xFFFFFFFF
+
+//Platform state of an entry
+typedef struct vscan_entry_ps{
+	//Slot in the current vectors or VSCAN_NO_SLOT
+	uint32_t slot;
+}vscan_entry_ps_t;
+
+//State
+typedef struct vscan_state{
+	//Current vectors. If NULL, the table is looked up linearly
+	vscan_vectors_t* vectors;
+
+	//Table modified since the last compilation
+	bool dirty;
+}vscan_state_t;
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+/**
+* Recompiles the vectors of the table, if it has been modified since the last
+* compilation. This is the maintenance hook of the algorithm.
+*/
+rofl_result_t of1x_compact_vscan(struct of1x_flow_table *const table);
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //VSCAN_MATCH
@@ -0,0 +1,190 @@
+#ifndef __OF1X_VSCAN_MATCH_PP_H__
+#define __OF1X_VSCAN_MATCH_PP_H__
+
+#include "rofl_datapath.h"
+#include "../../../../../util/pp_guard.h" //Never forget to include the guard
+#include "../../../../../common/bitmap.h"
+#include "../../of1x_pipeline.h"
+#include "../../of1x_flow_table.h"
+#include "../../of1x_flow_entry.h"
+#include "../../of1x_match_pp.h"
+#include "../../of1x_packet_key_pp.h"
+#include "../../of1x_group_table.h"
+#include "../../of1x_instruction_pp.h"
+#include "../../../of1x_async_events_hooks.h"
+#include "../../../../../platform/lock.h"
+#include "../../../../../platform/likely.h"
+#include "../../../../../platform/memory.h"
+#include "of1x_vscan_ma.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+	#include <immintrin.h>
+#endif
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+//Full check of the entry matches
+static inline bool __of1x_vscan_check_entry(datapacket_t *const pkt, of1x_flow_entry_t* entry){
+	of1x_match_t* it;
+
+	for(it=entry->matches.head; it; it=it->next){
+		if(!__of1x_check_match(pkt, it))
+			return false;
+	}
+	return true;
+}
+
+/*
+* Build the key words out of the canonical packet key. Fields not present are
+* left to 0 and their flag unset.
+*/
+static inline void __of1x_vscan_get_key(datapacket_t *const pkt, uint64_t* key){
+
+	of1x_packet_key_t* pkt_key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2 | OF1X_PKT_KEY_ARP | OF1X_PKT_KEY_L3 | OF1X_PKT_KEY_L4);
+	uint64_t present = pkt_key->present;
+	uint64_t port_eth = 0, nw = 0, misc = 0, tp = 0;
+
+	key[VSCAN_W_FLAGS] = present | VSCAN_F_METADATA;
+	key[VSCAN_W_METADATA] = pkt->__metadata;
+	key[VSCAN_W_ETH_DST] = (present & VSCAN_F_ETH_DST)? pkt_key->eth_dst : 0;
+	key[VSCAN_W_ETH_SRC] = (present & VSCAN_F_ETH_SRC)? pkt_key->eth_src : 0;
+
+	if(present & VSCAN_F_IN_PORT)
+		port_eth = pkt_key->port_in;
+	if(present & VSCAN_F_ETH_TYPE)
+		port_eth |= (uint64_t)pkt_key->eth_type << 32;
+	if(present & VSCAN_F_VLAN_VID)
+		port_eth |= (uint64_t)pkt_key->vlan_vid << 48;
+
+	//IPv4 and ARP are mutually exclusive
+	if(present & VSCAN_F_IPV4_SRC)
+		nw = pkt_key->ipv4_src;
+	if(present & VSCAN_F_IPV4_DST)
+		nw |= (uint64_t)pkt_key->ipv4_dst << 32;
+	if(present & VSCAN_F_ARP_SPA)
+		nw = pkt_key->arp_spa;
+	if(present & VSCAN_F_ARP_TPA)
+		nw |= (uint64_t)pkt_key->arp_tpa << 32;
+
+	if(present & VSCAN_F_VLAN_PCP)
+		misc = pkt_key->vlan_pcp;
+	if(present & VSCAN_F_IP_PROTO)
+		misc |= (uint64_t)pkt_key->ip_proto << 8;
+	if(present & VSCAN_F_IP_DSCP)
+		misc |= (uint64_t)pkt_key->ip_dscp << 16;
+	if(present & VSCAN_F_IP_ECN)
+		misc |= (uint64_t)pkt_key->ip_ecn << 24;
+	if(present & VSCAN_F_ICMPV4_TYPE)
+		misc |= (uint64_t)pkt_key->icmpv4_type << 32;
+	if(present & VSCAN_F_ICMPV4_CODE)
+		misc |= (uint64_t)pkt_key->icmpv4_code << 40;
+	if(present & VSCAN_F_ARP_OP)
+		misc |= (uint64_t)pkt_key->arp_opcode << 48;
+
+	//TCP, UDP and SCTP share the ports
+	if(present & OF1X_PKT_KEY_F_TP_SRC)
+		tp = pkt_key->tp_src;
+	if(present & OF1X_PKT_KEY_F_TP_DST)
+		tp |= (uint64_t)pkt_key->tp_dst << 16;
+
+	key[VSCAN_W_PORT_ETH] = port_eth;
+	key[VSCAN_W_NW] = nw;
+	key[VSCAN_W_MISC] = misc;
+	key[VSCAN_W_TP] = tp;
+}
+
+/*
+* Compare a key word against a block of VSCAN_BLOCK_SIZE entries. Returns the
+* bitmap of the entries of the block that match the word.
+*/
+static inline bitmap64_t __of1x_vscan_cmp_block(const uint64_t* values, const uint64_t* masks, uint64_t key){
+
+	unsigned int i;
+	bitmap64_t bm = 0x0ULL;
+
+#if defined(__AVX512F__)
+	__m512i k = _mm512_set1_epi64(key);
+
+	for(i=0;i<VSCAN_BLOCK_SIZE;i+=8)
+		bm |= (bitmap64_t)_mm512_cmpeq_epi64_mask(_mm512_and_si512(k, _mm512_load_si512((const void*)&masks[i])), _mm512_load_si512((const void*)&values[i])) << i;
+#elif defined(__AVX2__)
+	__m256i k = _mm256_set1_epi64x(key);
+	__m256i eq;
+
+	for(i=0;i<VSCAN_BLOCK_SIZE;i+=4){
+		eq = _mm256_cmpeq_epi64(_mm256_and_si256(k, _mm256_load_si256((const __m256i*)&masks[i])), _mm256_load_si256((const __m256i*)&values[i]));
+		bm |= (bitmap64_t)_mm256_movemask_pd(_mm256_castsi256_pd(eq)) << i;
+	}
+#else
+	//Scalar fallback
+	for(i=0;i<VSCAN_BLOCK_SIZE;i++)
+		bm |= (bitmap64_t)((key & masks[i]) == values[i]) << i;
+#endif
+	return bm;
+}
+
+/* FLOW entry lookup entry point */
+static inline of1x_flow_entry_t* of1x_find_best_match_vscan_ma(of1x_flow_table_t *const table, datapacket_t *const pkt){
+
+	uint64_t key[VSCAN_KEY_WORDS];
+	unsigned int b, w, i, offset, capacity;
+	bitmap64_t bm;
+	of1x_flow_entry_t *entry, *best_match = NULL;
+	vscan_vectors_t* vectors;
+	vscan_state_t* state = (vscan_state_t*)table->matching_aux[0];
+
+#ifndef ROFL_PIPELINE_LOCKLESS
+	//Prevent writers to change structure during matching
+	platform_rwlock_rdlock(table->rwlock);
+#endif
+
+	vectors = state->vectors;
+
+	if(likely(vectors != NULL)){
+		__of1x_vscan_get_key(pkt, key);
+		capacity = vectors->num_of_blocks*VSCAN_BLOCK_SIZE;
+
+		for(b=0, offset=0; b < vectors->num_of_blocks && !best_match; b++, offset += VSCAN_BLOCK_SIZE){
+			bm = ~0x0ULL;
+			for(w=0; w < vectors->num_of_words && bm; w++)
+				bm &= __of1x_vscan_cmp_block(&vectors->values[w*capacity + offset], &vectors->masks[w*capacity + offset], key[vectors->words[w]]);
+
+			//Entries are in priority order; first match is the best match
+			while(bm){
+				i = __builtin_ctzll(bm);
+				entry = vectors->entries[offset+i];
+
+				//Removed entries are NULL until the vectors are compacted
+				if( entry && (!(vectors->full_check[b] & (0x1ULL << i)) || __of1x_vscan_check_entry(pkt, entry)) ){
+					best_match = entry;
+					break;
+				}
+				bm &= bm - 1;
+			}
+		}
+	}else{
+		//No vectors (yet); linear lookup
+		for(entry = table->entries; entry; entry = entry->next){
+			if(__of1x_vscan_check_entry(pkt, entry)){
+				best_match = entry;
+				break;
+			}
+		}
+	}
+
+#ifndef ROFL_PIPELINE_LOCKLESS
+	//Lock writers to modify the entry while packet processing. WARNING!!!! this must be released by the pipeline, once packet is processed!
+	if(best_match)
+		platform_rwlock_rdlock(best_match->rwlock);
+
+	//Green light for writers
+	platform_rwlock_rdunlock(table->rwlock);
+#endif
+	return best_match;
+}
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //OF1X_VSCAN_MATCH_PP
@@ -18,6 +18,29 @@
 //Flood port
 extern switch_port_t* flood_meta_port;
 
+//Classify the destination of an OUTPUT action
+static of1x_output_dst_t __of1x_get_output_dst(uint32_t port_id){
+
+	if(port_id < LOGICAL_SWITCH_MAX_LOG_PORTS)
+		return OF1X_OUTPUT_DST_PORT;
+
+	switch(port_id){
+		case OF1X_PORT_FLOOD:
+			return OF1X_OUTPUT_DST_FLOOD;
+		case OF1X_PORT_CONTROLLER:
+		case OF1X_PORT_NORMAL:
+			return OF1X_OUTPUT_DST_CONTROLLER;
+		case OF1X_PORT_ALL:
+			return OF1X_OUTPUT_DST_ALL;
+		case OF1X_PORT_IN_PORT:
+			return OF1X_OUTPUT_DST_IN_PORT;
+		case OF1X_PORT_TABLE:
+			return OF1X_OUTPUT_DST_TABLE;
+		default:
+			return OF1X_OUTPUT_DST_UNKNOWN;
+	}
+}
+
 /* Actions init and destroyed */
 of1x_packet_action_t* of1x_init_packet_action(of1x_packet_action_type_t type, wrap_uint_t field, uint16_t output_send_len){
 
@@ -40,6 +63,8 @@ of1x_packet_action_t* of1x_init_packet_action(of1x_packet_action_type_t type, wr
 
 	//Make valgrind happy
 	UINT128__T_HI(action->__field.u128) = UINT128__T_LO(action->__field.u128) = 0x0ULL;
+	action->experimenter_id = action->exp_type = 0x0;
+	action->__exp_fn = NULL;
 	
 	/*
 	* Setting the field (for set_field actions) and fast validation flags
@@ -126,6 +151,7 @@ of1x_packet_action_t* of1x_init_packet_action(of1x_packet_action_type_t type, wr
 		case OF1X_AT_OUTPUT:
 			action->send_len = output_send_len;
 			action->__field.u32 = field.u32&OF1X_4_BYTE_MASK;
+			action->__output_dst = __of1x_get_output_dst(action->__field.u32);
 			break;
 		/* Extensions */
 		case OF1X_AT_SET_FIELD_GTP_TEID:
@@ -430,6 +456,21 @@ of1x_packet_action_t* of1x_init_packet_action(of1x_packet_action_type_t type, wr
 	return action;
 }
 
+of1x_packet_action_t* of1x_init_experimenter_action(uint32_t experimenter_id, uint32_t exp_type, wrap_uint_t field){
+
+	of1x_packet_action_t* action = of1x_init_packet_action(OF1X_AT_EXPERIMENTER, field, 0x0);
+
+	if( unlikely(action==NULL) )
+		return NULL;
+
+	//Argument is opaque
+	action->__field = field;
+	action->experimenter_id = experimenter_id;
+	action->exp_type = exp_type;
+
+	return action;
+}
+
 void of1x_destroy_packet_action(of1x_packet_action_t* action){
 
 	platform_free_shared(action);
@@ -467,6 +508,10 @@ of1x_action_group_t* of1x_init_action_group(of1x_packet_action_t* actions){
 	action_group->num_of_actions = number_of_actions;
 	action_group->num_of_output_actions = number_of_output_actions;
 
+	//Compiled on validation
+	action_group->ops = NULL;
+	action_group->num_of_ops = 0;
+
 	//Fast validation, set min max 
 	action_group->ver_req.min_ver = OF1X_MIN_VERSION;
 	action_group->ver_req.max_ver = OF1X_MAX_VERSION;
@@ -487,6 +532,8 @@ void of1x_destroy_action_group(of1x_action_group_t* group){
 		next = it->next; 
 		of1x_destroy_packet_action(it);
 	}
+	if(group->ops)
+		platform_free_shared(group->ops);
 	platform_free_shared(group);	
 }
 
@@ -580,6 +627,9 @@ rofl_result_t of1x_set_packet_action_on_write_actions(of1x_write_actions_t* writ
 	//Update field
 	write_actions->actions[action->type].__field = action->__field;
 	write_actions->actions[action->type].send_len = action->send_len;
+	write_actions->actions[action->type].__output_dst = action->__output_dst;
+	write_actions->actions[action->type].experimenter_id = action->experimenter_id;
+	write_actions->actions[action->type].exp_type = action->exp_type;
 
 	if( !bitmap128_is_bit_set(&write_actions->bitmap, action->type) ){
 		write_actions->num_of_actions++;
@@ -637,7 +687,7 @@ bool __of1x_write_actions_has(of1x_write_actions_t* write_actions, of1x_packet_a
 	if( unlikely(write_actions==NULL))
 		return false;	
 
-	return bitmap128_is_bit_set(&write_actions->bitmap, type);
+	return bitmap128_is_bit_set(&write_actions->bitmap, type) && write_actions->actions[type].__field.u64 == value;
 }
 /*TODO specific funcions for 128 bits. So far only used for OUTPUT and GROUP actions, so not really necessary*/
 bool __of1x_apply_actions_has(const of1x_action_group_t* apply_actions_group, of1x_packet_action_type_t type, uint64_t value){
@@ -649,12 +699,17 @@ bool __of1x_apply_actions_has(const of1x_action_group_t* apply_actions_group, of
 
 	for(it=apply_actions_group->head; it; it=it->next){
 		
+		if(it->type != type)
+			continue;
+
 		if(type != OF1X_AT_GROUP){
 			//Filter types where field cannot be 0
-			return (it->type == type) &&  (value != 0x0 && it->__field.u64 == value);
+			if(value != 0x0 && it->__field.u64 == value)
+				return true;
 		}else{
 			//Groups or anything else
-			return (it->type == type) &&  (it->__field.u64 == value);
+			if(it->__field.u64 == value)
+				return true;
 		}
 	}
 	return false;	
@@ -693,6 +748,10 @@ of1x_action_group_t* __of1x_copy_action_group(of1x_action_group_t* origin){
 	copy->num_of_actions = origin->num_of_actions;
 	copy->num_of_output_actions = origin->num_of_output_actions;
 
+	//Needs to be validated (compiled) again
+	copy->ops = NULL;
+	copy->num_of_ops = 0;
+
 	//Copy al apply actions
 	for(it=origin->head;it;it=it->next){
 		of1x_packet_action_t* act;
@@ -979,7 +1038,7 @@ static void __of1x_dump_packet_action(of1x_packet_action_t* action, bool raw_nbo
 		case OF1X_AT_GROUP:ROFL_PIPELINE_INFO_NO_PREFIX("GROUP:%u", __of1x_get_packet_action_field32(action, raw_nbo));
 			break;
 
-		case OF1X_AT_EXPERIMENTER:ROFL_PIPELINE_INFO_NO_PREFIX("EXPERIMENTER");
+		case OF1X_AT_EXPERIMENTER:ROFL_PIPELINE_INFO_NO_PREFIX("EXPERIMENTER(0x%x:0x%x)", action->experimenter_id, action->exp_type);
 			break;
 
 		case OF1X_AT_OUTPUT:
@@ -1038,6 +1097,53 @@ void __of1x_dump_action_group(of1x_action_group_t* action_group, bool raw_nbo){
 	}
 }
 
+//Compile the action list into a flat array (next pointers are kept consistent)
+static rofl_result_t __of1x_compile_action_group(of1x_action_group_t *ag){
+
+	unsigned int i, num_of_ops = 0;
+	of1x_packet_action_t *pa_it, *ops = NULL;
+
+	for(pa_it=ag->head; pa_it; pa_it=pa_it->next)
+		num_of_ops++;
+
+	if(num_of_ops){
+		ops = platform_malloc_shared(sizeof(of1x_packet_action_t)*num_of_ops);
+		if( unlikely(ops==NULL) )
+			return ROFL_FAILURE;
+
+		for(i=0, pa_it=ag->head; pa_it; pa_it=pa_it->next, i++){
+			ops[i] = *pa_it;
+			ops[i].next = (pa_it->next)? &ops[i+1] : NULL;
+		}
+	}
+
+	//Validation may be performed more than once
+	if(ag->ops)
+		platform_free_shared(ag->ops);
+
+	ag->ops = ops;
+	ag->num_of_ops = num_of_ops;
+
+	return ROFL_SUCCESS;
+}
+
+//Resolve the handler of an experimenter action
+static rofl_result_t __of1x_validate_experimenter_action(of1x_packet_action_t* action){
+
+	const of1x_experimenter_action_t* handler = __of1x_get_experimenter_action(action->experimenter_id, action->exp_type);
+
+	if(!handler){
+		ROFL_PIPELINE_DEBUG("Experimenter action 0x%x:0x%x not registered\n", action->experimenter_id, action->exp_type);
+		return ROFL_FAILURE;
+	}
+
+	if(handler->validate && handler->validate(action) != ROFL_SUCCESS)
+		return ROFL_FAILURE;
+
+	action->__exp_fn = handler->process;
+	return ROFL_SUCCESS;
+}
+
 rofl_result_t __of1x_validate_action_group(bitmap128_t* supported, of1x_action_group_t *ag, of1x_group_table_t *gt, bool is_pkt_out_al){
 	of1x_packet_action_t *pa_it;
 
@@ -1059,14 +1165,22 @@ rofl_result_t __of1x_validate_action_group(bitmap128_t* supported, of1x_action_g
 				//group num of actions and entry "num_of_output_actions cache"
 				ag->num_of_output_actions+=2;
 			}
+		}else if(pa_it->type == OF1X_AT_EXPERIMENTER){
+			if(__of1x_validate_experimenter_action(pa_it) != ROFL_SUCCESS)
+				return ROFL_FAILURE;
 		}
 	}
 
 	//Only pkt_out action lists can have output to table
 	if(!is_pkt_out_al && ag->has_output_table)
 		return ROFL_FAILURE;
-	
-	return ROFL_SUCCESS;
+
+	//pkt_out action lists are processed once; not worth compiling (no ops per packet)
+	if(is_pkt_out_al)
+		return ROFL_SUCCESS;
+
+	//Groups are resolved; compile
+	return __of1x_compile_action_group(ag);
 }
 
 rofl_result_t __of1x_validate_write_actions(bitmap128_t* supported, of1x_write_actions_t *wa, of1x_group_table_t *gt){
@@ -1092,6 +1206,11 @@ rofl_result_t __of1x_validate_write_actions(bitmap128_t* supported, of1x_write_a
 			wa->num_of_output_actions+=2;
 		}
 	}
+
+	if( bitmap128_is_bit_set(&wa->bitmap, OF1X_AT_EXPERIMENTER) ){
+		if(__of1x_validate_experimenter_action(&wa->actions[OF1X_AT_EXPERIMENTER]) != ROFL_SUCCESS)
+			return ROFL_FAILURE;
+	}
 	
 	return ROFL_SUCCESS;
 }
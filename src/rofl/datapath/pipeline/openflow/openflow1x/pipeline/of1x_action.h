@@ -11,6 +11,7 @@
 #include <assert.h>
 #include "rofl_datapath.h"
 #include "of1x_utils.h"
+#include "of1x_experimenter.h"
 #include "../../../common/ternary_fields.h"
 
 /**
@@ -267,6 +268,21 @@ enum of1x_port_numbers {
 						(including flows with no output port). */
 };
 
+/**
+* @ingroup core_of1x 
+* Destination of an OUTPUT action, classified when the action is created
+* so that the packet path does not compare the port against every meta-port
+*/
+typedef enum{
+	OF1X_OUTPUT_DST_PORT = 0,		/* Logical port (port id < LOGICAL_SWITCH_MAX_LOG_PORTS) */
+	OF1X_OUTPUT_DST_FLOOD,			/* OF1X_PORT_FLOOD */
+	OF1X_OUTPUT_DST_CONTROLLER,		/* OF1X_PORT_CONTROLLER and OF1X_PORT_NORMAL */
+	OF1X_OUTPUT_DST_ALL,			/* OF1X_PORT_ALL */
+	OF1X_OUTPUT_DST_IN_PORT,		/* OF1X_PORT_IN_PORT */
+	OF1X_OUTPUT_DST_TABLE,			/* OF1X_PORT_TABLE */
+	OF1X_OUTPUT_DST_UNKNOWN,		/* Anything else (dropped) */
+}of1x_output_dst_t;
+
 
 //fwd declaration
 struct of1x_group;
@@ -285,8 +301,16 @@ typedef struct of1x_packet_action{
 	//miss-send-len for OUTPUT actions only
 	uint16_t send_len;
 
+	//Destination for OUTPUT actions only
+	of1x_output_dst_t __output_dst;
+
 	//group
 	struct of1x_group* group;
+
+	//Experimenter (EXPERIMENTER actions only); handler resolved on validation
+	uint32_t experimenter_id;
+	uint32_t exp_type;
+	of1x_experimenter_action_fn_t __exp_fn;
 	
 	//DLL
 	struct of1x_packet_action* next;
@@ -311,6 +335,11 @@ typedef struct of1x_action_group{
 	//Double linked list
 	of1x_packet_action_t* head;
 	of1x_packet_action_t* tail;
+
+	//Flat copy of the list (contiguous), compiled on validation (except
+	//pkt_out lists). The packet path executes it instead of walking the list
+	of1x_packet_action_t* ops;
+	unsigned int num_of_ops;
 	
 	//Number of outputs in the action list
 	unsigned int num_of_output_actions;
@@ -332,9 +361,6 @@ typedef struct{
 	//bitmap of actions
 	bitmap128_t bitmap;
 	
-	//Write actions 0...OF1X_AT_NUMBER-1 at the very beginning of the array
-	of1x_packet_action_t actions[OF1X_AT_NUMBER];
-	
 	//Number of output actions. 
 	unsigned int num_of_actions;
 	unsigned int num_of_output_actions;
@@ -342,6 +368,10 @@ typedef struct{
 	/* Fast validation flags */
 	//Bitmap of required OF versions
 	of1x_ver_req_t ver_req; 
+
+	//Write actions 0...OF1X_AT_NUMBER-1 at the very beginning of the array
+	//(last; the header is reset per packet without touching the actions)
+	of1x_packet_action_t actions[OF1X_AT_NUMBER];
 }of1x_write_actions_t;
 
 //Fwd declaration
@@ -368,6 +398,17 @@ ROFL_BEGIN_DECLS
 */
 of1x_packet_action_t* of1x_init_packet_action(of1x_packet_action_type_t type, wrap_uint_t field, uint16_t output_send_len);
 
+/**
+* @ingroup core_of1x 
+* Initializes an experimenter action (OF1X_AT_EXPERIMENTER)
+*
+* The handler for experimenter_id and exp_type MUST be registered (of1x_register_experimenter_action())
+* before the flow entry (or group) containing the action is installed.
+*
+* @param field Argument of the experimenter action (opaque to the pipeline)
+*/
+of1x_packet_action_t* of1x_init_experimenter_action(uint32_t experimenter_id, uint32_t exp_type, wrap_uint_t field);
+
 /**
 * @ingroup core_of1x 
 * Destroys packet action (OF action)
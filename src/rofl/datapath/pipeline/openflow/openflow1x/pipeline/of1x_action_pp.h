@@ -13,6 +13,10 @@
 #include "../../../util/pp_guard.h" //Never forget to include the guard
 #include "of1x_statistics_pp.h"
 #include "of1x_action.h"
+#include "of1x_packet_key_pp.h"
+#include "of1x_checksum_pp.h"
+#include "of1x_set_field_pp.h"
+#include "of1x_tx_burst_pp.h"
 #include "of1x_group_table.h"
 #include "of1x_flow_table.h"
 #include "of1x_utils.h"
@@ -58,6 +62,18 @@
 //C++ extern C
 ROFL_BEGIN_DECLS
 
+//Get the packet size (bytes); retrieved from the platform only once
+static inline uint32_t __of1x_get_packet_size(datapacket_t *const pkt){
+	if(unlikely(pkt->__size_bytes == 0))
+		pkt->__size_bytes = platform_packet_get_size_bytes(pkt);
+	return pkt->__size_bytes;
+}
+
+//Packet size has changed (push/pop)
+static inline void __of1x_invalidate_packet_size(datapacket_t *const pkt){
+	pkt->__size_bytes = 0;
+}
+
 //Initialize (clear) pkt write actions
 static inline void __of1x_init_packet_write_actions(of1x_write_actions_t* pkt_write_actions){
 	bitmap128_clean(&pkt_write_actions->bitmap);
@@ -75,6 +91,12 @@ static inline void __of1x_update_packet_write_actions(of1x_write_actions_t* pack
 		packet_write_actions->actions[j].__field = entry_write_actions->actions[j].__field;
 		packet_write_actions->actions[j].group = entry_write_actions->actions[j].group;
 		packet_write_actions->actions[j].type = entry_write_actions->actions[j].type;
+		packet_write_actions->actions[j].__output_dst = entry_write_actions->actions[j].__output_dst;
+		if(unlikely(j == OF1X_AT_EXPERIMENTER)){
+			packet_write_actions->actions[j].experimenter_id = entry_write_actions->actions[j].experimenter_id;
+			packet_write_actions->actions[j].exp_type = entry_write_actions->actions[j].exp_type;
+			packet_write_actions->actions[j].__exp_fn = entry_write_actions->actions[j].__exp_fn;
+		}
 		
 		if(!bitmap128_is_bit_set(&packet_write_actions->bitmap,j)){
 			packet_write_actions->num_of_actions++;
@@ -97,6 +119,8 @@ static inline void __of1x_process_apply_actions(const unsigned int tid, const st
 static inline void __of1x_process_group_actions(const unsigned int tid, const struct of1x_switch* sw, const unsigned int table_id, datapacket_t *pkt, uint64_t field, of1x_group_t *group, bool replicate_pkts){
 	datapacket_t* pkt_replica;
 	of1x_bucket_t *it_bk;
+	//The packet may be consumed by the bucket actions
+	uint32_t size_bytes = __of1x_get_packet_size(pkt);
 	
 	platform_rwlock_rdlock(group->rwlock);
 	
@@ -112,6 +136,7 @@ static inline void __of1x_process_group_actions(const unsigned int tid, const st
 
 				//Clone the packet according to spec before applying the bucket
 				//action list
+				__of1x_commit_checksum_deltas(pkt);
 				pkt_replica = platform_packet_replicate(pkt);
 				if(unlikely(pkt_replica == NULL)){
 					assert(0);
@@ -120,7 +145,7 @@ static inline void __of1x_process_group_actions(const unsigned int tid, const st
 				
 				//Process all actions in the bucket
 				__of1x_process_apply_actions(tid, sw, table_id, pkt_replica, it_bk->actions, it_bk->actions->num_of_output_actions > 1, NULL); //No replica
-				__of1x_stats_bucket_update(tid, &it_bk->stats, platform_packet_get_size_bytes(pkt));
+				__of1x_stats_bucket_update(tid, &it_bk->stats, size_bytes);
 				
 				if(it_bk->actions->num_of_output_actions > 1)
 					platform_packet_drop(pkt_replica);
@@ -133,7 +158,7 @@ static inline void __of1x_process_group_actions(const unsigned int tid, const st
 		case OF1X_GROUP_TYPE_INDIRECT:
 			//executes the "one bucket defined"
 			__of1x_process_apply_actions(tid, sw,table_id,pkt,group->bc_list->head->actions, replicate_pkts, NULL);
-			__of1x_stats_bucket_update(tid, &group->bc_list->head->stats, platform_packet_get_size_bytes(pkt));
+			__of1x_stats_bucket_update(tid, &group->bc_list->head->stats, size_bytes);
 			break;
 		case OF1X_GROUP_TYPE_FF:
 			//NOT SUPPORTED
@@ -144,41 +169,98 @@ static inline void __of1x_process_group_actions(const unsigned int tid, const st
 			break;
 	}
 	
-	__of1x_stats_group_update(tid, &group->stats, platform_packet_get_size_bytes(pkt));
+	__of1x_stats_group_update(tid, &group->stats, size_bytes);
 	platform_rwlock_rdunlock(group->rwlock);
 
 }
 
+#ifdef ROFL_PIPELINE_FLOOD_EXPANSION
+/*
+* Output the packet to the ports of a set (FLOOD, ALL) except the incoming port,
+* if any (e.g. packet-outs may have none). The last port consumes the packet.
+*/
+static inline void __of1x_output_port_set(const unsigned int tid, const struct of1x_switch* sw, datapacket_t* pkt, const of1x_port_set_t* set){
+
+	unsigned int i, port_num, num_of_ports;
+	uint32_t* port_in;
+	switch_port_t *port, *prev = NULL;
+	datapacket_t* replica;
+
+	port_in = platform_packet_get_port_in(pkt);
+	num_of_ports = set->num_of_ports;
+
+	for(i=0;i<num_of_ports;i++){
+		port_num = set->port_nums[i];
+		port = sw->logical_ports[port_num].port;
+
+		if(unlikely((port_in && port_num == *port_in) || port == NULL))
+			continue;
+
+		//Output a replica to the previous port
+		if(prev){
+#ifdef ROFL_PIPELINE_SHARED_REPLICAS
+			replica = platform_packet_replicate_shared(pkt);
+#else
+			replica = platform_packet_replicate(pkt);
+#endif
+			if(likely(replica != NULL)){
+				replica->__cookie = pkt->__cookie;
+				__of1x_tx_burst_output(tid, sw, replica, prev);
+			}else{
+				ROFL_PIPELINE_INFO("Packet[%p] could NOT be cloned during FLOOD/ALL output\n", pkt);
+			}
+		}
+		prev = port;
+	}
+
+	if(prev)
+		__of1x_tx_burst_output(tid, sw, pkt, prev);
+	else
+		platform_packet_drop(pkt);
+}
+#endif //ROFL_PIPELINE_FLOOD_EXPANSION
+
 /* Contains switch with all the different action functions */
-static inline void __of1x_process_packet_action(const unsigned int tid, const struct of1x_switch* sw, const unsigned int table_id, datapacket_t* pkt, of1x_packet_action_t* action, bool replicate_pkts, datapacket_t** reinject_pkt){
+static inline void __of1x_process_packet_action(const unsigned int tid, const struct of1x_switch* sw, const unsigned int table_id, datapacket_t* pkt, const of1x_packet_action_t* action, bool replicate_pkts, datapacket_t** reinject_pkt){
+
+	uint32_t port_id, *port_in;
 
-	uint32_t port_id;
+	//Deferred set-fields
+	if(__of1x_prepare_packet_action(pkt, action))
+		return;
 
 	switch(action->type){
 		case OF1X_AT_NO_ACTION: assert(0);
 			break;
 
-		case OF1X_AT_COPY_TTL_IN: platform_packet_copy_ttl_in(pkt);
+		case OF1X_AT_COPY_TTL_IN:
+			//Platform updates the IPv4 checksum
+			__of1x_commit_checksum_deltas(pkt);
+			platform_packet_copy_ttl_in(pkt);
 			break;
 
 		//POP
 		case OF1X_AT_POP_VLAN: 
 			//Call platform
 			platform_packet_pop_vlan(pkt);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 		case OF1X_AT_POP_MPLS: 
 			//Call platform
 			platform_packet_pop_mpls(pkt, action->__field.u16);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 	
 		//PUSH
 		case OF1X_AT_PUSH_MPLS:
 			//Call platform
 			platform_packet_push_mpls(pkt, action->__field.u16);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 		case OF1X_AT_PUSH_VLAN:
 			//Call platform
 			platform_packet_push_vlan(pkt, action->__field.u16);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 
 		//TTL
@@ -187,6 +269,7 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			platform_packet_copy_ttl_out(pkt);
 			break;
 		case OF1X_AT_DEC_NW_TTL:
+			__of1x_checksum_dec_nw_ttl(pkt);
 			//Call platform
 			platform_packet_dec_nw_ttl(pkt);
 			break;
@@ -199,6 +282,8 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			platform_packet_set_mpls_ttl(pkt, action->__field.u8);
 			break;
 		case OF1X_AT_SET_NW_TTL:
+			//Platform updates the IPv4 checksum
+			__of1x_commit_checksum_deltas(pkt);
 			//Call platform
 			platform_packet_set_nw_ttl(pkt, action->__field.u8);
 			break;
@@ -229,6 +314,7 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			if(sw->of_ver == OF_VERSION_10 && !platform_packet_has_vlan(pkt)){
 				//Push VLAN
 				platform_packet_push_vlan(pkt, ETH_TYPE_8021Q);
+				__of1x_invalidate_packet_size(pkt);
 				platform_packet_set_vlan_pcp(pkt, 0x0);
 			}
 			//Call platform
@@ -239,6 +325,7 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			if(sw->of_ver == OF_VERSION_10 && !platform_packet_has_vlan(pkt)){
 				//Push VLAN
 				platform_packet_push_vlan(pkt, ETH_TYPE_8021Q);
+				__of1x_invalidate_packet_size(pkt);
 				platform_packet_set_vlan_vid(pkt, 0x0);
 			}
 			//Call platform
@@ -270,6 +357,8 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 		//NW
 		case OF1X_AT_SET_FIELD_NW_PROTO:
 			if(*platform_packet_get_eth_type(pkt) == ETH_TYPE_IPV4){
+				//Platform updates the checksums (pseudo-header)
+				__of1x_commit_checksum_deltas(pkt);
 				//Call platform
 				platform_packet_set_ip_proto(pkt, action->__field.u8);
 			}else if(*platform_packet_get_eth_type(pkt) == ETH_TYPE_ARP){
@@ -280,6 +369,7 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			break;
 		case OF1X_AT_SET_FIELD_NW_SRC:
 			if(*platform_packet_get_eth_type(pkt) == ETH_TYPE_IPV4){
+				__of1x_checksum_ipv4_src(pkt, action->__field.u32);
 				//Call platform
 				platform_packet_set_ipv4_src(pkt, action->__field.u32);
 			}else if(*platform_packet_get_eth_type(pkt) == ETH_TYPE_ARP){
@@ -289,6 +379,7 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			break;
 		case OF1X_AT_SET_FIELD_NW_DST:
 			if(*platform_packet_get_eth_type(pkt) == ETH_TYPE_IPV4){
+				__of1x_checksum_ipv4_dst(pkt, action->__field.u32);
 				//Call platform
 				platform_packet_set_ipv4_dst(pkt, action->__field.u32);
 			}else if(*platform_packet_get_eth_type(pkt) == ETH_TYPE_ARP){
@@ -299,24 +390,30 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 
 		//IP
 		case OF1X_AT_SET_FIELD_IP_DSCP:
+			__of1x_checksum_ip_dscp(pkt, action->__field.u8);
 			//Call platform
 			platform_packet_set_ip_dscp(pkt, action->__field.u8);
 			break;
 		case OF1X_AT_SET_FIELD_IP_ECN:
+			__of1x_checksum_ip_ecn(pkt, action->__field.u8);
 			//Call platform
 			platform_packet_set_ip_ecn(pkt, action->__field.u8);
 			break;
 		case OF1X_AT_SET_FIELD_IP_PROTO:
+			//Platform updates the checksums (pseudo-header)
+			__of1x_commit_checksum_deltas(pkt);
 			//Call platform
 			platform_packet_set_ip_proto(pkt, action->__field.u8);
 			break;
 
 		//IPv4
 		case OF1X_AT_SET_FIELD_IPV4_SRC:
+			__of1x_checksum_ipv4_src(pkt, action->__field.u32);
 			//Call platform
 			platform_packet_set_ipv4_src(pkt, action->__field.u32);
 			break;
 		case OF1X_AT_SET_FIELD_IPV4_DST:
+			__of1x_checksum_ipv4_dst(pkt, action->__field.u32);
 			//Call platform
 			platform_packet_set_ipv4_dst(pkt, action->__field.u32);
 			break;
@@ -324,9 +421,11 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 		//TP
 		case OF1X_AT_SET_FIELD_TP_SRC:  
 			if(*platform_packet_get_ip_proto(pkt) == IP_PROTO_TCP){
+				__of1x_checksum_tcp_src(pkt, action->__field.u16);
 				//Call platform
 				platform_packet_set_tcp_src(pkt, action->__field.u16);
 			}else if(*platform_packet_get_ip_proto(pkt) == IP_PROTO_UDP){
+				__of1x_checksum_udp_src(pkt, action->__field.u16);
 				//Call platform
 				platform_packet_set_udp_src(pkt, action->__field.u16);
 			}else if(*platform_packet_get_ip_proto(pkt) == IP_PROTO_ICMPV4){
@@ -336,9 +435,11 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			break;
 		case OF1X_AT_SET_FIELD_TP_DST:
 			if(*platform_packet_get_ip_proto(pkt) == IP_PROTO_TCP){
+				__of1x_checksum_tcp_dst(pkt, action->__field.u16);
 				//Call platform
 				platform_packet_set_tcp_dst(pkt, action->__field.u16);
 			}else if(*platform_packet_get_ip_proto(pkt) == IP_PROTO_UDP){
+				__of1x_checksum_udp_dst(pkt, action->__field.u16);
 				//Call platform
 				platform_packet_set_udp_dst(pkt, action->__field.u16);
 			}else if(*platform_packet_get_ip_proto(pkt) == IP_PROTO_ICMPV4){
@@ -349,20 +450,24 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 
 		//TCP
 		case OF1X_AT_SET_FIELD_TCP_SRC:  
+			__of1x_checksum_tcp_src(pkt, action->__field.u16);
 			//Call platform
 			platform_packet_set_tcp_src(pkt, action->__field.u16);
 			break;
 		case OF1X_AT_SET_FIELD_TCP_DST:
+			__of1x_checksum_tcp_dst(pkt, action->__field.u16);
 			//Call platform
 			platform_packet_set_tcp_dst(pkt, action->__field.u16);
 			break;
 
 		//UDP
 		case OF1X_AT_SET_FIELD_UDP_SRC:
+			__of1x_checksum_udp_src(pkt, action->__field.u16);
 			//Call platform
 			platform_packet_set_udp_src(pkt, action->__field.u16);
 			break;
 		case OF1X_AT_SET_FIELD_UDP_DST:
+			__of1x_checksum_udp_dst(pkt, action->__field.u16);
 			//Call platform
 			platform_packet_set_udp_dst(pkt, action->__field.u16);
 			break;
@@ -447,10 +552,12 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 		case OF1X_AT_POP_PPPOE:
 			//Call platform
 			platform_packet_pop_pppoe(pkt, action->__field.u16);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 		case OF1X_AT_PUSH_PPPOE:
 			//Call platform
 			platform_packet_push_pppoe(pkt, action->__field.u16);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 
 		//PPPoE
@@ -483,12 +590,18 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			platform_packet_set_gtp_teid(pkt, action->__field.u32);
 			break;
 		case OF1X_AT_POP_GTP: 
+			//Outer IPv4 header changes
+			__of1x_commit_checksum_deltas(pkt);
 			//Call platform
 			platform_packet_pop_gtp(pkt, action->__field.u16);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 		case OF1X_AT_PUSH_GTP: 
+			//Outer IPv4 header changes
+			__of1x_commit_checksum_deltas(pkt);
 			//Call platform
 			platform_packet_push_gtp(pkt, action->__field.u16);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 
 		//CAPWAP
@@ -505,12 +618,18 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			platform_packet_set_capwap_flags(pkt, action->__field.u16);
 			break;
 		case OF1X_AT_POP_CAPWAP:
+			//Outer IPv4 header changes
+			__of1x_commit_checksum_deltas(pkt);
 			//Call platform
 			platform_packet_pop_capwap(pkt);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 		case OF1X_AT_PUSH_CAPWAP:
+			//Outer IPv4 header changes
+			__of1x_commit_checksum_deltas(pkt);
 			//Call platform
 			platform_packet_push_capwap(pkt);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 
 		//IEEE80211 WLAN
@@ -545,10 +664,12 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 		case OF1X_AT_POP_WLAN:
 			//Call platform
 			platform_packet_pop_wlan(pkt);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 		case OF1X_AT_PUSH_WLAN:
 			//Call platform
 			platform_packet_push_wlan(pkt);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 
 		//GRE
@@ -565,12 +686,18 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			platform_packet_set_gre_key(pkt, action->__field.u32);
 			break;
 		case OF1X_AT_POP_GRE:
+			//Outer IPv4 header changes
+			__of1x_commit_checksum_deltas(pkt);
 			//Call platform
 			platform_packet_pop_gre(pkt, action->__field.u16);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 		case OF1X_AT_PUSH_GRE:
+			//Outer IPv4 header changes
+			__of1x_commit_checksum_deltas(pkt);
 			//Call platform
 			platform_packet_push_gre(pkt, action->__field.u16);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 
 #else
@@ -613,10 +740,12 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 		case OF1X_AT_POP_PBB: 
 			//Call platform
 			platform_packet_pop_pbb(pkt);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 		case OF1X_AT_PUSH_PBB: 
 			//Call platform
 			platform_packet_push_pbb(pkt, action->__field.u16);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 
 		//TUNNEL ID
@@ -629,20 +758,35 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			__of1x_process_group_actions(tid, sw, table_id, pkt, action->__field.u32, action->group, replicate_pkts);
 			break;
 
-		case OF1X_AT_EXPERIMENTER: //FIXME: implement
+		case OF1X_AT_EXPERIMENTER:
+			//Unresolved handler (never validated); skip it
+			if(unlikely(action->__exp_fn == NULL))
+				break;
+			//The handler may mangle the packet
+			__of1x_commit_checksum_deltas(pkt);
+			action->__exp_fn(tid, sw, table_id, pkt, action);
+			__of1x_invalidate_packet_size(pkt);
 			break;
 
 		case OF1X_AT_OUTPUT: 
 
 			//Store in automatic
 			port_id = action->__field.u32;
+
+			//Apply pending checksum deltas before the packet is cloned or sent
+			__of1x_commit_checksum_deltas(pkt);
 	
 			//Pointer for the packet to be sent
 			datapacket_t* pkt_to_send;			
 
 			//Duplicate the packet only if necessary
 			if(replicate_pkts){
+#ifdef ROFL_PIPELINE_SHARED_REPLICAS
+				//The replica is output right away (not mangled)
+				pkt_to_send = platform_packet_replicate_shared(pkt);
+#else
 				pkt_to_send = platform_packet_replicate(pkt);
+#endif
 			
 				//check for wrong copy
 				if(unlikely(pkt_to_send == NULL)){
@@ -655,59 +799,81 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 			}else
 				pkt_to_send = pkt;
 
-			//Perform output
-			if( port_id < LOGICAL_SWITCH_MAX_LOG_PORTS && unlikely(NULL != sw->logical_ports[port_id].port) ){
-
-				//Single port output
-				//According to the spec a packet cannot be sent to the incoming port
-				//unless IN_PORT meta port is used
-				if(unlikely(port_id == *platform_packet_get_port_in(pkt))){
-					ROFL_PIPELINE_DEBUG("Packet[%p] dropped. Attempting to output to the incoming port %u\n", pkt_to_send, port_id);
-					platform_packet_drop(pkt_to_send);
-				}else{
+			//Perform output (destination classified on action creation)
+			switch(action->__output_dst){
+				case OF1X_OUTPUT_DST_PORT:
+					if(unlikely(port_id >= LOGICAL_SWITCH_MAX_LOG_PORTS || NULL == sw->logical_ports[port_id].port))
+						goto OUTPUT_UNKNOWN;
+
+					//Single port output
+					//According to the spec a packet cannot be sent to the incoming port
+					//unless IN_PORT meta port is used
+					port_in = platform_packet_get_port_in(pkt);
+					if(unlikely(port_in && port_id == *port_in)){
+						ROFL_PIPELINE_DEBUG("Packet[%p] dropped. Attempting to output to the incoming port %u\n", pkt_to_send, port_id);
+						platform_packet_drop(pkt_to_send);
+					}else{
 #ifdef DEBUG
-                    			dump_packet_matches(pkt_to_send, false);
+						dump_packet_matches(pkt_to_send, false);
 #endif
-					ROFL_PIPELINE_INFO("Packet[%p] outputting to port num. %u\n", pkt_to_send, port_id);
-					platform_packet_output(pkt_to_send, sw->logical_ports[port_id].port);
-				}
-
-			}else if(port_id == OF1X_PORT_FLOOD){
-				//Flood
-				ROFL_PIPELINE_INFO("Packet[%p] outputting to FLOOD\n", pkt_to_send);
-				platform_packet_output(pkt_to_send, flood_meta_port);
-			}else if(port_id == OF1X_PORT_CONTROLLER ||
-				port_id == OF1X_PORT_NORMAL){
-				//Controller
-				ROFL_PIPELINE_INFO("Packet[%p] outputting to CONTROLLER\n", pkt_to_send);
-				platform_of1x_packet_in(sw, table_id, pkt_to_send, action->send_len, OF1X_PKT_IN_ACTION);
-			}else if(port_id == OF1X_PORT_ALL){
-				//All
-				ROFL_PIPELINE_INFO("Packet[%p] outputting to ALL_PORT\n", pkt_to_send);
-				platform_packet_output(pkt_to_send, all_meta_port);
-			}else if(port_id == OF1X_PORT_IN_PORT){
-				//in port
-				ROFL_PIPELINE_INFO("Packet[%p] outputting to IN_PORT\n", pkt_to_send);
-				platform_packet_output(pkt_to_send, in_port_meta_port);
-			}else if(port_id == OF1X_PORT_TABLE){
-				if(likely(reinject_pkt != NULL)){
-					//OFPP_TABLE
-					ROFL_PIPELINE_INFO("Packet[%p] reinjecting pkt to the sw(%p) pipeline\n", sw, pkt_to_send);
-					*reinject_pkt = pkt_to_send; 
-					assert(action->next == NULL);
-					return;
-				}else{
-					ROFL_PIPELINE_INFO("ERROR: packet[%p->%p] trying to execute an output to meta-port 'TABLE' from a non-PKT_OUT action list.\n", pkt, pkt_to_send);
-					assert(0);	
-				}
-				platform_packet_output(pkt_to_send, in_port_meta_port);
-			}else{
-				//This condition can only happen when flowmods are left for ports that are non-existent anymore
-				//or port id has been corrupted
-				ROFL_PIPELINE_INFO("Packet[%p] WARNING output to UNKNOWN port %u. Dropping...\n", pkt_to_send, port_id);
-	
-				//Drop the pkt
-				platform_packet_drop(pkt_to_send);
+						ROFL_PIPELINE_INFO("Packet[%p] outputting to port num. %u\n", pkt_to_send, port_id);
+						__of1x_tx_burst_output(tid, sw, pkt_to_send, sw->logical_ports[port_id].port);
+					}
+					break;
+				case OF1X_OUTPUT_DST_FLOOD:
+					//Flood
+					ROFL_PIPELINE_INFO("Packet[%p] outputting to FLOOD\n", pkt_to_send);
+#ifdef ROFL_PIPELINE_FLOOD_EXPANSION
+					of1x_port_sets_read_begin(tid, sw);
+					__of1x_output_port_set(tid, sw, pkt_to_send, of1x_get_flood_port_set(sw));
+					of1x_port_sets_read_end(tid, sw);
+#else
+					platform_packet_output(pkt_to_send, flood_meta_port);
+#endif
+					break;
+				case OF1X_OUTPUT_DST_CONTROLLER:
+					//Controller
+					ROFL_PIPELINE_INFO("Packet[%p] outputting to CONTROLLER\n", pkt_to_send);
+					platform_of1x_packet_in(sw, table_id, pkt_to_send, action->send_len, OF1X_PKT_IN_ACTION);
+					break;
+				case OF1X_OUTPUT_DST_ALL:
+					//All
+					ROFL_PIPELINE_INFO("Packet[%p] outputting to ALL_PORT\n", pkt_to_send);
+#ifdef ROFL_PIPELINE_FLOOD_EXPANSION
+					of1x_port_sets_read_begin(tid, sw);
+					__of1x_output_port_set(tid, sw, pkt_to_send, of1x_get_all_port_set(sw));
+					of1x_port_sets_read_end(tid, sw);
+#else
+					platform_packet_output(pkt_to_send, all_meta_port);
+#endif
+					break;
+				case OF1X_OUTPUT_DST_IN_PORT:
+					//in port
+					ROFL_PIPELINE_INFO("Packet[%p] outputting to IN_PORT\n", pkt_to_send);
+					platform_packet_output(pkt_to_send, in_port_meta_port);
+					break;
+				case OF1X_OUTPUT_DST_TABLE:
+					if(likely(reinject_pkt != NULL)){
+						//OFPP_TABLE
+						ROFL_PIPELINE_INFO("Packet[%p] reinjecting pkt to the sw(%p) pipeline\n", sw, pkt_to_send);
+						*reinject_pkt = pkt_to_send; 
+						assert(action->next == NULL);
+						return;
+					}else{
+						ROFL_PIPELINE_INFO("ERROR: packet[%p->%p] trying to execute an output to meta-port 'TABLE' from a non-PKT_OUT action list.\n", pkt, pkt_to_send);
+						assert(0);	
+					}
+					platform_packet_output(pkt_to_send, in_port_meta_port);
+					break;
+				default:
+OUTPUT_UNKNOWN:
+					//This condition can only happen when flowmods are left for ports that are non-existent anymore
+					//or port id has been corrupted
+					ROFL_PIPELINE_INFO("Packet[%p] WARNING output to UNKNOWN port %u. Dropping...\n", pkt_to_send, port_id);
+		
+					//Drop the pkt
+					platform_packet_drop(pkt_to_send);
+					break;
 			}
 			break;
 	}
@@ -718,11 +884,44 @@ static inline void __of1x_process_packet_action(const unsigned int tid, const st
 //Process apply actions
 static inline void __of1x_process_apply_actions(const unsigned int tid, const struct of1x_switch* sw, const unsigned int table_id, datapacket_t* pkt, const of1x_action_group_t* apply_actions_group, bool replicate_pkts, datapacket_t** reinject_pkt){
 
-	of1x_packet_action_t* it;
+	const of1x_packet_action_t *it, *end;
+
+	if(likely(apply_actions_group->ops != NULL)){
+		//Compiled (contiguous) actions
+		end = apply_actions_group->ops + apply_actions_group->num_of_ops;
+		for(it=apply_actions_group->ops;it<end;it++)
+			__of1x_process_packet_action(tid, sw, table_id, pkt, it, replicate_pkts, reinject_pkt);
+	}else{
+		//Not validated
+		for(it=apply_actions_group->head;it;it=it->next){
+			__of1x_process_packet_action(tid, sw, table_id, pkt, it, replicate_pkts, reinject_pkt);
+		}
+	}
+
+}
+
+/*
+* Process apply actions (multiple outputs, ending with an OUTPUT), where the last
+* output consumes the packet, instead of sending a clone. The packet cannot be
+* accessed once processed.
+*/
+static inline void __of1x_process_apply_actions_consume_pkt(const unsigned int tid, const struct of1x_switch* sw, const unsigned int table_id, datapacket_t* pkt, const of1x_action_group_t* apply_actions_group){
+
+	const of1x_packet_action_t *it, *last;
+
+	if(likely(apply_actions_group->ops != NULL)){
+		//Compiled (contiguous) actions
+		last = apply_actions_group->ops + apply_actions_group->num_of_ops - 1;
+		for(it=apply_actions_group->ops;it<last;it++)
+			__of1x_process_packet_action(tid, sw, table_id, pkt, it, true, NULL);
+	}else{
+		//Not validated
+		last = apply_actions_group->tail;
+		for(it=apply_actions_group->head;it!=last;it=it->next)
+			__of1x_process_packet_action(tid, sw, table_id, pkt, it, true, NULL);
+	}
 
-	for(it=apply_actions_group->head;it;it=it->next){
-		__of1x_process_packet_action(tid, sw, table_id, pkt, it, replicate_pkts, reinject_pkt);
-	}	
+	__of1x_process_packet_action(tid, sw, table_id, pkt, last, false, NULL);
 }
 
 /*
@@ -0,0 +1,59 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __OF1X_CHECKSUM_H__
+#define __OF1X_CHECKSUM_H__
+
+#include <inttypes.h>
+#include "rofl_datapath.h"
+
+/**
+* @file of1x_checksum.h
+*
+* @brief OpenFlow v1.0, 1.2 and 1.3.2 incremental checksum deltas
+*
+* When compiled with --with-pipeline-incremental-checksums, the pipeline
+* accumulates, for every header word m rewritten to m' by a set-field action,
+* the one's complement sum of ~m + m' (RFC 1624), and the platform applies it
+* once via platform_packet_update_checksums(), instead of updating the
+* checksums on every rewrite.
+*
+* Words are taken as they lay in the packet (NBO), so the deltas can be
+* directly applied to the checksum fields of the packet.
+*/
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+/**
+* @ingroup core_of1x
+* Pending checksum deltas of a packet (not folded)
+*/
+typedef struct of1x_checksum_deltas{
+	uint32_t l3;	//IPv4 header checksum
+	uint32_t l4;	//TCP/UDP checksum (including the pseudo-header)
+}of1x_checksum_deltas_t;
+
+/**
+* @ingroup core_of1x
+* Fold a (32 bit) one's complement sum
+*/
+static inline uint16_t of1x_checksum_fold(uint32_t sum){
+	sum = (sum & 0xFFFF) + (sum >> 16);
+	sum = (sum & 0xFFFF) + (sum >> 16);
+	return (uint16_t)sum;
+}
+
+/**
+* @ingroup core_of1x
+* Apply a delta to a checksum (RFC 1624, eqn. 3); HC' = ~(~HC + delta)
+*/
+static inline uint16_t of1x_checksum_apply_delta(uint16_t csum, uint16_t delta){
+	return (uint16_t)~of1x_checksum_fold((uint16_t)~csum + (uint32_t)delta);
+}
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //OF1X_CHECKSUM
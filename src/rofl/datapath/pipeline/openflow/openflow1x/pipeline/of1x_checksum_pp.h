@@ -0,0 +1,159 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __OF1X_CHECKSUM_PP_H__
+#define __OF1X_CHECKSUM_PP_H__
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "rofl_datapath.h"
+#include "../../../util/pp_guard.h" //Never forget to include the guard
+#include "../../../common/datapacket.h"
+#include "../../../common/endianness.h"
+#include "../../../common/protocol_constants.h"
+#include "../../../platform/likely.h"
+#include "../../../platform/packet.h"
+#include "of1x_checksum.h"
+
+/**
+* @file of1x_checksum_pp.h
+*
+* @brief Incremental checksum deltas (packet processing routines)
+*
+* The __of1x_checksum_xxx() calls MUST be done before the platform setter
+* of the field, so that the old value can be retrieved. They are no-ops if the
+* pipeline is not compiled with ROFL_PIPELINE_INCREMENTAL_CHECKSUMS.
+*
+* Pending deltas are committed before the packet leaves the pipeline
+* (output, packet-in), is replicated, and before any action that lets the
+* platform update the checksums on its own (e.g. set nw TTL).
+*/
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+//Initialize (clear) pkt checksum deltas
+static inline void __of1x_init_checksum_deltas(datapacket_t *const pkt){
+	pkt->checksum.of1x.l3 = pkt->checksum.of1x.l4 = 0x0;
+}
+
+//Account the rewrite of a 16 bit word (NBO)
+static inline void __of1x_checksum_delta16(uint32_t* acc, uint16_t old_val, uint16_t new_val){
+	*acc += (uint16_t)~old_val + (uint32_t)new_val;
+}
+
+//Account the rewrite of two (consecutive) 16 bit words (NBO)
+static inline void __of1x_checksum_delta32(uint32_t* acc, uint32_t old_val, uint32_t new_val){
+	__of1x_checksum_delta16(acc, old_val & 0xFFFF, new_val & 0xFFFF);
+	__of1x_checksum_delta16(acc, old_val >> 16, new_val >> 16);
+}
+
+//Commit pending deltas to the packet (platform)
+static inline void __of1x_commit_checksum_deltas(datapacket_t *const pkt){
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+	of1x_checksum_deltas_t* deltas = &pkt->checksum.of1x;
+
+	if(likely( (deltas->l3 | deltas->l4) == 0x0 ))
+		return;
+
+	platform_packet_update_checksums(pkt, of1x_checksum_fold(deltas->l3), of1x_checksum_fold(deltas->l4));
+	deltas->l3 = deltas->l4 = 0x0;
+#endif
+}
+
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+//IPv4 addresses are part of the header and of the TCP/UDP pseudo-header
+static inline void __of1x_checksum_ipv4_addr(datapacket_t *const pkt, uint32_t* old_addr, uint32_t new_addr){
+	uint8_t* ip_proto;
+
+	if(unlikely(old_addr == NULL))
+		return;
+
+	__of1x_checksum_delta32(&pkt->checksum.of1x.l3, *old_addr, new_addr);
+
+	ip_proto = platform_packet_get_ip_proto(pkt);
+	if(ip_proto && (*ip_proto == IP_PROTO_TCP || *ip_proto == IP_PROTO_UDP))
+		__of1x_checksum_delta32(&pkt->checksum.of1x.l4, *old_addr, new_addr);
+}
+
+//ToS is the second byte of the first IPv4 header word (no pseudo-header)
+static inline void __of1x_checksum_ip_tos(datapacket_t *const pkt, uint8_t old_tos, uint8_t new_tos){
+	uint16_t* eth_type = platform_packet_get_eth_type(pkt);
+
+	if(eth_type && *eth_type == ETH_TYPE_IPV4)
+		__of1x_checksum_delta16(&pkt->checksum.of1x.l3, HTONB16((uint16_t)old_tos), HTONB16((uint16_t)new_tos));
+}
+
+//TCP/UDP ports (no IPv4 header)
+static inline void __of1x_checksum_tp(datapacket_t *const pkt, uint16_t* old_port, uint16_t new_port){
+	if(likely(old_port != NULL))
+		__of1x_checksum_delta16(&pkt->checksum.of1x.l4, *old_port, new_port);
+}
+#endif
+
+static inline void __of1x_checksum_ipv4_src(datapacket_t *const pkt, uint32_t ip_src){
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+	__of1x_checksum_ipv4_addr(pkt, platform_packet_get_ipv4_src(pkt), ip_src);
+#endif
+}
+
+static inline void __of1x_checksum_ipv4_dst(datapacket_t *const pkt, uint32_t ip_dst){
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+	__of1x_checksum_ipv4_addr(pkt, platform_packet_get_ipv4_dst(pkt), ip_dst);
+#endif
+}
+
+//ip_dscp comes specially aligned (ToS position)
+static inline void __of1x_checksum_ip_dscp(datapacket_t *const pkt, uint8_t ip_dscp){
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+	uint8_t ecn = platform_packet_get_ip_ecn(pkt);
+	__of1x_checksum_ip_tos(pkt, platform_packet_get_ip_dscp(pkt) | ecn, ip_dscp | ecn);
+#endif
+}
+
+static inline void __of1x_checksum_ip_ecn(datapacket_t *const pkt, uint8_t ip_ecn){
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+	uint8_t dscp = platform_packet_get_ip_dscp(pkt);
+	__of1x_checksum_ip_tos(pkt, dscp | platform_packet_get_ip_ecn(pkt), dscp | ip_ecn);
+#endif
+}
+
+//TTL is the first byte of the TTL/proto word; decrementing it is a constant delta
+static inline void __of1x_checksum_dec_nw_ttl(datapacket_t *const pkt){
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+	uint16_t* eth_type = platform_packet_get_eth_type(pkt);
+
+	if(eth_type && *eth_type == ETH_TYPE_IPV4)
+		__of1x_checksum_delta16(&pkt->checksum.of1x.l3, HTONB16(0x0100), 0x0);
+#endif
+}
+
+static inline void __of1x_checksum_tcp_src(datapacket_t *const pkt, uint16_t tcp_src){
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+	__of1x_checksum_tp(pkt, platform_packet_get_tcp_src(pkt), tcp_src);
+#endif
+}
+
+static inline void __of1x_checksum_tcp_dst(datapacket_t *const pkt, uint16_t tcp_dst){
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+	__of1x_checksum_tp(pkt, platform_packet_get_tcp_dst(pkt), tcp_dst);
+#endif
+}
+
+static inline void __of1x_checksum_udp_src(datapacket_t *const pkt, uint16_t udp_src){
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+	__of1x_checksum_tp(pkt, platform_packet_get_udp_src(pkt), udp_src);
+#endif
+}
+
+static inline void __of1x_checksum_udp_dst(datapacket_t *const pkt, uint16_t udp_dst){
+#ifdef ROFL_PIPELINE_INCREMENTAL_CHECKSUMS
+	__of1x_checksum_tp(pkt, platform_packet_get_udp_dst(pkt), udp_dst);
+#endif
+}
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //OF1X_CHECKSUM_PP
@@ -0,0 +1,104 @@
+#include "of1x_experimenter.h"
+
+#include <stdbool.h>
+#include "../../../platform/likely.h"
+#include "../../../util/logging.h"
+
+//Registered handlers
+static of1x_experimenter_action_t actions[OF1X_MAX_EXPERIMENTER_HANDLERS];
+static unsigned int num_of_actions = 0;
+
+static of1x_experimenter_instruction_t instructions[OF1X_MAX_EXPERIMENTER_HANDLERS];
+static unsigned int num_of_instructions = 0;
+
+/*
+* Actions
+*/
+const of1x_experimenter_action_t* __of1x_get_experimenter_action(uint32_t experimenter_id, uint32_t exp_type){
+
+	unsigned int i;
+
+	for(i=0;i<num_of_actions;i++){
+		if(actions[i].experimenter_id == experimenter_id && actions[i].exp_type == exp_type)
+			return &actions[i];
+	}
+
+	return NULL;
+}
+
+rofl_result_t of1x_register_experimenter_action(const of1x_experimenter_action_t* handler){
+
+	if( unlikely(handler == NULL) || unlikely(handler->process == NULL) )
+		return ROFL_FAILURE;
+
+	if( __of1x_get_experimenter_action(handler->experimenter_id, handler->exp_type) != NULL ){
+		ROFL_PIPELINE_ERR("Experimenter action 0x%x:0x%x already registered\n", handler->experimenter_id, handler->exp_type);
+		return ROFL_FAILURE;
+	}
+
+	if( num_of_actions == OF1X_MAX_EXPERIMENTER_HANDLERS )
+		return ROFL_FAILURE;
+
+	actions[num_of_actions++] = *handler;
+
+	return ROFL_SUCCESS;
+}
+
+rofl_result_t of1x_unregister_experimenter_action(uint32_t experimenter_id, uint32_t exp_type){
+
+	const of1x_experimenter_action_t* handler = __of1x_get_experimenter_action(experimenter_id, exp_type);
+
+	if(!handler)
+		return ROFL_FAILURE;
+
+	//Compact
+	actions[handler-actions] = actions[--num_of_actions];
+
+	return ROFL_SUCCESS;
+}
+
+/*
+* Instructions
+*/
+const of1x_experimenter_instruction_t* __of1x_get_experimenter_instruction(uint32_t experimenter_id, uint32_t exp_type){
+
+	unsigned int i;
+
+	for(i=0;i<num_of_instructions;i++){
+		if(instructions[i].experimenter_id == experimenter_id && instructions[i].exp_type == exp_type)
+			return &instructions[i];
+	}
+
+	return NULL;
+}
+
+rofl_result_t of1x_register_experimenter_instruction(const of1x_experimenter_instruction_t* handler){
+
+	if( unlikely(handler == NULL) || unlikely(handler->process == NULL) )
+		return ROFL_FAILURE;
+
+	if( __of1x_get_experimenter_instruction(handler->experimenter_id, handler->exp_type) != NULL ){
+		ROFL_PIPELINE_ERR("Experimenter instruction 0x%x:0x%x already registered\n", handler->experimenter_id, handler->exp_type);
+		return ROFL_FAILURE;
+	}
+
+	if( num_of_instructions == OF1X_MAX_EXPERIMENTER_HANDLERS )
+		return ROFL_FAILURE;
+
+	instructions[num_of_instructions++] = *handler;
+
+	return ROFL_SUCCESS;
+}
+
+rofl_result_t of1x_unregister_experimenter_instruction(uint32_t experimenter_id, uint32_t exp_type){
+
+	const of1x_experimenter_instruction_t* handler = __of1x_get_experimenter_instruction(experimenter_id, exp_type);
+
+	if(!handler)
+		return ROFL_FAILURE;
+
+	//Compact
+	instructions[handler-instructions] = instructions[--num_of_instructions];
+
+	return ROFL_SUCCESS;
+}
@@ -0,0 +1,113 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __OF1X_EXPERIMENTER_H__
+#define __OF1X_EXPERIMENTER_H__
+
+#include <inttypes.h>
+#include "rofl_datapath.h"
+
+/**
+* @file of1x_experimenter.h
+*
+* @brief Experimenter actions and instructions registration API
+*
+* Experimenter actions (OF1X_AT_EXPERIMENTER) and instructions (OF1X_IT_EXPERIMENTER)
+* are identified by the pair (experimenter_id, exp_type). The handler of
+* the pair is looked up when the flow entry (or group) is validated, and the packet
+* path function pointer is stored in the (compiled) action or instruction. The
+* pipeline calls it directly, without any lookup per packet.
+*
+* Handlers MUST be registered before any flow entry or group using them is
+* installed, and MUST NOT be unregistered while in use. Registration is NOT thread-safe.
+*/
+
+#ifndef OF1X_MAX_EXPERIMENTER_HANDLERS
+	#define OF1X_MAX_EXPERIMENTER_HANDLERS 16 //Max. number of experimenter actions (and instructions)
+#endif
+
+//Fwd declarations
+struct datapacket;
+struct of1x_switch;
+struct of1x_packet_action;
+struct of1x_instruction;
+
+/**
+* @ingroup core_of1x
+* Packet path function of an experimenter action. The action field
+* (action->__field) and ids can be used as arguments of the action.
+*/
+typedef void (*of1x_experimenter_action_fn_t)(const unsigned int tid, const struct of1x_switch* sw, const unsigned int table_id, struct datapacket* pkt, const struct of1x_packet_action* action);
+
+/**
+* @ingroup core_of1x
+* Packet path function of an experimenter instruction.
+*/
+typedef void (*of1x_experimenter_instruction_fn_t)(const unsigned int tid, const struct of1x_switch* sw, const unsigned int table_id, struct datapacket* pkt, const struct of1x_instruction* inst);
+
+/**
+* @ingroup core_of1x
+* Experimenter action handler
+*/
+typedef struct of1x_experimenter_action{
+	uint32_t experimenter_id;
+	uint32_t exp_type;
+
+	//Validation hook (flow-mod time); optional
+	rofl_result_t (*validate)(const struct of1x_packet_action* action);
+
+	//Packet path
+	of1x_experimenter_action_fn_t process;
+}of1x_experimenter_action_t;
+
+/**
+* @ingroup core_of1x
+* Experimenter instruction handler
+*/
+typedef struct of1x_experimenter_instruction{
+	uint32_t experimenter_id;
+	uint32_t exp_type;
+
+	//Validation hook (flow-mod time); optional
+	rofl_result_t (*validate)(const struct of1x_instruction* inst);
+
+	//Packet path
+	of1x_experimenter_instruction_fn_t process;
+}of1x_experimenter_instruction_t;
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+/**
+* @brief Registers an experimenter action handler. The handler is copied.
+* @ingroup core_of1x
+*/
+rofl_result_t of1x_register_experimenter_action(const of1x_experimenter_action_t* handler);
+
+/**
+* @brief Unregisters an experimenter action handler.
+* @ingroup core_of1x
+*/
+rofl_result_t of1x_unregister_experimenter_action(uint32_t experimenter_id, uint32_t exp_type);
+
+/**
+* @brief Registers an experimenter instruction handler. The handler is copied.
+* @ingroup core_of1x
+*/
+rofl_result_t of1x_register_experimenter_instruction(const of1x_experimenter_instruction_t* handler);
+
+/**
+* @brief Unregisters an experimenter instruction handler.
+* @ingroup core_of1x
+*/
+rofl_result_t of1x_unregister_experimenter_instruction(uint32_t experimenter_id, uint32_t exp_type);
+
+//Lookup (validation time only)
+const of1x_experimenter_action_t* __of1x_get_experimenter_action(uint32_t experimenter_id, uint32_t exp_type);
+const of1x_experimenter_instruction_t* __of1x_get_experimenter_instruction(uint32_t experimenter_id, uint32_t exp_type);
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //OF1X_EXPERIMENTER
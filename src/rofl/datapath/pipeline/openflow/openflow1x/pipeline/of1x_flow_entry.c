@@ -122,10 +122,18 @@ rofl_result_t __of1x_update_flow_entry(of1x_flow_entry_t* entry_to_update, of1x_
 	//Copy instructions
 	__of1x_update_instructions(&entry_to_update->inst_grp, &mod->inst_grp);
 
+	//Output ports and groups may have changed
+	if(entry_to_update->table)
+		__of1x_flow_index_update(entry_to_update->table, entry_to_update);
+
 	//Reset counts
 	if(reset_counts){
 		__of1x_stats_flow_reset_counts(entry_to_update);
 		__of1x_reset_last_packet_count_idle_timeout(&entry_to_update->timer_info);
+
+		//Running aggregates
+		if(entry_to_update->table)
+			__of1x_stats_flow_aggregates_reset_entry(entry_to_update->table, entry_to_update);
 	}
 
 	//Update flags from the new modification flowmod
@@ -196,10 +204,12 @@ bool __of1x_flow_entry_check_overlap(of1x_flow_entry_t*const original, of1x_flow
 bool __of1x_flow_entry_check_contained(of1x_flow_entry_t*const original, of1x_flow_entry_t*const subentry, bool check_priority, bool check_cookie, uint32_t out_port, uint32_t out_group, bool reverse_out_check){
 
 	of1x_match_t* it_orig, *it_subentry;
+	of1x_flow_entry_t* filter = (reverse_out_check)? original : subentry; //The cookie (and mask) of the request
+	of1x_flow_entry_t* entry = (reverse_out_check)? subentry : original;
 	
 	//Check cookie first
-	if(check_cookie && subentry->cookie != OF1X_DO_NOT_CHECK_COOKIE && subentry->cookie_mask){
-		if( (subentry->cookie&subentry->cookie_mask) != (original->cookie&subentry->cookie_mask) )
+	if(check_cookie && filter->cookie != OF1X_DO_NOT_CHECK_COOKIE && filter->cookie_mask){
+		if( (filter->cookie&filter->cookie_mask) != (entry->cookie&filter->cookie_mask) )
 			return false;
 	}
 
@@ -29,6 +29,7 @@ struct of1x_pipeline;
 struct of1x_flow_table;
 struct of1x_timers_info;
 struct of1x_group_table;
+struct __of1x_flow_index_node;
 
 /**
 * Flow removal operations strictness
@@ -108,6 +109,12 @@ typedef struct of1x_flow_entry{
 	//statistics
 	of1x_stats_flow_t stats;
 
+	//Secondary index nodes (see of1x_flow_index.h)
+	struct __of1x_flow_index_node* __index_nodes;
+
+	//Insertion sequence number (table revision when inserted)
+	uint64_t __seq;
+
 	//RWlock
 	platform_rwlock_t* rwlock;
 
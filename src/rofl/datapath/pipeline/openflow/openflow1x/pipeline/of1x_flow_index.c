@@ -0,0 +1,353 @@
+#include "of1x_flow_index.h"
+
+#include <assert.h>
+#include "of1x_flow_table.h"
+#include "of1x_pipeline.h"
+#include "of1x_action.h"
+#include "of1x_instruction.h"
+#include "of1x_statistics.h"
+#include "matching_algorithms/matching_algorithms.h"
+#include "../of1x_switch.h"
+#include "../of1x_async_events_hooks.h"
+#include "../../../platform/memory.h"
+#include "../../../platform/likely.h"
+#include "../../../util/logging.h"
+
+#define OF1X_FLOW_INDEX_ALL_COOKIE_MASK 0xFFFFFFFFFFFFFFFFULL
+
+static inline unsigned int __of1x_flow_index_hash(uint64_t key){
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return (unsigned int)(key & (OF1X_FLOW_INDEX_BUCKETS-1));
+}
+
+static inline __of1x_flow_index_node_t** __of1x_flow_index_bucket(of1x_flow_index_t* index, enum of1x_flow_index_type type, uint64_t key){
+	return &index->buckets[type*OF1X_FLOW_INDEX_BUCKETS + __of1x_flow_index_hash(key)];
+}
+
+/*
+* Init and destroy
+*/
+rofl_result_t __of1x_flow_index_init(of1x_flow_index_t* index){
+
+	index->incomplete = false;
+	index->buckets = (__of1x_flow_index_node_t**)platform_malloc_shared(sizeof(__of1x_flow_index_node_t*)*OF1X_FLOW_INDEX_MAX*OF1X_FLOW_INDEX_BUCKETS);
+
+	if( unlikely(index->buckets == NULL) )
+		return ROFL_FAILURE;
+
+	platform_memset(index->buckets, 0, sizeof(__of1x_flow_index_node_t*)*OF1X_FLOW_INDEX_MAX*OF1X_FLOW_INDEX_BUCKETS);
+
+	return ROFL_SUCCESS;
+}
+
+void __of1x_flow_index_destroy(of1x_flow_index_t* index){
+
+	unsigned int i;
+	__of1x_flow_index_node_t *node, *next;
+
+	if(!index->buckets)
+		return;
+
+	//Entries may have already been destroyed; do not touch them
+	for(i=0;i<OF1X_FLOW_INDEX_MAX*OF1X_FLOW_INDEX_BUCKETS;i++){
+		for(node=index->buckets[i];node;node=next){
+			next = node->next;
+			platform_free_shared(node);
+		}
+	}
+
+	platform_free_shared(index->buckets);
+	index->buckets = NULL;
+}
+
+/*
+* Maintenance
+*/
+static void __of1x_flow_index_insert(of1x_flow_index_t* index, of1x_flow_entry_t* entry, enum of1x_flow_index_type type, uint64_t key){
+
+	__of1x_flow_index_node_t *node, **bucket;
+
+	//Only once per entry and key (e.g. several outputs to the same port)
+	for(node=entry->__index_nodes;node;node=node->entry_next){
+		if(node->type == type && node->key == key)
+			return;
+	}
+
+	node = (__of1x_flow_index_node_t*)platform_malloc_shared(sizeof(__of1x_flow_index_node_t));
+
+	if( unlikely(node == NULL) ){
+		ROFL_PIPELINE_ERR("Unable to index entry %p; out of memory. Disabling the secondary indexes of the table\n", entry);
+		index->incomplete = true;
+		return;
+	}
+
+	node->key = key;
+	node->type = type;
+	node->entry = entry;
+
+	//Bucket (head)
+	bucket = __of1x_flow_index_bucket(index, type, key);
+	node->prev = NULL;
+	node->next = *bucket;
+	if(*bucket)
+		(*bucket)->prev = node;
+	*bucket = node;
+
+	//Entry
+	node->entry_next = entry->__index_nodes;
+	entry->__index_nodes = node;
+}
+
+static void __of1x_flow_index_insert_actions(of1x_flow_index_t* index, of1x_flow_entry_t* entry){
+
+	of1x_packet_action_t* it;
+	of1x_action_group_t* apply_actions = entry->inst_grp.instructions[OF1X_IT_APPLY_ACTIONS].apply_actions;
+	of1x_write_actions_t* write_actions = entry->inst_grp.instructions[OF1X_IT_WRITE_ACTIONS].write_actions;
+
+	if(apply_actions){
+		for(it=apply_actions->head;it;it=it->next){
+			if(it->type == OF1X_AT_OUTPUT)
+				__of1x_flow_index_insert(index, entry, OF1X_FLOW_INDEX_OUT_PORT, it->__field.u32);
+			else if(it->type == OF1X_AT_GROUP)
+				__of1x_flow_index_insert(index, entry, OF1X_FLOW_INDEX_OUT_GROUP, it->__field.u32);
+		}
+	}
+
+	if(write_actions){
+		if(bitmap128_is_bit_set(&write_actions->bitmap, OF1X_AT_OUTPUT))
+			__of1x_flow_index_insert(index, entry, OF1X_FLOW_INDEX_OUT_PORT, write_actions->actions[OF1X_AT_OUTPUT].__field.u32);
+		if(bitmap128_is_bit_set(&write_actions->bitmap, OF1X_AT_GROUP))
+			__of1x_flow_index_insert(index, entry, OF1X_FLOW_INDEX_OUT_GROUP, write_actions->actions[OF1X_AT_GROUP].__field.u32);
+	}
+}
+
+void __of1x_flow_index_add(of1x_flow_table_t* table, of1x_flow_entry_t* entry){
+
+	of1x_flow_index_t* index = &table->index;
+
+	if( unlikely(index->buckets == NULL) )
+		return;
+
+	entry->__index_nodes = NULL;
+
+	__of1x_flow_index_insert(index, entry, OF1X_FLOW_INDEX_COOKIE, entry->cookie);
+	__of1x_flow_index_insert_actions(index, entry);
+}
+
+void __of1x_flow_index_remove(of1x_flow_table_t* table, of1x_flow_entry_t* entry){
+
+	__of1x_flow_index_node_t *node, *next;
+
+	if( unlikely(table->index.buckets == NULL) )
+		return;
+
+	for(node=entry->__index_nodes;node;node=next){
+		next = node->entry_next;
+
+		if(node->prev)
+			node->prev->next = node->next;
+		else
+			*__of1x_flow_index_bucket(&table->index, node->type, node->key) = node->next;
+		if(node->next)
+			node->next->prev = node->prev;
+
+		platform_free_shared(node);
+	}
+
+	entry->__index_nodes = NULL;
+}
+
+void __of1x_flow_index_update(of1x_flow_table_t* table, of1x_flow_entry_t* entry){
+	__of1x_flow_index_remove(table, entry);
+	__of1x_flow_index_add(table, entry);
+}
+
+/*
+* Indexed operations
+*/
+
+//Select the most selective index for the filter
+static bool __of1x_flow_index_select(of1x_flow_table_t* table, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, bool check_cookie, enum of1x_flow_index_type* type, uint64_t* key){
+
+	if( unlikely(table->index.buckets == NULL) || table->index.incomplete )
+		return false;
+
+	if(out_group != OF1X_GROUP_ANY){
+		*type = OF1X_FLOW_INDEX_OUT_GROUP;
+		*key = out_group;
+	}else if(out_port != OF1X_PORT_ANY){
+		*type = OF1X_FLOW_INDEX_OUT_PORT;
+		*key = out_port;
+	}else if(check_cookie && cookie != OF1X_DO_NOT_CHECK_COOKIE && cookie_mask == OF1X_FLOW_INDEX_ALL_COOKIE_MASK){
+		*type = OF1X_FLOW_INDEX_COOKIE;
+		*key = cookie;
+	}else{
+		return false;
+	}
+
+	return true;
+}
+
+bool __of1x_flow_index_get_flow_stats(of1x_flow_table_t* table, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, of1x_match_group_t* matches, of1x_stats_flow_msg_t* msg, rofl_result_t* result){
+
+	uint64_t key;
+	enum of1x_flow_index_type type;
+	__of1x_flow_index_node_t* node;
+	of1x_flow_entry_t flow_stats_entry;
+	of1x_stats_single_flow_msg_t* flow_stats;
+	bool check_cookie = ( table->pipeline->sw->of_ver != OF_VERSION_10 ); //Ignore cookie in OF1.0
+
+	*result = ROFL_SUCCESS;
+
+	platform_mutex_lock(table->mutex);
+
+	if(!__of1x_flow_index_select(table, cookie, cookie_mask, out_port, out_group, check_cookie, &type, &key)){
+		platform_mutex_unlock(table->mutex);
+		return false;
+	}
+
+	//Create a flow_stats_entry
+	platform_memset(&flow_stats_entry,0,sizeof(of1x_flow_entry_t));
+	flow_stats_entry.matches = *matches;
+	flow_stats_entry.cookie = cookie;
+	flow_stats_entry.cookie_mask = cookie_mask;
+
+	for(node=*__of1x_flow_index_bucket(&table->index, type, key);node;node=node->next){
+
+		if(node->type != type || node->key != key)
+			continue;
+
+		//Check if is contained
+		if(!__of1x_flow_entry_check_contained(&flow_stats_entry, node->entry, false, check_cookie, out_port, out_group, true))
+			continue;
+
+		// update statistics from platform
+		platform_of1x_update_stats_hook(node->entry);
+
+		flow_stats = __of1x_init_stats_single_flow_msg(node->entry);
+
+		if(!flow_stats){
+			*result = ROFL_FAILURE;
+			break;
+		}
+
+		__of1x_push_single_flow_stats_to_msg(msg, flow_stats);
+	}
+
+	platform_mutex_unlock(table->mutex);
+
+	return true;
+}
+
+bool __of1x_flow_index_get_flow_aggregate_stats(of1x_flow_table_t* table, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, of1x_match_group_t* matches, of1x_stats_flow_aggregate_msg_t* msg){
+
+	uint64_t key;
+	enum of1x_flow_index_type type;
+	__of1x_flow_index_node_t* node;
+	of1x_flow_entry_t flow_stats_entry;
+	__of1x_stats_flow_tid_t c;
+	bool check_cookie = ( table->pipeline->sw->of_ver != OF_VERSION_10 ); //Ignore cookie in OF1.0
+
+	platform_mutex_lock(table->mutex);
+
+	if(!__of1x_flow_index_select(table, cookie, cookie_mask, out_port, out_group, check_cookie, &type, &key)){
+		platform_mutex_unlock(table->mutex);
+		return false;
+	}
+
+	//Create a flow_stats_entry
+	platform_memset(&flow_stats_entry,0,sizeof(of1x_flow_entry_t));
+	flow_stats_entry.matches = *matches;
+	flow_stats_entry.cookie = cookie;
+	flow_stats_entry.cookie_mask = cookie_mask;
+
+	for(node=*__of1x_flow_index_bucket(&table->index, type, key);node;node=node->next){
+
+		if(node->type != type || node->key != key)
+			continue;
+
+		//Check if is contained
+		if(!__of1x_flow_entry_check_contained(&flow_stats_entry, node->entry, false, check_cookie, out_port, out_group, true))
+			continue;
+
+		//Consolidate stats
+		__of1x_stats_flow_consolidate(&node->entry->stats, &c);
+
+		msg->packet_count += c.packet_count;
+		msg->byte_count += c.byte_count;
+		msg->flow_count++;
+	}
+
+	platform_mutex_unlock(table->mutex);
+
+	return true;
+}
+
+bool __of1x_flow_index_remove_flow_entries(of1x_flow_table_t* table, of1x_flow_entry_t* entry, uint32_t out_port, uint32_t out_group, of1x_flow_remove_reason_t reason, rofl_of1x_fm_result_t* result){
+
+	uint64_t key;
+	unsigned int i, num_of_entries = 0;
+	enum of1x_flow_index_type type;
+	__of1x_flow_index_node_t* node;
+	of1x_flow_entry_t **entries, empty;
+	bool check_cookie = ( table->pipeline->sw->of_ver != OF_VERSION_10 ); //Ignore cookie in OF1.0
+
+	*result = ROFL_OF1X_FM_SUCCESS;
+
+	//No matches nor cookie
+	if(!entry){
+		platform_memset(&empty, 0, sizeof(of1x_flow_entry_t));
+		entry = &empty;
+	}
+
+	//Allow single add/remove operation over the table
+	platform_mutex_lock(table->mutex);
+
+	if(!__of1x_flow_index_select(table, entry->cookie, entry->cookie_mask, out_port, out_group, check_cookie, &type, &key)){
+		platform_mutex_unlock(table->mutex);
+		return false;
+	}
+
+	//Removal modifies the bucket; collect the entries first
+	for(node=*__of1x_flow_index_bucket(&table->index, type, key);node;node=node->next){
+		if(node->type == type && node->key == key)
+			num_of_entries++;
+	}
+
+	if(num_of_entries == 0){
+		platform_mutex_unlock(table->mutex);
+		return true;
+	}
+
+	entries = (of1x_flow_entry_t**)platform_malloc_shared(sizeof(of1x_flow_entry_t*)*num_of_entries);
+
+	if( unlikely(entries == NULL) ){
+		platform_mutex_unlock(table->mutex);
+		return false;
+	}
+
+	num_of_entries = 0;
+	for(node=*__of1x_flow_index_bucket(&table->index, type, key);node;node=node->next){
+		if(node->type != type || node->key != key)
+			continue;
+
+		if(__of1x_flow_entry_check_contained(node->entry, entry, false, check_cookie, out_port, out_group, false))
+			entries[num_of_entries++] = node->entry;
+	}
+
+	for(i=0;i<num_of_entries;i++){
+		if(of1x_matching_algorithms[table->matching_algorithm].remove_flow_entry_hook(table, NULL, entries[i], STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY, reason, MUTEX_ALREADY_ACQUIRED_NON_STRICT_SEARCH) != ROFL_OF1X_FM_SUCCESS){
+			assert(0); //This should never happen
+			*result = ROFL_OF1X_FM_FAILURE;
+			break;
+		}
+	}
+
+	platform_mutex_unlock(table->mutex);
+
+	platform_free_shared(entries);
+
+	return true;
+}
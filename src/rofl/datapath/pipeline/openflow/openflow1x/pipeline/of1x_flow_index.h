@@ -0,0 +1,103 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __OF1X_FLOW_INDEX_H__
+#define __OF1X_FLOW_INDEX_H__
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "rofl_datapath.h"
+#include "of1x_utils.h"
+#include "of1x_flow_entry.h"
+
+/**
+* @file of1x_flow_index.h
+*
+* @brief Secondary indexes of the flow entries of a table
+*
+* Each table keeps hashed indexes from the cookie, the output ports and the
+* referenced groups of its entries to the entries themselves. Flow stats requests,
+* non-strict deletes filtered by out port, out group or exact cookie, and group
+* deletion only visit the entries indexed under the key, instead of the whole table.
+*
+* The indexes are protected by the table mutex. Matching algorithms MUST call
+* __of1x_flow_index_add() when an entry is linked to the table and
+* __of1x_flow_index_remove() when it is unlinked. Entries are re-indexed
+* when their instructions are modified (__of1x_update_flow_entry()).
+*
+* If an entry cannot be indexed (out of memory), the indexes of the table are
+* no longer used, and the operations fall back to the matching algorithm.
+*/
+
+#ifndef OF1X_FLOW_INDEX_BUCKETS
+	#define OF1X_FLOW_INDEX_BUCKETS 1024 //Buckets per index; MUST be a power of 2
+#endif
+
+//Indexes
+enum of1x_flow_index_type{
+	OF1X_FLOW_INDEX_COOKIE = 0,
+	OF1X_FLOW_INDEX_OUT_PORT,
+	OF1X_FLOW_INDEX_OUT_GROUP,
+
+	OF1X_FLOW_INDEX_MAX
+};
+
+//Fwd declarations
+struct of1x_flow_table;
+struct of1x_match_group;
+struct of1x_stats_flow_msg;
+struct of1x_stats_flow_aggregate_msg;
+
+//Index node; one per entry and key
+typedef struct __of1x_flow_index_node{
+	uint64_t key;
+	enum of1x_flow_index_type type;
+	struct of1x_flow_entry* entry;
+
+	//Bucket chain
+	struct __of1x_flow_index_node* prev;
+	struct __of1x_flow_index_node* next;
+
+	//Nodes of the same entry
+	struct __of1x_flow_index_node* entry_next;
+}__of1x_flow_index_node_t;
+
+/**
+* @ingroup core_of1x
+* Secondary indexes of a table
+*/
+typedef struct of1x_flow_index{
+	//Buckets [OF1X_FLOW_INDEX_MAX][OF1X_FLOW_INDEX_BUCKETS]
+	__of1x_flow_index_node_t** buckets;
+
+	//An entry could not be indexed; indexes are not used
+	bool incomplete;
+}of1x_flow_index_t;
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+//Init and destroy
+rofl_result_t __of1x_flow_index_init(of1x_flow_index_t* index);
+void __of1x_flow_index_destroy(of1x_flow_index_t* index);
+
+//Maintenance (table mutex MUST be held)
+void __of1x_flow_index_add(struct of1x_flow_table* table, struct of1x_flow_entry* entry);
+void __of1x_flow_index_remove(struct of1x_flow_table* table, struct of1x_flow_entry* entry);
+void __of1x_flow_index_update(struct of1x_flow_table* table, struct of1x_flow_entry* entry);
+
+/*
+* Indexed operations. They return false if no index can be used (the caller
+* must fall back to the matching algorithm).
+*/
+bool __of1x_flow_index_get_flow_stats(struct of1x_flow_table* table, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group* matches, struct of1x_stats_flow_msg* msg, rofl_result_t* result);
+bool __of1x_flow_index_get_flow_aggregate_stats(struct of1x_flow_table* table, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group* matches, struct of1x_stats_flow_aggregate_msg* msg);
+
+//Non-strict removal (entry may be NULL; no matches nor cookie)
+bool __of1x_flow_index_remove_flow_entries(struct of1x_flow_table* table, struct of1x_flow_entry* entry, uint32_t out_port, uint32_t out_group, of1x_flow_remove_reason_t reason, rofl_of1x_fm_result_t* result);
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //OF1X_FLOW_INDEX
@@ -344,6 +344,7 @@ rofl_result_t __of1x_init_table(struct of1x_pipeline* pipeline, of1x_flow_table_
 	table->number = table_index;
 	table->entries = NULL;
 	table->num_of_entries = 0;
+	table->revision = 0;
 	table->max_entries = OF1X_MAX_NUMBER_OF_TABLE_ENTRIES;
 
 	//Set name
@@ -393,6 +394,14 @@ rofl_result_t __of1x_init_table(struct of1x_pipeline* pipeline, of1x_flow_table_
 	//Init stats
 	__of1x_stats_table_init(table);
 
+	//Secondary indexes
+	if(__of1x_flow_index_init(&table->index) != ROFL_SUCCESS){
+		__of1x_stats_table_destroy(table);
+		platform_mutex_destroy(table->mutex);
+		platform_rwlock_destroy(table->rwlock);
+		return ROFL_FAILURE;
+	}
+
 	//Allow matching algorithms to do stuff	
 	if(of1x_matching_algorithms[table->matching_algorithm].init_hook){
 		rofl_result_t result;
@@ -400,6 +409,7 @@ rofl_result_t __of1x_init_table(struct of1x_pipeline* pipeline, of1x_flow_table_
 		result = of1x_matching_algorithms[table->matching_algorithm].init_hook(table);
 		
 		if(result != ROFL_SUCCESS){
+			__of1x_flow_index_destroy(&table->index);
 			platform_mutex_destroy(table->mutex);
 			platform_rwlock_destroy(table->rwlock);
 			return result;
@@ -429,6 +439,9 @@ rofl_result_t __of1x_destroy_table(of1x_flow_table_t* table){
 	//Destroy stats
 	__of1x_stats_table_destroy(table);
 
+	//Destroy the secondary indexes
+	__of1x_flow_index_destroy(&table->index);
+
 	//Do NOT free table, since it was allocated in a single buffer in pipeline.c	
 	return ROFL_SUCCESS;
 }
@@ -589,7 +602,9 @@ rofl_of1x_fm_result_t of1x_remove_flow_entry_table(of1x_pipeline_t *const pipeli
 	//Recover table pointer
 	table = &pipeline->tables[table_id];
 	
-	result = of1x_matching_algorithms[table->matching_algorithm].remove_flow_entry_hook(table, entry, NULL, strict,  out_port, out_group, OF1X_FLOW_REMOVE_DELETE, MUTEX_NOT_ACQUIRED);
+	//Non-strict filtered by out port, out group or exact cookie; use the secondary indexes
+	if(strict == STRICT || !__of1x_flow_index_remove_flow_entries(table, entry, out_port, out_group, OF1X_FLOW_REMOVE_DELETE, &result))
+		result = of1x_matching_algorithms[table->matching_algorithm].remove_flow_entry_hook(table, entry, NULL, strict,  out_port, out_group, OF1X_FLOW_REMOVE_DELETE, MUTEX_NOT_ACQUIRED);
 	
 #ifdef DEBUG
 	if(result != ROFL_OF1X_FM_SUCCESS)
@@ -622,10 +637,16 @@ void of1x_dump_table(of1x_flow_table_t* table, bool raw_nbo){
 	__of1x_stats_table_tid_t c;
 
 	if(of1x_matching_algorithms[table->matching_algorithm].dump_hook){
+		//Serialize with flowmods; some matching algorithms only hold the mutex while modifying their state
+		platform_mutex_lock(table->mutex);
+
 		//Take rd lock over the grouptable (avoid deletion of groups while flow entry insertion)
 		platform_rwlock_rdlock(table->rwlock);
 		of1x_matching_algorithms[table->matching_algorithm].dump_hook(table, raw_nbo);
-		goto DUMP_TABLE_END;
+		platform_rwlock_rdunlock(table->rwlock);
+
+		platform_mutex_unlock(table->mutex);
+		return;
 	}
 
 	//Consolidate stats
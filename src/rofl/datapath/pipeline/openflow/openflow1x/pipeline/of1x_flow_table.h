@@ -15,6 +15,7 @@
 #include "of1x_flow_entry.h"
 #include "of1x_timers.h"
 #include "of1x_statistics.h"
+#include "of1x_flow_index.h"
 #include "of1x_utils.h"
 #include "matching_algorithms/matching_algorithms.h"
 
@@ -104,6 +105,9 @@ typedef struct of1x_flow_table{
 	unsigned int num_of_entries;
 	unsigned int max_entries;    	/* Max number of entries supported. */
 
+	//Incremented (mutex held) on every insertion/removal of entries
+	uint64_t revision;
+
 	//Timers associated
 #if OF1X_TIMER_STATIC_ALLOCATION_SLOTS
 	unsigned int current_timer_group; /*in case of static allocation indicates the timer group*/
@@ -116,6 +120,12 @@ typedef struct of1x_flow_table{
 
 	//statistics
 	of1x_stats_table_t stats;
+
+	//Running flow aggregates (protected by the stats mutex)
+	of1x_stats_flow_aggregates_t aggregates;
+
+	//Secondary indexes (protected by the mutex)
+	of1x_flow_index_t index;
 	
 	/**
 	* Place-holder to allow matching algorithms
@@ -21,6 +21,11 @@
 static void __of1x_destroy_group(of1x_group_table_t *gt, of1x_group_t *ge);
 bool __of1x_bucket_list_has_weights(of1x_bucket_list_t *bl);
 
+//Small (sequential) ids are directly indexed
+static inline unsigned int __of1x_group_hash(uint32_t id){
+	return (id ^ (id >> 16)) & (OF1X_GROUP_TABLE_BUCKETS-1);
+}
+
 void __of12_set_group_table_defaults(of1x_group_table_t *gt){
 	bitmap128_clean(&gt->config.supported_actions);
 
@@ -114,8 +119,20 @@ of1x_group_table_t* of1x_init_group_table(struct of1x_pipeline* pipeline){
 	}
 	
 	gt->num_of_entries = 0;
+	gt->revision = 0;
 	gt->head = NULL;
 	gt->tail = NULL;
+
+	gt->hash = (of1x_group_t**)platform_malloc_shared(sizeof(of1x_group_t*)*OF1X_GROUP_TABLE_BUCKETS);
+	if( unlikely(gt->hash==NULL) ){
+		platform_free_shared(gt);
+		return NULL;
+	}
+	platform_memset(gt->hash, 0, sizeof(of1x_group_t*)*OF1X_GROUP_TABLE_BUCKETS);
+	seqlock_init(&gt->seqlock);
+
+	gt->slabs = NULL;
+	gt->free_groups = NULL;
 	
 	gt->mutex = platform_mutex_init(NULL);
 	gt->rwlock = platform_rwlock_init(NULL);
@@ -132,6 +149,7 @@ of1x_group_table_t* of1x_init_group_table(struct of1x_pipeline* pipeline){
 		default:
 			platform_mutex_destroy(gt->mutex);
 			platform_rwlock_destroy(gt->rwlock);
+			platform_free_shared(gt->hash);
 			platform_free_shared(gt);
 			return NULL;
 	}
@@ -144,6 +162,7 @@ of1x_group_table_t* of1x_init_group_table(struct of1x_pipeline* pipeline){
 
 void of1x_destroy_group_table(of1x_group_table_t* gt){
 	of1x_group_t *iterator=NULL, *next=NULL;
+	__of1x_group_slab_t *slab, *next_slab;
 	//check if there are existing entries and deleting them
 	
 	platform_mutex_lock(gt->mutex);
@@ -153,14 +172,81 @@ void of1x_destroy_group_table(of1x_group_table_t* gt){
 		next=iterator->next;
 		__of1x_destroy_group(gt,iterator);
 	}
+
+	//Release the pool
+	for(slab=gt->slabs; slab; slab=next_slab){
+		next_slab = slab->next;
+		platform_free_shared(slab);
+	}
 	
 	platform_mutex_destroy(gt->mutex);
 	platform_rwlock_destroy(gt->rwlock);
 	
-	
+	platform_free_shared(gt->hash);
 	platform_free_shared(gt);
 }
 
+/*
+* Group pool (mutex MUST be held)
+*/
+static of1x_group_t* __of1x_group_pool_get(of1x_group_table_t *gt){
+	unsigned int i;
+	of1x_group_t* ge;
+	__of1x_group_slab_t* slab;
+
+	if(!gt->free_groups){
+		slab = (__of1x_group_slab_t*)platform_malloc_shared(sizeof(__of1x_group_slab_t));
+		if( unlikely(slab==NULL) )
+			return NULL;
+
+		for(i=0; i<OF1X_GROUP_POOL_SLAB_SIZE; i++){
+			slab->groups[i].id = OF1X_GROUP_ANY;
+			slab->groups[i].hash_next = NULL;
+			slab->groups[i].next = gt->free_groups;
+			gt->free_groups = &slab->groups[i];
+		}
+
+		slab->next = gt->slabs;
+		gt->slabs = slab;
+	}
+
+	ge = gt->free_groups;
+	gt->free_groups = ge->next;
+
+	return ge;
+}
+
+static void __of1x_group_pool_put(of1x_group_table_t *gt, of1x_group_t *ge){
+	//hash_next is kept; lock-free readers may still be walking through it
+	ge->next = gt->free_groups;
+	gt->free_groups = ge;
+}
+
+/*
+* Hash index (mutex MUST be held)
+*/
+static void __of1x_group_hash_insert(of1x_group_table_t *gt, of1x_group_t *ge){
+	of1x_group_t** bucket = &gt->hash[__of1x_group_hash(ge->id)];
+
+	seqlock_write_begin(&gt->seqlock);
+	ge->hash_next = *bucket;
+	*bucket = ge;
+	seqlock_write_end(&gt->seqlock);
+}
+
+static void __of1x_group_hash_remove(of1x_group_table_t *gt, of1x_group_t *ge){
+	of1x_group_t** it;
+
+	for(it=&gt->hash[__of1x_group_hash(ge->id)]; *it; it=&(*it)->hash_next){
+		if(*it == ge){
+			seqlock_write_begin(&gt->seqlock);
+			*it = ge->hash_next;
+			seqlock_write_end(&gt->seqlock);
+			return;
+		}
+	}
+}
+
 static
 rofl_of1x_gm_result_t __of1x_validate_group(of1x_group_table_t* gt, of1x_action_group_t* actions){
 
@@ -185,24 +271,22 @@ rofl_of1x_gm_result_t __of1x_validate_group(of1x_group_table_t* gt, of1x_action_
 
 /**
  * Searches in the table for an entry with a specific id
- * returns pointer if found or NULL if not
+ * returns pointer if found or NULL if not (lock-free)
  */
 of1x_group_t* __of1x_group_search(of1x_group_table_t *gt, uint32_t id){
-	of1x_group_t *iterator=NULL, *next=NULL;
-	
-	platform_rwlock_rdlock(gt->rwlock);
+	uint32_t seq;
+	of1x_group_t *iterator;
 	
-	for(iterator=gt->head; iterator!=NULL; iterator=next){
-		next=iterator->next;
-		if(iterator->id == id){
-			platform_rwlock_rdunlock(gt->rwlock);
-			return iterator;
+	do{
+		seq = seqlock_read_begin(&gt->seqlock);
+
+		for(iterator=gt->hash[__of1x_group_hash(id)]; iterator!=NULL; iterator=iterator->hash_next){
+			if(iterator->id == id)
+				break;
 		}
-	}
+	}while( unlikely(seqlock_read_retry(&gt->seqlock, seq)) );
 	
-	platform_rwlock_rdunlock(gt->rwlock);
-	
-	return NULL;
+	return iterator;
 }
 
 rofl_of1x_gm_result_t __of1x_check_group_parameters(of1x_group_table_t *gt, of1x_group_type_t type, uint32_t id, of1x_bucket_list_t *buckets){
@@ -241,16 +325,14 @@ rofl_of1x_gm_result_t __of1x_init_group(of1x_group_table_t *gt, of1x_group_type_
 	rofl_of1x_gm_result_t ret_val;
 	of1x_group_t* ge=NULL;
 	
-	ge = (of1x_group_t *) platform_malloc_shared(sizeof(of1x_group_t));
+	if((ret_val=__of1x_check_group_parameters(gt,type,id,buckets))!=ROFL_OF1X_GM_SUCCESS)
+	        return ret_val;
+
+	ge = __of1x_group_pool_get(gt);
 	if ( unlikely(ge==NULL) ){
 		return ROFL_OF1X_GM_OGRUPS;
 	}
 	
-	if((ret_val=__of1x_check_group_parameters(gt,type,id,buckets))!=ROFL_OF1X_GM_SUCCESS){
-		platform_free_shared(ge);		
-	        return ret_val;
-	}
-	
 	ge->bc_list = buckets;
 	ge->id = id;
 	ge->type = type;
@@ -279,6 +361,10 @@ rofl_of1x_gm_result_t __of1x_init_group(of1x_group_table_t *gt, of1x_group_type_
 	ge->next = NULL;
 	gt->tail = ge;
 	gt->num_of_entries++;
+	gt->revision++;
+
+	//Publish
+	__of1x_group_hash_insert(gt, ge);
 	
 	platform_rwlock_wrunlock(gt->rwlock);
 	
@@ -329,8 +415,8 @@ void __of1x_destroy_group(of1x_group_table_t *gt, of1x_group_t *ge){
 	
 	platform_rwlock_destroy(ge->rwlock);
 
-	//free
-	platform_free_shared(ge);
+	//Back to the pool
+	__of1x_group_pool_put(gt, ge);
 }
 
 static
@@ -344,6 +430,9 @@ rofl_result_t __of1x_extract_group(of1x_group_table_t *gt, of1x_group_t *ge){
 		return ROFL_FAILURE;
 	}
 	ge->group_table = NULL;
+
+	//Unpublish
+	__of1x_group_hash_remove(gt, ge);
 	
 	//detach
 	if(ge->next)
@@ -358,14 +447,29 @@ rofl_result_t __of1x_extract_group(of1x_group_table_t *gt, of1x_group_t *ge){
 		gt->tail = ge->prev;
 	
 	gt->num_of_entries--;
+	gt->revision++;
 	//leave write lock of the table
 	platform_rwlock_wrunlock(gt->rwlock);
 	return ROFL_SUCCESS;
 }
 
+//Remove the entries of the table referring to the group
+static void __of1x_remove_flow_entries_using_group(of1x_pipeline_t *pipeline, unsigned int table_id, uint32_t group_id){
+	of1x_flow_entry_t* entry;
+	of1x_flow_table_t* table = &pipeline->tables[table_id];
+	rofl_of1x_fm_result_t result;
+
+	//Secondary indexes
+	if(__of1x_flow_index_remove_flow_entries(table, NULL, OF1X_PORT_ANY, group_id, OF1X_FLOW_REMOVE_GROUP_DELETE, &result))
+		return;
+
+	while((entry=of1x_matching_algorithms[table->matching_algorithm].find_entry_using_group_hook(table,group_id))!=NULL){
+		__of1x_remove_specific_flow_entry_table(pipeline,table_id,entry, OF1X_FLOW_REMOVE_GROUP_DELETE, MUTEX_NOT_ACQUIRED);
+	}
+}
+
 rofl_of1x_gm_result_t of1x_group_delete(of1x_pipeline_t *pipeline, of1x_group_table_t *gt, uint32_t id){
 	int i;
-	of1x_flow_entry_t* entry;
 	of1x_group_t *ge, *next;
 	
 	//serialize mgmt actions
@@ -382,9 +486,7 @@ rofl_of1x_gm_result_t of1x_group_delete(of1x_pipeline_t *pipeline, of1x_group_ta
 			
 			//loop for all the tables and erase entries that point to the group
 			for(i=0; i<pipeline->num_of_tables; i++){
-				while((entry=of1x_matching_algorithms[pipeline->tables[i].matching_algorithm].find_entry_using_group_hook(&pipeline->tables[i],ge->id))!=NULL){
-					__of1x_remove_specific_flow_entry_table(pipeline,i,entry, OF1X_FLOW_REMOVE_GROUP_DELETE, MUTEX_NOT_ACQUIRED);
-				}
+				__of1x_remove_flow_entries_using_group(pipeline, i, ge->id);
 			}
 			//destroy the group
 			__of1x_destroy_group(gt,ge);
@@ -407,9 +509,7 @@ rofl_of1x_gm_result_t of1x_group_delete(of1x_pipeline_t *pipeline, of1x_group_ta
 	
 	//loop for all the tables and erase entries that point to the group
 	for(i=0; i<pipeline->num_of_tables; i++){
-		while((entry=of1x_matching_algorithms[pipeline->tables[i].matching_algorithm].find_entry_using_group_hook(&pipeline->tables[i],ge->id))!=NULL){
-			__of1x_remove_specific_flow_entry_table(pipeline,i,entry, OF1X_FLOW_REMOVE_GROUP_DELETE, MUTEX_NOT_ACQUIRED);
-		}
+		__of1x_remove_flow_entries_using_group(pipeline, i, ge->id);
 	}
 	
 	//destroy the group
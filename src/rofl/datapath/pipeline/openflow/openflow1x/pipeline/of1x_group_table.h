@@ -16,6 +16,14 @@
 #define OF1X_GROUP_ALL 0xfffffffc  /* Represents all groups for group delete commands. */
 #define OF1X_GROUP_ANY 0xffffffff /* Wildcard group used only for flow stats */
 
+#ifndef OF1X_GROUP_TABLE_BUCKETS
+	#define OF1X_GROUP_TABLE_BUCKETS 8192 //Hash buckets; MUST be a power of 2
+#endif
+
+#ifndef OF1X_GROUP_POOL_SLAB_SIZE
+	#define OF1X_GROUP_POOL_SLAB_SIZE 64 //Groups allocated at once
+#endif
+
 /**
 * @file of1x_group_table.h
 * @author Victor Alvarez<victor.alvarez (at) bisdn.de>, Marc Sune<marc.sune (at) bisdn.de>
@@ -63,10 +71,19 @@ typedef struct of1x_group{
 	
 	struct of1x_group *next;
 	struct of1x_group *prev;
+
+	//Hash bucket chain
+	struct of1x_group *hash_next;
 	
 	unsigned int num_of_output_actions;
 }of1x_group_t;
 
+//Slab of the group pool
+typedef struct __of1x_group_slab{
+	struct __of1x_group_slab* next;
+	of1x_group_t groups[OF1X_GROUP_POOL_SLAB_SIZE];
+}__of1x_group_slab_t;
+
 //Group table configuration
 typedef struct{
 	bitmap128_t supported_actions;	/* Bitmap of (1 << OF1X_AT_* that are supported by the group table. */
@@ -78,6 +95,9 @@ typedef struct of1x_group_table{
 	of1x_group_table_config_t config;
 	
 	uint32_t num_of_entries;
+
+	//Incremented (rwlock held) on every insertion/removal of groups
+	uint64_t revision;
 	
 	platform_mutex_t *mutex;
 	platform_rwlock_t *rwlock;
@@ -85,6 +105,18 @@ typedef struct of1x_group_table{
 	struct of1x_group *head;
 	struct of1x_group *tail;
 
+	/*
+	* Hash index by group id. Lookups are lock-free; writers (mutex)
+	* modify the chains within the seqlock write section, and the
+	* readers retry if a modification happened during the lookup.
+	*/
+	struct of1x_group **hash;
+	seqlock_t seqlock;
+
+	//Group pool (mutex). Groups are only released with the table
+	__of1x_group_slab_t* slabs;
+	struct of1x_group* free_groups;
+
 	//Reference back
 	struct of1x_pipeline* pipeline;
 
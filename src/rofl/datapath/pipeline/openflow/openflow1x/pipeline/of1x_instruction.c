@@ -60,6 +60,7 @@ void __of1x_destroy_instruction_group(of1x_instruction_group_t* group){
 void of1x_remove_instruction_from_the_group(of1x_instruction_group_t* group, of1x_instruction_type_t type){
 	
 	__of1x_destroy_instruction(&group->instructions[type]);
+	platform_memset(&group->instructions[type],0,sizeof(of1x_instruction_t));
 	group->num_of_instructions--;
 }
 
@@ -78,6 +79,20 @@ void of1x_add_instruction_to_group(of1x_instruction_group_t* group, of1x_instruc
 	//flow be installed/modified/deleted
 }
 
+void of1x_add_experimenter_instruction_to_group(of1x_instruction_group_t* group, uint32_t experimenter_id, uint32_t exp_type, wrap_uint_t field){
+
+	of1x_instruction_t* inst = &group->instructions[OF1X_IT_EXPERIMENTER];
+
+	of1x_add_instruction_to_group(group, OF1X_IT_EXPERIMENTER, NULL, NULL, NULL, 0);
+
+	inst->experimenter_id = experimenter_id;
+	inst->exp_type = exp_type;
+	inst->exp_field = field;
+
+	//Handler is resolved during validation
+	inst->__exp_fn = NULL;
+}
+
 
 //Update instructions
 rofl_result_t __of1x_update_instructions(of1x_instruction_group_t* group, of1x_instruction_group_t* new_group){
@@ -98,16 +113,19 @@ rofl_result_t __of1x_update_instructions(of1x_instruction_group_t* group, of1x_i
 	platform_memset(&new_group->instructions[OF1X_IT_WRITE_ACTIONS],0,sizeof(of1x_instruction_t));
 
 
-	//Static ones
-	//TODO: METADATA && EXPERIMENTER
-	
 	//Static stuff
 	group->instructions[OF1X_IT_CLEAR_ACTIONS] = new_group->instructions[OF1X_IT_CLEAR_ACTIONS];	
+	group->instructions[OF1X_IT_EXPERIMENTER] = new_group->instructions[OF1X_IT_EXPERIMENTER];
+	group->instructions[OF1X_IT_WRITE_METADATA] = new_group->instructions[OF1X_IT_WRITE_METADATA];
 	group->instructions[OF1X_IT_GOTO_TABLE] = new_group->instructions[OF1X_IT_GOTO_TABLE];
 			
 
 	//Static stuff
 	group->num_of_instructions = new_group->num_of_instructions;
+
+	//Validation results (the shape must match the instructions)
+	group->num_of_outputs = new_group->num_of_outputs;
+	group->shape = new_group->shape;
 	
 	return ROFL_SUCCESS;
 }
@@ -179,8 +197,8 @@ void __of1x_dump_instructions(of1x_instruction_group_t group, bool raw_nbo){
     			case OF1X_IT_WRITE_METADATA:
 					ROFL_PIPELINE_INFO_NO_PREFIX(" WRITE-META(0x%"PRIx64":0x%"PRIx64"), ", group.instructions[i].write_metadata.metadata, group.instructions[i].write_metadata.metadata_mask);
 					break;
-			case OF1X_IT_EXPERIMENTER: //TODO:
-					ROFL_PIPELINE_INFO_NO_PREFIX(" EXP, ");
+			case OF1X_IT_EXPERIMENTER:
+					ROFL_PIPELINE_INFO_NO_PREFIX(" EXP(0x%x:0x%x), ", group.instructions[i].experimenter_id, group.instructions[i].exp_type);
 					break;
     			case OF1X_IT_GOTO_TABLE:  
 					ROFL_PIPELINE_INFO_NO_PREFIX(" GOTO(%u), ",group.instructions[i].go_to_table);
@@ -214,12 +232,54 @@ bool __of1x_instruction_has(of1x_instruction_group_t *inst_grp, of1x_packet_acti
 		__of1x_apply_actions_has(inst_grp->instructions[OF1X_IT_APPLY_ACTIONS].apply_actions, type, value) );
 }
 
+//Classify the instruction group; must be called once validated
+static of1x_instruction_shape_t __of1x_get_instructions_shape(const of1x_instruction_group_t* inst_grp){
+
+	unsigned int i;
+	uint32_t present = 0x0;
+	const of1x_action_group_t* apply_actions;
+
+	for(i=0;i<OF1X_IT_MAX;i++){
+		if(inst_grp->instructions[i].type != OF1X_IT_NO_INSTRUCTION)
+			present |= 0x1 << i;
+	}
+
+	switch(present){
+		case 0x0:
+			return OF1X_IS_DROP;
+		case 0x1 << OF1X_IT_GOTO_TABLE:
+			return OF1X_IS_GOTO;
+		case (0x1 << OF1X_IT_WRITE_METADATA) | (0x1 << OF1X_IT_GOTO_TABLE):
+			return OF1X_IS_METADATA_GOTO;
+		case 0x1 << OF1X_IT_APPLY_ACTIONS:
+			apply_actions = inst_grp->instructions[OF1X_IT_APPLY_ACTIONS].apply_actions;
+
+			//Groups are accounted as multiple outputs (forced cloning)
+			if(bitmap128_is_bit_set(&apply_actions->bitmap, OF1X_AT_GROUP))
+				break;
+
+			if(inst_grp->num_of_outputs == 1 && apply_actions->num_of_output_actions == 1)
+				return OF1X_IS_APPLY;
+
+			//The last output can consume the packet (no need to clone it)
+			if(apply_actions->num_of_output_actions > 1 && apply_actions->tail &&
+				apply_actions->tail->type == OF1X_AT_OUTPUT && !apply_actions->has_output_table)
+				return OF1X_IS_APPLY_MULTI;
+			break;
+		default:
+			break;
+	}
+
+	return OF1X_IS_GENERIC;
+}
+
 rofl_result_t __of1x_validate_instructions(of1x_instruction_group_t* inst_grp, of1x_pipeline_t* pipeline, unsigned int table_id){
 	int i, num_of_output_actions=0;
 	of1x_group_table_t *gt = pipeline->groups;
 	of_version_t version = pipeline->sw->of_ver;
 	of1x_flow_table_t* table = &pipeline->tables[table_id];
 	of1x_instruction_t* inst;
+	const of1x_experimenter_instruction_t* exp_handler;
 
 	//if there is a group action we should check that the group exists
 	for(i=0;i<OF1X_IT_MAX;i++){
@@ -259,9 +319,20 @@ rofl_result_t __of1x_validate_instructions(of1x_instruction_group_t* inst_grp, o
 				if(inst->go_to_table >= pipeline->num_of_tables)
 					return ROFL_FAILURE;
 				break;
+			case OF1X_IT_EXPERIMENTER:
+				if( (version < OF_VERSION_12))
+					return ROFL_FAILURE;
+
+				//Resolve the handler
+				if( (exp_handler = __of1x_get_experimenter_instruction(inst->experimenter_id, inst->exp_type)) == NULL)
+					return ROFL_FAILURE;
+				if(exp_handler->validate && exp_handler->validate(inst) != ROFL_SUCCESS)
+					return ROFL_FAILURE;
+
+				inst->__exp_fn = exp_handler->process;
+				break;
 			case OF1X_IT_WRITE_METADATA:
 			case OF1X_IT_CLEAR_ACTIONS:
-			case OF1X_IT_EXPERIMENTER:
 				//Fast check WRITE actions supported from 1.2
 				if( (version < OF_VERSION_12))
 					return ROFL_FAILURE;
@@ -279,6 +350,9 @@ rofl_result_t __of1x_validate_instructions(of1x_instruction_group_t* inst_grp, o
 	
 	//update has multiple outputs flag
 	inst_grp->num_of_outputs = num_of_output_actions;
+
+	//Classify for the fast paths
+	inst_grp->shape = __of1x_get_instructions_shape(inst_grp);
 	
 	return ROFL_SUCCESS;
 }
@@ -76,6 +76,20 @@ typedef struct of1x_write_metadata{
 }of1x_write_metadata_t;
 
 
+/**
+* @ingroup core_of1x 
+* Instruction group shape. Classified on validation, so that the pipeline
+* can skip the generic instruction processing for the most common cases.
+*/
+typedef enum {
+	OF1X_IS_GENERIC		= 0,		/* Any other combination */
+	OF1X_IS_DROP		= 1,		/* No instructions */
+	OF1X_IS_APPLY		= 2,		/* APPLY_ACTIONS only, with a single output and no groups (e.g. output, set-field+output) */
+	OF1X_IS_GOTO		= 3,		/* GOTO_TABLE only */
+	OF1X_IS_METADATA_GOTO	= 4,		/* WRITE_METADATA and GOTO_TABLE only */
+	OF1X_IS_APPLY_MULTI	= 5,		/* APPLY_ACTIONS only, with multiple outputs, no groups and ending with an output */
+}of1x_instruction_shape_t;
+
 /* Instruction abstraction data structure */
 typedef struct of1x_instruction{
 	//Type and value(for set fields and push)
@@ -92,6 +106,12 @@ typedef struct of1x_instruction{
 
 	//GO-TO-TABLE
 	unsigned int go_to_table;	
+
+	//EXPERIMENTER type only; handler resolved on validation
+	uint32_t experimenter_id;
+	uint32_t exp_type;
+	wrap_uint_t exp_field;
+	of1x_experimenter_instruction_fn_t __exp_fn;
 }of1x_instruction_t;
 
 /* Instruction group, using a double-linked-list */ 
@@ -107,6 +127,9 @@ typedef struct of1x_instruction_group{
 	//Note: this does NOT reflect the exact number of output 
 	//actions when groups are used
 	unsigned int num_of_outputs;
+
+	//Shape (set on validation)
+	of1x_instruction_shape_t shape;
 	
 }of1x_instruction_group_t;
 
@@ -141,6 +164,16 @@ void __of1x_destroy_instruction_group(of1x_instruction_group_t* group);
 */
 void of1x_add_instruction_to_group(of1x_instruction_group_t* group, of1x_instruction_type_t type, of1x_action_group_t* apply_actions, of1x_write_actions_t* write_actions, of1x_write_metadata_t* write_metadata, unsigned int go_to_table);
 /**
+* @brief Adds an experimenter instruction (OF1X_IT_EXPERIMENTER) to the group 
+* @ingroup core_of1x 
+*
+* The handler for experimenter_id and exp_type MUST be registered (of1x_register_experimenter_instruction())
+* before the flow entry is installed.
+*
+* @param field Argument of the experimenter instruction (opaque to the pipeline)
+*/
+void of1x_add_experimenter_instruction_to_group(of1x_instruction_group_t* group, uint32_t experimenter_id, uint32_t exp_type, wrap_uint_t field);
+/**
 * @brief Remove an instruction of the group 
 * @ingroup core_of1x 
 * @param group Instruction group 
@@ -30,11 +30,49 @@ static inline bool  __of1x_process_instructions_must_replicate(const of1x_instru
 	return  ( (n_out == 1) && (has_goto) ) || ( n_out > 1); 
 }
 
+/**
+* Whether the packet will be consumed by the last output of the apply actions
+* (instead of being cloned and dropped). MUST be checked before the instructions
+* are processed, as the packet cannot be accessed afterwards.
+*/
+static inline bool __of1x_process_instructions_consume_pkt(const of1x_instruction_group_t* inst_grp, datapacket_t *const pkt){
+	//Pending write actions would be processed afterwards
+	return inst_grp->shape == OF1X_IS_APPLY_MULTI && pkt->write_actions.of1x.num_of_actions == 0;
+}
+
 /* Process instructions */
 static inline unsigned int __of1x_process_instructions(const unsigned int tid, const struct of1x_switch* sw, const unsigned int table_id, datapacket_t *const pkt, const of1x_instruction_group_t* instructions){
 
 	of1x_instruction_t* inst = (of1x_instruction_t*)&instructions->instructions[OF1X_IT_APPLY_ACTIONS]; 
 
+	/**
+	* Fast paths (shape classified on validation)
+	*/
+	switch(instructions->shape){
+		case OF1X_IS_DROP:
+			return 0;
+		case OF1X_IS_APPLY:
+			//Single output, no replication needed
+			__of1x_process_apply_actions(tid, sw, table_id, pkt, inst->apply_actions, false, NULL); 
+			return 0;
+		case OF1X_IS_APPLY_MULTI:
+			if(likely(__of1x_process_instructions_consume_pkt(instructions, pkt))){
+				//Clone for all outputs but the last one
+				__of1x_process_apply_actions_consume_pkt(tid, sw, table_id, pkt, inst->apply_actions);
+				return 0;
+			}
+			break;
+		case OF1X_IS_METADATA_GOTO:
+			inst = (of1x_instruction_t*)&instructions->instructions[OF1X_IT_WRITE_METADATA]; 
+			pkt->__metadata = (pkt->__metadata & ~inst->write_metadata.metadata_mask) |
+					(inst->write_metadata.metadata & inst->write_metadata.metadata_mask);
+			//Fall through
+		case OF1X_IS_GOTO:
+			return instructions->instructions[OF1X_IT_GOTO_TABLE].go_to_table;
+		default:
+			break;
+	}
+
 	/**
 	* Unrolled instructions loop
 	*/
@@ -66,8 +104,14 @@ static inline unsigned int __of1x_process_instructions(const unsigned int tid, c
 	//Next instruction
 	inst++;
 
-	if(inst->type == OF1X_IT_EXPERIMENTER){
-		//TODO:
+	//Unresolved handlers (never validated) are skipped
+	if(inst->type == OF1X_IT_EXPERIMENTER && likely(inst->__exp_fn != NULL)){
+		//Pending modifications must be visible to the handler, which may mangle the packet
+		__of1x_flush_set_fields(pkt);
+		__of1x_commit_checksum_deltas(pkt);
+		inst->__exp_fn(tid, sw, table_id, pkt, inst);
+		__of1x_invalidate_packet_key(pkt);
+		__of1x_invalidate_packet_size(pkt);
 	}
 	
 	//Next instruction
@@ -13,6 +13,7 @@
 #include "../../../platform/likely.h"
 #include "../../../platform/packet.h"
 #include "of1x_match.h"
+#include "of1x_packet_key_pp.h"
 #include "of1x_utils.h"
 
 /**
@@ -45,360 +46,162 @@ ROFL_BEGIN_DECLS
 /*
 * CHECK fields against packet
 *
+* Non-experimental fields are checked against the packet key; presence flags
+* account for the prerequisites of the match (ether type, ip proto...).
+*
 * @warning: it MUST BE != NULL
 */
 static inline bool __of1x_check_match(datapacket_t *const pkt, of1x_match_t* it){
+
+	of1x_packet_key_t* key;
 	
 	switch(it->type){
 		//Phy
-		case OF1X_MATCH_IN_PORT: return __utern_compare32(&it->__tern, platform_packet_get_port_in(pkt));
-		case OF1X_MATCH_IN_PHY_PORT: if(!platform_packet_get_port_in(pkt)) return false; //According to spec
-					return __utern_compare32(&it->__tern, platform_packet_get_phy_port_in(pkt));
+		case OF1X_MATCH_IN_PORT: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2);
+					return (key->present & OF1X_PKT_KEY_F_IN_PORT) && __utern_compare32(&it->__tern, &key->port_in);
+		case OF1X_MATCH_IN_PHY_PORT: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2); //in_port is required according to spec
+					return (key->present & OF1X_PKT_KEY_F_IN_PHY_PORT) && __utern_compare32(&it->__tern, &key->phy_port_in);
 		//Metadata
 	  	case OF1X_MATCH_METADATA: return __utern_compare64(&it->__tern, &pkt->__metadata); 
 		
 		//802
-   		case OF1X_MATCH_ETH_DST:  return __utern_compare64(&it->__tern, platform_packet_get_eth_dst(pkt));
-   		case OF1X_MATCH_ETH_SRC:  return __utern_compare64(&it->__tern, platform_packet_get_eth_src(pkt));
-   		case OF1X_MATCH_ETH_TYPE: return __utern_compare16(&it->__tern, platform_packet_get_eth_type(pkt));
+   		case OF1X_MATCH_ETH_DST: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2);
+					return (key->present & OF1X_PKT_KEY_F_ETH_DST) && __utern_compare64(&it->__tern, &key->eth_dst);
+   		case OF1X_MATCH_ETH_SRC: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2);
+					return (key->present & OF1X_PKT_KEY_F_ETH_SRC) && __utern_compare64(&it->__tern, &key->eth_src);
+   		case OF1X_MATCH_ETH_TYPE: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2);
+					return (key->present & OF1X_PKT_KEY_F_ETH_TYPE) && __utern_compare16(&it->__tern, &key->eth_type);
 		
 		//802.1q
-   		case OF1X_MATCH_VLAN_VID: if( it->vlan_present == OF1X_MATCH_VLAN_SPECIFIC )
-						return platform_packet_has_vlan(pkt) && __utern_compare16(&it->__tern, platform_packet_get_vlan_vid(pkt));
-					  else
-						return platform_packet_has_vlan(pkt) == it->vlan_present;
-   		case OF1X_MATCH_VLAN_PCP: return platform_packet_has_vlan(pkt) &&  __utern_compare8(&it->__tern, platform_packet_get_vlan_pcp(pkt));
+   		case OF1X_MATCH_VLAN_VID: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2);
+					if( it->vlan_present == OF1X_MATCH_VLAN_SPECIFIC )
+						return (key->present & OF1X_PKT_KEY_F_VLAN_VID) && __utern_compare16(&it->__tern, &key->vlan_vid);
+					else
+						return ((key->present & OF1X_PKT_KEY_F_VLAN) != 0) == it->vlan_present;
+   		case OF1X_MATCH_VLAN_PCP: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2);
+					return (key->present & OF1X_PKT_KEY_F_VLAN_PCP) && __utern_compare8(&it->__tern, &key->vlan_pcp);
 
 		//MPLS
-   		case OF1X_MATCH_MPLS_LABEL:{ 
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_MPLS_UNICAST || *ptr_ether_type == ETH_TYPE_MPLS_MULTICAST )) return false;
-					return __utern_compare32(&it->__tern, platform_packet_get_mpls_label(pkt));
-		}
-   		case OF1X_MATCH_MPLS_TC:{
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_MPLS_UNICAST || *ptr_ether_type == ETH_TYPE_MPLS_MULTICAST )) return false; 
-					return __utern_compare8(&it->__tern, platform_packet_get_mpls_tc(pkt));
-		}
-   		case OF1X_MATCH_MPLS_BOS:{
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_MPLS_UNICAST || *ptr_ether_type == ETH_TYPE_MPLS_MULTICAST )) return false;
-					uint8_t bos = platform_packet_get_mpls_bos(pkt);
-					return __utern_compare8(&it->__tern, &bos);
-		}
+   		case OF1X_MATCH_MPLS_LABEL: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_MPLS);
+					return (key->present & OF1X_PKT_KEY_F_MPLS_LABEL) && __utern_compare32(&it->__tern, &key->mpls_label);
+   		case OF1X_MATCH_MPLS_TC: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_MPLS);
+					return (key->present & OF1X_PKT_KEY_F_MPLS_TC) && __utern_compare8(&it->__tern, &key->mpls_tc);
+   		case OF1X_MATCH_MPLS_BOS: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_MPLS);
+					return (key->present & OF1X_PKT_KEY_F_MPLS_BOS) && __utern_compare8(&it->__tern, &key->mpls_bos);
 	
 		//ARP
-   		case OF1X_MATCH_ARP_OP:{
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_ARP)) return false;
-   					return __utern_compare16(&it->__tern, platform_packet_get_arp_opcode(pkt));
-		}
-   		case OF1X_MATCH_ARP_SHA:{
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_ARP)) return false;
-   					return __utern_compare64(&it->__tern, platform_packet_get_arp_sha(pkt));
-		}
-   		case OF1X_MATCH_ARP_SPA:{
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_ARP)) return false;
-					return __utern_compare32(&it->__tern, platform_packet_get_arp_spa(pkt));
-		}
-   		case OF1X_MATCH_ARP_THA:{
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_ARP)) return false;
-   					return __utern_compare64(&it->__tern, platform_packet_get_arp_tha(pkt));
-		}
-   		case OF1X_MATCH_ARP_TPA:{
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_ARP)) return false;
-					return __utern_compare32(&it->__tern, platform_packet_get_arp_tpa(pkt));
-		}
+   		case OF1X_MATCH_ARP_OP: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_ARP);
+					return (key->present & OF1X_PKT_KEY_F_ARP_OP) && __utern_compare16(&it->__tern, &key->arp_opcode);
+   		case OF1X_MATCH_ARP_SHA: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_ARP);
+					return (key->present & OF1X_PKT_KEY_F_ARP_SHA) && __utern_compare64(&it->__tern, &key->arp_sha);
+   		case OF1X_MATCH_ARP_SPA: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_ARP);
+					return (key->present & OF1X_PKT_KEY_F_ARP_SPA) && __utern_compare32(&it->__tern, &key->arp_spa);
+   		case OF1X_MATCH_ARP_THA: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_ARP);
+					return (key->present & OF1X_PKT_KEY_F_ARP_THA) && __utern_compare64(&it->__tern, &key->arp_tha);
+   		case OF1X_MATCH_ARP_TPA: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_ARP);
+					return (key->present & OF1X_PKT_KEY_F_ARP_TPA) && __utern_compare32(&it->__tern, &key->arp_tpa);
 
 		//NW (OF1.0 only)
-   		case OF1X_MATCH_NW_PROTO:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4 || *ptr_ether_type == ETH_TYPE_IPV6 || *ptr_ether_type == ETH_TYPE_ARP || (*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && (*ptr_ppp_proto == PPP_PROTO_IP4 || *ptr_ppp_proto == PPP_PROTO_IP6) ))) return false;
-					if(*ptr_ether_type == ETH_TYPE_ARP){
-						uint8_t *low_byte = ((uint8_t*)(platform_packet_get_arp_opcode(pkt)));
-						return __utern_compare8(&it->__tern, ++low_byte);
-					}
-					else 
-						return __utern_compare8(&it->__tern, platform_packet_get_ip_proto(pkt));
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4 || *ptr_ether_type == ETH_TYPE_IPV6 || *ptr_ether_type == ETH_TYPE_ARP )) return false;
-					if(*ptr_ether_type == ETH_TYPE_ARP){
-						uint8_t *low_byte = ((uint8_t*)(platform_packet_get_arp_opcode(pkt)));
+   		case OF1X_MATCH_NW_PROTO: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_ARP | OF1X_PKT_KEY_L3);
+					if(key->present & OF1X_PKT_KEY_F_ARP_OP){
+						//Low byte of the opcode
+						uint8_t *low_byte = ((uint8_t*)&key->arp_opcode);
 						return __utern_compare8(&it->__tern, ++low_byte);
 					}
-					else
-						return __utern_compare8(&it->__tern, platform_packet_get_ip_proto(pkt));
-#endif
-		}
-   		case OF1X_MATCH_NW_SRC:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( ptr_ether_type && (*ptr_ether_type == ETH_TYPE_IPV4 || (*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && *ptr_ppp_proto == PPP_PROTO_IP4 ))) 
-						return __utern_compare32(&it->__tern, platform_packet_get_ipv4_src(pkt)); 
-					if(ptr_ether_type && *ptr_ether_type == ETH_TYPE_ARP)
-						return __utern_compare32(&it->__tern, platform_packet_get_arp_spa(pkt)); 
-					return false;
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( ptr_ether_type && (*ptr_ether_type == ETH_TYPE_IPV4))
-						return __utern_compare32(&it->__tern, platform_packet_get_ipv4_src(pkt));
-					if(ptr_ether_type && *ptr_ether_type == ETH_TYPE_ARP)
-						return __utern_compare32(&it->__tern, platform_packet_get_arp_spa(pkt));
-					return false;
-#endif
-		}
-   		case OF1X_MATCH_NW_DST:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( ptr_ether_type && (*ptr_ether_type == ETH_TYPE_IPV4 ||(*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && *ptr_ppp_proto == PPP_PROTO_IP4 )))  
-						return __utern_compare32(&it->__tern, platform_packet_get_ipv4_dst(pkt));
-					if( ptr_ether_type && *ptr_ether_type == ETH_TYPE_ARP)
-						return __utern_compare32(&it->__tern, platform_packet_get_arp_tpa(pkt)); 
-					return false;
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( ptr_ether_type && (*ptr_ether_type == ETH_TYPE_IPV4))
-						return __utern_compare32(&it->__tern, platform_packet_get_ipv4_dst(pkt));
-					if( ptr_ether_type && *ptr_ether_type == ETH_TYPE_ARP)
-						return __utern_compare32(&it->__tern, platform_packet_get_arp_tpa(pkt));
-					return false;
-#endif
-		}
+					return (key->present & OF1X_PKT_KEY_F_IP_PROTO) && __utern_compare8(&it->__tern, &key->ip_proto);
+   		case OF1X_MATCH_NW_SRC: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_ARP | OF1X_PKT_KEY_L3);
+					if(key->present & OF1X_PKT_KEY_F_IPV4_SRC)
+						return __utern_compare32(&it->__tern, &key->ipv4_src);
+					return (key->present & OF1X_PKT_KEY_F_ARP_SPA) && __utern_compare32(&it->__tern, &key->arp_spa);
+   		case OF1X_MATCH_NW_DST: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_ARP | OF1X_PKT_KEY_L3);
+					if(key->present & OF1X_PKT_KEY_F_IPV4_DST)
+						return __utern_compare32(&it->__tern, &key->ipv4_dst);
+					return (key->present & OF1X_PKT_KEY_F_ARP_TPA) && __utern_compare32(&it->__tern, &key->arp_tpa);
 		
 		//IP
-   		case OF1X_MATCH_IP_PROTO:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4 || *ptr_ether_type == ETH_TYPE_IPV6 || (*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && (*ptr_ppp_proto == PPP_PROTO_IP4 || *ptr_ppp_proto == PPP_PROTO_IP6) ))) return false; 
-					return __utern_compare8(&it->__tern, platform_packet_get_ip_proto(pkt));
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4 || *ptr_ether_type == ETH_TYPE_IPV6)) return false;
-					return __utern_compare8(&it->__tern, platform_packet_get_ip_proto(pkt));
-#endif
-		}
-		case OF1X_MATCH_IP_ECN:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4 || *ptr_ether_type == ETH_TYPE_IPV6 || (*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && *ptr_ppp_proto == PPP_PROTO_IP4 ))) return false; //NOTE PPP_PROTO_IP6
-					{
-						uint8_t ecn = platform_packet_get_ip_ecn(pkt);
-						return __utern_compare8(&it->__tern, &ecn);
-					}
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4 || *ptr_ether_type == ETH_TYPE_IPV6)) return false; //NOTE PPP_PROTO_IP6
-					{
-						uint8_t ecn = platform_packet_get_ip_ecn(pkt);
-						return __utern_compare8(&it->__tern, &ecn);
-					}
-#endif
-		}
-		case OF1X_MATCH_IP_DSCP:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4 || *ptr_ether_type == ETH_TYPE_IPV6 || (*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && *ptr_ppp_proto == PPP_PROTO_IP4 ))) return false; //NOTE PPP_PROTO_IP6
-					{
-						uint8_t dscp = platform_packet_get_ip_dscp(pkt);
-						return __utern_compare8(&it->__tern, &dscp);
-					}
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4 || *ptr_ether_type == ETH_TYPE_IPV6)) return false; //NOTE PPP_PROTO_IP6
-					{
-						uint8_t dscp = platform_packet_get_ip_dscp(pkt);
-						return __utern_compare8(&it->__tern, &dscp);
-					}
-#endif
-		}
+   		case OF1X_MATCH_IP_PROTO: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L3);
+					return (key->present & OF1X_PKT_KEY_F_IP_PROTO) && __utern_compare8(&it->__tern, &key->ip_proto);
+		case OF1X_MATCH_IP_ECN: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L3);
+					return (key->present & OF1X_PKT_KEY_F_IP_ECN) && __utern_compare8(&it->__tern, &key->ip_ecn);
+		case OF1X_MATCH_IP_DSCP: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L3);
+					return (key->present & OF1X_PKT_KEY_F_IP_DSCP) && __utern_compare8(&it->__tern, &key->ip_dscp);
 		
 		//IPv4
-   		case OF1X_MATCH_IPV4_SRC:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4 || (*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && *ptr_ppp_proto == PPP_PROTO_IP4 ))) return false; 
-					return __utern_compare32(&it->__tern, platform_packet_get_ipv4_src(pkt));
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4)) return false;
-					return __utern_compare32(&it->__tern, platform_packet_get_ipv4_src(pkt));
-#endif
-		}
-   		case OF1X_MATCH_IPV4_DST:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4 ||(*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && *ptr_ppp_proto == PPP_PROTO_IP4 ))) return false;  
-					return __utern_compare32(&it->__tern, platform_packet_get_ipv4_dst(pkt));
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV4)) return false;
-					return __utern_compare32(&it->__tern, platform_packet_get_ipv4_dst(pkt));
-#endif
-		}
+   		case OF1X_MATCH_IPV4_SRC: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L3);
+					return (key->present & OF1X_PKT_KEY_F_IPV4_SRC) && __utern_compare32(&it->__tern, &key->ipv4_src);
+   		case OF1X_MATCH_IPV4_DST: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L3);
+					return (key->present & OF1X_PKT_KEY_F_IPV4_DST) && __utern_compare32(&it->__tern, &key->ipv4_dst);
 	
 		//TCP
-   		case OF1X_MATCH_TCP_SRC:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_TCP)) return false; 
-					return __utern_compare16(&it->__tern, platform_packet_get_tcp_src(pkt));
-		}
-   		case OF1X_MATCH_TCP_DST:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_TCP)) return false; 
-					return __utern_compare16(&it->__tern, platform_packet_get_tcp_dst(pkt));
-		}
+   		case OF1X_MATCH_TCP_SRC: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_TCP_SRC) && __utern_compare16(&it->__tern, &key->tp_src);
+   		case OF1X_MATCH_TCP_DST: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_TCP_DST) && __utern_compare16(&it->__tern, &key->tp_dst);
 	
 		//UDP
-   		case OF1X_MATCH_UDP_SRC:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_UDP)) return false; 	
-					return __utern_compare16(&it->__tern, platform_packet_get_udp_src(pkt));
-		}
-   		case OF1X_MATCH_UDP_DST:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_UDP)) return false; 
-					return __utern_compare16(&it->__tern, platform_packet_get_udp_dst(pkt));
-		}
+   		case OF1X_MATCH_UDP_SRC: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_UDP_SRC) && __utern_compare16(&it->__tern, &key->tp_src);
+   		case OF1X_MATCH_UDP_DST: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_UDP_DST) && __utern_compare16(&it->__tern, &key->tp_dst);
 		//SCTP
-   		case OF1X_MATCH_SCTP_SRC:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_SCTP)) return false; 
-					return __utern_compare16(&it->__tern, platform_packet_get_sctp_src(pkt));
-		}
-   		case OF1X_MATCH_SCTP_DST:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_SCTP)) return false; 
-					return __utern_compare16(&it->__tern, platform_packet_get_sctp_dst(pkt));
-		}
+   		case OF1X_MATCH_SCTP_SRC: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_SCTP_SRC) && __utern_compare16(&it->__tern, &key->tp_src);
+   		case OF1X_MATCH_SCTP_DST: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_SCTP_DST) && __utern_compare16(&it->__tern, &key->tp_dst);
 	
 		//TP (OF1.0 only)
-   		case OF1X_MATCH_TP_SRC:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if(ptr_ip_proto && (*ptr_ip_proto == IP_PROTO_TCP))
-						return __utern_compare16(&it->__tern, platform_packet_get_tcp_src(pkt));
-   					if(ptr_ip_proto && (*ptr_ip_proto == IP_PROTO_UDP))
-						return __utern_compare16(&it->__tern, platform_packet_get_udp_src(pkt));
-					if(ptr_ip_proto && (*ptr_ip_proto == IP_PROTO_ICMPV4)){
-						uint8_t two_byte[2] = {0,*platform_packet_get_icmpv4_type(pkt)};
+   		case OF1X_MATCH_TP_SRC: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					if(key->present & (OF1X_PKT_KEY_F_TCP_SRC | OF1X_PKT_KEY_F_UDP_SRC))
+						return __utern_compare16(&it->__tern, &key->tp_src);
+					if(key->present & OF1X_PKT_KEY_F_ICMPV4_TYPE){
+						uint8_t two_byte[2] = {0,key->icmpv4_type};
 						return __utern_compare16(&it->__tern, (uint16_t*)&two_byte);
 					}
 					return false;
-		}
-   		case OF1X_MATCH_TP_DST:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if(ptr_ip_proto && (*ptr_ip_proto == IP_PROTO_TCP))
-						return __utern_compare16(&it->__tern, platform_packet_get_tcp_dst(pkt));
-   					if(ptr_ip_proto && (*ptr_ip_proto == IP_PROTO_UDP))
-						return __utern_compare16(&it->__tern, platform_packet_get_udp_dst(pkt));
-					if(ptr_ip_proto && (*ptr_ip_proto == IP_PROTO_ICMPV4)){
-						uint8_t two_byte[2] = {0,*platform_packet_get_icmpv4_code(pkt)};
+   		case OF1X_MATCH_TP_DST: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					if(key->present & (OF1X_PKT_KEY_F_TCP_DST | OF1X_PKT_KEY_F_UDP_DST))
+						return __utern_compare16(&it->__tern, &key->tp_dst);
+					if(key->present & OF1X_PKT_KEY_F_ICMPV4_CODE){
+						uint8_t two_byte[2] = {0,key->icmpv4_code};
 						return __utern_compare16(&it->__tern, (uint16_t*)&two_byte);
 					}
 					return false;
-		}
 		
 		//ICMPv4
-		case OF1X_MATCH_ICMPV4_TYPE:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_ICMPV4)) return false; 
-					return __utern_compare8(&it->__tern, platform_packet_get_icmpv4_type(pkt));
-		}
-   		case OF1X_MATCH_ICMPV4_CODE:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_ICMPV4)) return false; 
-					return __utern_compare8(&it->__tern, platform_packet_get_icmpv4_code(pkt));
-		}
+		case OF1X_MATCH_ICMPV4_TYPE: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_ICMPV4_TYPE) && __utern_compare8(&it->__tern, &key->icmpv4_type);
+   		case OF1X_MATCH_ICMPV4_CODE: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_ICMPV4_CODE) && __utern_compare8(&it->__tern, &key->icmpv4_code);
   		
 		//IPv6
-		case OF1X_MATCH_IPV6_SRC:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV6 || (*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && *ptr_ppp_proto == PPP_PROTO_IP6 ))) return false; 
-					return __utern_compare128(&it->__tern, platform_packet_get_ipv6_src(pkt));
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV6)) return false;
-					return __utern_compare128(&it->__tern, platform_packet_get_ipv6_src(pkt));
-#endif
-		}
-		case OF1X_MATCH_IPV6_DST:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV6 || (*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && *ptr_ppp_proto == PPP_PROTO_IP6 ))) return false; 
-					return __utern_compare128(&it->__tern, platform_packet_get_ipv6_dst(pkt));
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV6)) return false;
-					return __utern_compare128(&it->__tern, platform_packet_get_ipv6_dst(pkt));
-#endif
-		}
-		case OF1X_MATCH_IPV6_FLABEL:{
-#ifdef ROFL_EXPERIMENTAL
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					uint16_t *ptr_ppp_proto = platform_packet_get_ppp_proto(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV6 || (*ptr_ether_type == ETH_TYPE_PPPOE_SESSION && ptr_ppp_proto && *ptr_ppp_proto == PPP_PROTO_IP6 ))) return false; 
-					return __utern_compare32(&it->__tern, platform_packet_get_ipv6_flabel(pkt));
-#else
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_IPV6)) return false;
-					return __utern_compare32(&it->__tern, platform_packet_get_ipv6_flabel(pkt));
-#endif
-		}
-		case OF1X_MATCH_IPV6_ND_TARGET:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_ICMPV6)) return false; 
-					return __utern_compare128(&it->__tern, platform_packet_get_ipv6_nd_target(pkt));
-		}
-		case OF1X_MATCH_IPV6_ND_SLL:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_ICMPV6 && platform_packet_get_ipv6_nd_sll(pkt))) return false; //NOTE OPTION SLL active
-					return __utern_compare64(&it->__tern, platform_packet_get_ipv6_nd_sll(pkt));
-		}
-		case OF1X_MATCH_IPV6_ND_TLL:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_ICMPV6 && platform_packet_get_ipv6_nd_tll(pkt))) return false; //NOTE OPTION TLL active
-					return __utern_compare64(&it->__tern, platform_packet_get_ipv6_nd_tll(pkt));
-		}
+		case OF1X_MATCH_IPV6_SRC: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L3);
+					return (key->present & OF1X_PKT_KEY_F_IPV6_SRC) && __utern_compare128(&it->__tern, &key->ipv6_src);
+		case OF1X_MATCH_IPV6_DST: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L3);
+					return (key->present & OF1X_PKT_KEY_F_IPV6_DST) && __utern_compare128(&it->__tern, &key->ipv6_dst);
+		case OF1X_MATCH_IPV6_FLABEL: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L3);
+					return (key->present & OF1X_PKT_KEY_F_IPV6_FLABEL) && __utern_compare32(&it->__tern, &key->ipv6_flabel);
+		case OF1X_MATCH_IPV6_ND_TARGET: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_IPV6_ND_TARGET) && __utern_compare128(&it->__tern, &key->ipv6_nd_target);
+		case OF1X_MATCH_IPV6_ND_SLL: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4); //NOTE OPTION SLL active
+					return (key->present & OF1X_PKT_KEY_F_IPV6_ND_SLL) && __utern_compare64(&it->__tern, &key->ipv6_nd_sll);
+		case OF1X_MATCH_IPV6_ND_TLL: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4); //NOTE OPTION TLL active
+					return (key->present & OF1X_PKT_KEY_F_IPV6_ND_TLL) && __utern_compare64(&it->__tern, &key->ipv6_nd_tll);
 		case OF1X_MATCH_IPV6_EXTHDR: //TODO not yet implemented.
 			return false;
 			break;
 					
 		//ICMPv6
-		case OF1X_MATCH_ICMPV6_TYPE:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_ICMPV6)) return false; 
-					return __utern_compare8(&it->__tern, platform_packet_get_icmpv6_type(pkt));
-		}
-		case OF1X_MATCH_ICMPV6_CODE:{
-					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					if( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_ICMPV6 )) return false; 
-					return __utern_compare8(&it->__tern, platform_packet_get_icmpv6_code(pkt));
-		}
+		case OF1X_MATCH_ICMPV6_TYPE: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_ICMPV6_TYPE) && __utern_compare8(&it->__tern, &key->icmpv6_type);
+		case OF1X_MATCH_ICMPV6_CODE: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					return (key->present & OF1X_PKT_KEY_F_ICMPV6_CODE) && __utern_compare8(&it->__tern, &key->icmpv6_code);
 			
 		//PBB
-   		case OF1X_MATCH_PBB_ISID:{
-					uint16_t *ptr_ether_type = platform_packet_get_eth_type(pkt);
-					if( !ptr_ether_type || !(*ptr_ether_type == ETH_TYPE_PBB)) return false;
-					return __utern_compare32(&it->__tern, platform_packet_get_pbb_isid(pkt));
-		}
+   		case OF1X_MATCH_PBB_ISID: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2);
+					return (key->present & OF1X_PKT_KEY_F_PBB_ISID) && __utern_compare32(&it->__tern, &key->pbb_isid);
 	 	//TUNNEL id
-   		case OF1X_MATCH_TUNNEL_ID: return __utern_compare64(&it->__tern, platform_packet_get_tunnel_id(pkt));
+   		case OF1X_MATCH_TUNNEL_ID: key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L2);
+					return (key->present & OF1X_PKT_KEY_F_TUNNEL_ID) && __utern_compare64(&it->__tern, &key->tunnel_id);
 
 #ifdef ROFL_EXPERIMENTAL
 		//PPPoE related extensions
@@ -428,13 +231,17 @@ static inline bool __of1x_check_match(datapacket_t *const pkt, of1x_match_t* it)
 		//GTP
    		case OF1X_MATCH_GTP_MSG_TYPE:{
 					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					uint16_t *ptr_udp_dst = platform_packet_get_udp_dst(pkt);
+					uint16_t *ptr_udp_dst;
+					key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					ptr_udp_dst = (key->present & OF1X_PKT_KEY_F_UDP_DST)? &key->tp_dst : NULL;
 					if (!ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_UDP || (ptr_udp_dst && *ptr_udp_dst == UDP_DST_PORT_GTPU))) return false;
    					return __utern_compare8(&it->__tern, platform_packet_get_gtp_msg_type(pkt));
 		}
    		case OF1X_MATCH_GTP_TEID:{
 					uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-					uint16_t *ptr_udp_dst = platform_packet_get_udp_dst(pkt);
+					uint16_t *ptr_udp_dst;
+					key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+					ptr_udp_dst = (key->present & OF1X_PKT_KEY_F_UDP_DST)? &key->tp_dst : NULL;
 					if ( !ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_UDP || (ptr_udp_dst && *ptr_udp_dst == UDP_DST_PORT_GTPU))) return false;
    					return __utern_compare32(&it->__tern, platform_packet_get_gtp_teid(pkt));
 		}
@@ -442,21 +249,27 @@ static inline bool __of1x_check_match(datapacket_t *const pkt, of1x_match_t* it)
    		//CAPWAP
    		case OF1X_MATCH_CAPWAP_WBID:{
 			uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-			uint16_t *ptr_udp_dst = platform_packet_get_udp_dst(pkt);
+			uint16_t *ptr_udp_dst;
+			key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+			ptr_udp_dst = (key->present & OF1X_PKT_KEY_F_UDP_DST)? &key->tp_dst : NULL;
 			// TODO: for CAPWAP-control or CAPWAP-data or both?
 			if (!ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_UDP || (ptr_udp_dst && *ptr_udp_dst == UDP_DST_PORT_CAPWAPC))) return false;
 				return __utern_compare8(&it->__tern, platform_packet_get_capwap_wbid(pkt));
 		}
    		case OF1X_MATCH_CAPWAP_RID:{
 			uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-			uint16_t *ptr_udp_dst = platform_packet_get_udp_dst(pkt);
+			uint16_t *ptr_udp_dst;
+			key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+			ptr_udp_dst = (key->present & OF1X_PKT_KEY_F_UDP_DST)? &key->tp_dst : NULL;
 			// TODO: for CAPWAP-control or CAPWAP-data or both?
 			if (!ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_UDP || (ptr_udp_dst && *ptr_udp_dst == UDP_DST_PORT_CAPWAPC))) return false;
 				return __utern_compare8(&it->__tern, platform_packet_get_capwap_rid(pkt));
 		}
    		case OF1X_MATCH_CAPWAP_FLAGS:{
 			uint8_t *ptr_ip_proto = platform_packet_get_ip_proto(pkt);
-			uint16_t *ptr_udp_dst = platform_packet_get_udp_dst(pkt);
+			uint16_t *ptr_udp_dst;
+			key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L4);
+			ptr_udp_dst = (key->present & OF1X_PKT_KEY_F_UDP_DST)? &key->tp_dst : NULL;
 			// TODO: for CAPWAP-control or CAPWAP-data or both?
 			if (!ptr_ip_proto || !(*ptr_ip_proto == IP_PROTO_UDP || (ptr_udp_dst && *ptr_udp_dst == UDP_DST_PORT_CAPWAPC))) return false;
 				return __utern_compare16(&it->__tern, platform_packet_get_capwap_flags(pkt));
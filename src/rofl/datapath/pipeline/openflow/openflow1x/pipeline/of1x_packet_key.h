@@ -0,0 +1,146 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __OF1X_PACKET_KEY_H__
+#define __OF1X_PACKET_KEY_H__
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "rofl_datapath.h"
+#include "../../../common/large_types.h"
+
+/**
+* @file of1x_packet_key.h
+*
+* @brief OpenFlow v1.0, 1.2 and 1.3.2 canonical packet key
+*
+* The packet key holds the values of the (non-experimental) match fields of
+* a packet, along with a presence bitmap. A field is flagged as present only if
+* its prerequisites (ether type, ip proto...) are met AND the platform
+* returned a value for it; hence matching algorithms don't need to re-check
+* prerequisites nor NULL pointers.
+*
+* The key is extracted lazily, per protocol layer, the first time a field of
+* the layer is accessed (see of1x_packet_key_pp.h), and it is kept in the
+* datapacket. It is invalidated on pipeline entry and whenever the packet is
+* mangled (apply actions).
+*
+* With deferred set-fields (see of1x_set_field_pp.h) the key also shadows
+* the header fields rewritten and not yet written back to the packet.
+*
+* Values are stored in the same byte order as returned by the platform getters
+* (NBO for packet fields).
+*/
+
+//Layers (extraction units)
+#define OF1X_PKT_KEY_L2		0x01	//port_in, phy_port_in, eth, vlan, pbb, tunnel id
+#define OF1X_PKT_KEY_MPLS	0x02
+#define OF1X_PKT_KEY_ARP	0x04
+#define OF1X_PKT_KEY_L3		0x08	//IPv4/IPv6
+#define OF1X_PKT_KEY_L4		0x10	//TCP/UDP/SCTP/ICMPv4/ICMPv6 (ND)
+
+//Field presence bitmap
+#define OF1X_PKT_KEY_F_IN_PORT		(1ULL << 0)
+#define OF1X_PKT_KEY_F_IN_PHY_PORT	(1ULL << 1)
+#define OF1X_PKT_KEY_F_ETH_DST		(1ULL << 2)
+#define OF1X_PKT_KEY_F_ETH_SRC		(1ULL << 3)
+#define OF1X_PKT_KEY_F_ETH_TYPE		(1ULL << 4)
+#define OF1X_PKT_KEY_F_VLAN		(1ULL << 5)	//Packet has a VLAN tag
+#define OF1X_PKT_KEY_F_VLAN_VID		(1ULL << 6)
+#define OF1X_PKT_KEY_F_VLAN_PCP		(1ULL << 7)
+#define OF1X_PKT_KEY_F_PBB_ISID		(1ULL << 8)
+#define OF1X_PKT_KEY_F_TUNNEL_ID	(1ULL << 9)
+#define OF1X_PKT_KEY_F_MPLS_LABEL	(1ULL << 10)
+#define OF1X_PKT_KEY_F_MPLS_TC		(1ULL << 11)
+#define OF1X_PKT_KEY_F_MPLS_BOS		(1ULL << 12)
+#define OF1X_PKT_KEY_F_ARP_OP		(1ULL << 13)
+#define OF1X_PKT_KEY_F_ARP_SHA		(1ULL << 14)
+#define OF1X_PKT_KEY_F_ARP_SPA		(1ULL << 15)
+#define OF1X_PKT_KEY_F_ARP_THA		(1ULL << 16)
+#define OF1X_PKT_KEY_F_ARP_TPA		(1ULL << 17)
+#define OF1X_PKT_KEY_F_IP_PROTO		(1ULL << 18)
+#define OF1X_PKT_KEY_F_IP_DSCP		(1ULL << 19)
+#define OF1X_PKT_KEY_F_IP_ECN		(1ULL << 20)
+#define OF1X_PKT_KEY_F_IPV4_SRC		(1ULL << 21)
+#define OF1X_PKT_KEY_F_IPV4_DST		(1ULL << 22)
+#define OF1X_PKT_KEY_F_IPV6_SRC		(1ULL << 23)
+#define OF1X_PKT_KEY_F_IPV6_DST		(1ULL << 24)
+#define OF1X_PKT_KEY_F_IPV6_FLABEL	(1ULL << 25)
+#define OF1X_PKT_KEY_F_TCP_SRC		(1ULL << 26)
+#define OF1X_PKT_KEY_F_TCP_DST		(1ULL << 27)
+#define OF1X_PKT_KEY_F_UDP_SRC		(1ULL << 28)
+#define OF1X_PKT_KEY_F_UDP_DST		(1ULL << 29)
+#define OF1X_PKT_KEY_F_SCTP_SRC		(1ULL << 30)
+#define OF1X_PKT_KEY_F_SCTP_DST		(1ULL << 31)
+#define OF1X_PKT_KEY_F_ICMPV4_TYPE	(1ULL << 32)
+#define OF1X_PKT_KEY_F_ICMPV4_CODE	(1ULL << 33)
+#define OF1X_PKT_KEY_F_ICMPV6_TYPE	(1ULL << 34)
+#define OF1X_PKT_KEY_F_ICMPV6_CODE	(1ULL << 35)
+#define OF1X_PKT_KEY_F_IPV6_ND_TARGET	(1ULL << 36)
+#define OF1X_PKT_KEY_F_IPV6_ND_SLL	(1ULL << 37)
+#define OF1X_PKT_KEY_F_IPV6_ND_TLL	(1ULL << 38)
+
+//Any of the transport ports
+#define OF1X_PKT_KEY_F_TP_SRC	(OF1X_PKT_KEY_F_TCP_SRC | OF1X_PKT_KEY_F_UDP_SRC | OF1X_PKT_KEY_F_SCTP_SRC)
+#define OF1X_PKT_KEY_F_TP_DST	(OF1X_PKT_KEY_F_TCP_DST | OF1X_PKT_KEY_F_UDP_DST | OF1X_PKT_KEY_F_SCTP_DST)
+
+/**
+* @brief Canonical packet key
+*/
+typedef struct of1x_packet_key{
+	//Layers extracted (OF1X_PKT_KEY_XX)
+	uint8_t layers;
+
+	//Presence bitmap (OF1X_PKT_KEY_F_XX)
+	uint64_t present;
+
+	//Fields set (deferred) but not yet written back to the packet (OF1X_PKT_KEY_F_XX)
+	uint64_t dirty;
+
+	//128 bit fields
+	uint128__t ipv6_src;
+	uint128__t ipv6_dst;
+	uint128__t ipv6_nd_target;
+
+	//64 bit fields
+	uint64_t eth_dst;
+	uint64_t eth_src;
+	uint64_t tunnel_id;
+	uint64_t arp_sha;
+	uint64_t arp_tha;
+	uint64_t ipv6_nd_sll;
+	uint64_t ipv6_nd_tll;
+
+	//32 bit fields
+	uint32_t port_in;
+	uint32_t phy_port_in;
+	uint32_t pbb_isid;
+	uint32_t mpls_label;
+	uint32_t arp_spa;
+	uint32_t arp_tpa;
+	uint32_t ipv4_src;
+	uint32_t ipv4_dst;
+	uint32_t ipv6_flabel;
+
+	//16 bit fields
+	uint16_t eth_type;
+	uint16_t vlan_vid;
+	uint16_t arp_opcode;
+	uint16_t tp_src;	//TCP, UDP or SCTP
+	uint16_t tp_dst;	//TCP, UDP or SCTP
+
+	//8 bit fields
+	uint8_t vlan_pcp;
+	uint8_t mpls_tc;
+	uint8_t mpls_bos;
+	uint8_t ip_proto;
+	uint8_t ip_dscp;
+	uint8_t ip_ecn;
+	uint8_t icmpv4_type;
+	uint8_t icmpv4_code;
+	uint8_t icmpv6_type;
+	uint8_t icmpv6_code;
+}of1x_packet_key_t;
+
+#endif //OF1X_PACKET_KEY
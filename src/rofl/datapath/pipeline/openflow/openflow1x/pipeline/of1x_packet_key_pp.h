@@ -0,0 +1,360 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __OF1X_PACKET_KEY_PP_H__
+#define __OF1X_PACKET_KEY_PP_H__
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "rofl_datapath.h"
+#include "../../../util/pp_guard.h" //Never forget to include the guard
+#include "../../../common/datapacket.h"
+#include "../../../common/protocol_constants.h"
+#include "../../../platform/likely.h"
+#include "../../../platform/packet.h"
+#include "of1x_packet_key.h"
+
+/**
+* @file of1x_packet_key_pp.h
+*
+* @brief Canonical packet key extraction (packet processing routines)
+*
+* Prerequisites applied are the same as the ones of the OF1.X matches
+* (see __of1x_check_match()).
+*/
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+/**
+* Invalidate the packet key. MUST be called whenever the packet is mangled,
+* once deferred set-fields (if any) have been written back
+*/
+static inline void __of1x_invalidate_packet_key(datapacket_t *const pkt){
+	pkt->key.of1x.layers = 0x0;
+	pkt->key.of1x.present = 0x0ULL;
+	pkt->key.of1x.dirty = 0x0ULL;
+}
+
+static inline void __of1x_extract_packet_key_l2(datapacket_t *const pkt, of1x_packet_key_t* key){
+
+	uint32_t *port_in, *phy_port_in, *isid;
+	uint64_t *eth_dst, *eth_src, *tunnel_id;
+	uint16_t *eth_type, *vid;
+	uint8_t *pcp;
+
+	port_in = platform_packet_get_port_in(pkt);
+	if(port_in){
+		key->present |= OF1X_PKT_KEY_F_IN_PORT;
+		key->port_in = *port_in;
+
+		//According to spec
+		phy_port_in = platform_packet_get_phy_port_in(pkt);
+		if(phy_port_in){
+			key->present |= OF1X_PKT_KEY_F_IN_PHY_PORT;
+			key->phy_port_in = *phy_port_in;
+		}
+	}
+
+	//802
+	eth_dst = platform_packet_get_eth_dst(pkt);
+	if(eth_dst){
+		key->present |= OF1X_PKT_KEY_F_ETH_DST;
+		key->eth_dst = *eth_dst;
+	}
+	eth_src = platform_packet_get_eth_src(pkt);
+	if(eth_src){
+		key->present |= OF1X_PKT_KEY_F_ETH_SRC;
+		key->eth_src = *eth_src;
+	}
+	eth_type = platform_packet_get_eth_type(pkt);
+	if(eth_type){
+		key->present |= OF1X_PKT_KEY_F_ETH_TYPE;
+		key->eth_type = *eth_type;
+	}
+
+	//802.1q
+	if(platform_packet_has_vlan(pkt)){
+		key->present |= OF1X_PKT_KEY_F_VLAN;
+		vid = platform_packet_get_vlan_vid(pkt);
+		if(vid){
+			key->present |= OF1X_PKT_KEY_F_VLAN_VID;
+			key->vlan_vid = *vid;
+		}
+		pcp = platform_packet_get_vlan_pcp(pkt);
+		if(pcp){
+			key->present |= OF1X_PKT_KEY_F_VLAN_PCP;
+			key->vlan_pcp = *pcp;
+		}
+	}
+
+	//PBB
+	if(eth_type && *eth_type == ETH_TYPE_PBB){
+		isid = platform_packet_get_pbb_isid(pkt);
+		if(isid){
+			key->present |= OF1X_PKT_KEY_F_PBB_ISID;
+			key->pbb_isid = *isid;
+		}
+	}
+
+	//Tunnel id
+	tunnel_id = platform_packet_get_tunnel_id(pkt);
+	if(tunnel_id){
+		key->present |= OF1X_PKT_KEY_F_TUNNEL_ID;
+		key->tunnel_id = *tunnel_id;
+	}
+}
+
+static inline void __of1x_extract_packet_key_mpls(datapacket_t *const pkt, of1x_packet_key_t* key){
+
+	uint32_t *label;
+	uint8_t *tc;
+
+	if(!(key->present & OF1X_PKT_KEY_F_ETH_TYPE) || !(key->eth_type == ETH_TYPE_MPLS_UNICAST || key->eth_type == ETH_TYPE_MPLS_MULTICAST))
+		return;
+
+	label = platform_packet_get_mpls_label(pkt);
+	if(label){
+		key->present |= OF1X_PKT_KEY_F_MPLS_LABEL;
+		key->mpls_label = *label;
+	}
+	tc = platform_packet_get_mpls_tc(pkt);
+	if(tc){
+		key->present |= OF1X_PKT_KEY_F_MPLS_TC;
+		key->mpls_tc = *tc;
+	}
+	key->present |= OF1X_PKT_KEY_F_MPLS_BOS;
+	key->mpls_bos = platform_packet_get_mpls_bos(pkt);
+}
+
+static inline void __of1x_extract_packet_key_arp(datapacket_t *const pkt, of1x_packet_key_t* key){
+
+	uint16_t *opcode;
+	uint64_t *sha, *tha;
+	uint32_t *spa, *tpa;
+
+	if(!(key->present & OF1X_PKT_KEY_F_ETH_TYPE) || key->eth_type != ETH_TYPE_ARP)
+		return;
+
+	opcode = platform_packet_get_arp_opcode(pkt);
+	if(opcode){
+		key->present |= OF1X_PKT_KEY_F_ARP_OP;
+		key->arp_opcode = *opcode;
+	}
+	sha = platform_packet_get_arp_sha(pkt);
+	if(sha){
+		key->present |= OF1X_PKT_KEY_F_ARP_SHA;
+		key->arp_sha = *sha;
+	}
+	spa = platform_packet_get_arp_spa(pkt);
+	if(spa){
+		key->present |= OF1X_PKT_KEY_F_ARP_SPA;
+		key->arp_spa = *spa;
+	}
+	tha = platform_packet_get_arp_tha(pkt);
+	if(tha){
+		key->present |= OF1X_PKT_KEY_F_ARP_THA;
+		key->arp_tha = *tha;
+	}
+	tpa = platform_packet_get_arp_tpa(pkt);
+	if(tpa){
+		key->present |= OF1X_PKT_KEY_F_ARP_TPA;
+		key->arp_tpa = *tpa;
+	}
+}
+
+static inline void __of1x_extract_packet_key_l3(datapacket_t *const pkt, of1x_packet_key_t* key){
+
+	bool is_ipv4, is_ipv6, is_ip_tos;
+	uint8_t *ip_proto;
+	uint32_t *ipv4_src, *ipv4_dst, *flabel;
+	uint128__t *ipv6_src, *ipv6_dst;
+
+	if(!(key->present & OF1X_PKT_KEY_F_ETH_TYPE))
+		return;
+
+	is_ipv4 = (key->eth_type == ETH_TYPE_IPV4);
+	is_ipv6 = (key->eth_type == ETH_TYPE_IPV6);
+	is_ip_tos = is_ipv4 || is_ipv6;
+
+#ifdef ROFL_EXPERIMENTAL
+	if(key->eth_type == ETH_TYPE_PPPOE_SESSION){
+		uint16_t *ppp_proto = platform_packet_get_ppp_proto(pkt);
+		if(ppp_proto && *ppp_proto == PPP_PROTO_IP4)
+			is_ipv4 = is_ip_tos = true;
+		if(ppp_proto && *ppp_proto == PPP_PROTO_IP6)
+			is_ipv6 = true; //NOTE no ECN/DSCP for PPP_PROTO_IP6
+	}
+#endif
+
+	if(!is_ipv4 && !is_ipv6)
+		return;
+
+	ip_proto = platform_packet_get_ip_proto(pkt);
+	if(ip_proto){
+		key->present |= OF1X_PKT_KEY_F_IP_PROTO;
+		key->ip_proto = *ip_proto;
+	}
+	if(is_ip_tos){
+		key->present |= OF1X_PKT_KEY_F_IP_DSCP | OF1X_PKT_KEY_F_IP_ECN;
+		key->ip_dscp = platform_packet_get_ip_dscp(pkt);
+		key->ip_ecn = platform_packet_get_ip_ecn(pkt);
+	}
+
+	if(is_ipv4){
+		ipv4_src = platform_packet_get_ipv4_src(pkt);
+		if(ipv4_src){
+			key->present |= OF1X_PKT_KEY_F_IPV4_SRC;
+			key->ipv4_src = *ipv4_src;
+		}
+		ipv4_dst = platform_packet_get_ipv4_dst(pkt);
+		if(ipv4_dst){
+			key->present |= OF1X_PKT_KEY_F_IPV4_DST;
+			key->ipv4_dst = *ipv4_dst;
+		}
+	}else{
+		ipv6_src = platform_packet_get_ipv6_src(pkt);
+		if(ipv6_src){
+			key->present |= OF1X_PKT_KEY_F_IPV6_SRC;
+			key->ipv6_src = *ipv6_src;
+		}
+		ipv6_dst = platform_packet_get_ipv6_dst(pkt);
+		if(ipv6_dst){
+			key->present |= OF1X_PKT_KEY_F_IPV6_DST;
+			key->ipv6_dst = *ipv6_dst;
+		}
+		flabel = platform_packet_get_ipv6_flabel(pkt);
+		if(flabel){
+			key->present |= OF1X_PKT_KEY_F_IPV6_FLABEL;
+			key->ipv6_flabel = *flabel;
+		}
+	}
+}
+
+//Note: L4 prerequisites are based on the IP proto only
+static inline void __of1x_extract_packet_key_l4(datapacket_t *const pkt, of1x_packet_key_t* key){
+
+	uint8_t *ip_proto, *type, *code;
+	uint16_t *src=NULL, *dst=NULL;
+	uint64_t src_flag=0x0ULL, dst_flag=0x0ULL;
+
+	ip_proto = platform_packet_get_ip_proto(pkt);
+	if(!ip_proto)
+		return;
+
+	switch(*ip_proto){
+		case IP_PROTO_TCP:
+			src = platform_packet_get_tcp_src(pkt);
+			dst = platform_packet_get_tcp_dst(pkt);
+			src_flag = OF1X_PKT_KEY_F_TCP_SRC;
+			dst_flag = OF1X_PKT_KEY_F_TCP_DST;
+			break;
+		case IP_PROTO_UDP:
+			src = platform_packet_get_udp_src(pkt);
+			dst = platform_packet_get_udp_dst(pkt);
+			src_flag = OF1X_PKT_KEY_F_UDP_SRC;
+			dst_flag = OF1X_PKT_KEY_F_UDP_DST;
+			break;
+		case IP_PROTO_SCTP:
+			src = platform_packet_get_sctp_src(pkt);
+			dst = platform_packet_get_sctp_dst(pkt);
+			src_flag = OF1X_PKT_KEY_F_SCTP_SRC;
+			dst_flag = OF1X_PKT_KEY_F_SCTP_DST;
+			break;
+		case IP_PROTO_ICMPV4:
+			type = platform_packet_get_icmpv4_type(pkt);
+			if(type){
+				key->present |= OF1X_PKT_KEY_F_ICMPV4_TYPE;
+				key->icmpv4_type = *type;
+			}
+			code = platform_packet_get_icmpv4_code(pkt);
+			if(code){
+				key->present |= OF1X_PKT_KEY_F_ICMPV4_CODE;
+				key->icmpv4_code = *code;
+			}
+			return;
+		case IP_PROTO_ICMPV6:{
+			uint128__t *target;
+			uint64_t *sll, *tll;
+
+			type = platform_packet_get_icmpv6_type(pkt);
+			if(type){
+				key->present |= OF1X_PKT_KEY_F_ICMPV6_TYPE;
+				key->icmpv6_type = *type;
+			}
+			code = platform_packet_get_icmpv6_code(pkt);
+			if(code){
+				key->present |= OF1X_PKT_KEY_F_ICMPV6_CODE;
+				key->icmpv6_code = *code;
+			}
+			target = platform_packet_get_ipv6_nd_target(pkt);
+			if(target){
+				key->present |= OF1X_PKT_KEY_F_IPV6_ND_TARGET;
+				key->ipv6_nd_target = *target;
+			}
+			sll = platform_packet_get_ipv6_nd_sll(pkt);
+			if(sll){
+				key->present |= OF1X_PKT_KEY_F_IPV6_ND_SLL;
+				key->ipv6_nd_sll = *sll;
+			}
+			tll = platform_packet_get_ipv6_nd_tll(pkt);
+			if(tll){
+				key->present |= OF1X_PKT_KEY_F_IPV6_ND_TLL;
+				key->ipv6_nd_tll = *tll;
+			}
+			return;
+		}
+		default:
+			return;
+	}
+
+	if(src){
+		key->present |= src_flag;
+		key->tp_src = *src;
+	}
+	if(dst){
+		key->present |= dst_flag;
+		key->tp_dst = *dst;
+	}
+}
+
+//Extracts the layers not yet extracted
+static inline void __of1x_extract_packet_key(datapacket_t *const pkt, of1x_packet_key_t* key, uint8_t layers){
+
+	//MPLS, ARP and L3 depend on the L2
+	if(layers & (OF1X_PKT_KEY_MPLS | OF1X_PKT_KEY_ARP | OF1X_PKT_KEY_L3))
+		layers |= OF1X_PKT_KEY_L2;
+	layers &= ~key->layers;
+
+	if(layers & OF1X_PKT_KEY_L2)
+		__of1x_extract_packet_key_l2(pkt, key);
+	if(layers & OF1X_PKT_KEY_MPLS)
+		__of1x_extract_packet_key_mpls(pkt, key);
+	if(layers & OF1X_PKT_KEY_ARP)
+		__of1x_extract_packet_key_arp(pkt, key);
+	if(layers & OF1X_PKT_KEY_L3)
+		__of1x_extract_packet_key_l3(pkt, key);
+	if(layers & OF1X_PKT_KEY_L4)
+		__of1x_extract_packet_key_l4(pkt, key);
+
+	key->layers |= layers;
+}
+
+/**
+* Get the packet key, with (at least) the layers requested extracted
+*/
+static inline of1x_packet_key_t* __of1x_get_packet_key(datapacket_t *const pkt, uint8_t layers){
+
+	of1x_packet_key_t* key = &pkt->key.of1x;
+
+	if(unlikely((key->layers & layers) != layers))
+		__of1x_extract_packet_key(pkt, key, layers);
+
+	return key;
+}
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //OF1X_PACKET_KEY_PP
@@ -35,6 +35,8 @@ rofl_result_t __of1x_init_pipeline(struct of1x_switch* sw, const unsigned int nu
 	pipeline->sw = sw;
 	pipeline->num_of_tables = num_of_tables;
 	pipeline->num_of_buffers = 0; //Should be filled in the post_init hook
+	platform_memset(&pipeline->stats_service, 0, sizeof(of1x_stats_service_t));
+	pipeline->tables_refs = pipeline->groups_refs = NULL;
 
 
 	//Allocate tables and initialize	
@@ -167,8 +169,14 @@ rofl_result_t __of1x_set_pipeline_tables_defaults(of1x_pipeline_t* pipeline, of_
 				return ROFL_FAILURE;			
 
 		}
+
+		//Configuration changed
+		pipeline->tables[i].revision++;
 	}
 
+	if(pipeline->groups)
+		pipeline->groups->revision++;
+
 	return ROFL_SUCCESS;
 }
 
@@ -178,55 +186,117 @@ rofl_result_t __of1x_set_pipeline_tables_defaults(of1x_pipeline_t* pipeline, of_
 // Snapshots
 //
 
+//Checks whether table i changed since the base snapshot
+static inline bool __of1x_pipeline_table_changed(of1x_pipeline_t* pipeline, of1x_pipeline_snapshot_t* base, int i){
+	return !base || !base->tables || base->num_of_tables != pipeline->num_of_tables || base->tables[i].revision != pipeline->tables[i].revision;
+}
+
+//Checks whether any table changed since the base snapshot
+static bool __of1x_pipeline_tables_changed(of1x_pipeline_t* pipeline, of1x_pipeline_snapshot_t* base){
+
+	int i;
+
+	for(i=0;i<pipeline->num_of_tables;i++){
+		if(__of1x_pipeline_table_changed(pipeline, base, i))
+			return true;
+	}
+
+	return false;
+}
+
+//Snapshot the running table in t
+static void __of1x_pipeline_snapshot_table(of1x_flow_table_t* table, of1x_flow_table_t* t){
+
+	__of1x_stats_table_tid_t c;
+
+	memcpy(t, table, sizeof(of1x_flow_table_t));
+
+	//Consolidate stats
+	__of1x_stats_table_consolidate(&t->stats, &c);
+
+	//Memset to 0
+	memset(&t->stats,0,sizeof(of1x_stats_table_t));
+
+	//Assign consolidated
+	t->stats.s.counters = c;	
+	
+	t->pipeline = t->rwlock = t->mutex = t->matching_aux[0] = t->matching_aux[1] = NULL;
+	t->index.buckets = NULL;
+	
+#if OF1X_TIMER_STATIC_ALLOCATION_SLOTS	
+#else
+	t->timers = NULL;
+#endif
+}
+
 //Creates a snapshot of the running pipeline of an LSI 
 rofl_result_t __of1x_pipeline_get_snapshot(of1x_pipeline_t* pipeline, of1x_pipeline_snapshot_t* sn){
+	return __of1x_pipeline_get_delta_snapshot(pipeline, NULL, sn);
+}
+
+rofl_result_t __of1x_pipeline_get_delta_snapshot(of1x_pipeline_t* pipeline, of1x_pipeline_snapshot_t* base, of1x_pipeline_snapshot_t* sn){
 
 	int i;
-	of1x_flow_table_t* t;
+	uint64_t groups_revision;
 
 	//Cleanup stuff coming from the cloning process
 	sn->sw = NULL;		
 
-	//Allocate tables and initialize	
-	sn->tables = (of1x_flow_table_t*)platform_malloc_shared(sizeof(of1x_flow_table_t)*pipeline->num_of_tables);
+	//No table changed; share them
+	if(!__of1x_pipeline_tables_changed(pipeline, base)){
+		sn->tables = base->tables;
+		sn->tables_refs = base->tables_refs;
+		refcnt_get(sn->tables_refs);
+		goto snapshot_groups;
+	}
+
+	//Allocate tables (and the reference counter) and initialize	
+	sn->tables = (of1x_flow_table_t*)platform_malloc_shared(sizeof(of1x_flow_table_t)*pipeline->num_of_tables + sizeof(refcnt_t));
 	
 	if(!sn->tables)
 		return ROFL_FAILURE;
 
-	//Copy contents of the tables and remove references
-	memcpy(sn->tables, pipeline->tables, sizeof(of1x_flow_table_t)*pipeline->num_of_tables);
+	sn->tables_refs = (refcnt_t*)&sn->tables[pipeline->num_of_tables];
+	refcnt_init(sn->tables_refs);
 
-	//Snapshot tables tables
+	//Snapshot the tables that changed; reuse the (consolidated) rest from base
 	for(i=0;i<pipeline->num_of_tables;i++){
-		__of1x_stats_table_tid_t c;
-
-		t = &sn->tables[i];
-		
-		//Consolidate stats
-		__of1x_stats_table_consolidate(&t->stats, &c);
-
-		//Memset to 0
-		memset(&t->stats,0,sizeof(of1x_stats_table_t));
-	
-		//Assign consolidated
-		t->stats.s.counters = c;	
-		
-		t->pipeline = t->rwlock = t->mutex = t->matching_aux[0] = t->matching_aux[1] = NULL;
-		
-#if OF1X_TIMER_STATIC_ALLOCATION_SLOTS	
-#else
-		t->timers = NULL;
-#endif
+		if(__of1x_pipeline_table_changed(pipeline, base, i))
+			__of1x_pipeline_snapshot_table(&pipeline->tables[i], &sn->tables[i]);
+		else
+			memcpy(&sn->tables[i], &base->tables[i], sizeof(of1x_flow_table_t));
 	}
 	
+snapshot_groups:
 	//TODO: deep entry copy?
 	sn->num_of_tables = pipeline->num_of_tables;
 	sn->num_of_buffers = pipeline->num_of_buffers;
 	sn->capabilities = pipeline->capabilities;
 	sn->miss_send_len = pipeline->miss_send_len;
 
-	//Allocate GROUPS and initialize
-	sn->groups = (of1x_group_table_t*)platform_malloc_shared(sizeof(of1x_group_table_t));
+	platform_rwlock_rdlock(pipeline->groups->rwlock);
+	groups_revision = pipeline->groups->revision;
+	platform_rwlock_rdunlock(pipeline->groups->rwlock);
+
+	//Group table unchanged; share it
+	if(base && base->groups && base->groups->revision == groups_revision){
+		sn->groups = base->groups;
+		sn->groups_refs = base->groups_refs;
+		refcnt_get(sn->groups_refs);
+		return ROFL_SUCCESS;
+	}
+
+	//Allocate GROUPS (and the reference counter) and initialize
+	sn->groups = (of1x_group_table_t*)platform_malloc_shared(sizeof(of1x_group_table_t) + sizeof(refcnt_t));
+
+	if(!sn->groups){
+		if(refcnt_put(sn->tables_refs))
+			platform_free_shared(sn->tables);
+		return ROFL_FAILURE;
+	}
+
+	sn->groups_refs = (refcnt_t*)&sn->groups[1];
+	refcnt_init(sn->groups_refs);
 	
 	platform_rwlock_rdlock(pipeline->groups->rwlock);
 	
@@ -237,13 +307,20 @@ rofl_result_t __of1x_pipeline_get_snapshot(of1x_pipeline_t* pipeline, of1x_pipel
 	
 	//clean unnecessary information
 	sn->groups->head = sn->groups->tail = sn->groups->rwlock = NULL;
+	sn->groups->mutex = NULL;
+	sn->groups->hash = NULL;
+	sn->groups->free_groups = NULL;
+	sn->groups->slabs = NULL;
+	sn->groups->pipeline = NULL;
 	
 	return ROFL_SUCCESS;
 }
 
 //Destroy a previously getd snapshot
 void __of1x_pipeline_destroy_snapshot(of1x_pipeline_snapshot_t* sn){
-	//Release tables memory
-	platform_free_shared(sn->tables);
-	platform_free_shared(sn->groups);
+	//Release tables memory (last reference)
+	if(refcnt_put(sn->tables_refs))
+		platform_free_shared(sn->tables);
+	if(refcnt_put(sn->groups_refs))
+		platform_free_shared(sn->groups);
 }
@@ -63,10 +63,19 @@ typedef struct of1x_pipeline{
 
 	//Array of tables; 
 	of1x_flow_table_t* tables;
+
+	//Snapshots only; the tables are shared among delta snapshots
+	refcnt_t* tables_refs;
 	
 	//Group table
 	of1x_group_table_t* groups;
 
+	//Snapshots only; the group table is shared among delta snapshots
+	refcnt_t* groups_refs;
+
+	//Stats service
+	of1x_stats_service_t stats_service;
+
 	//Reference back
 	struct of1x_switch* sw;	
 }of1x_pipeline_t;
@@ -94,6 +103,9 @@ rofl_result_t __of1x_set_pipeline_tables_defaults(of1x_pipeline_t* pipeline, of_
 //Creates a snapshot of the running pipeline of an LSI 
 rofl_result_t __of1x_pipeline_get_snapshot(of1x_pipeline_t* pipeline, of1x_pipeline_snapshot_t* snapshot);
 
+//Creates a snapshot reusing the tables and the group table of base that did not change (base may be NULL)
+rofl_result_t __of1x_pipeline_get_delta_snapshot(of1x_pipeline_t* pipeline, of1x_pipeline_snapshot_t* base, of1x_pipeline_snapshot_t* snapshot);
+
 //Destroy a previously generated snapshot
 void __of1x_pipeline_destroy_snapshot(of1x_pipeline_snapshot_t* snapshot);
 
@@ -11,6 +11,8 @@
 #include "of1x_pipeline.h"
 #include "of1x_flow_table_pp.h"
 #include "of1x_instruction_pp.h"
+#include "of1x_packet_key_pp.h"
+#include "of1x_checksum_pp.h"
 #include "of1x_statistics_pp.h"
 
 //This block is not necessary but it is useful to prevent
@@ -53,12 +55,15 @@ static inline void __of1x_process_packet_pipeline(const unsigned int tid, const
 
 	//Loop over tables
 	unsigned int i, table_to_go, num_of_outputs;
+	bool consumed;
 	of1x_flow_table_t* table;
 	of1x_flow_entry_t* match;
 	
 	//Initialize packet for OF1.X pipeline processing 
 	__init_packet_metadata(pkt);
 	__of1x_init_packet_write_actions(&pkt->write_actions.of1x);
+	__of1x_invalidate_packet_key(pkt);
+	__of1x_init_checksum_deltas(pkt);
 
 	//Mark packet as being processed by this sw
 	pkt->sw = sw;
@@ -92,7 +97,10 @@ static inline void __of1x_process_packet_pipeline(const unsigned int tid, const
 			__of1x_stats_table_update_match(tid, &table->stats);
 			
 			//Update flow statistics
-			__of1x_stats_flow_update_match(tid, &match->stats, platform_packet_get_size_bytes(pkt));
+			__of1x_stats_flow_update_match(tid, &match->stats, __of1x_get_packet_size(pkt));
+
+			//Last output may consume the packet; cannot be checked afterwards
+			consumed = __of1x_process_instructions_consume_pkt(&match->inst_grp, pkt);
 
 			//Process instructions
 			table_to_go = __of1x_process_instructions(tid, (of1x_switch_t*)sw, i, pkt, &match->inst_grp);
@@ -102,6 +110,12 @@ static inline void __of1x_process_packet_pipeline(const unsigned int tid, const
 				ROFL_PIPELINE_INFO("Packet[%p] Going to table %u->%u\n",pkt, i,table_to_go);
 				i = table_to_go-1;
 
+#ifndef ROFL_PIPELINE_DEFERRED_SET_FIELDS
+				//Packet may have been mangled; key must be re-extracted
+				if(match->inst_grp.instructions[OF1X_IT_APPLY_ACTIONS].type == OF1X_IT_APPLY_ACTIONS)
+					__of1x_invalidate_packet_key(pkt);
+#endif
+
 #ifdef ROFL_PIPELINE_LOCKLESS
 				//Unmark core presence in the table
 				tid_mark_as_not_present(tid, &table->tid_presence_mask);
@@ -113,7 +127,8 @@ static inline void __of1x_process_packet_pipeline(const unsigned int tid, const
 			}
 
 			//Process WRITE actions
-			__of1x_process_write_actions(tid, (of1x_switch_t*)sw, i, pkt, __of1x_process_instructions_must_replicate(&match->inst_grp));
+			if(!consumed)
+				__of1x_process_write_actions(tid, (of1x_switch_t*)sw, i, pkt, __of1x_process_instructions_must_replicate(&match->inst_grp));
 
 			//Recover the num_of_outputs to release the lock asap
 			num_of_outputs = match->inst_grp.num_of_outputs;
@@ -127,8 +142,8 @@ static inline void __of1x_process_packet_pipeline(const unsigned int tid, const
 #endif
 
 			//Drop packet Only if there has been copy(cloning of the packet) due to 
-			//multiple output actions
-			if(num_of_outputs != 1)
+			//multiple output actions, and the last output did not consume it
+			if(num_of_outputs != 1 && !consumed)
 				platform_packet_drop(pkt);
 							
 			return;	
@@ -152,6 +167,10 @@ static inline void __of1x_process_packet_pipeline(const unsigned int tid, const
 			
 				ROFL_PIPELINE_INFO("Packet[%p] table MISS_CONTROLLER. Generating a PACKET_IN event towards the controller\n",pkt);
 
+				//Set-fields of previous tables may be pending
+				__of1x_flush_set_fields(pkt);
+				__of1x_commit_checksum_deltas(pkt);
+
 				platform_of1x_packet_in((of1x_switch_t*)sw, i, pkt, ((of1x_switch_t*)sw)->pipeline.miss_send_len, OF1X_PKT_IN_NO_MATCH);
 				return;
 			}
@@ -174,8 +193,12 @@ static inline void of1x_process_packet_out_pipeline(const unsigned int tid, cons
 	datapacket_t* reinject_pkt=NULL;
 	of1x_group_table_t *gt = sw->pipeline.groups;
 
-	//Validate apply_actions_group
-	__of1x_validate_action_group(NULL, (of1x_action_group_t*)apply_actions_group, gt, true);
+	//Validate apply_actions_group (e.g. unknown groups or experimenter actions)
+	if(unlikely(__of1x_validate_action_group(NULL, (of1x_action_group_t*)apply_actions_group, gt, true) != ROFL_SUCCESS)){
+		ROFL_PIPELINE_INFO("Packet[%p] WARNING: dropping! Invalid PKT_OUT action group.\n",pkt);
+		platform_packet_drop(pkt);
+		return;
+	}
 
 #ifdef DEBUG
 	ROFL_PIPELINE_INFO("Packet[%p] Processing PKT_OUT, action group: ",pkt);
@@ -192,6 +215,10 @@ static inline void of1x_process_packet_out_pipeline(const unsigned int tid, cons
 	
 	has_multiple_outputs = (apply_actions_group->num_of_output_actions > 1);
 	
+	//Initialize packet key, size and checksum deltas
+	__of1x_invalidate_packet_key(pkt);
+	__of1x_invalidate_packet_size(pkt);
+	__of1x_init_checksum_deltas(pkt);
 
 	//Just process the action group
 	__of1x_process_apply_actions(tid, (of1x_switch_t*)sw, 0, pkt, apply_actions_group, has_multiple_outputs, &reinject_pkt);
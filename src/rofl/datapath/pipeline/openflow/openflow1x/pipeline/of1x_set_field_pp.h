@@ -0,0 +1,279 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __OF1X_SET_FIELD_PP_H__
+#define __OF1X_SET_FIELD_PP_H__
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "rofl_datapath.h"
+#include "../../../util/pp_guard.h" //Never forget to include the guard
+#include "../../../common/datapacket.h"
+#include "../../../common/protocol_constants.h"
+#include "../../../platform/likely.h"
+#include "../../../platform/packet.h"
+#include "of1x_action.h"
+#include "of1x_packet_key_pp.h"
+#include "of1x_checksum_pp.h"
+
+/**
+* @file of1x_set_field_pp.h
+*
+* @brief Deferred set-field actions (packet processing routines)
+*
+* When compiled with --with-pipeline-deferred-set-fields, set-field actions
+* over fields of the packet key (see of1x_packet_key.h) only update the key,
+* which then acts as a shadow of the packet headers. Rewritten fields are
+* flagged as dirty and written back to the packet, in a single pass, before
+* any action that needs the packet to be up to date: output, groups
+* (replication) and any other action mangling the packet. Matches in
+* subsequent tables read the key, hence the shadowed values.
+*
+* Setting a field that is not present in the key (e.g. VID of an untagged
+* packet in OF1.0) is not deferred.
+*/
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+#ifdef ROFL_PIPELINE_DEFERRED_SET_FIELDS
+
+/**
+* Write back the dirty fields of the packet key
+*/
+static inline void __of1x_write_back_packet_key(datapacket_t *const pkt){
+
+	of1x_packet_key_t* key = &pkt->key.of1x;
+	uint64_t dirty = key->dirty;
+
+	if(likely(dirty == 0x0ULL))
+		return;
+
+	//802
+	if(dirty & OF1X_PKT_KEY_F_ETH_DST)
+		platform_packet_set_eth_dst(pkt, key->eth_dst);
+	if(dirty & OF1X_PKT_KEY_F_ETH_SRC)
+		platform_packet_set_eth_src(pkt, key->eth_src);
+
+	//802.1q
+	if(dirty & OF1X_PKT_KEY_F_VLAN_VID)
+		platform_packet_set_vlan_vid(pkt, key->vlan_vid);
+	if(dirty & OF1X_PKT_KEY_F_VLAN_PCP)
+		platform_packet_set_vlan_pcp(pkt, key->vlan_pcp);
+
+	//IP
+	if(dirty & OF1X_PKT_KEY_F_IP_DSCP){
+		__of1x_checksum_ip_dscp(pkt, key->ip_dscp);
+		platform_packet_set_ip_dscp(pkt, key->ip_dscp);
+	}
+	if(dirty & OF1X_PKT_KEY_F_IP_ECN){
+		__of1x_checksum_ip_ecn(pkt, key->ip_ecn);
+		platform_packet_set_ip_ecn(pkt, key->ip_ecn);
+	}
+	if(dirty & OF1X_PKT_KEY_F_IPV4_SRC){
+		__of1x_checksum_ipv4_src(pkt, key->ipv4_src);
+		platform_packet_set_ipv4_src(pkt, key->ipv4_src);
+	}
+	if(dirty & OF1X_PKT_KEY_F_IPV4_DST){
+		__of1x_checksum_ipv4_dst(pkt, key->ipv4_dst);
+		platform_packet_set_ipv4_dst(pkt, key->ipv4_dst);
+	}
+
+	//TCP/UDP
+	if(dirty & OF1X_PKT_KEY_F_TCP_SRC){
+		__of1x_checksum_tcp_src(pkt, key->tp_src);
+		platform_packet_set_tcp_src(pkt, key->tp_src);
+	}
+	if(dirty & OF1X_PKT_KEY_F_TCP_DST){
+		__of1x_checksum_tcp_dst(pkt, key->tp_dst);
+		platform_packet_set_tcp_dst(pkt, key->tp_dst);
+	}
+	if(dirty & OF1X_PKT_KEY_F_UDP_SRC){
+		__of1x_checksum_udp_src(pkt, key->tp_src);
+		platform_packet_set_udp_src(pkt, key->tp_src);
+	}
+	if(dirty & OF1X_PKT_KEY_F_UDP_DST){
+		__of1x_checksum_udp_dst(pkt, key->tp_dst);
+		platform_packet_set_udp_dst(pkt, key->tp_dst);
+	}
+
+	key->dirty = 0x0ULL;
+}
+
+//Returns the key if field is present (and marks it as dirty), NULL otherwise
+static inline of1x_packet_key_t* __of1x_defer_field(datapacket_t *const pkt, uint8_t layers, uint64_t field){
+
+	of1x_packet_key_t* key = __of1x_get_packet_key(pkt, layers);
+
+	if(unlikely( !(key->present & field) ))
+		return NULL;
+
+	key->dirty |= field;
+	return key;
+}
+
+//Deferrable set-field; returns false if the action must be executed
+static inline bool __of1x_defer_set_field(datapacket_t *const pkt, const of1x_packet_action_t* action){
+
+	of1x_packet_key_t* key;
+	uint8_t ip_proto;
+
+	switch(action->type){
+		//802
+		case OF1X_AT_SET_FIELD_ETH_DST:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L2, OF1X_PKT_KEY_F_ETH_DST)))
+				return false;
+			key->eth_dst = action->__field.u64;
+			return true;
+		case OF1X_AT_SET_FIELD_ETH_SRC:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L2, OF1X_PKT_KEY_F_ETH_SRC)))
+				return false;
+			key->eth_src = action->__field.u64;
+			return true;
+
+		//802.1q (only if tagged)
+		case OF1X_AT_SET_FIELD_VLAN_VID:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L2, OF1X_PKT_KEY_F_VLAN_VID)))
+				return false;
+			key->vlan_vid = action->__field.u16;
+			return true;
+		case OF1X_AT_SET_FIELD_VLAN_PCP:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L2, OF1X_PKT_KEY_F_VLAN_PCP)))
+				return false;
+			key->vlan_pcp = action->__field.u8;
+			return true;
+
+		//IP
+		case OF1X_AT_SET_FIELD_IP_DSCP:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L3, OF1X_PKT_KEY_F_IP_DSCP)))
+				return false;
+			key->ip_dscp = action->__field.u8;
+			return true;
+		case OF1X_AT_SET_FIELD_IP_ECN:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L3, OF1X_PKT_KEY_F_IP_ECN)))
+				return false;
+			key->ip_ecn = action->__field.u8;
+			return true;
+
+		//IPv4 (NW_XX for OF1.0; ARP is not deferred)
+		case OF1X_AT_SET_FIELD_NW_SRC:
+		case OF1X_AT_SET_FIELD_IPV4_SRC:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L3, OF1X_PKT_KEY_F_IPV4_SRC)))
+				return false;
+			key->ipv4_src = action->__field.u32;
+			return true;
+		case OF1X_AT_SET_FIELD_NW_DST:
+		case OF1X_AT_SET_FIELD_IPV4_DST:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L3, OF1X_PKT_KEY_F_IPV4_DST)))
+				return false;
+			key->ipv4_dst = action->__field.u32;
+			return true;
+
+		//TCP/UDP (TP_XX for OF1.0; ICMPv4 is not deferred)
+		case OF1X_AT_SET_FIELD_TP_SRC:
+			key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L3);
+			ip_proto = (key->present & OF1X_PKT_KEY_F_IP_PROTO)? key->ip_proto : 0x0;
+			if(ip_proto == IP_PROTO_TCP)
+				key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L4, OF1X_PKT_KEY_F_TCP_SRC);
+			else if(ip_proto == IP_PROTO_UDP)
+				key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L4, OF1X_PKT_KEY_F_UDP_SRC);
+			else
+				return false;
+			if(!key)
+				return false;
+			key->tp_src = action->__field.u16;
+			return true;
+		case OF1X_AT_SET_FIELD_TP_DST:
+			key = __of1x_get_packet_key(pkt, OF1X_PKT_KEY_L3);
+			ip_proto = (key->present & OF1X_PKT_KEY_F_IP_PROTO)? key->ip_proto : 0x0;
+			if(ip_proto == IP_PROTO_TCP)
+				key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L4, OF1X_PKT_KEY_F_TCP_DST);
+			else if(ip_proto == IP_PROTO_UDP)
+				key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L4, OF1X_PKT_KEY_F_UDP_DST);
+			else
+				return false;
+			if(!key)
+				return false;
+			key->tp_dst = action->__field.u16;
+			return true;
+		case OF1X_AT_SET_FIELD_TCP_SRC:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L4, OF1X_PKT_KEY_F_TCP_SRC)))
+				return false;
+			key->tp_src = action->__field.u16;
+			return true;
+		case OF1X_AT_SET_FIELD_TCP_DST:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L4, OF1X_PKT_KEY_F_TCP_DST)))
+				return false;
+			key->tp_dst = action->__field.u16;
+			return true;
+		case OF1X_AT_SET_FIELD_UDP_SRC:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L4, OF1X_PKT_KEY_F_UDP_SRC)))
+				return false;
+			key->tp_src = action->__field.u16;
+			return true;
+		case OF1X_AT_SET_FIELD_UDP_DST:
+			if(!(key = __of1x_defer_field(pkt, OF1X_PKT_KEY_L4, OF1X_PKT_KEY_F_UDP_DST)))
+				return false;
+			key->tp_dst = action->__field.u16;
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+#endif //ROFL_PIPELINE_DEFERRED_SET_FIELDS
+
+/**
+* Process the action over the packet key, if it can be deferred. Otherwise,
+* pending set-fields are written back if the action requires the packet to
+* be up to date, and the key invalidated if the action mangles the packet.
+*
+* Returns true if the action has been deferred (nothing else to do).
+*/
+static inline bool __of1x_prepare_packet_action(datapacket_t *const pkt, const of1x_packet_action_t* action){
+#ifdef ROFL_PIPELINE_DEFERRED_SET_FIELDS
+	if(__of1x_defer_set_field(pkt, action))
+		return true;
+
+	switch(action->type){
+		//Don't touch the key fields
+		case OF1X_AT_COPY_TTL_IN:
+		case OF1X_AT_COPY_TTL_OUT:
+		case OF1X_AT_DEC_NW_TTL:
+		case OF1X_AT_SET_NW_TTL:
+		case OF1X_AT_DEC_MPLS_TTL:
+		case OF1X_AT_SET_MPLS_TTL:
+		case OF1X_AT_SET_QUEUE:
+			break;
+
+		//Packet must be up to date (sent or replicated)
+		case OF1X_AT_GROUP:
+		case OF1X_AT_OUTPUT:
+			__of1x_write_back_packet_key(pkt);
+			break;
+
+		//Mangle the packet
+		default:
+			__of1x_write_back_packet_key(pkt);
+			__of1x_invalidate_packet_key(pkt);
+			break;
+	}
+#endif
+	return false;
+}
+
+/**
+* Write back the pending set-fields, if any (e.g. packet-in on table-miss)
+*/
+static inline void __of1x_flush_set_fields(datapacket_t *const pkt){
+#ifdef ROFL_PIPELINE_DEFERRED_SET_FIELDS
+	__of1x_write_back_packet_key(pkt);
+#endif
+}
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //OF1X_SET_FIELD_PP
@@ -7,6 +7,8 @@
 #include "of1x_instruction.h"
 #include "of1x_timers.h"
 #include "of1x_group_table.h"
+#include "../of1x_switch.h"
+#include "../of1x_async_events_hooks.h"
 #include "../../../platform/memory.h"
 #include "../../../platform/likely.h"
 #include "../../../platform/timing.h"
@@ -71,25 +73,14 @@ void of1x_destroy_stats_flow_aggregate_msg(of1x_stats_flow_aggregate_msg_t* msg)
 /*
 * Msg flow stats
 */
-of1x_stats_single_flow_msg_t* __of1x_init_stats_single_flow_msg(of1x_flow_entry_t* entry){
+rofl_result_t __of1x_fill_stats_single_flow_msg(of1x_flow_entry_t* entry, of1x_stats_single_flow_msg_t* msg){
 
-	of1x_stats_single_flow_msg_t* msg;
 	__of1x_stats_flow_tid_t consolidated_stats;
 
-	if(!entry)
-		return NULL;
-
-	msg = (of1x_stats_single_flow_msg_t*)platform_malloc_shared(sizeof(of1x_stats_single_flow_msg_t)); 
-
-	if(unlikely(msg==NULL))
-		return NULL;
-	
 	msg->inst_grp = (of1x_instruction_group_t*)platform_malloc_shared(sizeof(of1x_instruction_group_t)); 
 	
-	if(unlikely(msg->inst_grp==NULL)){
-		platform_free_shared(msg);
-		return NULL;
-	}
+	if(unlikely(msg->inst_grp==NULL))
+		return ROFL_FAILURE;
 
 	//Fill static values
 	if(entry->table)
@@ -99,6 +90,7 @@ of1x_stats_single_flow_msg_t* __of1x_init_stats_single_flow_msg(of1x_flow_entry_
 	msg->idle_timeout = entry->timer_info.idle_timeout;
 	msg->hard_timeout = entry->timer_info.hard_timeout;
 	msg->flags = entry->flags;
+	msg->next = NULL;
 	
 	//Aggregate stats
 	__of1x_stats_flow_consolidate(&entry->stats, &consolidated_stats);
@@ -115,14 +107,12 @@ of1x_stats_single_flow_msg_t* __of1x_init_stats_single_flow_msg(of1x_flow_entry_
 	//Copy instructions
 	__of1x_copy_instruction_group(&entry->inst_grp,msg->inst_grp);
 
-	return msg;
+	return ROFL_SUCCESS;
 }
-void __of1x_destroy_stats_single_flow_msg(of1x_stats_single_flow_msg_t* msg){
 
-	of1x_match_t* match;
+void __of1x_release_stats_single_flow_msg(of1x_stats_single_flow_msg_t* msg){
 
-	if(unlikely(msg==NULL))
-		return;
+	of1x_match_t* match;
 
 	//TODO: deprecate this in favour of group_matches
 	match = msg->matches;
@@ -135,8 +125,34 @@ void __of1x_destroy_stats_single_flow_msg(of1x_stats_single_flow_msg_t* msg){
 	//Destroy instructions
 	__of1x_destroy_instruction_group(msg->inst_grp);
 	
-	
 	platform_free_shared(msg->inst_grp);
+}
+
+of1x_stats_single_flow_msg_t* __of1x_init_stats_single_flow_msg(of1x_flow_entry_t* entry){
+
+	of1x_stats_single_flow_msg_t* msg;
+
+	if(!entry)
+		return NULL;
+
+	msg = (of1x_stats_single_flow_msg_t*)platform_malloc_shared(sizeof(of1x_stats_single_flow_msg_t)); 
+
+	if(unlikely(msg==NULL))
+		return NULL;
+	
+	if(__of1x_fill_stats_single_flow_msg(entry, msg) != ROFL_SUCCESS){
+		platform_free_shared(msg);
+		return NULL;
+	}
+
+	return msg;
+}
+void __of1x_destroy_stats_single_flow_msg(of1x_stats_single_flow_msg_t* msg){
+
+	if(unlikely(msg==NULL))
+		return;
+
+	__of1x_release_stats_single_flow_msg(msg);
 	platform_free_shared(msg);
 }
 
@@ -210,6 +226,7 @@ void of1x_stats_flow_get_duration(struct of1x_flow_entry * entry, uint32_t* sec,
 void __of1x_stats_table_init(of1x_flow_table_t * table){
 	
 	memset(&table->stats, 0, sizeof(of1x_stats_table_t));
+	memset(&table->aggregates, 0, sizeof(of1x_stats_flow_aggregates_t));
 
 	//Stats mutex	
 	table->stats.mutex = platform_mutex_init(NULL);
@@ -225,6 +242,466 @@ void __of1x_stats_table_destroy(of1x_flow_table_t * table){
 //NOTE this functions add too much overhead!
 
 
+//Walks all the entries of the table in batches, releasing the table mutex in between
+static rofl_result_t __of1x_stats_walk_flow_entries(of1x_flow_table_t* table, of1x_flow_entry_walk_fn_t fn, void* arg){
+
+	of1x_flow_stats_iter_t iter;
+
+	if(!of1x_matching_algorithms[table->matching_algorithm].walk_flow_entries_hook)
+		return ROFL_FAILURE;
+
+	platform_memset(&iter, 0, sizeof(iter));
+
+	do{
+		if(of1x_matching_algorithms[table->matching_algorithm].walk_flow_entries_hook(table, &iter, OF1X_STATS_WALK_BATCH_SIZE, fn, arg) != ROFL_SUCCESS)
+			return ROFL_FAILURE;
+	}while(!iter.__table_done);
+
+	return ROFL_SUCCESS;
+}
+
+/*
+* Running flow aggregates
+*/
+
+//Applies a delta to the aggregates the entry belongs to (stats mutex held)
+static void __of1x_stats_aggregates_apply(of1x_flow_table_t* table, of1x_flow_entry_t* entry, int flows, uint64_t packets, uint64_t bytes){
+
+	unsigned int i;
+	of1x_stats_flow_aggregates_t* aggr = &table->aggregates;
+
+	//Negative deltas wrap around (unsigned arithmetic)
+	aggr->all.packet_count += packets;
+	aggr->all.byte_count += bytes;
+	aggr->all.flow_count += flows;
+
+	if(table->pipeline->sw->of_ver == OF_VERSION_10) //Ignore cookie in OF1.0
+		return;
+
+	for(i=0;i<aggr->num_of_classes;i++){
+		if( (entry->cookie & aggr->cookie_mask[i]) != (aggr->cookie[i] & aggr->cookie_mask[i]) )
+			continue;
+		aggr->classes[i].packet_count += packets;
+		aggr->classes[i].byte_count += bytes;
+		aggr->classes[i].flow_count += flows;
+	}
+}
+
+//Accounts the current counters of the entry (table mutex held)
+static void __of1x_stats_aggregate_entry(of1x_flow_table_t* table, of1x_flow_entry_t* entry, __of1x_stats_flow_tid_t* c){
+
+	of1x_stats_flow_aggregates_t* aggr = &table->aggregates;
+	__of1x_stats_flow_tid_t* acc = &entry->stats.__aggr_counters;
+
+	platform_mutex_lock(table->stats.mutex);
+
+	//Not accounted in this epoch yet (aggregates rebuilt)
+	if(entry->stats.__aggr_epoch != aggr->epoch){
+		entry->stats.__aggr_epoch = aggr->epoch;
+		acc->packet_count = acc->byte_count = 0x0ULL;
+		__of1x_stats_aggregates_apply(table, entry, 1, 0x0ULL, 0x0ULL);
+	}
+
+	__of1x_stats_aggregates_apply(table, entry, 0, c->packet_count - acc->packet_count, c->byte_count - acc->byte_count);
+	*acc = *c;
+
+	platform_mutex_unlock(table->stats.mutex);
+}
+
+void __of1x_stats_flow_aggregates_add_entry(of1x_flow_table_t* table, of1x_flow_entry_t* entry){
+
+	platform_mutex_lock(table->stats.mutex);
+
+	//Counters are accounted at the next consolidation
+	entry->stats.__aggr_epoch = table->aggregates.epoch;
+	entry->stats.__aggr_counters.packet_count = entry->stats.__aggr_counters.byte_count = 0x0ULL;
+	__of1x_stats_aggregates_apply(table, entry, 1, 0x0ULL, 0x0ULL);
+
+	platform_mutex_unlock(table->stats.mutex);
+}
+
+void __of1x_stats_flow_aggregates_remove_entry(of1x_flow_table_t* table, of1x_flow_entry_t* entry){
+
+	__of1x_stats_flow_tid_t* acc = &entry->stats.__aggr_counters;
+
+	platform_mutex_lock(table->stats.mutex);
+
+	if(entry->stats.__aggr_epoch == table->aggregates.epoch)
+		__of1x_stats_aggregates_apply(table, entry, -1, -acc->packet_count, -acc->byte_count);
+
+	platform_mutex_unlock(table->stats.mutex);
+}
+
+void __of1x_stats_flow_aggregates_reset_entry(of1x_flow_table_t* table, of1x_flow_entry_t* entry){
+
+	__of1x_stats_flow_tid_t* acc = &entry->stats.__aggr_counters;
+
+	platform_mutex_lock(table->stats.mutex);
+
+	if(entry->stats.__aggr_epoch == table->aggregates.epoch)
+		__of1x_stats_aggregates_apply(table, entry, 0, -acc->packet_count, -acc->byte_count);
+	acc->packet_count = acc->byte_count = 0x0ULL;
+
+	platform_mutex_unlock(table->stats.mutex);
+}
+
+//Checks whether the consolidation is due, and starts it
+static bool __of1x_stats_aggregates_begin(of1x_flow_table_t* table, uint64_t now_ms, uint64_t* num_of_invalidations){
+
+	of1x_stats_flow_aggregates_t* aggr = &table->aggregates;
+
+	//Nothing registered
+	if(!aggr->whole_table && !aggr->num_of_classes)
+		return false;
+
+	//Period
+	if(aggr->valid && now_ms < aggr->last_consolidation_ms + OF1X_STATS_AGGREGATES_PERIOD_MS)
+		return false;
+
+	platform_mutex_lock(table->stats.mutex);
+
+	//Classes registered; rebuild (entries accounted in the previous epoch are no longer)
+	if(!aggr->valid){
+		aggr->epoch++;
+		platform_memset(&aggr->all, 0, sizeof(aggr->all));
+		platform_memset(aggr->classes, 0, sizeof(aggr->classes));
+	}
+	*num_of_invalidations = aggr->num_of_invalidations;
+
+	platform_mutex_unlock(table->stats.mutex);
+
+	return true;
+}
+
+static void __of1x_stats_aggregates_end(of1x_flow_table_t* table, uint64_t now_ms, uint64_t num_of_invalidations){
+
+	of1x_stats_flow_aggregates_t* aggr = &table->aggregates;
+
+	//Table mutex; the add and remove deltas of the entries linked or unlinked are applied
+	platform_mutex_lock(table->mutex);
+	platform_mutex_lock(table->stats.mutex);
+
+	//Valid if all the entries are accounted in the current epoch (the table may have been
+	//modified in between batches), unless classes were registered meanwhile
+	if(aggr->num_of_invalidations == num_of_invalidations && aggr->all.flow_count == table->num_of_entries){
+		aggr->last_consolidation_ms = now_ms;
+		aggr->valid = true;
+	}
+
+	platform_mutex_unlock(table->stats.mutex);
+	platform_mutex_unlock(table->mutex);
+}
+
+/*
+* Table pass (stats service and running aggregates)
+*/
+typedef struct __of1x_stats_table_walk{
+	of1x_flow_table_t* table;
+	of1x_stats_service_t* service; //Publish the entries (stats service), if not NULL
+	bool aggregate; //Consolidate the running aggregates
+	uint64_t num_of_invalidations;
+}__of1x_stats_table_walk_t;
+
+static void __of1x_stats_walk_entry(of1x_flow_entry_t* entry, void* arg){
+
+	__of1x_stats_flow_tid_t c;
+	__of1x_stats_table_walk_t* walk = (__of1x_stats_table_walk_t*)arg;
+
+	// update statistics from platform
+	platform_of1x_update_stats_hook(entry);
+
+	__of1x_stats_flow_consolidate(&entry->stats, &c);
+
+	if(walk->service)
+		__stats_publish(&entry->stats.published, c.packet_count, c.byte_count, walk->service->last_run_ms, walk->service->rate_window_ms);
+
+	if(walk->aggregate)
+		__of1x_stats_aggregate_entry(walk->table, entry, &c);
+}
+
+//Single (batched) pass over the entries of the table, for the stats service and the running aggregates (if due)
+static void __of1x_stats_walk_table(of1x_flow_table_t* table, of1x_stats_service_t* service, uint64_t now_ms){
+
+	__of1x_stats_table_walk_t walk;
+
+	walk.table = table;
+	walk.service = service;
+	walk.aggregate = __of1x_stats_aggregates_begin(table, now_ms, &walk.num_of_invalidations);
+
+	if(!walk.service && !walk.aggregate)
+		return;
+
+	if(__of1x_stats_walk_flow_entries(table, __of1x_stats_walk_entry, &walk) != ROFL_SUCCESS)
+		return;
+
+	if(walk.aggregate)
+		__of1x_stats_aggregates_end(table, now_ms, walk.num_of_invalidations);
+}
+
+void __of1x_stats_consolidate_flow_aggregates(of1x_flow_table_t* table, uint64_t now_ms){
+
+	//Consolidated within the stats service pass
+	if(table->pipeline->stats_service.enabled)
+		return;
+
+	__of1x_stats_walk_table(table, NULL, now_ms);
+}
+
+bool __of1x_stats_get_flow_aggregates(of1x_flow_table_t* table, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group* matches, of1x_stats_flow_aggregate_msg_t* msg){
+
+	unsigned int i;
+	bool found = false;
+	of1x_stats_flow_aggregates_t* aggr = &table->aggregates;
+
+	//Only whole table or cookie class requests
+	if(matches->num_elements || out_port != OF1X_PORT_ANY || out_group != OF1X_GROUP_ANY)
+		return false;
+
+	platform_mutex_lock(table->stats.mutex);
+
+	//Classes registered since the last consolidation
+	if(!aggr->valid)
+		goto AGGREGATES_END;
+
+	if(cookie_mask == 0x0ULL || table->pipeline->sw->of_ver == OF_VERSION_10){
+		if(!aggr->whole_table)
+			goto AGGREGATES_END;
+		msg->packet_count += aggr->all.packet_count;
+		msg->byte_count += aggr->all.byte_count;
+		msg->flow_count += aggr->all.flow_count;
+		found = true;
+		goto AGGREGATES_END;
+	}
+
+	for(i=0;i<aggr->num_of_classes;i++){
+		if( aggr->cookie_mask[i] != cookie_mask || (aggr->cookie[i] & cookie_mask) != (cookie & cookie_mask) )
+			continue;
+		msg->packet_count += aggr->classes[i].packet_count;
+		msg->byte_count += aggr->classes[i].byte_count;
+		msg->flow_count += aggr->classes[i].flow_count;
+		found = true;
+		break;
+	}
+
+AGGREGATES_END:
+	platform_mutex_unlock(table->stats.mutex);
+
+	return found;
+}
+
+rofl_result_t of1x_stats_add_aggregate_cookie_class(of1x_pipeline_t* pipeline, uint64_t cookie, uint64_t cookie_mask){
+
+	unsigned int i, j;
+	of1x_stats_flow_aggregates_t* aggr;
+	rofl_result_t res = ROFL_SUCCESS;
+
+	if( unlikely(pipeline==NULL) )
+		return ROFL_FAILURE;
+
+	for(i=0;i<pipeline->num_of_tables;i++){
+		aggr = &pipeline->tables[i].aggregates;
+
+		platform_mutex_lock(pipeline->tables[i].stats.mutex);
+
+		//Whole table
+		if(cookie_mask == 0x0ULL){
+			if(!aggr->whole_table){
+				aggr->whole_table = true;
+				aggr->valid = false;
+				aggr->num_of_invalidations++;
+			}
+			platform_mutex_unlock(pipeline->tables[i].stats.mutex);
+			continue;
+		}
+
+		for(j=0;j<aggr->num_of_classes;j++){
+			if(aggr->cookie_mask[j] == cookie_mask && (aggr->cookie[j] & cookie_mask) == (cookie & cookie_mask))
+				break;
+		}
+
+		if(j == aggr->num_of_classes){
+			if(j == OF1X_STATS_MAX_COOKIE_CLASSES){
+				res = ROFL_FAILURE;
+			}else{
+				aggr->cookie[j] = cookie & cookie_mask;
+				aggr->cookie_mask[j] = cookie_mask;
+				aggr->num_of_classes++;
+
+				//Not available until the next consolidation
+				aggr->valid = false;
+				aggr->num_of_invalidations++;
+			}
+		}
+
+		platform_mutex_unlock(pipeline->tables[i].stats.mutex);
+	}
+
+	return res;
+}
+
+rofl_result_t of1x_stats_remove_aggregate_cookie_class(of1x_pipeline_t* pipeline, uint64_t cookie, uint64_t cookie_mask){
+
+	unsigned int i, j;
+	of1x_stats_flow_aggregates_t* aggr;
+	rofl_result_t res = ROFL_FAILURE;
+
+	if( unlikely(pipeline==NULL) )
+		return ROFL_FAILURE;
+
+	for(i=0;i<pipeline->num_of_tables;i++){
+		aggr = &pipeline->tables[i].aggregates;
+
+		platform_mutex_lock(pipeline->tables[i].stats.mutex);
+
+		//Whole table
+		if(cookie_mask == 0x0ULL){
+			if(aggr->whole_table)
+				res = ROFL_SUCCESS;
+			aggr->whole_table = false;
+			platform_mutex_unlock(pipeline->tables[i].stats.mutex);
+			continue;
+		}
+
+		for(j=0;j<aggr->num_of_classes;j++){
+			if(aggr->cookie_mask[j] != cookie_mask || aggr->cookie[j] != (cookie & cookie_mask))
+				continue;
+
+			//Compact
+			aggr->num_of_classes--;
+			aggr->cookie[j] = aggr->cookie[aggr->num_of_classes];
+			aggr->cookie_mask[j] = aggr->cookie_mask[aggr->num_of_classes];
+			aggr->classes[j] = aggr->classes[aggr->num_of_classes];
+			aggr->cookie[aggr->num_of_classes] = aggr->cookie_mask[aggr->num_of_classes] = 0x0ULL;
+			res = ROFL_SUCCESS;
+			break;
+		}
+
+		platform_mutex_unlock(pipeline->tables[i].stats.mutex);
+	}
+
+	return res;
+}
+
+/*
+* Stats service
+*/
+
+//Ports and their queues (switch mutex prevents port detachment)
+static void __of1x_stats_service_publish_ports(of1x_switch_t* sw, uint64_t now_ms, uint64_t rate_window_ms){
+
+	unsigned int i, j;
+	switch_port_t* port;
+	port_stats_t cp;
+	queue_stats_t cq;
+
+	platform_mutex_lock(sw->mutex);
+
+	for(i=1;i<LOGICAL_SWITCH_MAX_LOG_PORTS;i++){
+		port = sw->logical_ports[i].port;
+
+		if(sw->logical_ports[i].attachment_state != LOGICAL_PORT_STATE_ATTACHED || !port)
+			continue;
+
+		__port_stats_consolidate(&port->stats, &cp);
+		__stats_publish(&port->stats.rx_published, cp.rx_packets, cp.rx_bytes, now_ms, rate_window_ms);
+		__stats_publish(&port->stats.tx_published, cp.tx_packets, cp.tx_bytes, now_ms, rate_window_ms);
+
+		for(j=0;j<SWITCH_PORT_MAX_QUEUES;j++){
+			if(!port->queues[j].set)
+				continue;
+			__queue_stats_consolidate(&port->queues[j].stats, &cq);
+			__stats_publish(&port->queues[j].stats.published, cq.tx_packets, cq.tx_bytes, now_ms, rate_window_ms);
+		}
+	}
+
+	platform_mutex_unlock(sw->mutex);
+}
+
+void __of1x_stats_service_run(of1x_pipeline_t* pipeline, uint64_t now_ms){
+
+	unsigned int i;
+	of1x_flow_table_t* table;
+	of1x_group_t* group;
+	of1x_bucket_t* bucket;
+	__of1x_stats_table_tid_t ct;
+	__of1x_stats_group_tid_t cg;
+	__of1x_stats_bucket_tid_t cb;
+	of1x_stats_service_t* service = &pipeline->stats_service;
+
+	if(!service->enabled)
+		return;
+
+	//Period 
+	if(service->last_run_ms && now_ms < service->last_run_ms + service->period_ms)
+		return;
+
+	service->last_run_ms = now_ms;
+
+	for(i=0;i<pipeline->num_of_tables;i++){
+		table = &pipeline->tables[i];
+
+		//Table
+		__of1x_stats_table_consolidate(&table->stats, &ct);
+		__stats_publish(&table->stats.published, ct.lookup_count, ct.matched_count, now_ms, service->rate_window_ms);
+
+		//Flow entries (and running aggregates)
+		__of1x_stats_walk_table(table, service, now_ms);
+	}
+
+	if(pipeline->sw)
+		__of1x_stats_service_publish_ports(pipeline->sw, now_ms, service->rate_window_ms);
+
+	if(!pipeline->groups)
+		return;
+
+	//Groups and buckets (group table mutex prevents group removal or modification)
+	platform_mutex_lock(pipeline->groups->mutex);
+
+	for(group=pipeline->groups->head;group;group=group->next){
+		__of1x_stats_group_consolidate(&group->stats, &cg);
+		__stats_publish(&group->stats.published, cg.packet_count, cg.byte_count, now_ms, service->rate_window_ms);
+
+		for(bucket=group->bc_list->head;bucket;bucket=bucket->next){
+			__of1x_stats_bucket_consolidate(&bucket->stats, &cb);
+			__stats_publish(&bucket->stats.published, cb.packet_count, cb.byte_count, now_ms, service->rate_window_ms);
+		}
+	}
+
+	platform_mutex_unlock(pipeline->groups->mutex);
+}
+
+rofl_result_t of1x_stats_service_enable(of1x_pipeline_t* pipeline, uint64_t period_ms, uint64_t rate_window_ms){
+
+	if( unlikely(pipeline==NULL) )
+		return ROFL_FAILURE;
+
+	//Defaults
+	if(period_ms == 0)
+		period_ms = OF1X_STATS_SERVICE_PERIOD_MS;
+	if(rate_window_ms == 0)
+		rate_window_ms = OF1X_STATS_SERVICE_RATE_WINDOW_MS;
+
+	if(rate_window_ms < period_ms)
+		return ROFL_FAILURE;
+
+	pipeline->stats_service.period_ms = period_ms;
+	pipeline->stats_service.rate_window_ms = rate_window_ms;
+	pipeline->stats_service.last_run_ms = 0x0ULL;
+	pipeline->stats_service.enabled = true;
+
+	return ROFL_SUCCESS;
+}
+
+rofl_result_t of1x_stats_service_disable(of1x_pipeline_t* pipeline){
+
+	if( unlikely(pipeline==NULL) )
+		return ROFL_FAILURE;
+
+	pipeline->stats_service.enabled = false;
+
+	return ROFL_SUCCESS;
+}
+
 void __of1x_init_group_stats(of1x_stats_group_t *group_stats){
 	
 	memset(group_stats, 0, sizeof(of1x_stats_group_t));
@@ -441,10 +918,11 @@ void __of1x_destroy_buckets_stats(__of1x_stats_bucket_t *bc_stats){
 * External interfaces
 */
 
-of1x_stats_flow_msg_t* of1x_get_flow_stats(struct of1x_pipeline* pipeline, uint8_t table_id, uint32_t cookie, uint32_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group *const matches){
+of1x_stats_flow_msg_t* of1x_get_flow_stats(struct of1x_pipeline* pipeline, uint8_t table_id, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group *const matches){
 
 	uint32_t i,tid_start, tid_end;	
 	of1x_stats_flow_msg_t* msg;
+	rofl_result_t res;
 
 	//Verify table_id
 	if(table_id >= pipeline->num_of_tables && table_id != OF1X_FLOW_TABLE_ALL)
@@ -465,15 +943,101 @@ of1x_stats_flow_msg_t* of1x_get_flow_stats(struct of1x_pipeline* pipeline, uint8
 	}
 
 	for(i=tid_start;i<tid_end;i++){
-		if(of1x_matching_algorithms[pipeline->tables[i].matching_algorithm].get_flow_stats_hook(&pipeline->tables[i], cookie, cookie_mask, out_port, out_group, matches, msg) != ROFL_SUCCESS){
-			of1x_destroy_stats_flow_msg(msg);
-			return NULL;
-		} 
+		//Filtered by out port, out group or exact cookie; use the secondary indexes
+		if(__of1x_flow_index_get_flow_stats(&pipeline->tables[i], cookie, cookie_mask, out_port, out_group, matches, msg, &res)){
+			if(res == ROFL_SUCCESS)
+				continue;
+		}else if(of1x_matching_algorithms[pipeline->tables[i].matching_algorithm].get_flow_stats_hook(&pipeline->tables[i], cookie, cookie_mask, out_port, out_group, matches, msg) == ROFL_SUCCESS){
+			continue;
+		}
+
+		of1x_destroy_stats_flow_msg(msg);
+		return NULL;
 	}
 	
 	return msg;
 }
-of1x_stats_flow_aggregate_msg_t* of1x_get_flow_aggregate_stats(struct of1x_pipeline* pipeline, uint8_t table_id, uint32_t cookie, uint32_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group *const matches){
+/*
+* Flow stats iterator
+*/
+rofl_result_t of1x_flow_stats_iter_init(of1x_flow_stats_iter_t* iter, struct of1x_pipeline* pipeline, uint8_t table_id, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group* matches){
+
+	if( unlikely(iter==NULL) || unlikely(pipeline==NULL) || unlikely(matches==NULL) )
+		return ROFL_FAILURE;
+
+	//Verify table_id
+	if(table_id >= pipeline->num_of_tables && table_id != OF1X_FLOW_TABLE_ALL)
+		return ROFL_FAILURE;
+
+	platform_memset(iter, 0, sizeof(*iter));
+
+	iter->pipeline = pipeline;
+	iter->table_id = table_id;
+	iter->cookie = cookie;
+	iter->cookie_mask = cookie_mask;
+	iter->out_port = out_port;
+	iter->out_group = out_group;
+	iter->matches = matches;
+
+	//Set the tables to go through
+	if(table_id == OF1X_FLOW_TABLE_ALL){
+		iter->__table = 0;
+		iter->__table_end = pipeline->num_of_tables;
+	}else{
+		iter->__table = table_id;
+		iter->__table_end = table_id+1; 
+	}
+
+	return ROFL_SUCCESS;
+}
+
+rofl_result_t of1x_flow_stats_iter_next_page(of1x_flow_stats_iter_t* iter, of1x_stats_single_flow_msg_t* page, unsigned int page_size, unsigned int* num_of_entries){
+
+	of1x_flow_table_t* table;
+	unsigned int filled;
+
+	if( unlikely(iter==NULL) || unlikely(page==NULL) || unlikely(num_of_entries==NULL) )
+		return ROFL_FAILURE;
+
+	*num_of_entries = 0;
+
+	while(*num_of_entries < page_size && iter->__table < iter->__table_end){
+
+		table = &iter->pipeline->tables[iter->__table];
+		filled = 0;
+
+		//Table is only locked while filling (part of) the page
+		if(of1x_matching_algorithms[table->matching_algorithm].get_flow_stats_page_hook(table, iter, &page[*num_of_entries], page_size - *num_of_entries, &filled) != ROFL_SUCCESS){
+			of1x_flow_stats_iter_release_page(page, *num_of_entries + filled);
+			*num_of_entries = 0;
+			return ROFL_FAILURE;
+		}
+
+		*num_of_entries += filled;
+
+		if(iter->__table_done){
+			//Move to the next table
+			iter->__table++;
+			iter->__num_visited = 0;
+			iter->__last_priority = iter->__last_num_matches = 0;
+			iter->__last_seq = 0;
+			iter->__table_done = false;
+			platform_memset(iter->__pos, 0, sizeof(iter->__pos));
+		}
+	}
+
+	return ROFL_SUCCESS;
+}
+
+void of1x_flow_stats_iter_release_page(of1x_stats_single_flow_msg_t* page, unsigned int num_of_entries){
+
+	unsigned int i;
+
+	for(i=0;i<num_of_entries;i++)
+		__of1x_release_stats_single_flow_msg(&page[i]);
+}
+
+of1x_stats_flow_aggregate_msg_t* of1x_get_flow_aggregate_stats(struct of1x_pipeline* pipeline, uint8_t table_id, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group *const matches){
 	
 	uint32_t i, tid_start, tid_end;	
 	of1x_stats_flow_aggregate_msg_t* msg;
@@ -498,6 +1062,14 @@ of1x_stats_flow_aggregate_msg_t* of1x_get_flow_aggregate_stats(struct of1x_pipel
 	}
 
 	for(i=tid_start;i<tid_end;i++){
+		//Running aggregates (O(1))
+		if(__of1x_stats_get_flow_aggregates(&pipeline->tables[i], cookie, cookie_mask, out_port, out_group, matches, msg))
+			continue;
+
+		//Filtered by out port, out group or exact cookie; use the secondary indexes
+		if(__of1x_flow_index_get_flow_aggregate_stats(&pipeline->tables[i], cookie, cookie_mask, out_port, out_group, matches, msg))
+			continue;
+
 		if(of1x_matching_algorithms[pipeline->tables[i].matching_algorithm].get_flow_aggregate_stats_hook(&pipeline->tables[i], cookie, cookie_mask, out_port, out_group, matches, msg) != ROFL_SUCCESS){
 			of1x_destroy_stats_flow_aggregate_msg(msg);
 			return NULL;
@@ -6,11 +6,14 @@
 #define __OF1X_STATISTICS_H__
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <sys/time.h>
 #include <string.h>
 #include "rofl_datapath.h"
 #include "of1x_group_types.h"
 #include "../../../platform/lock.h"
+#include "../../../threading.h"
+#include "../../../stats_snapshot.h"
 
 #define OF1X_STATS_NS_IN_A_SEC 1000000000
 
@@ -42,6 +45,17 @@ struct of1x_pipeline;
 // Inner pipeline stats
 //
 
+/**
+* @ingroup core_of1x 
+* Consolidated counters of a flow entry, table, group or bucket, published
+* by the stats service (see of1x_stats_service_enable()). Ports and queues
+* are published too (see port_stats_get_rx_snapshot()).
+*/
+typedef stats_snapshot_t of1x_stats_snapshot_t;
+
+//Published snapshot (written only by the stats service)
+typedef __stats_published_t __of1x_stats_published_t;
+
 /* Flows */
 //Per thread flow stats
 typedef struct __of1x_stats_flow_tid{
@@ -62,6 +76,13 @@ typedef struct of1x_stats_flow{
 	//And more not so interesting
 	struct timeval initial_time;
 
+	//Consolidated (stats service)
+	__of1x_stats_published_t published;
+
+	//Running aggregates (protected by the table mutex)
+	uint64_t __aggr_epoch; //Epoch of the table aggregates the entry is accounted in
+	__of1x_stats_flow_tid_t __aggr_counters; //Counters accounted at the last consolidation
+
 	platform_mutex_t* mutex; //Mutual exclusion stats
 }of1x_stats_flow_t;
 
@@ -84,6 +105,9 @@ typedef struct of1x_stats_table{
 		__of1x_stats_table_tid_t __internal[ROFL_PIPELINE_MAX_TIDS];	
 	}s;
 
+	//Consolidated (stats service)
+	__of1x_stats_published_t published;
+
 	platform_mutex_t* mutex; //Mutual exclusion only for stats
 }of1x_stats_table_t;
 
@@ -106,6 +130,9 @@ typedef struct __of1x_stats_bucket{
 		__of1x_stats_bucket_tid_t __internal[ROFL_PIPELINE_MAX_TIDS];	
 	}s;
 
+	//Consolidated (stats service)
+	__of1x_stats_published_t published;
+
 	platform_mutex_t* mutex;
 }__of1x_stats_bucket_t;
 
@@ -128,6 +155,9 @@ typedef struct of1x_stats_group{
 		__of1x_stats_group_tid_t __internal[ROFL_PIPELINE_MAX_TIDS];	
 	}s;
 
+	//Consolidated (stats service)
+	__of1x_stats_published_t published;
+
 	platform_mutex_t* mutex;
 }of1x_stats_group_t;
 
@@ -173,6 +203,45 @@ typedef struct of1x_stats_flow_msg{
 	of1x_stats_single_flow_msg_t* 	flows_tail;
 }of1x_stats_flow_msg_t;
 
+/**
+* @ingroup core_of1x 
+* Flow stats iterator (cursor). Flow stats are retrieved in pages of
+* of1x_stats_single_flow_msg_t, filled in a buffer provided by the caller,
+* using of1x_flow_stats_iter_next_page(). The table is only locked while
+* a page is being filled.
+*
+* If the table is modified between pages, the iteration is resumed right after
+* the last entry visited, by its key in the table order (priority, number of
+* matches and insertion sequence number), so entries present during the whole
+* iteration are reported exactly once, regardless of the entries added or
+* removed meanwhile (which may or may not be reported). Matching algorithms not
+* traversing the entries in table order resume by position (number of entries
+* of the table already visited) instead.
+*/
+typedef struct of1x_flow_stats_iter{
+	//Filter
+	struct of1x_pipeline* pipeline;
+	uint8_t table_id;
+	uint64_t cookie;
+	uint64_t cookie_mask;
+	uint32_t out_port;
+	uint32_t out_group;
+	struct of1x_match_group* matches; //Must be valid until the iteration is over
+
+	/* 
+	* Position (internal)
+	*/
+	unsigned int __table;		//Current table
+	unsigned int __table_end;	//Last table (not included)
+	uint64_t __revision;		//Revision of the table when the position was saved
+	uint64_t __num_visited;		//Entries of the table already visited
+	uint32_t __last_priority;	//Key (table order) of the last entry visited
+	uint32_t __last_num_matches;
+	uint64_t __last_seq;
+	void* __pos[3];			//Matching algorithm position; only valid if the revision is unchanged
+	bool __table_done;		//Set by the matching algorithm at the end of the table
+}of1x_flow_stats_iter_t;
+
 /**
 * @ingroup core_of1x 
 * Aggregated flow stats message 
@@ -183,6 +252,65 @@ typedef struct of1x_stats_flow_aggregate_msg{
 	uint32_t flow_count;
 }of1x_stats_flow_aggregate_msg_t;
 
+#ifndef OF1X_STATS_MAX_COOKIE_CLASSES
+	#define OF1X_STATS_MAX_COOKIE_CLASSES 16 //Max. number of cookie classes with running aggregates
+#endif
+
+#ifndef OF1X_STATS_AGGREGATES_PERIOD_MS
+	#define OF1X_STATS_AGGREGATES_PERIOD_MS 1000 //Consolidation period of the running aggregates
+#endif
+
+/**
+* @ingroup core_of1x 
+* Running flow aggregates of a table, for the whole table and for each
+* of the registered cookie classes (cookie, cookie_mask), if registered. Counters
+* are consolidated in the background (see of1x_stats_add_aggregate_cookie_class()),
+* while entries added, removed or with their counters reset are applied as deltas
+* when the table is modified. Protected by the table stats mutex.
+*/
+typedef struct of1x_stats_flow_aggregates{
+	//Whole table class registered
+	bool whole_table;
+
+	//Cookie classes
+	unsigned int num_of_classes;
+	uint64_t cookie[OF1X_STATS_MAX_COOKIE_CLASSES];
+	uint64_t cookie_mask[OF1X_STATS_MAX_COOKIE_CLASSES];
+
+	//Sum of the counters accounted by the entries of the current epoch
+	of1x_stats_flow_aggregate_msg_t all;
+	of1x_stats_flow_aggregate_msg_t classes[OF1X_STATS_MAX_COOKIE_CLASSES];
+
+	//Consolidation
+	bool valid;
+	uint64_t epoch; //Bumped when the aggregates are rebuilt (after being invalidated)
+	uint64_t num_of_invalidations; //Classes registered
+	uint64_t last_consolidation_ms;
+}of1x_stats_flow_aggregates_t;
+
+#ifndef OF1X_STATS_SERVICE_PERIOD_MS
+	#define OF1X_STATS_SERVICE_PERIOD_MS 1000 //Default consolidation period of the stats service
+#endif
+
+#ifndef OF1X_STATS_WALK_BATCH_SIZE
+	#define OF1X_STATS_WALK_BATCH_SIZE 128 //Flow entries visited per table mutex acquisition by the background contexts
+#endif
+
+#ifndef OF1X_STATS_SERVICE_RATE_WINDOW_MS
+	#define OF1X_STATS_SERVICE_RATE_WINDOW_MS 5000 //Default rate window of the stats service
+#endif
+
+/**
+* @ingroup core_of1x 
+* Stats service state of a pipeline
+*/
+typedef struct of1x_stats_service{
+	bool enabled;
+	uint64_t period_ms;
+	uint64_t rate_window_ms;
+	uint64_t last_run_ms;
+}of1x_stats_service_t;
+
 
 typedef struct of1x_stats_group_msg{
 	uint32_t group_id;
@@ -220,6 +348,9 @@ void __of1x_destroy_flow_stats(struct of1x_flow_entry * entry);
 void __of1x_push_single_flow_stats_to_msg(of1x_stats_flow_msg_t* msg, of1x_stats_single_flow_msg_t* sfs);
 of1x_stats_single_flow_msg_t* __of1x_init_stats_single_flow_msg(struct of1x_flow_entry* entry);
 void __of1x_destroy_stats_single_flow_msg(of1x_stats_single_flow_msg_t* msg);
+//Fill/release an already allocated (e.g. page) single flow stats msg
+rofl_result_t __of1x_fill_stats_single_flow_msg(struct of1x_flow_entry* entry, of1x_stats_single_flow_msg_t* msg);
+void __of1x_release_stats_single_flow_msg(of1x_stats_single_flow_msg_t* msg);
 
 of1x_stats_flow_msg_t* __of1x_init_stats_flow_msg(void);
 /**
@@ -273,6 +404,14 @@ static inline void __of1x_stats_table_consolidate(of1x_stats_table_t* stats, __o
 	}
 }
 
+//Running aggregates; matching algorithms MUST call the add and remove hooks (table mutex held)
+//along with the secondary indexes (__of1x_flow_index_add(), __of1x_flow_index_remove())
+void __of1x_stats_consolidate_flow_aggregates(struct of1x_flow_table* table, uint64_t now_ms);
+void __of1x_stats_flow_aggregates_add_entry(struct of1x_flow_table* table, struct of1x_flow_entry* entry);
+void __of1x_stats_flow_aggregates_remove_entry(struct of1x_flow_table* table, struct of1x_flow_entry* entry);
+void __of1x_stats_flow_aggregates_reset_entry(struct of1x_flow_table* table, struct of1x_flow_entry* entry);
+bool __of1x_stats_get_flow_aggregates(struct of1x_flow_table* table, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group* matches, of1x_stats_flow_aggregate_msg_t* msg);
+
 void __of1x_init_group_stats(of1x_stats_group_t *group_stats);
 void __of1x_destroy_group_stats(of1x_stats_group_t* group_stats);
 
@@ -296,6 +435,62 @@ static inline void __of1x_stats_bucket_consolidate(__of1x_stats_bucket_t* stats,
 	}
 }
 
+//Stats service 
+void __of1x_stats_service_run(struct of1x_pipeline* pipeline, uint64_t now_ms);
+
+/**
+* @ingroup core_of1x 
+* Get the consolidated counters and rates of a flow entry, as published by the stats service,
+* without locking nor walking the per-TID counters.
+* @return false if the entry has not been consolidated yet
+*/
+static inline bool of1x_stats_flow_get_snapshot(of1x_stats_flow_t* stats, of1x_stats_snapshot_t* snapshot){
+	return __stats_read_published(&stats->published, snapshot);
+}
+
+/**
+* @ingroup core_of1x 
+* Get the consolidated counters and rates of a table (see of1x_stats_flow_get_snapshot())
+*/
+static inline bool of1x_stats_table_get_snapshot(of1x_stats_table_t* stats, of1x_stats_snapshot_t* snapshot){
+	return __stats_read_published(&stats->published, snapshot);
+}
+
+/**
+* @ingroup core_of1x 
+* Get the consolidated counters and rates of a group (see of1x_stats_flow_get_snapshot())
+*/
+static inline bool of1x_stats_group_get_snapshot(of1x_stats_group_t* stats, of1x_stats_snapshot_t* snapshot){
+	return __stats_read_published(&stats->published, snapshot);
+}
+
+/**
+* @ingroup core_of1x 
+* Get the consolidated counters and rates of a group bucket (see of1x_stats_flow_get_snapshot())
+*/
+static inline bool of1x_stats_bucket_get_snapshot(__of1x_stats_bucket_t* stats, of1x_stats_snapshot_t* snapshot){
+	return __stats_read_published(&stats->published, snapshot);
+}
+
+/**
+* @ingroup core_of1x 
+* Enable the stats service of the pipeline. Every period_ms the per-TID counters of all
+* the flow entries, tables, groups, buckets, attached ports and their queues are consolidated
+* and published (see of1x_stats_flow_get_snapshot(), port_stats_get_rx_snapshot()), and the rates are computed over windows of rate_window_ms.
+* A value of 0 selects the default (OF1X_STATS_SERVICE_PERIOD_MS, OF1X_STATS_SERVICE_RATE_WINDOW_MS).
+*
+* The service runs in the background context processing the timeouts 
+* (of_process_pipeline_tables_timeout_expirations()); the period is therefore 
+* bounded by the frequency of that call.
+*/
+rofl_result_t of1x_stats_service_enable(struct of1x_pipeline* pipeline, uint64_t period_ms, uint64_t rate_window_ms);
+
+/**
+* @ingroup core_of1x 
+* Disable the stats service of the pipeline. Published snapshots are no longer updated.
+*/
+rofl_result_t of1x_stats_service_disable(struct of1x_pipeline* pipeline);
+
 void __of1x_stats_group_inc_reference(of1x_stats_group_t *gr_stats);
 void __of1x_stats_group_dec_reference(of1x_stats_group_t *gr_stats);
 
@@ -326,14 +521,54 @@ void __of1x_destroy_buckets_stats(__of1x_stats_bucket_t *bc_stats);
 * Retrieves individual flow stats 
 * @return of1x_stats_flow_msg_t instance that must be destroyed using of1x_destroy_stats_flow_msg() 
 */
-of1x_stats_flow_msg_t* of1x_get_flow_stats(struct of1x_pipeline* pipeline, uint8_t table_id, uint32_t cookie, uint32_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group* matchs);
+of1x_stats_flow_msg_t* of1x_get_flow_stats(struct of1x_pipeline* pipeline, uint8_t table_id, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group* matchs);
+
+/**
+* @ingroup core_of1x 
+* Initializes a flow stats iterator. Same filtering as of1x_get_flow_stats().
+*/
+rofl_result_t of1x_flow_stats_iter_init(of1x_flow_stats_iter_t* iter, struct of1x_pipeline* pipeline, uint8_t table_id, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group* matches);
+
+/**
+* @ingroup core_of1x 
+* Fills the next page of flow stats (up to page_size entries) in page. num_of_entries is
+* set to the number of entries filled; 0 means that the iteration is over. Page entries
+* MUST be released with of1x_flow_stats_iter_release_page() once used.
+*/
+rofl_result_t of1x_flow_stats_iter_next_page(of1x_flow_stats_iter_t* iter, of1x_stats_single_flow_msg_t* page, unsigned int page_size, unsigned int* num_of_entries);
+
+/**
+* @ingroup core_of1x 
+* Releases the entries of a page (the page buffer itself is owned by the caller)
+*/
+void of1x_flow_stats_iter_release_page(of1x_stats_single_flow_msg_t* page, unsigned int num_of_entries);
 
 /**
 * @ingroup core_of1x 
 * Retrieves aggregated flow stats 
 * @return of1x_stats_flow_aggregate_msg_t instance that must be destroyed using of1x_destroy_stats_flow_aggregate_msg() 
 */
-of1x_stats_flow_aggregate_msg_t* of1x_get_flow_aggregate_stats(struct of1x_pipeline* pipeline, uint8_t table_id, uint32_t cookie, uint32_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group* matchs);
+of1x_stats_flow_aggregate_msg_t* of1x_get_flow_aggregate_stats(struct of1x_pipeline* pipeline, uint8_t table_id, uint64_t cookie, uint64_t cookie_mask, uint32_t out_port, uint32_t out_group, struct of1x_match_group* matchs);
+
+/**
+* @ingroup core_of1x 
+* Maintain running aggregates for the cookie class (cookie, cookie_mask) in all the tables of the
+* pipeline; a cookie_mask of 0 is the whole table class. Aggregated flow stats requests with no
+* matches, any out port and group, and a registered class, are served from the running aggregates
+* (O(1)). The counters are consolidated every OF1X_STATS_AGGREGATES_PERIOD_MS by the background
+* context processing the timeouts (of_process_pipeline_tables_timeout_expirations()), within the
+* stats service pass if enabled. Entries added or removed are accounted immediately.
+*
+* This is opt-in: counters served may be up to a period old. Other requests are always exact, as
+* well as the ones for a class registered since the last consolidation.
+*/
+rofl_result_t of1x_stats_add_aggregate_cookie_class(struct of1x_pipeline* pipeline, uint64_t cookie, uint64_t cookie_mask);
+
+/**
+* @ingroup core_of1x 
+* Stop maintaining running aggregates for the cookie class
+*/
+rofl_result_t of1x_stats_remove_aggregate_cookie_class(struct of1x_pipeline* pipeline, uint64_t cookie, uint64_t cookie_mask);
 
 /**
  * @ingroup core_of1x
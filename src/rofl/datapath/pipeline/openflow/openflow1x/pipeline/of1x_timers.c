@@ -566,6 +566,9 @@ void __of1x_process_pipeline_tables_timeout_expirations(of1x_pipeline_t *const p
 	platform_gettimeofday(&system_time);
 	uint64_t now = __of1x_get_time_ms(&system_time);
 
+	//Consolidate and publish the stats (if enabled and due)
+	__of1x_stats_service_run(pipeline, now);
+
 	for(i=0;i<pipeline->num_of_tables;i++)
 	{
 		of1x_flow_table_t* table = &pipeline->tables[i];
@@ -595,6 +598,13 @@ void __of1x_process_pipeline_tables_timeout_expirations(of1x_pipeline_t *const p
 		}		
 #endif
 		platform_mutex_unlock(table->mutex);
+
+		//Let the matching algorithm do its own maintenance
+		if(of1x_matching_algorithms[table->matching_algorithm].maintenance_hook)
+			of1x_matching_algorithms[table->matching_algorithm].maintenance_hook(table);
+
+		//Consolidate the running flow aggregates (if due)
+		__of1x_stats_consolidate_flow_aggregates(table, now);
 	}
 	return;
 }
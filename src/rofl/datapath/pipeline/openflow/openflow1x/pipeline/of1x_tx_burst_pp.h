@@ -0,0 +1,120 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __OF1X_TX_BURST_PP_H__
+#define __OF1X_TX_BURST_PP_H__
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "rofl_datapath.h"
+#include "../../../util/pp_guard.h" //Never forget to include the guard
+#include "../../../common/datapacket.h"
+#include "../../../platform/likely.h"
+#include "../../../platform/packet.h"
+#include "../../../util/logging.h"
+#include "../of1x_switch.h"
+
+/**
+* @file of1x_tx_burst_pp.h
+*
+* @brief Per TID, per port TX staging (packet processing routines)
+*
+* If the pipeline is compiled with ROFL_PIPELINE_TX_BURSTS, packets output
+* to a (non-meta) port are staged in a per TID, per port buffer of the switch,
+* and handed to the platform via platform_packet_output_burst() when the
+* buffer is full or when the platform flushes them (end of the RX burst).
+*
+* ROFL_PIPELINE_LOCKED_TID may be shared by several threads, so packets
+* processed with it are never staged (platform_packet_output()).
+*/
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+#ifdef ROFL_PIPELINE_TX_BURSTS
+
+//Hand the staged packets to the platform
+static inline void __of1x_tx_burst_flush_port(__of1x_tx_burst_t* burst){
+	ROFL_PIPELINE_INFO("Outputting burst of %u packets to port %p\n", burst->num_of_pkts, burst->port);
+	platform_packet_output_burst(burst->port, burst->pkts, burst->num_of_pkts);
+	burst->num_of_pkts = 0;
+}
+
+//Flush all the staged packets of a TID
+static inline void __of1x_tx_bursts_flush(__of1x_tx_bursts_t* bursts){
+	unsigned int i;
+
+	for(i=0;i<bursts->num_of_ports;i++){
+		if(bursts->ports[i].num_of_pkts)
+			__of1x_tx_burst_flush_port(&bursts->ports[i]);
+	}
+	bursts->num_of_ports = 0;
+}
+
+#endif //ROFL_PIPELINE_TX_BURSTS
+
+/**
+* Output the packet to a (non-meta) port. The packet is staged if the
+* pipeline is compiled with ROFL_PIPELINE_TX_BURSTS.
+*/
+static inline void __of1x_tx_burst_output(const unsigned int tid, const struct of1x_switch* sw, datapacket_t* pkt, switch_port_t* port){
+
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	__of1x_tx_bursts_t* bursts;
+	__of1x_tx_burst_t* burst;
+	unsigned int i;
+
+	if(unlikely(tid == ROFL_PIPELINE_LOCKED_TID)){
+		platform_packet_output(pkt, port);
+		return;
+	}
+
+	bursts = &((of1x_switch_t*)sw)->tx_bursts[tid];
+
+	//Lookup the port staging buffer (few ports per burst)
+	for(i=0;i<bursts->num_of_ports;i++){
+		if(bursts->ports[i].port == port)
+			break;
+	}
+
+	if(unlikely(i == bursts->num_of_ports)){
+		//Make room if all the buffers are in use
+		if(unlikely(i == ROFL_PIPELINE_TX_BURST_MAX_PORTS)){
+			__of1x_tx_bursts_flush(bursts);
+			i = 0;
+		}
+		bursts->ports[i].port = port;
+		bursts->ports[i].num_of_pkts = 0;
+		bursts->num_of_ports++;
+	}
+
+	burst = &bursts->ports[i];
+	burst->pkts[burst->num_of_pkts++] = pkt;
+
+	//Threshold
+	if(burst->num_of_pkts == ROFL_PIPELINE_TX_BURST_SIZE)
+		__of1x_tx_burst_flush_port(burst);
+#else
+	(void)tid;
+	(void)sw;
+	platform_packet_output(pkt, port);
+#endif
+}
+
+/**
+* Flush the packets staged by the TID
+*/
+static inline void __of1x_tx_burst_flush(const unsigned int tid, const struct of1x_switch* sw){
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	__of1x_tx_bursts_flush(&((of1x_switch_t*)sw)->tx_bursts[tid]);
+#else
+	(void)tid;
+	(void)sw;
+#endif
+}
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //OF1X_TX_BURST_PP
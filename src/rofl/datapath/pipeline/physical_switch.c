@@ -19,6 +19,313 @@ switch_port_t* flood_meta_port=NULL;
 switch_port_t* in_port_meta_port=NULL;
 switch_port_t* all_meta_port=NULL;
 
+//
+// Retired arrays
+//
+
+//Keep mem until the physical switch is destroyed (lock-free readers)
+static rofl_result_t __physical_switch_retire(void* mem){
+
+	__physical_switch_retired_t* node = platform_malloc_shared(sizeof(__physical_switch_retired_t));
+
+	if( unlikely(node == NULL) )
+		return ROFL_FAILURE;
+
+	node->mem = mem;
+	node->next = psw->retired;
+	psw->retired = node;
+
+	return ROFL_SUCCESS;
+}
+
+static void __physical_switch_release_retired(void){
+
+	__physical_switch_retired_t* next;
+
+	while(psw->retired){
+		next = psw->retired->next;
+		platform_free_shared(psw->retired->mem);
+		platform_free_shared(psw->retired);
+		psw->retired = next;
+	}
+}
+
+//
+// Growable tables
+//
+
+static rofl_result_t __physical_switch_table_init(__physical_switch_table_t* table, unsigned int size, unsigned int max_size){
+
+	if(size > max_size)
+		size = max_size;
+
+	table->entries = platform_malloc_shared(sizeof(void*)*size);
+	if( unlikely(table->entries == NULL) )
+		return ROFL_FAILURE;
+
+	platform_memset(table->entries, 0, sizeof(void*)*size);
+	table->size = size;
+	table->max_size = max_size;
+	table->num_of_entries = table->first_free = 0;
+
+	return ROFL_SUCCESS;
+}
+
+static void __physical_switch_table_destroy(__physical_switch_table_t* table){
+	platform_free_shared(table->entries);
+	table->entries = NULL;
+	table->size = table->num_of_entries = 0;
+}
+
+//Double the size (up to max_size)
+static rofl_result_t __physical_switch_table_grow(__physical_switch_table_t* table){
+
+	void** entries;
+	unsigned int size;
+
+	if(table->size == table->max_size)
+		return ROFL_FAILURE;
+
+	size = (table->size*2 > table->max_size)? table->max_size : table->size*2;
+	entries = platform_malloc_shared(sizeof(void*)*size);
+	if( unlikely(entries == NULL) )
+		return ROFL_FAILURE;
+
+	platform_memset(entries, 0, sizeof(void*)*size);
+	memcpy(entries, table->entries, sizeof(void*)*table->size);
+
+	if(__physical_switch_retire(table->entries) != ROFL_SUCCESS){
+		platform_free_shared(entries);
+		return ROFL_FAILURE;
+	}
+
+	//Publish the array before the size (see __physical_switch_table_get())
+	table->entries = entries;
+	tid_memory_barrier();
+	table->size = size;
+
+	return ROFL_SUCCESS;
+}
+
+//Adds an entry in the first free slot (physical switch mutex MUST be held)
+static rofl_result_t __physical_switch_table_add(__physical_switch_table_t* table, void* value, unsigned int* id){
+
+	unsigned int i;
+
+	if(table->num_of_entries == table->size && __physical_switch_table_grow(table) != ROFL_SUCCESS)
+		return ROFL_FAILURE;
+
+	for(i=table->first_free;i<table->size;i++){
+		if(table->entries[i] == NULL)
+			break;
+	}
+
+	assert(i < table->size);
+
+	table->entries[i] = value;
+	table->num_of_entries++;
+	table->first_free = i+1;
+	*id = i;
+
+	return ROFL_SUCCESS;
+}
+
+//Removes an entry (physical switch mutex MUST be held)
+static void __physical_switch_table_remove(__physical_switch_table_t* table, unsigned int id){
+
+	assert(id < table->size && table->entries[id]);
+
+	table->entries[id] = NULL;
+	table->num_of_entries--;
+	if(id < table->first_free)
+		table->first_free = id;
+}
+
+//Lock-free read of the array and its size
+static inline void** __physical_switch_table_get(const __physical_switch_table_t* table, unsigned int* size){
+	*size = table->size;
+	tid_memory_barrier();
+	return table->entries;
+}
+
+//
+// Hash indexes
+//
+
+static rofl_result_t __physical_switch_index_init(__physical_switch_index_t* index, unsigned int num_of_slots){
+
+	index->slots = platform_malloc_shared(sizeof(__physical_switch_index_slot_t)*num_of_slots);
+	if( unlikely(index->slots == NULL) )
+		return ROFL_FAILURE;
+
+	platform_memset(index->slots, 0, sizeof(__physical_switch_index_slot_t)*num_of_slots);
+	index->mask = num_of_slots-1;
+	index->num_of_entries = 0;
+	seqlock_init(&index->seqlock);
+
+	return ROFL_SUCCESS;
+}
+
+static void __physical_switch_index_destroy(__physical_switch_index_t* index){
+	platform_free_shared(index->slots);
+	index->slots = NULL;
+}
+
+static inline unsigned int __physical_switch_index_home(unsigned int mask, uint64_t key){
+	return ((unsigned int)((key * UINT64_C(0x9E3779B97F4A7C15)) >> 32)) & mask;
+}
+
+//FNV-1a of the port name
+static inline uint64_t __physical_switch_port_name_hash(const char* name){
+
+	unsigned int i;
+	uint64_t hash = UINT64_C(0xcbf29ce484222325);
+
+	for(i=0;i<SWITCH_PORT_MAX_LEN_NAME && name[i] != '\0';i++){
+		hash ^= (uint8_t)name[i];
+		hash *= UINT64_C(0x100000001b3);
+	}
+
+	return hash;
+}
+
+//Lock-free lookup. If name is set, values are ports and the name must match
+static inline void* __physical_switch_index_lookup(const __physical_switch_index_t* index, uint64_t key, const char* name){
+
+	uint32_t seq;
+	unsigned int i, slot, mask;
+	const __physical_switch_index_slot_t *slots, *s;
+	void* value;
+
+	do{
+		seq = seqlock_read_begin(&index->seqlock);
+		value = NULL;
+
+		//The mask first (see __physical_switch_index_grow())
+		mask = index->mask;
+		tid_memory_barrier();
+		slots = index->slots;
+
+		slot = __physical_switch_index_home(mask, key);
+		for(i=0;i<=mask;i++,slot=(slot+1)&mask){
+			s = &slots[slot];
+
+			if(!s->value)
+				break;
+
+			if(s->key == key && ( !name || strncmp(((switch_port_t*)s->value)->name, name, SWITCH_PORT_MAX_LEN_NAME) == 0 ) ){
+				value = s->value;
+				break;
+			}
+		}
+	}while( unlikely(seqlock_read_retry(&index->seqlock, seq)) );
+
+	return value;
+}
+
+//Doubles the slots (physical switch mutex MUST be held)
+static rofl_result_t __physical_switch_index_grow(__physical_switch_index_t* index){
+
+	unsigned int i, slot, mask;
+	__physical_switch_index_slot_t* slots;
+
+	mask = (index->mask<<1) | 0x1;
+	slots = platform_malloc_shared(sizeof(__physical_switch_index_slot_t)*(mask+1));
+	if( unlikely(slots == NULL) )
+		return ROFL_FAILURE;
+	platform_memset(slots, 0, sizeof(__physical_switch_index_slot_t)*(mask+1));
+
+	//Rehash
+	for(i=0;i<=index->mask;i++){
+		if(!index->slots[i].value)
+			continue;
+		slot = __physical_switch_index_home(mask, index->slots[i].key);
+		while(slots[slot].value)
+			slot = (slot+1)&mask;
+		slots[slot] = index->slots[i];
+	}
+
+	if(__physical_switch_retire(index->slots) != ROFL_SUCCESS){
+		platform_free_shared(slots);
+		return ROFL_FAILURE;
+	}
+
+	//Publish the (bigger) slots before the mask
+	seqlock_write_begin(&index->seqlock);
+	index->slots = slots;
+	tid_memory_barrier();
+	index->mask = mask;
+	seqlock_write_end(&index->seqlock);
+
+	return ROFL_SUCCESS;
+}
+
+//Add (physical switch mutex MUST be held)
+static rofl_result_t __physical_switch_index_add(__physical_switch_index_t* index, uint64_t key, void* value){
+
+	unsigned int slot;
+
+	//Keep it at most half full
+	if( (index->num_of_entries+1)*2 > index->mask+1 && __physical_switch_index_grow(index) != ROFL_SUCCESS)
+		return ROFL_FAILURE;
+
+	slot = __physical_switch_index_home(index->mask, key);
+	while(index->slots[slot].value)
+		slot = (slot+1)&index->mask;
+
+	seqlock_write_begin(&index->seqlock);
+	index->slots[slot].key = key;
+	index->slots[slot].value = value;
+	seqlock_write_end(&index->seqlock);
+
+	index->num_of_entries++;
+
+	return ROFL_SUCCESS;
+}
+
+//Remove (physical switch mutex MUST be held)
+static void __physical_switch_index_remove(__physical_switch_index_t* index, uint64_t key, void* value){
+
+	unsigned int i, slot, next, home;
+
+	//Look for the value
+	slot = __physical_switch_index_home(index->mask, key);
+	for(i=0;i<=index->mask;i++,slot=(slot+1)&index->mask){
+		if(!index->slots[slot].value)
+			return; //Not indexed
+		if(index->slots[slot].value == value)
+			break;
+	}
+
+	if(i > index->mask)
+		return;
+
+	seqlock_write_begin(&index->seqlock);
+
+	//Shift back the following values of the cluster (no tombstones)
+	next = slot;
+	while(1){
+		next = (next+1)&index->mask;
+
+		if(!index->slots[next].value)
+			break;
+
+		//Move it only if its home slot is not within (slot, next]
+		home = __physical_switch_index_home(index->mask, index->slots[next].key);
+		if( ((next-home)&index->mask) >= ((next-slot)&index->mask) ){
+			index->slots[slot] = index->slots[next];
+			slot = next;
+		}
+	}
+
+	index->slots[slot].key = 0x0ULL;
+	index->slots[slot].value = NULL;
+
+	seqlock_write_end(&index->seqlock);
+
+	index->num_of_entries--;
+}
+
 
 //
 // Physical switch mgmt
@@ -45,12 +352,19 @@ rofl_result_t physical_switch_init(){
 	if(!psw->mutex)
 		return ROFL_FAILURE;
 	
-	platform_memset(psw->logical_switches, 0, sizeof(psw->logical_switches));
+	psw->retired = NULL;
 	psw->num_of_logical_switches = 0;	
 
-	platform_memset(psw->physical_ports, 0, sizeof(psw->physical_ports));
-	platform_memset(psw->tunnel_ports, 0, sizeof(psw->tunnel_ports));
-	platform_memset(psw->virtual_ports, 0, sizeof(psw->virtual_ports));
+	//Tables
+	if(__physical_switch_table_init(&psw->logical_switches, PHYSICAL_SWITCH_INITIAL_NUM_LS, PHYSICAL_SWITCH_MAX_LS) != ROFL_SUCCESS)
+		return ROFL_FAILURE;
+	if(__physical_switch_table_init(&psw->physical_ports, PHYSICAL_SWITCH_INITIAL_NUM_PORTS, PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS) != ROFL_SUCCESS)
+		return ROFL_FAILURE;
+	if(__physical_switch_table_init(&psw->tunnel_ports, PHYSICAL_SWITCH_INITIAL_NUM_PORTS, PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS) != ROFL_SUCCESS)
+		return ROFL_FAILURE;
+	if(__physical_switch_table_init(&psw->virtual_ports, PHYSICAL_SWITCH_INITIAL_NUM_PORTS, PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS) != ROFL_SUCCESS)
+		return ROFL_FAILURE;
+
 	platform_memset(psw->meta_ports, 0, sizeof(psw->meta_ports));
 	
 	//Generate metaports
@@ -69,6 +383,12 @@ rofl_result_t physical_switch_init(){
 	in_port_meta_port = &psw->meta_ports[META_PORT_IN_PORT_INDEX];
 	all_meta_port = &psw->meta_ports[META_PORT_ALL_INDEX];
 
+	//Indexes
+	if(__physical_switch_index_init(&psw->port_index, PHYSICAL_SWITCH_PORT_INDEX_SLOTS) != ROFL_SUCCESS)
+		return ROFL_FAILURE;
+	if(__physical_switch_index_init(&psw->lsi_index, PHYSICAL_SWITCH_LSI_INDEX_SLOTS) != ROFL_SUCCESS)
+		return ROFL_FAILURE;
+
 	//Initialize monitoring data
 	if(__monitoring_init(&psw->monitoring) != ROFL_SUCCESS)
 		return ROFL_FAILURE;		
@@ -104,30 +424,39 @@ void physical_switch_destroy(){
 	platform_mutex_lock(psw->mutex);
 
 	//Destroy logical switches
-	for(i=0;i<PHYSICAL_SWITCH_MAX_LS;i++){
-		if(psw->logical_switches[i])
-			of_destroy_switch(psw->logical_switches[i]);	
+	for(i=0;i<psw->logical_switches.size;i++){
+		if(psw->logical_switches.entries[i])
+			of_destroy_switch((of_switch_t*)psw->logical_switches.entries[i]);	
 	}
 
 	//Destroying ports
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS;i++){
-		if( psw->physical_ports[i] != NULL ){ 
-			switch_port_destroy(psw->physical_ports[i]);
+	for(i=0;i<psw->physical_ports.size;i++){
+		if( psw->physical_ports.entries[i] != NULL ){ 
+			switch_port_destroy((switch_port_t*)psw->physical_ports.entries[i]);
 		}
 	}
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS;i++){
-		if( psw->virtual_ports[i] != NULL ){ 
-			switch_port_destroy(psw->virtual_ports[i]);
+	for(i=0;i<psw->virtual_ports.size;i++){
+		if( psw->virtual_ports.entries[i] != NULL ){ 
+			switch_port_destroy((switch_port_t*)psw->virtual_ports.entries[i]);
 		}
 	}
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS;i++){
-		if( psw->tunnel_ports[i] != NULL ){ 
-			switch_port_destroy(psw->tunnel_ports[i]);
+	for(i=0;i<psw->tunnel_ports.size;i++){
+		if( psw->tunnel_ports.entries[i] != NULL ){ 
+			switch_port_destroy((switch_port_t*)psw->tunnel_ports.entries[i]);
 		}
 	}
 
 	//Destroy monitoring
 	__monitoring_destroy(&psw->monitoring);		
+
+	//Destroy tables, indexes and the arrays they replaced
+	__physical_switch_table_destroy(&psw->logical_switches);
+	__physical_switch_table_destroy(&psw->physical_ports);
+	__physical_switch_table_destroy(&psw->virtual_ports);
+	__physical_switch_table_destroy(&psw->tunnel_ports);
+	__physical_switch_index_destroy(&psw->port_index);
+	__physical_switch_index_destroy(&psw->lsi_index);
+	__physical_switch_release_retired();
 	
 	//Destroy mutex
 	platform_mutex_destroy(psw->mutex);
@@ -143,47 +472,23 @@ void physical_switch_destroy(){
 //Get the port by its name
 switch_port_t* physical_switch_get_port_by_name(const char *name){
 
-	unsigned int i;
-
-	//Physical ports	
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS;i++){
-		if( psw->physical_ports[i] != NULL && strncmp(psw->physical_ports[i]->name, name, SWITCH_PORT_MAX_LEN_NAME)==0 ){
-			return psw->physical_ports[i];
-		}
-	}
-
-	//Virtual ports
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS;i++){
-		if( psw->virtual_ports[i] != NULL && strncmp(psw->virtual_ports[i]->name, name, SWITCH_PORT_MAX_LEN_NAME)==0 ){
-			return psw->virtual_ports[i];
-		}
-	}
-
-	//Tunnel ports
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS;i++){
-		if( psw->tunnel_ports[i] != NULL && strncmp(psw->tunnel_ports[i]->name, name, SWITCH_PORT_MAX_LEN_NAME)==0 ){
-			return psw->tunnel_ports[i];
-		}
-	}
+	if( unlikely(name==NULL) )
+		return NULL;
 
-	return NULL;
+	return (switch_port_t*)__physical_switch_index_lookup(&psw->port_index, __physical_switch_port_name_hash(name), name);
 }
 
-
 //Get the reference to the physical ports
 switch_port_t** physical_switch_get_physical_ports(unsigned int* max_ports){
-	*max_ports = PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS;
-	return psw->physical_ports;
+	return (switch_port_t**)__physical_switch_table_get(&psw->physical_ports, max_ports);
 }
 //Get the reference to the virtual ports
 switch_port_t** physical_switch_get_virtual_ports(unsigned int* max_ports){
-	*max_ports = PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS;
-	return psw->virtual_ports;
+	return (switch_port_t**)__physical_switch_table_get(&psw->virtual_ports, max_ports);
 }
 //Get the reference to the physical ports
 switch_port_t** physical_switch_get_tunnel_ports(unsigned int* max_ports){
-	*max_ports = PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS;
-	return psw->tunnel_ports;
+	return (switch_port_t**)__physical_switch_table_get(&psw->tunnel_ports, max_ports);
 }
 
 /*
@@ -208,73 +513,79 @@ switch_port_t* physical_switch_get_port_by_num(const uint64_t dpid, unsigned int
 	return lsw->logical_ports[port_num].port;
 }
 
+//Table of ports of the type
+static __physical_switch_table_t* __physical_switch_get_port_table(port_type_t type){
+
+	switch(type){
+
+		case PORT_TYPE_PHYSICAL:
+			return &psw->physical_ports; 
+
+		case PORT_TYPE_VIRTUAL:
+			return &psw->virtual_ports; 
+
+		case PORT_TYPE_TUNNEL:
+			return &psw->tunnel_ports; 
+			
+		case PORT_TYPE_NF_NATIVE:
+		case PORT_TYPE_NF_SHMEM:
+		case PORT_TYPE_NF_EXTERNAL:
+			//IVANO - FIXME: I'm not sure about this
+			return &psw->physical_ports; 
+		
+		default:
+			//Invalid type		
+			return NULL;
+	}	
+}
+
 /*
 * Attempts to add a port to the physical switch pool port
 */
 rofl_result_t physical_switch_add_port(switch_port_t* port){
 
-	unsigned int i, max;
-	switch_port_t** array = NULL;
-
+	unsigned int id;
+	__physical_switch_table_t* table;
 
 	if( unlikely(port==NULL) )
 		return ROFL_FAILURE;	
 
 	ROFL_PIPELINE_DEBUG("Trying to add port(%p) named %s to the physical switch\n", port, port->name);
 	
+	//Serialize
+	platform_mutex_lock(psw->mutex);
+
 	if(physical_switch_get_port_by_name(port->name)){
+		platform_mutex_unlock(psw->mutex);
 		ROFL_PIPELINE_DEBUG("There is already a port named:%s in the physical switch\n",port->name);
 		return ROFL_FAILURE;
 	}
 
-	//Serialize
-	platform_mutex_lock(psw->mutex);
+	table = __physical_switch_get_port_table(port->type);
+	if(!table){
+		platform_mutex_unlock(psw->mutex);
+		return ROFL_FAILURE;
+	}
 
-	switch(port->type){
+	//Add it to the first empty slot (growing the table if needed)
+	if(__physical_switch_table_add(table, port, &id) != ROFL_SUCCESS){
+		platform_mutex_unlock(psw->mutex);
 
-		case PORT_TYPE_PHYSICAL:
-			max = PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS;
-			array = psw->physical_ports; 
-			break;			
+		//No free slots left in the pool
+		ROFL_PIPELINE_DEBUG("Insertion failed of port(%p); no available slots\n",port);
+		return ROFL_FAILURE;
+	}
 
-		case PORT_TYPE_VIRTUAL:
-			max = PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS;
-			array = psw->virtual_ports; 
-			break;			
+	if(__physical_switch_index_add(&psw->port_index, __physical_switch_port_name_hash(port->name), port) != ROFL_SUCCESS){
+		__physical_switch_table_remove(table, id);
+		platform_mutex_unlock(psw->mutex);
+		return ROFL_FAILURE;
+	}
 
-		case PORT_TYPE_TUNNEL:
-			max = PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS;
-			array = psw->tunnel_ports; 
-			break;
-			
-		case PORT_TYPE_NF_NATIVE:
-		case PORT_TYPE_NF_SHMEM:
-		case PORT_TYPE_NF_EXTERNAL:
-			//IVANO - FIXME: I'm not sure about this
-			max = PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS;
-			array = psw->physical_ports; 
-			break;
-		
-		default:
-			//Invalid type		
-			platform_mutex_unlock(psw->mutex);
-			return ROFL_FAILURE;
-	}	
+	port->psw_id = id;
 
-	//Look for the first empty slot
-	for(i=0;i<max;i++){
-		if(array[i] == NULL){
-			array[i] = port;
-			platform_mutex_unlock(psw->mutex);
-			return ROFL_SUCCESS;
-		}
-	}
-	
 	platform_mutex_unlock(psw->mutex);
-
-	//No free slots left in the pool
-	ROFL_PIPELINE_DEBUG("Insertion failed of port(%p); no available slots\n",port);
-	return ROFL_FAILURE;
+	return ROFL_SUCCESS;
 }
 
 /*
@@ -282,7 +593,6 @@ rofl_result_t physical_switch_add_port(switch_port_t* port){
 */
 rofl_result_t physical_switch_remove_port(const char* name){
 
-	unsigned int i;
 	switch_port_t* port;
 
 	if( unlikely(name==NULL) )
@@ -291,46 +601,23 @@ rofl_result_t physical_switch_remove_port(const char* name){
 	//Serialize
 	platform_mutex_lock(psw->mutex);
 
-	//Looking in the physical ports list 
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS;i++){
-		
-		if(  psw->physical_ports[i] != NULL && strncmp(psw->physical_ports[i]->name, name, SWITCH_PORT_MAX_LEN_NAME) == 0 ){
-			port = psw->physical_ports[i]; 
-			psw->physical_ports[i] = NULL;
-			platform_mutex_unlock(psw->mutex);
-			switch_port_destroy(port);
-			return ROFL_SUCCESS;
-		}
-	}
-	
-	//Looking in the virtual ports list 
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS;i++){
-		if(  psw->virtual_ports[i] != NULL && strncmp(psw->virtual_ports[i]->name, name, SWITCH_PORT_MAX_LEN_NAME) == 0 ){
-			port = psw->virtual_ports[i]; 
-			psw->virtual_ports[i] = NULL;
-			platform_mutex_unlock(psw->mutex);
-			switch_port_destroy(port);
-			return ROFL_SUCCESS;
-		}
-	}
+	port = physical_switch_get_port_by_name(name);
 
-	//Looking in the tunnel ports list 
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS;i++){
-		if(  psw->tunnel_ports[i] != NULL && strncmp(psw->tunnel_ports[i]->name, name, SWITCH_PORT_MAX_LEN_NAME) == 0 ){
-			port = psw->tunnel_ports[i]; 
-			psw->tunnel_ports[i] = NULL;
-			platform_mutex_unlock(psw->mutex);
-			switch_port_destroy(port);
-			return ROFL_SUCCESS;
-		}
+	if(!port){
+		platform_mutex_unlock(psw->mutex);
+		//Port not found
+		return ROFL_FAILURE;
 	}
 
-	platform_mutex_unlock(psw->mutex);
+	__physical_switch_index_remove(&psw->port_index, __physical_switch_port_name_hash(port->name), port);
 
-	//Port not found
-	return ROFL_FAILURE;
-	 	
+	//Remove it from the pool
+	__physical_switch_table_remove(__physical_switch_get_port_table(port->type), port->psw_id);
+
+	platform_mutex_unlock(psw->mutex);
 
+	switch_port_destroy(port);
+	return ROFL_SUCCESS;
 }
 
 
@@ -344,48 +631,41 @@ rofl_result_t physical_switch_remove_port(const char* name){
 */
 of_switch_t** physical_switch_get_logical_switches(unsigned int* max_switches){
 
-	*max_switches = PHYSICAL_SWITCH_MAX_LS;
-	
-	return psw->logical_switches; 	
+	return (of_switch_t**)__physical_switch_table_get(&psw->logical_switches, max_switches);
 }
 
 
 //Get logical switch
 of_switch_t* physical_switch_get_logical_switch_by_dpid(const uint64_t dpid){
-	int i;
-	
-	for(i=0;i<PHYSICAL_SWITCH_MAX_LS;i++){
-		if( psw->logical_switches[i] && psw->logical_switches[i]->dpid == dpid )
-			return psw->logical_switches[i];
-	}
-
-	return NULL;
+	return (of_switch_t*)__physical_switch_index_lookup(&psw->lsi_index, dpid, NULL);
 }
 
 //Add/remove methods
 rofl_result_t physical_switch_add_logical_switch(of_switch_t* sw){
-	int i;
 
-	if(physical_switch_get_logical_switch_by_dpid(sw->dpid))
-		return ROFL_FAILURE;
-	
+	unsigned int id;
+
 	//Serialize
 	platform_mutex_lock(psw->mutex);
 
-	// check bounds
-	if(psw->num_of_logical_switches == PHYSICAL_SWITCH_MAX_LS){
-		//Serialize
+	if(physical_switch_get_logical_switch_by_dpid(sw->dpid)){
 		platform_mutex_unlock(psw->mutex);
 		return ROFL_FAILURE;
 	}
-	
-	//Look for an available slot
-	for(i=0;i<PHYSICAL_SWITCH_MAX_LS;i++){
-		if(!psw->logical_switches[i])
-			break;
+
+	//Look for an available slot (growing the table if needed)
+	if(__physical_switch_table_add(&psw->logical_switches, sw, &id) != ROFL_SUCCESS){
+		platform_mutex_unlock(psw->mutex);
+		return ROFL_FAILURE;
+	}
+
+	if(__physical_switch_index_add(&psw->lsi_index, sw->dpid, sw) != ROFL_SUCCESS){
+		__physical_switch_table_remove(&psw->logical_switches, id);
+		platform_mutex_unlock(psw->mutex);
+		return ROFL_FAILURE;
 	}
 
-	psw->logical_switches[i] = sw;
+	sw->psw_id = id;
 	psw->num_of_logical_switches++;
 
 	platform_mutex_unlock(psw->mutex);
@@ -394,7 +674,6 @@ rofl_result_t physical_switch_add_logical_switch(of_switch_t* sw){
 
 rofl_result_t physical_switch_remove_logical_switch_by_dpid(const uint64_t dpid){
 
-	int i;
 	of_switch_t* sw;
 
 	ROFL_PIPELINE_DEBUG("Removing logical switch with dpid: 0x%"PRIx64"\n",dpid);
@@ -402,33 +681,27 @@ rofl_result_t physical_switch_remove_logical_switch_by_dpid(const uint64_t dpid)
 	//Serialize
 	platform_mutex_lock(psw->mutex);
 
-	if(!physical_switch_get_logical_switch_by_dpid(dpid)){
+	sw = physical_switch_get_logical_switch_by_dpid(dpid);
+
+	if(!sw){
 		platform_mutex_unlock(psw->mutex);
 		ROFL_PIPELINE_WARN("Logical switch not found\n");	
 		return ROFL_FAILURE;
 	}
-	
-	for(i=0;i<PHYSICAL_SWITCH_MAX_LS;i++){
-		if(psw->logical_switches[i] && psw->logical_switches[i]->dpid == dpid){
-
-			sw = psw->logical_switches[i];
 
-			psw->logical_switches[i] = NULL;
-			psw->num_of_logical_switches--;
+	__physical_switch_index_remove(&psw->lsi_index, dpid, sw);
+	
+	//Remove it from the table
+	__physical_switch_table_remove(&psw->logical_switches, sw->psw_id);
+	psw->num_of_logical_switches--;
 
-			//Free the rest to do stuff with the physical sw
-			platform_mutex_unlock(psw->mutex);
+	//Free the rest to do stuff with the physical sw
+	platform_mutex_unlock(psw->mutex);
 
-			//Destroy the switch				
-			of_destroy_switch(sw);				
-			
-			return ROFL_SUCCESS;
-		}
-	}
+	//Destroy the switch				
+	of_destroy_switch(sw);				
 	
-	//This statement can never be reached	
-	platform_mutex_unlock(psw->mutex);
-	return ROFL_FAILURE;
+	return ROFL_SUCCESS;
 }
 
 rofl_result_t physical_switch_remove_logical_switch(of_switch_t* sw){
@@ -547,19 +820,7 @@ switch_port_name_list_t* physical_switch_get_all_port_names(void){
 	platform_mutex_lock(psw->mutex);
 
 	//Determine the number of (currenly) exisitng ports
-	num_of_ports=0;
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS;i++){
-		if(psw->physical_ports[i])
-			num_of_ports++;
-	}
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS;i++){
-		if(psw->tunnel_ports[i])
-			num_of_ports++;
-	}
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS;i++){
-		if(psw->virtual_ports[i])
-			num_of_ports++;
-	}
+	num_of_ports = psw->physical_ports.num_of_entries + psw->tunnel_ports.num_of_entries + psw->virtual_ports.num_of_entries;
 	
 	//Allocate memory
 	list = platform_malloc_shared(sizeof(switch_port_name_list_t));
@@ -579,21 +840,21 @@ switch_port_name_list_t* physical_switch_get_all_port_names(void){
 	list->num_of_ports = num_of_ports;
 
 	num_of_ports=0;
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS;i++){
-		if(psw->physical_ports[i]){
-			memcpy(&list->names[num_of_ports], &psw->physical_ports[i]->name, SWITCH_PORT_MAX_LEN_NAME);
+	for(i=0;i<psw->physical_ports.size;i++){
+		if(psw->physical_ports.entries[i]){
+			memcpy(&list->names[num_of_ports], &((switch_port_t*)psw->physical_ports.entries[i])->name, SWITCH_PORT_MAX_LEN_NAME);
 			num_of_ports++;
 		}
 	}
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS;i++){
-		if(psw->tunnel_ports[i]){
-			memcpy(&list->names[num_of_ports], &psw->tunnel_ports[i]->name, SWITCH_PORT_MAX_LEN_NAME);
+	for(i=0;i<psw->tunnel_ports.size;i++){
+		if(psw->tunnel_ports.entries[i]){
+			memcpy(&list->names[num_of_ports], &((switch_port_t*)psw->tunnel_ports.entries[i])->name, SWITCH_PORT_MAX_LEN_NAME);
 			num_of_ports++;
 		}
 	}
-	for(i=0;i<PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS;i++){
-		if(psw->virtual_ports[i]){
-			memcpy(&list->names[num_of_ports], &psw->virtual_ports[i]->name, SWITCH_PORT_MAX_LEN_NAME);
+	for(i=0;i<psw->virtual_ports.size;i++){
+		if(psw->virtual_ports.entries[i]){
+			memcpy(&list->names[num_of_ports], &((switch_port_t*)psw->virtual_ports.entries[i])->name, SWITCH_PORT_MAX_LEN_NAME);
 			num_of_ports++;
 		}
 	}
@@ -632,7 +893,7 @@ switch_port_snapshot_t* physical_switch_get_port_snapshot(const char* name){
 //LSIs
 dpid_list_t* physical_switch_get_all_lsi_dpids(void){
 
-	int i,j;
+	unsigned int i,j;
 	dpid_list_t* list;
 
 	list = platform_malloc_shared(sizeof(dpid_list_t));
@@ -653,9 +914,9 @@ dpid_list_t* physical_switch_get_all_lsi_dpids(void){
 	
 	//Fill it with 0s	
 	platform_memset(list->dpids,0,sizeof(uint64_t)*list->num_of_lsis);
-	for(i=0,j=0;i<PHYSICAL_SWITCH_MAX_LS;i++){
-		if(psw->logical_switches[i]){
-			list->dpids[j] = psw->logical_switches[i]->dpid; 
+	for(i=0,j=0;i<psw->logical_switches.size;i++){
+		if(psw->logical_switches.entries[i]){
+			list->dpids[j] = ((of_switch_t*)psw->logical_switches.entries[i])->dpid; 
 			j++;
 		}
 	}
@@ -689,3 +950,22 @@ of_switch_snapshot_t* physical_switch_get_logical_switch_snapshot(const uint64_t
 
 	return to_return;
 }
+
+of_switch_snapshot_t* physical_switch_get_logical_switch_delta_snapshot(const uint64_t dpid, of_switch_snapshot_t* base){
+
+	of_switch_t* sw;
+	of_switch_snapshot_t* to_return=NULL;
+
+	//Serialize
+	platform_mutex_lock(psw->mutex);
+
+	//Try to find the switch
+	sw = physical_switch_get_logical_switch_by_dpid(dpid);  
+
+	if(sw)
+		to_return = __of_switch_get_delta_snapshot(sw, base); 
+
+	platform_mutex_unlock(psw->mutex);
+
+	return to_return;
+}
@@ -11,6 +11,7 @@
 #include "openflow/of_switch.h"
 #include "switch_port.h"
 #include "monitoring.h"
+#include "threading.h"
 #include "platform/lock.h"
 
 /**
@@ -92,12 +93,17 @@
 */
 
 
+/*
+* Port and logical switch tables grow on demand (doubling) from their
+* initial size up to the maximum.
+*/
+
 #ifndef PHYSICAL_SWITCH_MAX_LS
     /**
     * @brief Maximum number of logical switches that can be instantiated
     * @ingroup mgmt
     */
-    #define PHYSICAL_SWITCH_MAX_LS 64
+    #define PHYSICAL_SWITCH_MAX_LS 4096
 #endif
 
 #ifndef PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS
@@ -105,7 +111,7 @@
     * @brief Maximum number of phyisical ports
     * @ingroup mgmt
     */
-    #define PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS 1024 
+    #define PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS 4096 
 #endif
 
 #ifndef PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS
@@ -113,7 +119,7 @@
     * @brief Maximum number of virtual ports
     * @ingroup mgmt
     */
-    #define PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS 256
+    #define PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS 65536
 #endif
 
 #ifndef PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS
@@ -121,11 +127,31 @@
     * @brief Maximum number of tunnel ports
     * @ingroup mgmt
     */
-    #define PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS 32
+    #define PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS 65536
+#endif
+
+#ifndef PHYSICAL_SWITCH_INITIAL_NUM_LS
+	//Initial size of the logical switch table
+	#define PHYSICAL_SWITCH_INITIAL_NUM_LS 16
+#endif
+
+#ifndef PHYSICAL_SWITCH_INITIAL_NUM_PORTS
+	//Initial size of the port tables
+	#define PHYSICAL_SWITCH_INITIAL_NUM_PORTS 64
 #endif
     
 #define PHYSICAL_SWITCH_MAX_NUM_META_PORTS 8
 
+#ifndef PHYSICAL_SWITCH_PORT_INDEX_SLOTS
+	//Initial slots of the port name index; MUST be a power of 2
+	#define PHYSICAL_SWITCH_PORT_INDEX_SLOTS 256
+#endif
+
+#ifndef PHYSICAL_SWITCH_LSI_INDEX_SLOTS
+	//Initial slots of the LSI dpid index; MUST be a power of 2
+	#define PHYSICAL_SWITCH_LSI_INDEX_SLOTS 64
+#endif
+
 //Opaque platform state (to be used, maybe, for platform hooks).
 //Currently unused
 typedef void platform_physical_switch_state_t;
@@ -146,33 +172,86 @@ extern switch_port_t* in_port_meta_port;
 */
 extern switch_port_t* all_meta_port;
 
+//Hash index slot (empty if value is NULL)
+typedef struct __physical_switch_index_slot{
+	uint64_t key; //dpid or port name hash
+	void* value;
+}__physical_switch_index_slot_t;
+
+/*
+* Hash index (open addressing, linear probing). Modified only with the
+* physical switch mutex held; lookups are lock-free (seqlock retry).
+* It doubles its slots when it is half full.
+*/
+typedef struct __physical_switch_index{
+	seqlock_t seqlock;
+	unsigned int mask;
+	unsigned int num_of_entries;
+	__physical_switch_index_slot_t* slots;
+}__physical_switch_index_t;
+
+/*
+* Growable table of ports or logical switches. The index of an entry in
+* the table (id) is stable. Modified only with the physical switch mutex held.
+*/
+typedef struct __physical_switch_table{
+	unsigned int size;
+	unsigned int max_size;
+	unsigned int num_of_entries;
+	unsigned int first_free; //Hint; no free slot below it
+	void** entries;
+}__physical_switch_table_t;
+
+/*
+* Arrays replaced when growing the tables and indexes. Lock-free readers may
+* still be using them, so they are only released on physical_switch_destroy()
+*/
+typedef struct __physical_switch_retired{
+	void* mem;
+	struct __physical_switch_retired* next;
+}__physical_switch_retired_t;
+
 /**
 * Keeps the state of the physical switch (device), including ports
 * and logical switch instances
+*
+* @warning The port and logical switch members are no longer fixed-size arrays
+* (switch_port_t* physical_ports[PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS]...), but
+* growable tables. Code indexing them directly must use the getters instead
+* (physical_switch_get_physical_ports(), physical_switch_get_virtual_ports(),
+* physical_switch_get_tunnel_ports() and physical_switch_get_logical_switches()),
+* which return the current array and its size.
 */
 typedef struct physical_switch{
 
 	/*
-	* List of all logical switches in the system
+	* List of all logical switches in the system (of_switch_t*)
 	*/
 	unsigned int num_of_logical_switches;
-	of_switch_t* logical_switches[PHYSICAL_SWITCH_MAX_LS];
+	__physical_switch_table_t logical_switches;
 
 	/*
-	* Ports
+	* Ports (switch_port_t*)
 	*/
 	//physical: index is the physical port of the platform.
-	switch_port_t* physical_ports[PHYSICAL_SWITCH_MAX_NUM_PHY_PORTS];
+	__physical_switch_table_t physical_ports;
 
 	//tunnel ports
-	switch_port_t* tunnel_ports[PHYSICAL_SWITCH_MAX_NUM_TUN_PORTS]; //Not used yet
+	__physical_switch_table_t tunnel_ports;
 
 	//virtual ports (which are not tunnel)
-	switch_port_t* virtual_ports[PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS]; //Not used yet
+	__physical_switch_table_t virtual_ports;
 
 	//meta ports (esoteric ports). This is NOT an array of pointers!
 	switch_port_t meta_ports[PHYSICAL_SWITCH_MAX_NUM_META_PORTS]; 
 
+	//Indexes (ports by name, LSIs by dpid)
+	__physical_switch_index_t port_index;
+	__physical_switch_index_t lsi_index;
+
+	//Replaced table and index arrays
+	__physical_switch_retired_t* retired;
+
 	//Monitoring data
 	monitoring_state_t monitoring;
 
@@ -245,6 +324,9 @@ void physical_switch_destroy(void);
 * @brief    Retrieves the list of logical switches within the logical switch 
 * @ingroup  mgmt
 *
+* The array grows on demand; a previously retrieved array remains valid (but it is
+* no longer updated) until the physical switch is destroyed.
+*
 * @param max_switches Number of maximum switches in the array (array boundary)
 * @retval  Pointer to the of_switch_t* array. This array cannot be modified is READ-ONLY! 
 */
@@ -278,6 +360,8 @@ rofl_result_t physical_switch_remove_logical_switch(of_switch_t* sw);
 /**
 * @brief    Attemps to retrieve a logical switch from the pool by its dpid.
 * @ingroup  mgmt
+*
+* The lookup is hashed and lock-free.
 */
 of_switch_t* physical_switch_get_logical_switch_by_dpid(const uint64_t dpid);
 
@@ -298,6 +382,7 @@ of_switch_t* physical_switch_get_logical_switch_attached_to_port(const switch_po
 * @ingroup  mgmt
 * 
 * Attempts to retrieve a port previously added to the physical switch by its name.
+* The lookup is hashed and lock-free.
 */
 switch_port_t* physical_switch_get_port_by_name(const char *name);
 
@@ -305,6 +390,10 @@ switch_port_t* physical_switch_get_port_by_name(const char *name);
 * @brief Get the reference to the physical ports
 * @ingroup  mgmt
 *
+* The array grows on demand; a previously retrieved array remains valid (but it is
+* no longer updated) until the physical switch is destroyed. The index of a port in
+* the array (switch_port_t::psw_id) is stable.
+*
 * @param max_ports Number of maximum ports in the array (array boundary)
 * @retval  Pointer to the switch_port_t* array. This array cannot be modified is READ-ONLY! 
 */
@@ -314,6 +403,10 @@ switch_port_t** physical_switch_get_physical_ports(unsigned int* max_ports);
 * @brief Get the reference to the virtual ports
 * @ingroup  mgmt
 *
+* The array grows on demand; a previously retrieved array remains valid (but it is
+* no longer updated) until the physical switch is destroyed. The index of a port in
+* the array (switch_port_t::psw_id) is stable.
+*
 * @param max_ports Number of maximum ports in the array (array boundary)
 * @retval  Pointer to the switch_port_t* array. This array cannot be modified is READ-ONLY! 
 */
@@ -323,6 +416,10 @@ switch_port_t** physical_switch_get_virtual_ports(unsigned int* max_ports);
 * @brief Get the reference to the physical ports
 * @ingroup  mgmt
 *
+* The array grows on demand; a previously retrieved array remains valid (but it is
+* no longer updated) until the physical switch is destroyed. The index of a port in
+* the array (switch_port_t::psw_id) is stable.
+*
 * @param max_ports Number of maximum ports in the array (array boundary)
 * @retval  Pointer to the switch_port_t* array. This array cannot be modified is READ-ONLY! 
 */
@@ -475,6 +572,19 @@ void dpid_list_destroy(dpid_list_t* list);
 */
 of_switch_snapshot_t* physical_switch_get_logical_switch_snapshot(const uint64_t dpid);
 
+/**
+* @brief    Generates a snapshot of the current running state of a LSI, reusing the unchanged parts of a previous snapshot (base). Should be deleted using of_switch_destroy_snapshot()
+* @ingroup  mgmt
+*
+* Ports and flow tables whose revision did not change since base are not copied
+* again; they are shared (refcounted) with base, so the pointers compare equal.
+* base can be destroyed at any moment. Shared parts keep the counters of the
+* time they were copied; use the statistics API to get up-to-date counters.
+*
+* @param base Previous snapshot of the same LSI, or NULL (full snapshot)
+*/
+of_switch_snapshot_t* physical_switch_get_logical_switch_delta_snapshot(const uint64_t dpid, of_switch_snapshot_t* base);
+
 
 //
 // Other
@@ -50,6 +50,9 @@ ROFL_BEGIN_DECLS
 /**
 * @ingroup platform_packet
 * Gets the complete packet size in bytes.
+*
+* The pipeline caches the value in the datapacket_t (__size_bytes) and only
+* calls it again when the size changes (push/pop actions).
 */
 uint32_t platform_packet_get_size_bytes(datapacket_t *const pkt);
 
@@ -60,7 +63,9 @@ uint32_t platform_packet_get_size_bytes(datapacket_t *const pkt);
 * (including if this pkt is a replica).
 *
 * If a flooding output actions needs to be done, the function
-* has itself to deal with packet replication.
+* has itself to deal with packet replication. If rofl-datapath is compiled
+* with --with-pipeline-flood-expansion, FLOOD and ALL outputs are expanded
+* by the pipeline, and the meta ports are never used.
 */
 void platform_packet_output(datapacket_t* pkt, switch_port_t* port);
 /**
@@ -89,6 +94,61 @@ void platform_packet_drop(datapacket_t* pkt);
 */
 datapacket_t* platform_packet_replicate(datapacket_t* pkt);
 
+/**
+* @ingroup platform_packet
+* Creates a replica of the datapacket_t that shares the packet buffer with the
+* original (e.g. reference counted). Only used if rofl-datapath is compiled
+* with --with-pipeline-shared-replicas, for the OUTPUT actions of the
+* apply/write actions. The same behaviour as platform_packet_replicate() is
+* expected for the datapacket_t.
+*
+* The replica is output (or sent to the controller) right away by the pipeline,
+* without further mangling. The original, however, may still be mangled by
+* subsequent actions. The platform MUST isolate the replica from these (e.g.
+* copy-on-write of the headers), and release the buffer only once the last
+* reference is dropped.
+*
+* The last OUTPUT action of an apply actions list with multiple outputs
+* consumes the original packet, so no replica is created for it.
+*/
+datapacket_t* platform_packet_replicate_shared(datapacket_t* pkt);
+
+/**
+* @ingroup platform_packet
+* Output a burst of packets to a port. Only used if rofl-datapath is compiled
+* with --with-pipeline-tx-bursts; otherwise platform_packet_output() is used
+* for every packet.
+*
+* The pipeline stages the packets output to (non-meta) ports, and hands them
+* over with this hook when the staging buffer is full, or when the packets are
+* flushed (of_process_packet_pipeline_flush()). The same behaviour as
+* platform_packet_output() is expected for every packet of the burst. The pkts
+* array MUST NOT be retained by the platform after the call.
+*
+* @param port Output port (never a meta port)
+* @param pkts Packets to be sent
+* @param num_of_pkts Number of packets (>0)
+*/
+void platform_packet_output_burst(switch_port_t* port, datapacket_t** pkts, unsigned int num_of_pkts);
+
+/**
+* @ingroup platform_packet
+* Apply the checksum deltas accumulated by the pipeline. Only used if
+* rofl-datapath is compiled with --with-pipeline-incremental-checksums.
+*
+* In that mode, the IPv4 src/dst, IP DSCP/ECN and TCP/UDP port setters
+* and the decrement of the nw TTL MUST NOT update the checksums; the pipeline
+* accumulates the deltas (RFC 1624) of these rewrites and calls this hook
+* once, before the packet is output, replicated or sent to the controller.
+*
+* Deltas can be applied using of1x_checksum_apply_delta(). l4_delta shall be
+* applied to the TCP or UDP checksum, except for UDP checksums of value 0x0
+* (no checksum). An updated UDP checksum of 0x0 shall be sent as 0xFFFF.
+*
+* @warning l3_delta and l4_delta are in NBO
+*/
+void platform_packet_update_checksums(datapacket_t* pkt, uint16_t l3_delta, uint16_t l4_delta);
+
 
 ////////////
 // Ports //
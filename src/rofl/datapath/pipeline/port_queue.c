@@ -17,6 +17,14 @@ rofl_result_t __port_queue_init(port_queue_t* queue, uint32_t id, char* name, ui
 		return ROFL_FAILURE;
 	}
 
+	//Per thread counters
+	queue->stats.__internal = tid_alloc_slots(sizeof(__queue_stats_tid_t), &queue->stats.__internal_mem);
+
+	if(!queue->stats.__internal){
+		platform_mutex_destroy(queue->stats.mutex);
+		return ROFL_FAILURE;
+	}
+
 	//Fill in values
 	queue->set = true;
 	queue->id = id;
@@ -33,6 +41,7 @@ rofl_result_t __port_queue_init(port_queue_t* queue, uint32_t id, char* name, ui
 rofl_result_t __port_queue_destroy(port_queue_t* queue){
 	//Destroy
 	platform_mutex_destroy(queue->stats.mutex);
+	platform_free_shared(queue->stats.__internal_mem);
 	platform_memset(queue,0,sizeof(port_queue_t));
 	return ROFL_SUCCESS;
 }
@@ -17,15 +17,28 @@
 
 #include "rofl_datapath.h"
 #include "platform/lock.h"
+#include "threading.h"
+#include "stats_snapshot.h"
 
 #define PORT_QUEUE_MAX_LEN_NAME 32
 
 //Opaque platform queue state (to be used, maybe, for platform hooks)
 typedef void platform_queue_state_t;
 
+//Per thread queue stats (cache line isolated)
+typedef struct __queue_stats_tid{
+	uint64_t tx_packets;
+	uint64_t tx_bytes;
+	uint64_t overrun;
+}__tid_aligned __queue_stats_tid_t;
+
 /**
 * @brief Queue stats 
 * @ingroup core
+*
+* The datapath should update the per thread counters via __queue_stats_tx_update()
+* and __queue_stats_overrun_update() (switch_port_pp.h). They are consolidated
+* in the port snapshots.
 */
 typedef struct queue_stats {
 	uint64_t tx_packets;	/* Number of transmitted packets by the queue. */
@@ -34,6 +47,13 @@ typedef struct queue_stats {
 	
 	//Mutex for statistics
 	platform_mutex_t* mutex;
+
+	//Per thread counters (NULL in snapshots)
+	__queue_stats_tid_t* __internal;
+	void* __internal_mem;
+
+	//TX counters published by the stats service
+	__stats_published_t published;
 }queue_stats_t;
 
 
@@ -104,6 +124,34 @@ rofl_result_t __port_queue_init(port_queue_t* queue, uint32_t id, char* name, ui
 */
 rofl_result_t __port_queue_destroy(port_queue_t* queue);
 
+//Consolidates the queue counters (including per thread counters) in c
+static inline void __queue_stats_consolidate(const queue_stats_t* stats, queue_stats_t* c){
+	int i;
+
+	c->tx_packets = stats->tx_packets;
+	c->tx_bytes = stats->tx_bytes;
+	c->overrun = stats->overrun;
+
+	if(!stats->__internal)
+		return;
+	
+	for(i=0;i<ROFL_PIPELINE_MAX_TIDS;i++){
+		c->tx_packets += stats->__internal[i].tx_packets;
+		c->tx_bytes += stats->__internal[i].tx_bytes;
+		c->overrun += stats->__internal[i].overrun;
+	}
+}
+
+/**
+* @brief Get the consolidated TX counters and rates of a queue, as published by the
+* stats service (see of1x_stats_service_enable()).
+* @ingroup core
+* @return false if never published
+*/
+static inline bool queue_stats_get_snapshot(const queue_stats_t* stats, stats_snapshot_t* snapshot){
+	return __stats_read_published(&stats->published, snapshot);
+}
+
 //C++ extern C
 ROFL_END_DECLS
 
@@ -0,0 +1,100 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/**
+* @file stats_snapshot.h
+*
+* @brief Published counter snapshots (and rates)
+*
+* Consolidated counters of an object (flow entry, table, group, port, queue...)
+* are periodically published by a single writer (the stats service), and read
+* lock-free by any number of readers.
+*/
+
+#ifndef __STATS_SNAPSHOT_H__
+#define __STATS_SNAPSHOT_H__
+
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "rofl_datapath.h"
+#include "platform/likely.h"
+#include "threading.h"
+
+/**
+* @brief Consolidated counters and rates
+* @ingroup core
+*/
+typedef struct stats_snapshot{
+	uint64_t packet_count;	//Tables: lookup count
+	uint64_t byte_count;	//Tables: matched count
+	uint64_t packet_rate;	//Per second, over the last rate window (tables: lookups/s)
+	uint64_t byte_rate;	//Per second, over the last rate window (tables: matches/s)
+	uint64_t timestamp_ms;	//Consolidation time; 0 if never consolidated
+}stats_snapshot_t;
+
+//Published snapshot (written only by the stats service)
+typedef struct __stats_published{
+	seqlock_t seqlock;
+	stats_snapshot_t snapshot;
+
+	//Rate window
+	uint64_t window_start_ms;
+	uint64_t window_packet_count;
+	uint64_t window_byte_count;
+}__stats_published_t;
+
+//C++ extern C
+ROFL_BEGIN_DECLS
+
+//Read a published snapshot (lock-free)
+static inline bool __stats_read_published(const __stats_published_t* published, stats_snapshot_t* snapshot){
+	uint32_t seq;
+
+	do{
+		seq = seqlock_read_begin(&published->seqlock);
+		*snapshot = published->snapshot;
+	}while( unlikely(seqlock_read_retry(&published->seqlock, seq)) );
+
+	return snapshot->timestamp_ms != 0x0ULL;
+}
+
+//Publish the consolidated counters and (if the window is over) the rates
+static inline void __stats_publish(__stats_published_t* published, uint64_t packet_count, uint64_t byte_count, uint64_t now_ms, uint64_t rate_window_ms){
+
+	uint64_t elapsed;
+	stats_snapshot_t* snapshot = &published->snapshot;
+
+	seqlock_write_begin(&published->seqlock);
+
+	snapshot->packet_count = packet_count;
+	snapshot->byte_count = byte_count;
+	snapshot->timestamp_ms = now_ms;
+
+	//First consolidation or counters reset; restart the window
+	if(published->window_start_ms == 0x0ULL || packet_count < published->window_packet_count || byte_count < published->window_byte_count){
+		published->window_start_ms = now_ms;
+		published->window_packet_count = packet_count;
+		published->window_byte_count = byte_count;
+		goto PUBLISH_END;
+	}
+
+	elapsed = now_ms - published->window_start_ms;
+	if(elapsed >= rate_window_ms && elapsed){
+		snapshot->packet_rate = ( (packet_count - published->window_packet_count) * 1000 ) / elapsed;
+		snapshot->byte_rate = ( (byte_count - published->window_byte_count) * 1000 ) / elapsed;
+
+		published->window_start_ms = now_ms;
+		published->window_packet_count = packet_count;
+		published->window_byte_count = byte_count;
+	}
+
+PUBLISH_END:
+	seqlock_write_end(&published->seqlock);
+}
+
+//C++ extern C
+ROFL_END_DECLS
+
+#endif //STATS_SNAPSHOT
@@ -39,6 +39,15 @@ switch_port_t* switch_port_init(char* name, bool up, port_type_t type, port_stat
 		return NULL;
 	}
 
+	//Per thread counters
+	port->stats.__internal = tid_alloc_slots(sizeof(__port_stats_tid_t), &port->stats.__internal_mem);
+	if(!port->stats.__internal){
+		platform_mutex_destroy(port->stats.mutex);
+		platform_mutex_destroy(port->mutex);
+		platform_free_shared(port);
+		return NULL;
+	}
+
 	//Fill values	
 	port->type = type;
 	port->up = up;
@@ -56,6 +65,7 @@ switch_port_t* switch_port_init(char* name, bool up, port_type_t type, port_stat
 	port->of_port_num = 0;
 	port->of_generate_packet_in = true;
 	port->attached_sw = NULL;
+	port->revision = 0;
 
 	//Platform state
 	port->platform_port_state = NULL;
@@ -73,8 +83,9 @@ rofl_result_t switch_port_destroy(switch_port_t* port){
 			__port_queue_destroy(&port->queues[i]);
 	}
 
-	//Destroy port stats mutex
+	//Destroy port stats mutex and per thread counters
 	platform_mutex_destroy(port->stats.mutex);
+	platform_free_shared(port->stats.__internal_mem);
 	
 	//Destroy port mutex
 	platform_mutex_destroy(port->mutex);
@@ -100,7 +111,11 @@ rofl_result_t switch_port_add_queue(switch_port_t* port, uint32_t id, char* name
 	}
 	
 	//Init switch queue
-	__port_queue_init(&port->queues[id], id, name, length, min_rate, max_rate);
+	if(__port_queue_init(&port->queues[id], id, name, length, min_rate, max_rate) != ROFL_SUCCESS){
+		platform_mutex_unlock(port->mutex);
+		return ROFL_FAILURE;
+	}
+	port->revision++;
 
 	platform_mutex_unlock(port->mutex);
 	return ROFL_SUCCESS;
@@ -122,6 +137,7 @@ rofl_result_t switch_port_remove_queue(switch_port_t* port, uint32_t id){
 	
 	//destroy queue
 	__port_queue_destroy(&port->queues[id]);
+	port->revision++;
 
 	platform_mutex_unlock(port->mutex);
 	return ROFL_SUCCESS;
@@ -140,11 +156,16 @@ void switch_port_set_current_speed(switch_port_t* port, port_features_t speed){
 	if(speed > PORT_FEATURE_1TB_FD)
 		return;
 	port->curr_speed = speed;
+	port->revision++;
 }
 void switch_port_set_current_max_speed(switch_port_t* port, port_features_t speed){
 	if(speed > PORT_FEATURE_1TB_FD)
 		return;
 	port->curr_max_speed = speed;
+	port->revision++;
+}
+void switch_port_mark_changed(switch_port_t* port){
+	port->revision++;
 }
 
 
@@ -168,8 +189,19 @@ switch_port_snapshot_t* __switch_port_get_snapshot(switch_port_t* port){
 	s->platform_port_state=s->mutex=s->attached_sw=s->stats.mutex=NULL;
 	for(i=0;i<SWITCH_PORT_MAX_QUEUES;i++)
 		s->queues[i].stats.mutex = NULL;
+
+	//Consolidate per thread counters
+	__port_stats_consolidate(&port->stats, &s->stats);
+	s->stats.__internal = NULL;
+	s->stats.__internal_mem = NULL;
+	for(i=0;i<SWITCH_PORT_MAX_QUEUES;i++){
+		__queue_stats_consolidate(&port->queues[i].stats, &s->queues[i].stats);
+		s->queues[i].stats.__internal = NULL;
+		s->queues[i].stats.__internal_mem = NULL;
+	}
 	
 	//Copy missing information
+	refcnt_init(&s->refs);
 	s->attached_sw = NULL;
 	s->is_attached_to_sw = (port->attached_sw != NULL);
 	if(port->attached_sw)
@@ -188,12 +220,14 @@ switch_port_snapshot_t* switch_port_clone_snapshot(switch_port_snapshot_t* orig)
 		return NULL;
 
 	memcpy(copy, orig, sizeof(switch_port_snapshot_t));	
+	refcnt_init(&copy->refs);
 	
 	return copy;
 }
 
 void switch_port_destroy_snapshot(switch_port_snapshot_t* port){
-	if(port)
+	//Only release the last reference
+	if(port && refcnt_put(&port->refs))
 		platform_free_shared(port);
 }
 
@@ -20,6 +20,7 @@
 #include "port_queue.h"
 #include "common/bitmap.h"
 #include "platform/lock.h"
+#include "threading.h"
 
 
 //fwd decl
@@ -67,9 +68,26 @@ typedef enum port_features{
 //Opaque platform port state (to be used, maybe, for platform hooks)
 typedef void platform_port_state_t;
 
+//Per thread port stats (cache line isolated)
+typedef struct __port_stats_tid{
+	uint64_t rx_packets;
+	uint64_t tx_packets;
+	uint64_t rx_bytes;
+	uint64_t tx_bytes;
+	uint64_t rx_dropped;
+	uint64_t tx_dropped;
+	uint64_t rx_errors;
+	uint64_t tx_errors;
+}__tid_aligned __port_stats_tid_t;
+
 /**
 * @brief Port stats 
 * @ingroup core
+*
+* The datapath should update the per thread counters via __port_stats_rx_update(),
+* __port_stats_tx_update() and friends (switch_port_pp.h), instead of locking or
+* atomically incrementing the shared counters. The per thread counters are
+* consolidated in the port snapshots (switch_port_snapshot_t).
 */
 typedef struct port_stats {
 	uint64_t rx_packets;     /* Number of received packets. */
@@ -93,6 +111,14 @@ typedef struct port_stats {
 
 	//Mutex for statistics
 	platform_mutex_t* mutex;
+
+	//Per thread counters (NULL in snapshots)
+	__port_stats_tid_t* __internal;
+	void* __internal_mem;
+
+	//RX and TX counters published by the stats service
+	__stats_published_t rx_published;
+	__stats_published_t tx_published;
 }port_stats_t;
 
 /**
@@ -194,11 +220,18 @@ typedef struct switch_port{
 	//Pointer to current logical switch attached
 	struct of_switch* attached_sw;	
 
+	//Revision; incremented on every configuration or state change
+	uint64_t revision;
+
+	//Stable id in the physical switch (index in the table of ports of its type)
+	unsigned int psw_id;
+
 	/*
 	* Only used in snapshots
 	*/
 	bool is_attached_to_sw;
 	uint64_t attached_sw_dpid;
+	refcnt_t refs; //Shared among LSI (delta) snapshots
  	//OF port number != physical port num 
 	unsigned int of_port_num; 
 	
@@ -278,6 +311,52 @@ rofl_result_t switch_port_remove_queue(switch_port_t* port, uint32_t id);
 
 //Port Statistics
 
+//Consolidates the port counters (including per thread counters) in c
+static inline void __port_stats_consolidate(const port_stats_t* stats, port_stats_t* c){
+	int i;
+
+	c->rx_packets = stats->rx_packets;
+	c->tx_packets = stats->tx_packets;
+	c->rx_bytes = stats->rx_bytes;
+	c->tx_bytes = stats->tx_bytes;
+	c->rx_dropped = stats->rx_dropped;
+	c->tx_dropped = stats->tx_dropped;
+	c->rx_errors = stats->rx_errors;
+	c->tx_errors = stats->tx_errors;
+
+	if(!stats->__internal)
+		return;
+	
+	for(i=0;i<ROFL_PIPELINE_MAX_TIDS;i++){
+		c->rx_packets += stats->__internal[i].rx_packets;
+		c->tx_packets += stats->__internal[i].tx_packets;
+		c->rx_bytes += stats->__internal[i].rx_bytes;
+		c->tx_bytes += stats->__internal[i].tx_bytes;
+		c->rx_dropped += stats->__internal[i].rx_dropped;
+		c->tx_dropped += stats->__internal[i].tx_dropped;
+		c->rx_errors += stats->__internal[i].rx_errors;
+		c->tx_errors += stats->__internal[i].tx_errors;
+	}
+}
+
+/**
+* @brief Get the consolidated RX counters and rates of a port, as published by the
+* stats service (see of1x_stats_service_enable()).
+* @ingroup core
+* @return false if never published
+*/
+static inline bool port_stats_get_rx_snapshot(const port_stats_t* stats, stats_snapshot_t* snapshot){
+	return __stats_read_published(&stats->rx_published, snapshot);
+}
+
+/**
+* @brief Get the consolidated TX counters and rates of a port (see port_stats_get_rx_snapshot())
+* @ingroup core
+*/
+static inline bool port_stats_get_tx_snapshot(const port_stats_t* stats, stats_snapshot_t* snapshot){
+	return __stats_read_published(&stats->tx_published, snapshot);
+}
+
 /*
 * Conveninent wrappers just to avoid messing up with the bitmaps
 */
@@ -306,6 +385,16 @@ void switch_port_set_current_speed(switch_port_t* port, port_features_t speed);
 */
 void switch_port_set_current_max_speed(switch_port_t* port, port_features_t speed);
 
+/**
+* @brief Marks the port as changed (increments its revision)
+* @ingroup  mgmt
+*
+* This MUST be called by the platform whenever it modifies the configuration
+* or the state of the port directly, so that LSI delta snapshots do not reuse
+* the previous snapshot of the port.
+*/
+void switch_port_mark_changed(switch_port_t* port);
+
 //
 // Snapshots
 //
@@ -0,0 +1,132 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __SWITCH_PORT_PP_H__
+#define __SWITCH_PORT_PP_H__
+
+#include <assert.h>
+#include "rofl_datapath.h"
+#include "util/pp_guard.h" //Never forget to include the guard
+
+#include "switch_port.h"
+#include "port_queue.h"
+
+//Platform stuff
+#include "platform/likely.h"
+#include "platform/atomic_operations.h"
+
+/**
+* @file switch_port_pp.h
+*
+* @brief Port and queue statistics packet processing routines
+*
+* Every thread (tid) updates its own counters, isolated in their own cache line,
+* so neither locking nor atomic operations are required except for
+* ROFL_PIPELINE_LOCKED_TID. Only ports created via switch_port_init() (and their
+* queues) have per thread counters.
+*/
+
+//Port
+static inline void __port_stats_rx_update(unsigned int tid, port_stats_t* stats, uint64_t bytes){
+
+	__port_stats_tid_t* s = &stats->__internal[tid];
+
+	assert(tid < ROFL_PIPELINE_MAX_TIDS);
+
+	if(unlikely(tid == ROFL_PIPELINE_LOCKED_TID)){
+		platform_atomic_inc64(&s->rx_packets, stats->mutex);
+		platform_atomic_add64(&s->rx_bytes, bytes, stats->mutex);
+	}else{
+		s->rx_packets++;
+		s->rx_bytes += bytes;
+	}
+}
+
+static inline void __port_stats_tx_update(unsigned int tid, port_stats_t* stats, uint64_t bytes){
+
+	__port_stats_tid_t* s = &stats->__internal[tid];
+
+	assert(tid < ROFL_PIPELINE_MAX_TIDS);
+
+	if(unlikely(tid == ROFL_PIPELINE_LOCKED_TID)){
+		platform_atomic_inc64(&s->tx_packets, stats->mutex);
+		platform_atomic_add64(&s->tx_bytes, bytes, stats->mutex);
+	}else{
+		s->tx_packets++;
+		s->tx_bytes += bytes;
+	}
+}
+
+static inline void __port_stats_rx_dropped_update(unsigned int tid, port_stats_t* stats){
+
+	assert(tid < ROFL_PIPELINE_MAX_TIDS);
+
+	if(unlikely(tid == ROFL_PIPELINE_LOCKED_TID)){
+		platform_atomic_inc64(&stats->__internal[tid].rx_dropped, stats->mutex);
+	}else{
+		stats->__internal[tid].rx_dropped++;
+	}
+}
+
+static inline void __port_stats_tx_dropped_update(unsigned int tid, port_stats_t* stats){
+
+	assert(tid < ROFL_PIPELINE_MAX_TIDS);
+
+	if(unlikely(tid == ROFL_PIPELINE_LOCKED_TID)){
+		platform_atomic_inc64(&stats->__internal[tid].tx_dropped, stats->mutex);
+	}else{
+		stats->__internal[tid].tx_dropped++;
+	}
+}
+
+static inline void __port_stats_rx_errors_update(unsigned int tid, port_stats_t* stats){
+
+	assert(tid < ROFL_PIPELINE_MAX_TIDS);
+
+	if(unlikely(tid == ROFL_PIPELINE_LOCKED_TID)){
+		platform_atomic_inc64(&stats->__internal[tid].rx_errors, stats->mutex);
+	}else{
+		stats->__internal[tid].rx_errors++;
+	}
+}
+
+static inline void __port_stats_tx_errors_update(unsigned int tid, port_stats_t* stats){
+
+	assert(tid < ROFL_PIPELINE_MAX_TIDS);
+
+	if(unlikely(tid == ROFL_PIPELINE_LOCKED_TID)){
+		platform_atomic_inc64(&stats->__internal[tid].tx_errors, stats->mutex);
+	}else{
+		stats->__internal[tid].tx_errors++;
+	}
+}
+
+//Queue
+static inline void __queue_stats_tx_update(unsigned int tid, queue_stats_t* stats, uint64_t bytes){
+
+	__queue_stats_tid_t* s = &stats->__internal[tid];
+
+	assert(tid < ROFL_PIPELINE_MAX_TIDS);
+
+	if(unlikely(tid == ROFL_PIPELINE_LOCKED_TID)){
+		platform_atomic_inc64(&s->tx_packets, stats->mutex);
+		platform_atomic_add64(&s->tx_bytes, bytes, stats->mutex);
+	}else{
+		s->tx_packets++;
+		s->tx_bytes += bytes;
+	}
+}
+
+static inline void __queue_stats_overrun_update(unsigned int tid, queue_stats_t* stats){
+
+	assert(tid < ROFL_PIPELINE_MAX_TIDS);
+
+	if(unlikely(tid == ROFL_PIPELINE_LOCKED_TID)){
+		platform_atomic_inc64(&stats->__internal[tid].overrun, stats->mutex);
+	}else{
+		stats->__internal[tid].overrun++;
+	}
+}
+
+#endif //SWITCH_PORT_PP_H
@@ -18,6 +18,7 @@
 #include <stdint.h>
 #include "rofl_datapath.h"
 #include "platform/likely.h"
+#include "platform/memory.h"
 
 #if !defined(__GNUC__) && !defined(__INTEL_COMPILER)
 	#error Unknown compiler; could not guess which compare-and-swap instructions to use
@@ -108,4 +109,97 @@ static inline void tid_wait_all_not_present(volatile tid_presence_t* presence_ma
 	}
 }
 
+/*
+* Sequence lock; single writer, lock-free readers. Readers retry
+* if the writer published a new version while they were reading.
+*/
+typedef struct seqlock{
+	volatile uint32_t seq;
+}seqlock_t;
+
+static inline void seqlock_init(seqlock_t* lock){
+	lock->seq = 0;
+}
+
+static inline void seqlock_write_begin(seqlock_t* lock){
+	lock->seq++; //Odd; write in progress
+	tid_memory_barrier();
+}
+
+static inline void seqlock_write_end(seqlock_t* lock){
+	tid_memory_barrier();
+	lock->seq++;
+}
+
+static inline uint32_t seqlock_read_begin(const seqlock_t* lock){
+	uint32_t seq;
+
+	while( unlikely( (seq = lock->seq) & 0x1 ) );
+	tid_memory_barrier();
+
+	return seq;
+}
+
+static inline bool seqlock_read_retry(const seqlock_t* lock, uint32_t seq){
+	tid_memory_barrier();
+	return lock->seq != seq;
+}
+
+/*
+* Reference counter (e.g. objects shared among snapshots)
+*/
+typedef struct refcnt{
+	volatile uint32_t refs;
+}refcnt_t;
+
+static inline void refcnt_init(refcnt_t* cnt){
+	cnt->refs = 1;
+}
+
+static inline void refcnt_get(refcnt_t* cnt){
+	uint32_t old_val;
+
+	do{
+		old_val = cnt->refs;
+	}while( CAS(&cnt->refs, old_val, old_val+1) == false);
+}
+
+//Returns true if it was the last reference
+static inline bool refcnt_put(refcnt_t* cnt){
+	uint32_t old_val;
+
+	do{
+		old_val = cnt->refs;
+		assert(old_val > 0);
+	}while( CAS(&cnt->refs, old_val, old_val-1) == false);
+
+	return old_val == 1;
+}
+
+/*
+* Per thread state; every thread slot is isolated in its own cache line(s)
+*/
+#ifndef ROFL_PIPELINE_CACHE_LINE_SIZE
+	#define ROFL_PIPELINE_CACHE_LINE_SIZE 64
+#endif
+
+#define __tid_aligned __attribute__((aligned(ROFL_PIPELINE_CACHE_LINE_SIZE)))
+
+//Allocates ROFL_PIPELINE_MAX_TIDS zeroed slots. *mem MUST be released via platform_free_shared()
+static inline void* tid_alloc_slots(size_t slot_size, void** mem){
+	uintptr_t slots;
+
+	assert( (slot_size % ROFL_PIPELINE_CACHE_LINE_SIZE) == 0 );
+
+	*mem = platform_malloc_shared(slot_size*ROFL_PIPELINE_MAX_TIDS + ROFL_PIPELINE_CACHE_LINE_SIZE);
+	if( unlikely(*mem == NULL) )
+		return NULL;
+	platform_memset(*mem, 0, slot_size*ROFL_PIPELINE_MAX_TIDS + ROFL_PIPELINE_CACHE_LINE_SIZE);
+
+	//Align to the cache line
+	slots = ((uintptr_t)*mem + ROFL_PIPELINE_CACHE_LINE_SIZE - 1) & ~((uintptr_t)ROFL_PIPELINE_CACHE_LINE_SIZE - 1);
+
+	return (void*)slots;
+}
+
 #endif //THREADING_PP
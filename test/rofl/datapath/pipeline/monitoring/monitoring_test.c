@@ -187,6 +187,51 @@ void test_snapshots(){
 	monitoring_destroy_snapshot(snapshot);
 }
 
+void test_published_snapshots(){
+	
+	monitoring_state_t* mon = &(get_physical_switch()->monitoring);
+	monitoring_snapshot_state_t *sn1, *sn2, *clone;
+	uint64_t rev;
+
+	//Unchanged state; the published snapshot is returned
+	sn1 = monitoring_get_snapshot(mon);
+	sn2 = monitoring_get_snapshot(mon);
+	CU_ASSERT(sn1 != NULL);
+	CU_ASSERT(sn1 == sn2);
+	CU_ASSERT(sn1->refs.refs == 3);
+	
+	//Clones are references
+	clone = monitoring_clone_snapshot(sn1);
+	CU_ASSERT(clone == sn1);
+	CU_ASSERT(sn1->refs.refs == 4);
+	monitoring_destroy_snapshot(clone);
+	monitoring_destroy_snapshot(sn2);
+	
+	//Same rev
+	rev = sn1->last_rev;
+	CU_ASSERT(monitoring_get_snapshot_if_changed(mon, rev) == NULL);
+
+	//Modify the state
+	CU_ASSERT(monitoring_add_monitored_entity(mon, ME_TYPE_FAN, NULL, &mon->chassis) != NULL);
+	sn2 = monitoring_get_snapshot_if_changed(mon, rev);
+	CU_ASSERT(sn2 != NULL);
+	CU_ASSERT(sn2 != sn1);
+	CU_ASSERT(sn2->last_rev == mon->last_rev);
+	CU_ASSERT(sn2->chassis.inner != NULL);
+	CU_ASSERT(sn2->chassis.inner->type == ME_TYPE_FAN);
+	CU_ASSERT(mon->published == sn2);
+
+	//The previous one is still valid
+	CU_ASSERT(sn1->refs.refs == 1);
+	CU_ASSERT(sn1->last_rev == rev);
+	CU_ASSERT(sn1->chassis.inner != NULL);
+	CU_ASSERT(sn1->chassis.inner->type != ME_TYPE_FAN);
+
+	monitoring_destroy_snapshot(sn1);
+	monitoring_destroy_snapshot(sn2);
+	CU_ASSERT(mon->published->refs.refs == 1);
+}
+
 int main(int args, char** argv){
 
 	physical_switch_init();
@@ -211,7 +256,8 @@ int main(int args, char** argv){
 	/* NOTE - ORDER IS IMPORTANT - MUST TEST fread() AFTER fprintf() */
 	if ((NULL == CU_add_test(pSuite, "test simple insertions", test_simple_insertions)) ||
 	(NULL == CU_add_test(pSuite, "test simple_deletions", test_simple_deletions)) ||
-	(NULL == CU_add_test(pSuite, "test snapshots", test_snapshots))
+	(NULL == CU_add_test(pSuite, "test snapshots", test_snapshots)) ||
+	(NULL == CU_add_test(pSuite, "test published snapshots", test_published_snapshots))
 		)
 	{
 		fprintf(stderr,"ERROR WHILE ADDING TEST\n");
@@ -8,6 +8,9 @@ extern unsigned int drops;
 extern unsigned int outputs;
 extern unsigned int allocated;
 extern unsigned int released;
+extern unsigned int bursts;
+extern uint32_t port_in;
+extern bool no_port_in;
 
 
 void init_io();
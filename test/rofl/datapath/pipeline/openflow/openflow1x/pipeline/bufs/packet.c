@@ -18,6 +18,11 @@ unsigned int drops = 0;
 unsigned int outputs = 0;
 unsigned int allocated = 0;
 unsigned int released = 0;
+unsigned int bursts = 0;
+
+//Incoming port of the packets
+uint32_t port_in = 0;
+bool no_port_in = false;
 
 /*
 * Buffer pool 
@@ -45,7 +50,9 @@ void destroy_io(){
 void reset_io_state(){
 	int i;
 
-	replicas = drops = outputs = allocated = released = 0;
+	replicas = drops = outputs = allocated = released = bursts = 0;
+	port_in = 0;
+	no_port_in = false;
 
 	for(i=0;i<FAKE_IO_POOL_SLOTS;i++){
 		pool_state[i] = false;
@@ -137,6 +144,13 @@ void platform_packet_output(datapacket_t* pkt, switch_port_t* port){
 	release_buffer(pkt);
 	outputs++;
 }
+void platform_packet_output_burst(switch_port_t* port, datapacket_t** pkts, unsigned int num_of_pkts){
+	unsigned int i;
+	fprintf(stderr,"Output burst of %u packets\n", num_of_pkts);
+	bursts++;
+	for(i=0;i<num_of_pkts;i++)
+		platform_packet_output(pkts[i], port);
+}
 datapacket_t* platform_packet_replicate(datapacket_t* pkt){
 	datapacket_t* replica = allocate_buffer(); 
 	if(replica){
@@ -145,11 +159,15 @@ datapacket_t* platform_packet_replicate(datapacket_t* pkt){
 	fprintf(stderr,"Pkt: %p cloned into %p\n", pkt, replica);
 	return replica;
 }
+datapacket_t* platform_packet_replicate_shared(datapacket_t* pkt){
+	return platform_packet_replicate(pkt);
+}
 void platform_packet_drop(datapacket_t* pkt){
 	fprintf(stderr,"Drop packet %p\n", pkt);
 	release_buffer(pkt);
 	drops++;
 }
+void platform_packet_update_checksums(datapacket_t* pkt, uint16_t l3_delta, uint16_t l4_delta){}
 void platform_packet_set_ipv6_src(datapacket_t * pkt, uint128__t ipv6_src){}
 void platform_packet_set_ipv6_dst(datapacket_t * pkt, uint128__t ipv6_dst){}
 void platform_packet_set_ipv6_flabel(datapacket_t * pkt, uint64_t ipv6_flabel){}
@@ -174,7 +192,9 @@ uint32_t platform_packet_get_size_bytes(datapacket_t * const pkt){
 	return 0;
 }
 uint32_t* platform_packet_get_port_in(datapacket_t *const pkt){
-	return (uint32_t*)&tmp_val;
+	if(no_port_in)
+		return NULL;
+	return &port_in;
 }
 uint32_t* platform_packet_get_phy_port_in(datapacket_t *const pkt){
 	return (uint32_t*)&tmp_val;
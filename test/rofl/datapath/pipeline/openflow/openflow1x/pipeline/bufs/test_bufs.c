@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "CUnit/Basic.h"
 #include "rofl/datapath/pipeline/openflow/of_switch_pp.h"
 #include "test_bufs.h"
@@ -238,15 +240,15 @@ void bufs_multiple_apply_output_actions(void){
 	//Dump pipeline
 	of1x_full_dump_switch(sw,false);
 
-	//Process through pipeline. Packet should be dropped
+	//Process through pipeline. The last output consumes the packet (no drop)
 	of_process_packet_pipeline(ROFL_PIPELINE_LOCKED_TID,(of_switch_t*)sw,pkt);
 
 	//Checkings	
-	CU_ASSERT(allocated == 3);
-	CU_ASSERT(released == 3);	
-	CU_ASSERT(drops == 1);
+	CU_ASSERT(allocated == 2);
+	CU_ASSERT(released == 2);	
+	CU_ASSERT(drops == 0);
 	CU_ASSERT(outputs == 2);	
-	CU_ASSERT(replicas == 2);	
+	CU_ASSERT(replicas == 1);	
 }
 
 //An output action in both apply and write actions
@@ -1105,4 +1107,260 @@ void bufs_output_all(void){
 	CU_ASSERT(replicas == 12)
 }
 
+//Output of a burst of packets (staged if compiled with TX bursts) 
+void bufs_tx_bursts(void){
+	int i;
+	wrap_uint_t field;
+	field.u32 = 1;
+	reset_io_state();
+	
+	of1x_flow_entry_t* entry = of1x_init_flow_entry(false); 
+	of1x_action_group_t *apply_actions = of1x_init_action_group(NULL);
+	of1x_packet_action_t* action = of1x_init_packet_action( OF1X_AT_OUTPUT, field, 0x0);
+	
+	CU_ASSERT(entry != NULL);	
+	CU_ASSERT(apply_actions != NULL);	
+	CU_ASSERT(action != NULL);	
+	of1x_push_packet_action_to_group(apply_actions, action);
+	
+	of1x_add_instruction_to_group(
+			&(entry->inst_grp),
+			OF1X_IT_APPLY_ACTIONS,
+			(of1x_action_group_t*)apply_actions,
+			NULL,
+			NULL,
+			/*go_to_table*/0);
+
+	//Install
+	CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+	
+	//Process a burst of packets through the pipeline
+	for(i=0;i<3;i++){
+		pkt = allocate_buffer();	
+		CU_ASSERT(pkt != NULL);	
+		if(!pkt)
+			return;
+		of_process_packet_pipeline(1,(of_switch_t*)sw,pkt);
+	}
+
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	//Staged
+	CU_ASSERT(outputs == 0);	
+	CU_ASSERT(released == 0);	
+#else
+	CU_ASSERT(outputs == 3);	
+#endif
+
+	//End of the burst
+	of_process_packet_pipeline_flush(1,(of_switch_t*)sw);
+
+	//Checkings	
+	CU_ASSERT(allocated == 3);	
+	CU_ASSERT(released == 3);	
+	CU_ASSERT(drops == 0);	
+	CU_ASSERT(outputs == 3);	
+	CU_ASSERT(replicas == 0);	
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	CU_ASSERT(bursts == 1);	
+#else
+	CU_ASSERT(bursts == 0);	
+#endif
+
+	//Nothing left
+	of_process_packet_pipeline_flush(1,(of_switch_t*)sw);
+	CU_ASSERT(outputs == 3);	
+
+#ifdef ROFL_PIPELINE_TX_BURSTS
+	//Every TID slot in its own cache line(s)
+	CU_ASSERT(((uintptr_t)&sw->tx_bursts[1] % ROFL_PIPELINE_CACHE_LINE_SIZE) == 0);
+#endif
+}
+
+//Output to FLOOD (expanded if compiled with FLOOD/ALL expansion)
+void bufs_flood_expansion(void){
+	int i;
+	wrap_uint_t field;
+	field.u32 = OF1X_PORT_FLOOD;
+	switch_port_t* ports[3];
+	char name[SWITCH_PORT_MAX_LEN_NAME];
+	of1x_switch_t* sw2;
+	enum of1x_matching_algorithm_available ma_list[1]={of1x_loop_matching_algorithm};
+
+	reset_io_state();
+
+	sw2 = of1x_init_switch("Test switch 2", OF_VERSION_12, 0x0102, 1, ma_list);
+	CU_ASSERT(sw2 != NULL);
+	if(!sw2)
+		return;
+
+	CU_ASSERT(of1x_get_flood_port_set(sw2)->num_of_ports == 0);
+	CU_ASSERT(of1x_get_all_port_set(sw2)->num_of_ports == 0);
+
+	//Attach 3 ports (1..3)
+	for(i=0;i<3;i++){
+		snprintf(name, SWITCH_PORT_MAX_LEN_NAME, "flood%d", i);
+		ports[i] = switch_port_init(name, true, PORT_TYPE_PHYSICAL, PORT_STATE_NONE);
+		CU_ASSERT(ports[i] != NULL);
+		CU_ASSERT(__of1x_attach_port_to_switch_at_port_num(sw2, i+1, ports[i]) == ROFL_SUCCESS);
+	}
+	
+	CU_ASSERT(of1x_get_flood_port_set(sw2)->num_of_ports == 3);
+	CU_ASSERT(of1x_get_all_port_set(sw2)->num_of_ports == 3);
+
+	//No flood on port 3
+	ports[2]->no_flood = true;
+	of1x_switch_port_config_changed(sw2);
+	CU_ASSERT(of1x_get_flood_port_set(sw2)->num_of_ports == 2);
+	CU_ASSERT(of1x_get_flood_port_set(sw2)->port_nums[0] == 1);
+	CU_ASSERT(of1x_get_flood_port_set(sw2)->port_nums[1] == 2);
+	CU_ASSERT(of1x_get_all_port_set(sw2)->num_of_ports == 3);
+
+	//Flood entry
+	of1x_flow_entry_t* entry = of1x_init_flow_entry(false); 
+	of1x_action_group_t *apply_actions = of1x_init_action_group(NULL);
+	CU_ASSERT(entry != NULL);	
+	CU_ASSERT(apply_actions != NULL);	
+	of1x_push_packet_action_to_group(apply_actions, of1x_init_packet_action( OF1X_AT_OUTPUT, field, 0x0));
+	of1x_add_instruction_to_group(
+			&(entry->inst_grp),
+			OF1X_IT_APPLY_ACTIONS,
+			(of1x_action_group_t*)apply_actions,
+			NULL,
+			NULL,
+			/*go_to_table*/0);
+	CU_ASSERT(of1x_add_flow_entry_table(&sw2->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+
+	//Packet coming from port 1
+	port_in = 1;
+	pkt = allocate_buffer();	
+	CU_ASSERT(pkt != NULL);	
+	if(!pkt)
+		return;
+	of_process_packet_pipeline(ROFL_PIPELINE_LOCKED_TID,(of_switch_t*)sw2,pkt);
+
+	CU_ASSERT(allocated == released);	
+	CU_ASSERT(drops == 0);	
+	CU_ASSERT(outputs == 1);	
+	CU_ASSERT(replicas == 0);	
+
+	//Packet coming from port 3 (not flooded)
+	reset_io_state();
+	port_in = 3;
+	pkt = allocate_buffer();	
+	CU_ASSERT(pkt != NULL);	
+	if(!pkt)
+		return;
+	of_process_packet_pipeline(ROFL_PIPELINE_LOCKED_TID,(of_switch_t*)sw2,pkt);
+
+	CU_ASSERT(allocated == released);	
+	CU_ASSERT(drops == 0);	
+#ifdef ROFL_PIPELINE_FLOOD_EXPANSION
+	//Ports 1 and 2
+	CU_ASSERT(outputs == 2);	
+	CU_ASSERT(replicas == 1);	
+#else
+	//Meta port
+	CU_ASSERT(outputs == 1);	
+	CU_ASSERT(replicas == 0);	
+#endif
+
+	//Packet without incoming port (e.g. packet-out)
+	reset_io_state();
+	no_port_in = true;
+	pkt = allocate_buffer();	
+	CU_ASSERT(pkt != NULL);	
+	if(!pkt)
+		return;
+	of_process_packet_pipeline(ROFL_PIPELINE_LOCKED_TID,(of_switch_t*)sw2,pkt);
+	no_port_in = false;
+
+	CU_ASSERT(allocated == released);	
+	CU_ASSERT(drops == 0);	
+#ifdef ROFL_PIPELINE_FLOOD_EXPANSION
+	//Ports 1 and 2
+	CU_ASSERT(outputs == 2);	
+	CU_ASSERT(replicas == 1);	
+#else
+	//Meta port
+	CU_ASSERT(outputs == 1);	
+	CU_ASSERT(replicas == 0);	
+#endif
+
+	//Detach
+	CU_ASSERT(__of1x_detach_port_from_switch_by_port_num(sw2, 2) == ROFL_SUCCESS);
+	CU_ASSERT(of1x_get_flood_port_set(sw2)->num_of_ports == 1);
+	CU_ASSERT(of1x_get_all_port_set(sw2)->num_of_ports == 2);
+
+	CU_ASSERT(__of1x_detach_all_ports_from_switch(sw2) == ROFL_SUCCESS);
+	CU_ASSERT(of1x_get_flood_port_set(sw2)->num_of_ports == 0);
+	CU_ASSERT(of1x_get_all_port_set(sw2)->num_of_ports == 0);
+
+	for(i=0;i<3;i++)
+		switch_port_destroy(ports[i]);
+	__of1x_destroy_switch(sw2);
+}
+
+static volatile bool port_sets_updated;
+
+static void* update_port_sets(void* arg){
+	of1x_switch_t* sw2 = (of1x_switch_t*)arg;
 
+	//The second update reuses the sets being read
+	of1x_switch_port_config_changed(sw2);
+	of1x_switch_port_config_changed(sw2);
+	port_sets_updated = true;
+
+	return NULL;
+}
+
+void bufs_port_sets_grace_period(void){
+	int i;
+	switch_port_t* ports[2];
+	char name[SWITCH_PORT_MAX_LEN_NAME];
+	of1x_switch_t* sw2;
+	const of1x_port_set_t* flood;
+	pthread_t thread;
+	enum of1x_matching_algorithm_available ma_list[1]={of1x_loop_matching_algorithm};
+
+	sw2 = of1x_init_switch("Test switch 3", OF_VERSION_12, 0x0103, 1, ma_list);
+	CU_ASSERT(sw2 != NULL);
+	if(!sw2)
+		return;
+
+	for(i=0;i<2;i++){
+		snprintf(name, SWITCH_PORT_MAX_LEN_NAME, "grace%d", i);
+		ports[i] = switch_port_init(name, true, PORT_TYPE_PHYSICAL, PORT_STATE_NONE);
+		CU_ASSERT(ports[i] != NULL);
+		CU_ASSERT(__of1x_attach_port_to_switch_at_port_num(sw2, i+1, ports[i]) == ROFL_SUCCESS);
+	}
+
+	//Reader (e.g. a FLOOD output in progress)
+	of1x_port_sets_read_begin(0, sw2);
+	flood = of1x_get_flood_port_set(sw2);
+	CU_ASSERT(flood->num_of_ports == 2);
+
+	port_sets_updated = false;
+	ports[1]->no_flood = true;
+	CU_ASSERT(pthread_create(&thread, NULL, update_port_sets, sw2) == 0);
+
+	//Updates must wait for the reader
+	usleep(100000);
+	CU_ASSERT(port_sets_updated == false);
+	CU_ASSERT(flood->num_of_ports == 2);
+	CU_ASSERT(flood->port_nums[0] == 1);
+	CU_ASSERT(flood->port_nums[1] == 2);
+
+	of1x_port_sets_read_end(0, sw2);
+	pthread_join(thread, NULL);
+	CU_ASSERT(port_sets_updated == true);
+
+	of1x_port_sets_read_begin(0, sw2);
+	CU_ASSERT(of1x_get_flood_port_set(sw2)->num_of_ports == 1);
+	CU_ASSERT(of1x_get_all_port_set(sw2)->num_of_ports == 2);
+	of1x_port_sets_read_end(0, sw2);
+
+	CU_ASSERT(__of1x_detach_all_ports_from_switch(sw2) == ROFL_SUCCESS);
+	for(i=0;i<2;i++)
+		switch_port_destroy(ports[i]);
+	__of1x_destroy_switch(sw2);
+}
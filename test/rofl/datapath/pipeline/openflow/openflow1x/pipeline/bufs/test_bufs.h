@@ -28,5 +28,8 @@ void bufs_apply_output_action_both_tables_goto(void);
 void bufs_apply_output_action_both_tables_bis_goto(void);
 void bufs_output_first_table_output_on_group_second_table(void);
 void bufs_output_all(void);
+void bufs_tx_bursts(void);
+void bufs_flood_expansion(void);
+void bufs_port_sets_grace_period(void);
 
 #endif //__TEST_BUFS_H__
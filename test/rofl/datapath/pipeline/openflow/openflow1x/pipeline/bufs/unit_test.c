@@ -34,7 +34,10 @@ int main(int args, char** argv){
 		(CU_add_test(bufs_suite,"Output action(apply) on both tables\n", bufs_apply_output_action_both_tables_goto)==NULL) ||
 		(CU_add_test(bufs_suite,"Two output actions (apply) on first able, one in the second table\n", bufs_apply_output_action_both_tables_goto)==NULL) ||
 		(CU_add_test(bufs_suite,"Output (apply) o first table, output action on an indirect group in second table\n",bufs_output_first_table_output_on_group_second_table)==NULL) ||
-		(CU_add_test(bufs_suite,"Output on apply and group on first table, output on apply, group and write actions(output and group again) on the second table (write set on the first table)\n",bufs_output_all)==NULL)
+		(CU_add_test(bufs_suite,"Output on apply and group on first table, output on apply, group and write actions(output and group again) on the second table (write set on the first table)\n",bufs_output_all)==NULL) ||
+		(CU_add_test(bufs_suite,"Output (apply) of a burst of packets, with a TID other than ROFL_PIPELINE_LOCKED_TID\n",bufs_tx_bursts)==NULL) ||
+		(CU_add_test(bufs_suite,"FLOOD and ALL port sets (and expansion)\n",bufs_flood_expansion)==NULL) ||
+		(CU_add_test(bufs_suite,"Port sets are not reused while being read\n",bufs_port_sets_grace_period)==NULL)
 	){
 		fprintf(stderr,"ERROR WHILE ADDING TEST\n");
 		CU_cleanup_registry();
@@ -50,7 +50,10 @@ void platform_packet_set_mpls_tc(datapacket_t* pkt, uint8_t tc){}
 void platform_packet_set_mpls_bos(datapacket_t* pkt, bool bos){}
 void platform_packet_output(datapacket_t* pkt, switch_port_t* port){}
 datapacket_t* platform_packet_replicate(datapacket_t* pkt){return NULL;}
+datapacket_t* platform_packet_replicate_shared(datapacket_t* pkt){return NULL;}
+void platform_packet_output_burst(switch_port_t* port, datapacket_t** pkts, unsigned int num_of_pkts){}
 void platform_packet_drop(datapacket_t* pkt){}
+void platform_packet_update_checksums(datapacket_t* pkt, uint16_t l3_delta, uint16_t l4_delta){}
 void platform_packet_set_ipv6_src(datapacket_t * pkt, uint128__t ipv6_src){}
 void platform_packet_set_ipv6_dst(datapacket_t * pkt, uint128__t ipv6_dst){}
 void platform_packet_set_ipv6_flabel(datapacket_t * pkt, uint64_t ipv6_flabel){}
@@ -0,0 +1,130 @@
+#include "flow_index_test.h"
+
+#define FLOW_STATS_ENTRIES 100
+
+static of1x_switch_t* sw=NULL;
+	
+int set_up(){
+
+	physical_switch_init();
+
+	enum of1x_matching_algorithm_available ma_list[4]={of1x_loop_matching_algorithm, of1x_loop_matching_algorithm,
+	of1x_loop_matching_algorithm, of1x_loop_matching_algorithm};
+
+	//Create instance	
+	sw = of1x_init_switch("Test switch", OF_VERSION_12, 0x0101,4,ma_list);
+	
+	if(!sw)
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
+
+int tear_down(){
+	//Destroy the switch
+	if(__of1x_destroy_switch(sw) != ROFL_SUCCESS)
+		return EXIT_FAILURE;
+	
+	return EXIT_SUCCESS;
+}
+
+//Add an entry outputting to port
+static void add_output_entry(int priority, uint64_t cookie, uint32_t port){
+
+	wrap_uint_t field;
+	of1x_flow_entry_t* entry = of1x_init_flow_entry(false);
+	of1x_action_group_t* apply_actions = of1x_init_action_group(NULL);
+
+	field.u64 = 0;
+	field.u32 = port;
+
+	entry->priority = priority;
+	entry->cookie = cookie;
+	of1x_add_match_to_entry(entry,of1x_init_port_in_match(priority));
+	of1x_push_packet_action_to_group(apply_actions, of1x_init_packet_action(OF1X_AT_OUTPUT, field, 0x0));
+	of1x_add_instruction_to_group(&entry->inst_grp, OF1X_IT_APPLY_ACTIONS, apply_actions, NULL, NULL, 0);
+
+	CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+}
+
+static uint32_t count_flow_stats(uint64_t cookie, uint64_t cookie_mask, uint32_t out_port){
+
+	uint32_t num_of_entries;
+	of1x_match_group_t matches;
+	of1x_stats_flow_msg_t* msg;
+
+	__of1x_init_match_group(&matches);
+
+	msg = of1x_get_flow_stats(&sw->pipeline, 0, cookie, cookie_mask, out_port, OF1X_GROUP_ANY, &matches);
+	CU_ASSERT(msg != NULL);
+	if(!msg)
+		return 0;
+
+	num_of_entries = msg->num_of_entries;
+	of1x_destroy_stats_flow_msg(msg);
+
+	return num_of_entries;
+}
+
+void test_flow_index(){
+
+	int i;
+	wrap_uint_t field;
+	of1x_flow_entry_t* entry;
+	of1x_action_group_t* apply_actions;
+	of1x_flow_table_t* table = &sw->pipeline.tables[0];
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+
+	for(i=0;i<FLOW_STATS_ENTRIES;i++)
+		add_output_entry(i, i%8, i%4+1);
+	CU_ASSERT(table->num_of_entries == FLOW_STATS_ENTRIES);
+	CU_ASSERT(table->index.incomplete == false);
+
+	//Out port
+	CU_ASSERT(count_flow_stats(0x0, 0x0, 1) == FLOW_STATS_ENTRIES/4);
+	CU_ASSERT(count_flow_stats(0x0, 0x0, 7) == 0);
+
+	//Exact cookie (and cookie plus out port)
+	CU_ASSERT(count_flow_stats(0x5, 0xFFFFFFFFFFFFFFFFULL, OF1X_PORT_ANY) == (FLOW_STATS_ENTRIES+2)/8);
+	CU_ASSERT(count_flow_stats(0x5, 0xFFFFFFFFFFFFFFFFULL, 2) == (FLOW_STATS_ENTRIES+2)/8);
+	CU_ASSERT(count_flow_stats(0x5, 0xFFFFFFFFFFFFFFFFULL, 3) == 0);
+
+	//Masked cookie; not indexed
+	CU_ASSERT(count_flow_stats(0x1, 0x3, OF1X_PORT_ANY) == FLOW_STATS_ENTRIES/4);
+
+	//Modify the instructions of entry 0 (port 1 => port 3); re-indexed
+	entry = of1x_init_flow_entry(false);
+	apply_actions = of1x_init_action_group(NULL);
+	field.u64 = 3;
+	entry->priority = 0;
+	of1x_add_match_to_entry(entry,of1x_init_port_in_match(0));
+	of1x_push_packet_action_to_group(apply_actions, of1x_init_packet_action(OF1X_AT_OUTPUT, field, 0x0));
+	of1x_add_instruction_to_group(&entry->inst_grp, OF1X_IT_APPLY_ACTIONS, apply_actions, NULL, NULL, 0);
+	CU_ASSERT(of1x_modify_flow_entry_table(&sw->pipeline, 0, &entry, STRICT, false) == ROFL_OF1X_FM_SUCCESS);
+
+	CU_ASSERT(count_flow_stats(0x0, 0x0, 1) == FLOW_STATS_ENTRIES/4-1);
+	CU_ASSERT(count_flow_stats(0x0, 0x0, 3) == FLOW_STATS_ENTRIES/4+1);
+
+	//Non-strict delete by out port
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, 3, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(table->num_of_entries == FLOW_STATS_ENTRIES-(FLOW_STATS_ENTRIES/4+1));
+	CU_ASSERT(count_flow_stats(0x0, 0x0, 3) == 0);
+	CU_ASSERT(count_flow_stats(0x0, 0x0, 2) == FLOW_STATS_ENTRIES/4);
+
+	//Non-strict delete by exact cookie
+	entry = of1x_init_flow_entry(false);
+	entry->cookie = 0x5;
+	entry->cookie_mask = 0xFFFFFFFFFFFFFFFFULL;
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(count_flow_stats(0x0, 0x0, 2) == FLOW_STATS_ENTRIES/4-(FLOW_STATS_ENTRIES+2)/8);
+	CU_ASSERT(count_flow_stats(0x1, 0xFFFFFFFFFFFFFFFFULL, 2) == (FLOW_STATS_ENTRIES+6)/8);
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(count_flow_stats(0x0, 0x0, 2) == 0);
+}
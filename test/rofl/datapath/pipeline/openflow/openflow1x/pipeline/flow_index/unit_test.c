@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <string.h>
+#include "CUnit/Basic.h"
+
+#include "flow_index_test.h"
+
+int main(int args, char** argv){
+
+	int return_code;
+	CU_pSuite pSuite = NULL;
+
+	/* initialize the CUnit test registry */
+	if (CUE_SUCCESS != CU_initialize_registry())
+		return CU_get_error();
+
+	/* add a suite to the registry */
+	pSuite = CU_add_suite("Suite_Flow_index", set_up, tear_down);
+
+	if (NULL == pSuite){
+		CU_cleanup_registry();
+		return CU_get_error();
+	}
+
+	/* add the tests to the suite */
+	if ((NULL == CU_add_test(pSuite, "test flow index", test_flow_index))
+		)
+	{
+		fprintf(stderr,"ERROR WHILE ADDING TEST\n");
+		return_code = CU_get_error();
+		CU_cleanup_registry();
+		return return_code;
+	}
+	
+	/* Run all tests using the CUnit Basic interface */
+	CU_basic_set_mode(CU_BRM_VERBOSE);
+	CU_basic_run_tests();
+	return_code = CU_get_number_of_failures();
+	CU_cleanup_registry();
+
+	return return_code;
+}
@@ -3,10 +3,157 @@
 #include <assert.h>
 #include <pthread.h>
 #include <unistd.h>
+#include "CUnit/Basic.h"
 
 #include "group_table.h"
 #define NUM_THREADS 10
 
+static of1x_switch_t* gt_sw=NULL;
+static unsigned int gt_port=2;
+
+static void gt_switch_set_up(void){
+
+	enum of1x_matching_algorithm_available ma_list=of1x_loop_matching_algorithm;
+
+	physical_switch_init();
+	gt_sw = of1x_init_switch("Test switch", OF_VERSION_12, 0x0101,1,&ma_list);
+	assert(gt_sw != NULL);
+}
+
+static void gt_switch_tear_down(void){
+	__of1x_destroy_switch(gt_sw);
+	gt_sw = NULL;
+}
+
+//Bucket of an id (ids below 2^16)
+static unsigned int gt_hash(uint32_t id){
+	return id & (OF1X_GROUP_TABLE_BUCKETS-1);
+}
+
+//Add a group with a single output bucket
+static rofl_of1x_gm_result_t gt_add_group(uint32_t id){
+	wrap_uint_t field={0}; field.u32 = be32toh(gt_port);
+	of1x_action_group_t *ag=of1x_init_action_group(0);
+	of1x_bucket_list_t *buckets=of1x_init_bucket_list();
+	rofl_of1x_gm_result_t res;
+
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	of1x_insert_bucket_in_list(buckets,of1x_init_bucket(0,1,0,ag));
+
+	res = of1x_group_add(gt_sw->pipeline.groups,OF1X_GROUP_TYPE_ALL,id,&buckets);
+	if(buckets)
+		of1x_destroy_bucket_list(buckets);
+	return res;
+}
+
+void gt_group_search(void){
+	uint32_t i;
+	of1x_group_t* ge;
+	of1x_group_table_t* gt;
+	gt_switch_set_up();
+	gt = gt_sw->pipeline.groups;
+
+	//Several pool slabs; ids colliding in the same hash buckets
+	for(i=0;i<OF1X_GROUP_POOL_SLAB_SIZE*3;i++){
+		CU_ASSERT(gt_add_group(i) == ROFL_OF1X_GM_SUCCESS);
+		CU_ASSERT(gt_add_group(i+OF1X_GROUP_TABLE_BUCKETS) == ROFL_OF1X_GM_SUCCESS);
+	}
+	CU_ASSERT(gt_add_group(0) == ROFL_OF1X_GM_EXISTS);
+	CU_ASSERT(gt->num_of_entries == OF1X_GROUP_POOL_SLAB_SIZE*6);
+
+	for(i=0;i<OF1X_GROUP_POOL_SLAB_SIZE*3;i++){
+		ge = __of1x_group_search(gt, i);
+		CU_ASSERT(ge != NULL && ge->id == i);
+		ge = __of1x_group_search(gt, i+OF1X_GROUP_TABLE_BUCKETS);
+		CU_ASSERT(ge != NULL && ge->id == i+OF1X_GROUP_TABLE_BUCKETS);
+	}
+	CU_ASSERT(__of1x_group_search(gt, OF1X_GROUP_POOL_SLAB_SIZE*3) == NULL);
+
+	//Delete the odd ids
+	for(i=1;i<OF1X_GROUP_POOL_SLAB_SIZE*3;i+=2)
+		CU_ASSERT(of1x_group_delete(&gt_sw->pipeline, gt, i) == ROFL_OF1X_GM_SUCCESS);
+	CU_ASSERT(gt->num_of_entries == OF1X_GROUP_POOL_SLAB_SIZE*9/2);
+
+	for(i=0;i<OF1X_GROUP_POOL_SLAB_SIZE*3;i++){
+		CU_ASSERT( (__of1x_group_search(gt, i) == NULL) == (i%2 == 1) );
+		CU_ASSERT(__of1x_group_search(gt, i+OF1X_GROUP_TABLE_BUCKETS) != NULL);
+	}
+
+	//Re-added from the pool
+	for(i=1;i<OF1X_GROUP_POOL_SLAB_SIZE*3;i+=2)
+		CU_ASSERT(gt_add_group(i) == ROFL_OF1X_GM_SUCCESS);
+	for(i=0;i<OF1X_GROUP_POOL_SLAB_SIZE*3;i++){
+		ge = __of1x_group_search(gt, i);
+		CU_ASSERT(ge != NULL && ge->id == i);
+	}
+
+	//Delete all
+	CU_ASSERT(of1x_group_delete(&gt_sw->pipeline, gt, OF1X_GROUP_ALL) == ROFL_OF1X_GM_SUCCESS);
+	CU_ASSERT(gt->num_of_entries == 0);
+	CU_ASSERT(__of1x_group_search(gt, 0) == NULL);
+	CU_ASSERT(__of1x_group_search(gt, OF1X_GROUP_TABLE_BUCKETS) == NULL);
+
+	gt_switch_tear_down();
+}
+
+void gt_group_pool_reuse(void){
+	uint32_t id = 5, other = 6, chained = 5+OF1X_GROUP_TABLE_BUCKETS;
+	uint32_t seq;
+	of1x_group_t *ge, *reused, *it;
+	of1x_group_table_t* gt;
+	gt_switch_set_up();
+	gt = gt_sw->pipeline.groups;
+
+	CU_ASSERT(gt_hash(id) == gt_hash(chained));
+	CU_ASSERT(gt_hash(id) != gt_hash(other));
+
+	//Bucket chain: id -> chained
+	CU_ASSERT(gt_add_group(chained) == ROFL_OF1X_GM_SUCCESS);
+	CU_ASSERT(gt_add_group(id) == ROFL_OF1X_GM_SUCCESS);
+	ge = __of1x_group_search(gt, id);
+	CU_ASSERT(ge != NULL && gt->hash[gt_hash(id)] == ge);
+
+	//Reader in the middle of the walk of the bucket of id
+	seq = seqlock_read_begin(&gt->seqlock);
+	it = gt->hash[gt_hash(id)];
+
+	//Delete and reuse the group (pool) under an id of another bucket
+	CU_ASSERT(of1x_group_delete(&gt_sw->pipeline, gt, id) == ROFL_OF1X_GM_SUCCESS);
+	CU_ASSERT(gt_add_group(other) == ROFL_OF1X_GM_SUCCESS);
+	reused = __of1x_group_search(gt, other);
+	CU_ASSERT(reused == ge);
+	CU_ASSERT(reused->id == other);
+
+	//The reader is now in the chain of the other bucket; it MUST retry
+	CU_ASSERT(it == reused);
+	CU_ASSERT(it->hash_next != __of1x_group_search(gt, chained));
+	CU_ASSERT(seqlock_read_retry(&gt->seqlock, seq));
+
+	//Both chains are consistent
+	CU_ASSERT(__of1x_group_search(gt, id) == NULL);
+	CU_ASSERT(gt->hash[gt_hash(id)] == __of1x_group_search(gt, chained));
+	CU_ASSERT(__of1x_group_search(gt, chained)->hash_next == NULL);
+	CU_ASSERT(gt->hash[gt_hash(other)] == reused);
+	CU_ASSERT(reused->hash_next == NULL);
+	CU_ASSERT(__of1x_group_search(gt, other+OF1X_GROUP_TABLE_BUCKETS) == NULL);
+	CU_ASSERT(gt->num_of_entries == 2);
+
+	//Original id re-added (from a new slot)
+	CU_ASSERT(gt_add_group(id) == ROFL_OF1X_GM_SUCCESS);
+	ge = __of1x_group_search(gt, id);
+	CU_ASSERT(ge != NULL && ge != reused && ge->id == id);
+	CU_ASSERT(__of1x_group_search(gt, chained) != NULL);
+	CU_ASSERT(__of1x_group_search(gt, other) == reused);
+
+	CU_ASSERT(of1x_group_delete(&gt_sw->pipeline, gt, OF1X_GROUP_ALL) == ROFL_OF1X_GM_SUCCESS);
+	CU_ASSERT(gt->num_of_entries == 0);
+
+	gt_switch_tear_down();
+}
+
+//FIXME legacy tests; they use the old group table API and are not built
+#ifdef GT_LEGACY_TESTS
+
 switch_port_t flood_meta_port;
 struct test_utils tu;
 typedef struct info_th{
@@ -150,3 +297,4 @@ void gt_references_test(void){
 	
 	assert(of1x_group_delete(tu.gt, tu.id)==ROFL_SUCCESS);
 }
+#endif //GT_LEGACY_TESTS
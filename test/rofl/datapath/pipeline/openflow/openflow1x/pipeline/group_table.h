@@ -7,6 +7,7 @@
 #include "rofl/datapath/pipeline/openflow/of_switch.h"
 #include "rofl/datapath/pipeline/openflow/openflow1x/of1x_switch.h"
 #include "rofl/datapath/pipeline/openflow/openflow1x/pipeline/of1x_pipeline.h"
+#include "rofl/datapath/pipeline/physical_switch.h"
 
 struct test_utils{
 	of1x_group_table_t* gt;
@@ -26,5 +27,7 @@ void gt_expected_errors_test(void);
 void gt_add_and_delete_buckets_test(void);
 void gt_concurrency_test(void);
 void gt_references_test(void);
+void gt_group_search(void);
+void gt_group_pool_reuse(void);
 
 #endif //__GROUP_TABLE_H__
@@ -0,0 +1,300 @@
+#include "dtree.h"
+#include "rofl/datapath/pipeline/openflow/openflow1x/pipeline/matching_algorithms/dtree/of1x_dtree_ma_pp.h"
+
+static of1x_switch_t* sw = NULL;
+static of1x_flow_table_t* table = NULL;
+static datapacket_t pkt;
+
+//tmp val (all the packet getters of the empty packet point to it)
+extern uint128__t tmp_val;
+
+//Ports of the random packets and entries are within [0, DTREE_TEST_PORT_SPACE)
+#define DTREE_TEST_PORT_BITS 10
+#define DTREE_TEST_PORT_SPACE (1 << DTREE_TEST_PORT_BITS)
+
+int set_up(){
+
+	physical_switch_init();
+
+	enum of1x_matching_algorithm_available ma_list[4]={of1x_dtree_matching_algorithm, of1x_dtree_matching_algorithm,
+	of1x_dtree_matching_algorithm, of1x_dtree_matching_algorithm};
+
+	//Create instance
+	sw = of1x_init_switch("Test switch", OF_VERSION_12, 0x0101,4,ma_list);
+
+	if(!sw)
+		return EXIT_FAILURE;
+
+	table = &sw->pipeline.tables[0];
+
+	return EXIT_SUCCESS;
+}
+
+int tear_down(){
+	//Destroy the switch
+	if(__of1x_destroy_switch(sw) != ROFL_SUCCESS)
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
+
+static void clean_all(){
+	of1x_flow_entry_t *entry = of1x_init_flow_entry(false);
+	CU_ASSERT(entry != NULL);
+
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, false, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(table->num_of_entries == 0);
+}
+
+/*
+* Set the packet. The empty packet returns the same buffer for every field, so
+* eth_type=0x0800 (IPv4) and IPv4 src/dst=0x0800XXXX
+*/
+static void set_pkt(uint16_t low){
+	uint8_t* buf = (uint8_t*)&tmp_val;
+
+	memset(&tmp_val, 0, sizeof(tmp_val));
+	buf[0] = 0x08;
+	buf[1] = 0x00;
+	buf[2] = low >> 8;
+	buf[3] = low & 0xFF;
+
+	//Packet contents changed
+	__of1x_invalidate_packet_key(&pkt);
+}
+
+/*
+* Set the L4 fields. The empty packet cannot hold them (ip_proto is always
+* 0x08), so they are written directly into the extracted packet key
+*/
+static void set_pkt_l4(uint8_t ip_proto, uint16_t tp_src, uint16_t tp_dst){
+	of1x_packet_key_t* key = __of1x_get_packet_key(&pkt, OF1X_PKT_KEY_L2 | OF1X_PKT_KEY_MPLS | OF1X_PKT_KEY_ARP | OF1X_PKT_KEY_L3 | OF1X_PKT_KEY_L4);
+
+	key->ip_proto = ip_proto;
+	key->tp_src = HTONB16(tp_src);
+	key->tp_dst = HTONB16(tp_dst);
+
+	key->present &= ~(OF1X_PKT_KEY_F_TP_SRC | OF1X_PKT_KEY_F_TP_DST);
+	if(ip_proto == IP_PROTO_TCP)
+		key->present |= OF1X_PKT_KEY_F_TCP_SRC | OF1X_PKT_KEY_F_TCP_DST;
+	else if(ip_proto == IP_PROTO_UDP)
+		key->present |= OF1X_PKT_KEY_F_UDP_SRC | OF1X_PKT_KEY_F_UDP_DST;
+}
+
+//Random ip_proto (TCP, UDP or the one of the empty packet)
+static uint8_t random_ip_proto(){
+	switch(rand()%3){
+		case 0: return IP_PROTO_TCP;
+		case 1: return IP_PROTO_UDP;
+		default: return 0x08;
+	}
+}
+
+//Random port mask; prefixes and arbitrary (non-prefix) masks
+static uint16_t random_port_mask(){
+	if(rand()%2)
+		return 0xFFFF << (rand()%(DTREE_TEST_PORT_BITS+1));
+	return rand() | ~((1 << DTREE_TEST_PORT_BITS)-1);
+}
+
+/*
+* Add a TCP/UDP port match. Port matches are exact in OF1.2, but the pipeline
+* (and the tree) handle any mask
+*/
+static void add_port_match(of1x_flow_entry_t* entry, uint8_t ip_proto, bool src){
+	of1x_match_t* match;
+	uint16_t mask = random_port_mask();
+	uint16_t value = (rand()%DTREE_TEST_PORT_SPACE) & mask;
+
+	if(ip_proto == IP_PROTO_TCP)
+		match = (src)? of1x_init_tcp_src_match(value) : of1x_init_tcp_dst_match(value);
+	else
+		match = (src)? of1x_init_udp_src_match(value) : of1x_init_udp_dst_match(value);
+	CU_ASSERT(match != NULL);
+
+	__init_utern16(&match->__tern, HTONB16(value), HTONB16(mask));
+	CU_ASSERT(of1x_add_match_to_entry(entry, match) == ROFL_SUCCESS);
+}
+
+//Reference lookup (table order)
+static of1x_flow_entry_t* ref_lookup(){
+	of1x_flow_entry_t* entry;
+	of1x_match_t* it;
+
+	for(entry = table->entries; entry; entry = entry->next){
+		for(it = entry->matches.head; it; it = it->next){
+			if(!__of1x_check_match(&pkt, it))
+				break;
+		}
+		if(!it)
+			return entry;
+	}
+	return NULL;
+}
+
+static of1x_flow_entry_t* dtree_lookup(){
+	of1x_flow_entry_t* entry = of1x_find_best_match_dtree_ma(table, &pkt);
+
+#ifndef ROFL_PIPELINE_LOCKLESS
+	if(entry)
+		platform_rwlock_rdunlock(entry->rwlock);
+#endif
+	return entry;
+}
+
+//Compare against the reference over a random set of packets
+static void check_lookups(unsigned int num_of_pkts){
+	unsigned int i, errors = 0;
+
+	for(i=0;i<num_of_pkts;i++){
+		set_pkt(rand()%0xFFFF);
+		set_pkt_l4(random_ip_proto(), rand()%DTREE_TEST_PORT_SPACE, rand()%DTREE_TEST_PORT_SPACE);
+		if(dtree_lookup() != ref_lookup())
+			errors++;
+	}
+	CU_ASSERT(errors == 0);
+}
+
+static void add_random_entry(){
+	unsigned int len, ports;
+	uint8_t ip_proto;
+	of1x_flow_entry_t* entry = of1x_init_flow_entry(false);
+	CU_ASSERT(entry != NULL);
+
+	entry->priority = rand()%64;
+
+	switch(rand()%7){
+		case 0:
+			len = 16 + rand()%17;
+			CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_ip4_src_match(0x08000000 | (rand()%0xFFFF), 0xFFFFFFFF << (32-len))) == ROFL_SUCCESS);
+			break;
+		case 1:
+			len = 16 + rand()%17;
+			CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_ip4_dst_match(0x08000000 | (rand()%0xFFFF), 0xFFFFFFFF << (32-len))) == ROFL_SUCCESS);
+			break;
+		case 2:
+			len = 16 + rand()%17;
+			CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_ip4_src_match(0x08000000 | (rand()%0xFFFF), 0xFFFFFFFF << (32-len))) == ROFL_SUCCESS);
+			len = 16 + rand()%17;
+			CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_ip4_dst_match(0x08000000 | (rand()%0xFFFF), 0xFFFFFFFF << (32-len))) == ROFL_SUCCESS);
+			break;
+		case 3:
+			CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_ip_proto_match(random_ip_proto())) == ROFL_SUCCESS);
+			break;
+		case 4:
+			//TCP/UDP ports (src, dst or both)
+			ip_proto = (rand()%2)? IP_PROTO_TCP : IP_PROTO_UDP;
+			CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_ip_proto_match(ip_proto)) == ROFL_SUCCESS);
+			ports = 1 + rand()%3;
+			if(ports & 0x1)
+				add_port_match(entry, ip_proto, true);
+			if(ports & 0x2)
+				add_port_match(entry, ip_proto, false);
+			break;
+		case 5:
+			len = 16 + rand()%17;
+			CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_ip4_src_match(0x08000000 | (rand()%0xFFFF), 0xFFFFFFFF << (32-len))) == ROFL_SUCCESS);
+			ip_proto = (rand()%2)? IP_PROTO_TCP : IP_PROTO_UDP;
+			CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_ip_proto_match(ip_proto)) == ROFL_SUCCESS);
+			add_port_match(entry, ip_proto, false);
+			break;
+		default:
+			//Non-tree dimension (only verified at the leafs)
+			CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_eth_type_match((rand()%2)? 0x0800 : 0x86dd)) == ROFL_SUCCESS);
+			break;
+	}
+
+	CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+}
+
+void test_install_flowmods(){
+
+	unsigned int i;
+	dtree_state_t* state = (dtree_state_t*)table->matching_aux[0];
+
+	clean_all();
+	CU_ASSERT(of1x_rebuild_dtree(table) == ROFL_SUCCESS);
+	CU_ASSERT(state->tree == NULL);
+
+	for(i=0;i<200;i++)
+		add_random_entry();
+
+	//Not yet built; everything in the side list
+	CU_ASSERT(state->tree == NULL);
+	CU_ASSERT(state->num_of_side_entries == table->num_of_entries);
+	check_lookups(2000);
+
+	//Build
+	CU_ASSERT(of1x_rebuild_dtree(table) == ROFL_SUCCESS);
+	CU_ASSERT(state->tree != NULL);
+	CU_ASSERT(state->side == NULL);
+	CU_ASSERT(state->num_of_side_entries == 0);
+	CU_ASSERT(state->tree->num_of_rules == table->num_of_entries);
+	CU_ASSERT(((uintptr_t)state->tree->nodes % DTREE_CACHE_LINE_SIZE) == 0);
+	check_lookups(2000);
+
+	//Periodic maintenance (through the timers processing)
+	of_process_pipeline_tables_timeout_expirations((of_switch_t*)sw);
+	CU_ASSERT(state->dirty == false);
+	check_lookups(2000);
+}
+
+void test_incremental_updates(){
+
+	unsigned int i;
+	of1x_flow_entry_t* entry;
+	dtree_state_t* state = (dtree_state_t*)table->matching_aux[0];
+
+	CU_ASSERT(state->tree != NULL);
+
+	//Add some more entries => side list
+	for(i=0;i<20;i++)
+		add_random_entry();
+	CU_ASSERT(state->num_of_side_entries > 0);
+	check_lookups(2000);
+
+	//Remove some (tree and side list)
+	for(i=0;i<10;i++){
+		entry = of1x_init_flow_entry(false);
+		CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_ip4_src_match(0x08000000 | (rand()%0xFFFF), 0xFFFFF000)) == ROFL_SUCCESS);
+		CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+		of1x_destroy_flow_entry(entry);
+	}
+	check_lookups(2000);
+
+	//Rebuild
+	of_process_pipeline_tables_timeout_expirations((of_switch_t*)sw);
+	CU_ASSERT(state->dirty == false);
+	CU_ASSERT(state->side == NULL);
+	CU_ASSERT(state->tree->num_of_rules == table->num_of_entries);
+	check_lookups(2000);
+}
+
+void test_remove_all(){
+
+	dtree_state_t* state = (dtree_state_t*)table->matching_aux[0];
+
+	clean_all();
+	set_pkt(0x1234);
+	CU_ASSERT(dtree_lookup() == NULL);
+
+	CU_ASSERT(of1x_rebuild_dtree(table) == ROFL_SUCCESS);
+	CU_ASSERT(state->tree == NULL);
+	CU_ASSERT(dtree_lookup() == NULL);
+}
+
+void test_many_entries(){
+
+	unsigned int i;
+	dtree_state_t* state = (dtree_state_t*)table->matching_aux[0];
+
+	for(i=0;i<5000;i++)
+		add_random_entry();
+
+	CU_ASSERT(of1x_rebuild_dtree(table) == ROFL_SUCCESS);
+	CU_ASSERT(state->tree != NULL);
+	CU_ASSERT(state->tree->num_of_nodes > 1);
+	check_lookups(10000);
+
+	clean_all();
+}
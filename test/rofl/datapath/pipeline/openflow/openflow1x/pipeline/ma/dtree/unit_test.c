@@ -0,0 +1,46 @@
+#include <stdio.h>
+#include <string.h>
+#include "CUnit/Basic.h"
+#include "rofl/datapath/pipeline/openflow/of_switch_pp.h"
+
+#include "dtree.h"
+
+int main(int args, char** argv){
+
+	int return_code;
+	//main to call all the other tests written in the oder files in this folder
+	CU_pSuite pSuite = NULL;
+
+	/* initialize the CUnit test registry */
+	if (CUE_SUCCESS != CU_initialize_registry())
+		return CU_get_error();
+
+	/* add a suite to the registry */
+	pSuite = CU_add_suite("Suite_Dtree_matching algorithm", set_up, tear_down);
+
+	if (NULL == pSuite){
+		CU_cleanup_registry();
+		return CU_get_error();
+	}
+
+	/* add the tests to the suite */
+	if ((NULL == CU_add_test(pSuite, "Dtree: test install flowmods and rebuild", test_install_flowmods)) ||
+	(NULL == CU_add_test(pSuite, "Dtree: test incremental updates between rebuilds", test_incremental_updates)) ||
+	(NULL == CU_add_test(pSuite, "Dtree: test remove all", test_remove_all)) ||
+	(NULL == CU_add_test(pSuite, "Dtree: test many entries", test_many_entries))
+		)
+	{
+		fprintf(stderr,"ERROR WHILE ADDING TEST\n");
+		return_code = CU_get_error();
+		CU_cleanup_registry();
+		return return_code;
+	}
+
+	/* Run all tests using the CUnit Basic interface */
+	CU_basic_set_mode(CU_BRM_VERBOSE);
+	CU_basic_run_tests();
+	return_code = CU_get_number_of_failures();
+	CU_cleanup_registry();
+
+	return return_code;
+}
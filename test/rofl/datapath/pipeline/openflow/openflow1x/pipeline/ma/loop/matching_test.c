@@ -462,3 +462,93 @@ void test_flow_modify(){
 	//Reupdate with NO-Strict
 
 }
+
+#define FLOW_STATS_ENTRIES 100
+#define FLOW_STATS_PAGE_SIZE 7
+
+/*
+* Iterate over table 0; if modify is set, remove the first two entries reported
+* and add the first one back (ahead of the cursor) after the first page
+*/
+static unsigned int iterate_flow_stats(bool* seen, bool modify){
+
+	unsigned int i, num_of_entries, total=0;
+	of1x_stats_single_flow_msg_t page[FLOW_STATS_PAGE_SIZE];
+	of1x_flow_stats_iter_t iter;
+	of1x_match_group_t matches;
+	of1x_flow_entry_t* entry;
+
+	__of1x_init_match_group(&matches);
+	memset(seen, 0, sizeof(bool)*FLOW_STATS_ENTRIES);
+
+	CU_ASSERT(of1x_flow_stats_iter_init(&iter, &sw->pipeline, 0, 0x0ULL, 0x0ULL, OF1X_PORT_ANY, OF1X_GROUP_ANY, &matches) == ROFL_SUCCESS);
+
+	do{
+		CU_ASSERT(of1x_flow_stats_iter_next_page(&iter, page, FLOW_STATS_PAGE_SIZE, &num_of_entries) == ROFL_SUCCESS);
+		CU_ASSERT(num_of_entries <= FLOW_STATS_PAGE_SIZE);
+
+		for(i=0;i<num_of_entries;i++){
+			CU_ASSERT(page[i].priority < FLOW_STATS_ENTRIES);
+			if(page[i].priority >= FLOW_STATS_ENTRIES)
+				continue;
+			//Never reported twice
+			CU_ASSERT(seen[page[i].priority] == false);
+			seen[page[i].priority] = true;
+		}
+
+		//Concurrent modification
+		if(modify && total == 0 && num_of_entries > 1){
+			entry = of1x_init_flow_entry(false);
+			entry->priority = page[1].priority;
+			of1x_add_match_to_entry(entry,of1x_init_port_in_match(page[1].priority));
+			CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+			of1x_destroy_flow_entry(entry);
+
+			entry = of1x_init_flow_entry(false);
+			entry->priority = page[0].priority;
+			of1x_add_match_to_entry(entry,of1x_init_port_in_match(page[0].priority));
+			CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+			CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+		}
+
+		total += num_of_entries;
+		of1x_flow_stats_iter_release_page(page, num_of_entries);
+	}while(num_of_entries);
+
+	return total;
+}
+
+void test_flow_stats_iter(){
+
+	int i;
+	bool seen[FLOW_STATS_ENTRIES];
+	of1x_flow_entry_t* entry;
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(sw->pipeline.tables[0].num_of_entries == 0);
+
+	for(i=0;i<FLOW_STATS_ENTRIES;i++){
+		entry = of1x_init_flow_entry(false);
+		entry->priority = i;
+		of1x_add_match_to_entry(entry,of1x_init_port_in_match(i));
+		CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+	}
+	CU_ASSERT(sw->pipeline.tables[0].num_of_entries == FLOW_STATS_ENTRIES);
+
+	//All entries reported exactly once
+	CU_ASSERT(iterate_flow_stats(seen, false) == FLOW_STATS_ENTRIES);
+	for(i=0;i<FLOW_STATS_ENTRIES;i++)
+		CU_ASSERT(seen[i] == true);
+
+	//Table modified (ahead of the cursor) between pages; resumed after the last entry visited
+	CU_ASSERT(iterate_flow_stats(seen, true) == FLOW_STATS_ENTRIES);
+	for(i=0;i<FLOW_STATS_ENTRIES;i++)
+		CU_ASSERT(seen[i] == true);
+	CU_ASSERT(sw->pipeline.tables[0].num_of_entries == FLOW_STATS_ENTRIES-1);
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+}
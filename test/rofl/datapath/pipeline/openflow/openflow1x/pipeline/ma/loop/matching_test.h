@@ -25,6 +25,7 @@ void test_uninstall_wildcard(void);
 void test_overlap(void);
 void test_overlap2(void);
 void test_flow_modify(void);
+void test_flow_stats_iter(void);
 
 
 #endif
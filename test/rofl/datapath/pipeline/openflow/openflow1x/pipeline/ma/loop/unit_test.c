@@ -31,7 +31,8 @@ int main(int args, char** argv){
 	(NULL == CU_add_test(pSuite, "test uninstall wildcard", test_uninstall_wildcard)) || 
 	(NULL == CU_add_test(pSuite, "test check overlap addition", test_overlap)) || 
 	(NULL == CU_add_test(pSuite, "test check overlap addition2", test_overlap2)) || 
-	(NULL == CU_add_test(pSuite, "test flow modify", test_flow_modify)) 
+	(NULL == CU_add_test(pSuite, "test flow modify", test_flow_modify)) ||
+	(NULL == CU_add_test(pSuite, "test flow stats iterator", test_flow_stats_iter))
 	
 		)
 	{
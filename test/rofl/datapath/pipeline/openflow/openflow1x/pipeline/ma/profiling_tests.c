@@ -3,6 +3,7 @@
 #include "utils.h"
 #include <stdio.h>
 #include <string.h>
+#include <stddef.h>
 #include "CUnit/Basic.h"
 #include "profiling_tests.h"
 
@@ -258,6 +259,59 @@ void profile_match_n_entries(){
 #endif
 }
 
+//Packet layout profiling
+#define CACHE_LINE_SIZE 64
+#define MAX_PKT_CACHE_LINES 1024
+
+#define TOUCH(lines, field) __touch(lines, offsetof(datapacket_t, field), sizeof(((datapacket_t*)0)->field))
+
+static void __touch(bool* lines, size_t offset, size_t size){
+	size_t i;
+	for(i=offset/CACHE_LINE_SIZE; i<=(offset+size-1)/CACHE_LINE_SIZE; i++)
+		lines[i] = true;
+}
+
+static unsigned int __count_lines(bool* lines){
+	unsigned int i, count=0;
+	for(i=0;i<MAX_PKT_CACHE_LINES;i++)
+		if(lines[i])
+			count++;
+	return count;
+}
+
+void profile_packet_layout(){
+
+	bool hot[MAX_PKT_CACHE_LINES], touched[MAX_PKT_CACHE_LINES];
+	unsigned int num_of_lines = (sizeof(datapacket_t)+CACHE_LINE_SIZE-1)/CACHE_LINE_SIZE;
+
+	CU_ASSERT(num_of_lines <= MAX_PKT_CACHE_LINES);
+
+	memset(hot, 0, sizeof(hot));
+
+	//State accessed by every packet (and every matched table)
+	TOUCH(hot, sw);
+	TOUCH(hot, platform_state);
+	TOUCH(hot, __metadata);
+	TOUCH(hot, __cookie);
+	TOUCH(hot, __size_bytes);
+	TOUCH(hot, is_replica);
+	TOUCH(hot, checksum);
+
+	//Per packet initialization (key and write actions headers)
+	memcpy(touched, hot, sizeof(hot));
+	TOUCH(touched, key.of1x.layers);
+	TOUCH(touched, key.of1x.present);
+	TOUCH(touched, key.of1x.dirty);
+	TOUCH(touched, write_actions.of1x.bitmap);
+	TOUCH(touched, write_actions.of1x.num_of_actions);
+
+	fprintf(stderr,"\n%s datapacket_t size: %u bytes (%u cache lines), hot state: %u cache line(s), cache lines touched per packet: %u\n", __func__, (unsigned int)sizeof(datapacket_t), num_of_lines, __count_lines(hot), __count_lines(touched));
+
+	//Hot state must fit in the first cache line
+	CU_ASSERT(__count_lines(hot) == 1);
+	CU_ASSERT(hot[0] == true);
+}
+
 int main(int args, char** argv){
 
 	int return_code;
@@ -277,7 +331,8 @@ int main(int args, char** argv){
 	}
 
 	/* add the tests to the suite */
-	if ((NULL == CU_add_test(pSuite, "Basic profiling (single flow_mod); match match (lock)", profile_basic_match_lock)) ||
+	if ((NULL == CU_add_test(pSuite, "Packet layout; cache lines touched per packet", profile_packet_layout)) ||
+	(NULL == CU_add_test(pSuite, "Basic profiling (single flow_mod); match match (lock)", profile_basic_match_lock)) ||
 	(NULL == CU_add_test(pSuite, "Basic profiling (single flow_mod); match no-match (lock)", profile_basic_no_match_lock)) ||
 	(NULL == CU_add_test(pSuite, "Basic profiling (single flow_mod); match match (no lock)", profile_basic_match_no_lock)) ||
 	(NULL == CU_add_test(pSuite, "Basic profiling (single flow_mod); match no-match (no lock)", profile_basic_no_match_no_lock)) ||
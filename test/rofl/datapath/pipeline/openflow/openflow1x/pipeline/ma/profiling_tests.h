@@ -19,6 +19,8 @@ int set_up(void);
 int tear_down(void);
 	
 /* Test cases */
+void profile_packet_layout(void);
+
 void profile_basic_match_lock(void);
 void profile_basic_no_match_lock(void);
 
@@ -1,5 +1,7 @@
 #include "trie.h"
 #include "rofl/datapath/pipeline/openflow/openflow1x/pipeline/matching_algorithms/trie/of1x_trie_ma.h"
+#include "rofl/datapath/pipeline/openflow/openflow1x/pipeline/matching_algorithms/trie/of1x_trie_ma_pp.h"
+#include "rofl/datapath/pipeline/common/endianness.h"
 
 
 static of1x_switch_t* sw = NULL;
@@ -60,6 +62,20 @@ void test_install_empty_flowmods(){
 		CU_ASSERT(trie->entry->priority == 100);
 	}
 
+	//Looked up from the side array until the pool is recompiled
+	CU_ASSERT(trie->pool == NULL);
+	CU_ASSERT(trie->num_of_side_entries == 1);
+	CU_ASSERT(trie->side[0] == trie->entry);
+
+	//Published for the lookups, even with no leafs
+	CU_ASSERT(of1x_rebuild_trie(table) == ROFL_SUCCESS);
+	CU_ASSERT(trie->num_of_side_entries == 0);
+	CU_ASSERT(trie->pool != NULL);
+	if(trie->pool){
+		CU_ASSERT(trie->pool->num_of_nodes == 0);
+		CU_ASSERT(trie->pool->entry == trie->entry);
+	}
+
 	//Add a second entry with lower priority
 	entry = of1x_init_flow_entry(false);
 	CU_ASSERT(entry != NULL);
@@ -1105,3 +1121,291 @@ void test_many_entries(){
 	CU_ASSERT(table->num_of_entries == 0);
 }
 
+
+#define FLOW_STATS_ENTRIES 100
+#define FLOW_STATS_PAGE_SIZE 7
+
+//Iterate over table 0; if remove is set, remove the first entry reported after the first page
+static unsigned int iterate_flow_stats(bool* seen, bool remove){
+
+	unsigned int i, num_of_entries, total=0;
+	of1x_stats_single_flow_msg_t page[FLOW_STATS_PAGE_SIZE];
+	of1x_flow_stats_iter_t iter;
+	of1x_match_group_t matches;
+	of1x_flow_entry_t* entry;
+
+	__of1x_init_match_group(&matches);
+	memset(seen, 0, sizeof(bool)*FLOW_STATS_ENTRIES);
+
+	CU_ASSERT(of1x_flow_stats_iter_init(&iter, &sw->pipeline, 0, 0x0ULL, 0x0ULL, OF1X_PORT_ANY, OF1X_GROUP_ANY, &matches) == ROFL_SUCCESS);
+
+	do{
+		CU_ASSERT(of1x_flow_stats_iter_next_page(&iter, page, FLOW_STATS_PAGE_SIZE, &num_of_entries) == ROFL_SUCCESS);
+		CU_ASSERT(num_of_entries <= FLOW_STATS_PAGE_SIZE);
+
+		for(i=0;i<num_of_entries;i++){
+			CU_ASSERT(page[i].priority < FLOW_STATS_ENTRIES);
+			if(page[i].priority >= FLOW_STATS_ENTRIES)
+				continue;
+			//Never reported twice
+			CU_ASSERT(seen[page[i].priority] == false);
+			seen[page[i].priority] = true;
+		}
+
+		//Concurrent modification
+		if(remove && total == 0 && num_of_entries){
+			entry = of1x_init_flow_entry(false);
+			entry->priority = page[0].priority;
+			of1x_add_match_to_entry(entry,of1x_init_port_in_match(page[0].priority));
+			CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+		}
+
+		total += num_of_entries;
+		of1x_flow_stats_iter_release_page(page, num_of_entries);
+	}while(num_of_entries);
+
+	return total;
+}
+
+void test_flow_stats_iter(){
+
+	int i;
+	bool seen[FLOW_STATS_ENTRIES];
+	of1x_flow_entry_t* entry;
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(sw->pipeline.tables[0].num_of_entries == 0);
+
+	for(i=0;i<FLOW_STATS_ENTRIES;i++){
+		entry = of1x_init_flow_entry(false);
+		entry->priority = i;
+		of1x_add_match_to_entry(entry,of1x_init_port_in_match(i));
+		CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+	}
+	CU_ASSERT(sw->pipeline.tables[0].num_of_entries == FLOW_STATS_ENTRIES);
+
+	//All entries reported exactly once
+	CU_ASSERT(iterate_flow_stats(seen, false) == FLOW_STATS_ENTRIES);
+	for(i=0;i<FLOW_STATS_ENTRIES;i++)
+		CU_ASSERT(seen[i] == true);
+
+	//Table modified between pages; resumed by position (at most one entry is missed)
+	CU_ASSERT(iterate_flow_stats(seen, true) >= FLOW_STATS_ENTRIES-2);
+	CU_ASSERT(sw->pipeline.tables[0].num_of_entries == FLOW_STATS_ENTRIES-1);
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+}
+
+
+#define NUM_OF_TEMPLATES 16
+#define NUM_LOOKUP_ENTRIES 300
+
+//tmp val (all the packet getters of the empty packet point to it)
+extern uint128__t tmp_val;
+
+static uint8_t templates[NUM_OF_TEMPLATES][16];
+static of1x_flow_entry_t* lookup_entries[NUM_LOOKUP_ENTRIES];
+
+static void set_pkt(datapacket_t* pkt, unsigned int t){
+	memcpy(&tmp_val, templates[t], sizeof(tmp_val));
+	pkt->__metadata = rand()%2;
+	__of1x_invalidate_packet_key(pkt);
+}
+
+//Reference lookup (highest priority matching entry)
+static of1x_flow_entry_t* ref_lookup(datapacket_t* pkt, unsigned int num_of_entries){
+	unsigned int i;
+	of1x_match_t* it;
+	of1x_flow_entry_t* best = NULL;
+
+	for(i=0;i<num_of_entries;i++){
+		for(it = lookup_entries[i]->matches.head; it; it = it->next){
+			if(!__of1x_check_match(pkt, it))
+				break;
+		}
+		if(!it && (!best || lookup_entries[i]->priority > best->priority))
+			best = lookup_entries[i];
+	}
+	return best;
+}
+
+static of1x_flow_entry_t* trie_lookup(datapacket_t* pkt){
+	of1x_flow_entry_t* entry = of1x_find_best_match_trie_ma(table, pkt);
+
+#ifndef ROFL_PIPELINE_LOCKLESS
+	if(entry)
+		platform_rwlock_rdunlock(entry->rwlock);
+#endif
+	return entry;
+}
+
+//Entry partially matching one of the templates (same seed, same matches)
+static of1x_flow_entry_t* init_lookup_entry(uint32_t priority, unsigned int seed){
+	unsigned int j, num_of_matches;
+	uint8_t* t;
+	of1x_flow_entry_t* entry;
+
+	t = templates[rand_r(&seed)%NUM_OF_TEMPLATES];
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(entry != NULL);
+	entry->priority = priority;
+
+	//No catch-all entries
+	if(rand_r(&seed)%4)
+		of1x_add_match_to_entry(entry, of1x_init_eth_type_match(NTOHB16(*(uint16_t*)t)));
+	else
+		of1x_add_match_to_entry(entry, of1x_init_ip_proto_match(t[0]));
+	num_of_matches = rand_r(&seed)%3;
+	for(j=0;j<num_of_matches;j++){
+		switch(rand_r(&seed)%7){
+			case 0: of1x_add_match_to_entry(entry, of1x_init_port_in_match(*(uint32_t*)t));
+				break;
+			case 1: of1x_add_match_to_entry(entry, of1x_init_ip4_src_match(NTOHB32(*(uint32_t*)t), 0xFFFFFFFF << (rand_r(&seed)%17)));
+				break;
+			case 2: of1x_add_match_to_entry(entry, of1x_init_ip_proto_match(t[0]));
+				break;
+			case 3: of1x_add_match_to_entry(entry, of1x_init_metadata_match(rand_r(&seed)%2, 0x1));
+				break;
+			case 4: of1x_add_match_to_entry(entry, of1x_init_vlan_vid_match(0, 0, (rand_r(&seed)%2)? OF1X_MATCH_VLAN_NONE : OF1X_MATCH_VLAN_ANY));
+				break;
+			case 5: of1x_add_match_to_entry(entry, of1x_init_ip6_src_match(*(uint128__t*)t, *(uint128__t*)templates[0]));
+				break;
+			default: of1x_add_match_to_entry(entry, of1x_init_eth_dst_match(NTOHB64(*(uint64_t*)t) >> 16, 0xFFFFFFFFFF00));
+				break;
+		}
+	}
+	return entry;
+}
+
+static void init_templates(void){
+	unsigned int i, j;
+	uint16_t eth_types[] = {0x0800, 0x86dd, 0x0806, 0x8100};
+	uint8_t bytes[] = {0x00, 0x01, 0x06, 0x11, 0xff};
+
+	for(i=0;i<NUM_OF_TEMPLATES;i++){
+		templates[i][0] = eth_types[i%4] >> 8;
+		templates[i][1] = eth_types[i%4] & 0xFF;
+		for(j=2;j<16;j++)
+			templates[i][j] = bytes[rand()%5];
+	}
+}
+
+//Number of lookups not matching the reference
+static unsigned int check_lookups(datapacket_t* pkt, unsigned int num_of_entries, unsigned int* hits){
+	unsigned int i, errors = 0;
+	of1x_flow_entry_t* entry;
+
+	for(i=0;i<1000;i++){
+		set_pkt(pkt, rand()%NUM_OF_TEMPLATES);
+		entry = trie_lookup(pkt);
+		if(entry != ref_lookup(pkt, num_of_entries))
+			errors++;
+		if(entry && hits)
+			(*hits)++;
+	}
+	return errors;
+}
+
+void test_lookups(){
+
+	unsigned int i, errors = 0, hits = 0;
+	of1x_flow_entry_t* entry;
+	datapacket_t pkt;
+
+	clean_all();
+	CU_ASSERT(trie->pool == NULL);
+	memset(&pkt, 0, sizeof(pkt));
+
+	init_templates();
+
+	//Unique priorities; entries partially match one of the templates
+	for(i=0;i<NUM_LOOKUP_ENTRIES;i++){
+		entry = init_lookup_entry(i+1, rand());
+		lookup_entries[i] = entry;
+		CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+	}
+	CU_ASSERT(table->num_of_entries == NUM_LOOKUP_ENTRIES);
+	CU_ASSERT(trie->pool != NULL);
+	CU_ASSERT(((uintptr_t)trie->pool->nodes % OF1X_TRIE_CACHE_LINE_SIZE) == 0);
+
+	for(i=0;i<5;i++)
+		errors += check_lookups(&pkt, NUM_LOOKUP_ENTRIES, &hits);
+	CU_ASSERT(errors == 0);
+	CU_ASSERT(hits > 0);
+
+	clean_all();
+	CU_ASSERT(trie->pool == NULL);
+	set_pkt(&pkt, 0);
+	CU_ASSERT(trie_lookup(&pkt) == NULL);
+}
+
+void test_lazy_pool(){
+
+	unsigned int i, j, num_of_entries, errors = 0;
+	unsigned int seeds[NUM_LOOKUP_ENTRIES];
+	of1x_flow_entry_t* entry;
+	of1x_trie_pool_t* pool;
+	datapacket_t pkt;
+
+	clean_all();
+	memset(&pkt, 0, sizeof(pkt));
+	init_templates();
+
+	//Adds are looked up from the side array; the pool is only recompiled when it is full
+	for(i=0;i<NUM_LOOKUP_ENTRIES;i++){
+		seeds[i] = rand();
+		entry = init_lookup_entry(i+1, seeds[i]);
+		lookup_entries[i] = entry;
+		CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+		CU_ASSERT(trie->num_of_side_entries == (i%OF1X_TRIE_MAX_SIDE_ENTRIES)+1);
+		if(i%10 == 0)
+			errors += check_lookups(&pkt, i+1, NULL);
+	}
+	CU_ASSERT(errors == 0);
+	CU_ASSERT(trie->dirty == true);
+
+	//Overwrites and removals patch the pool in place
+	pool = trie->pool;
+	CU_ASSERT(pool != NULL);
+
+	for(i=0;i<NUM_LOOKUP_ENTRIES;i+=5){
+		entry = init_lookup_entry(i+1, seeds[i]);
+		lookup_entries[i] = entry;
+		CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+	}
+	CU_ASSERT(table->num_of_entries == NUM_LOOKUP_ENTRIES);
+	CU_ASSERT(check_lookups(&pkt, NUM_LOOKUP_ENTRIES, NULL) == 0);
+
+	for(i=0, num_of_entries=0;i<NUM_LOOKUP_ENTRIES;i++){
+		if(i%3 == 0 || i == NUM_LOOKUP_ENTRIES-1){
+			CU_ASSERT(__of1x_remove_specific_flow_entry_table(&sw->pipeline, 0, lookup_entries[i], OF1X_FLOW_REMOVE_NO_REASON, MUTEX_NOT_ACQUIRED) == ROFL_OF1X_FM_SUCCESS);
+			continue;
+		}
+		lookup_entries[num_of_entries++] = lookup_entries[i];
+	}
+	CU_ASSERT(table->num_of_entries == num_of_entries);
+	CU_ASSERT(trie->pool == pool);
+	CU_ASSERT(check_lookups(&pkt, num_of_entries, NULL) == 0);
+
+	//Maintenance
+	CU_ASSERT(of1x_rebuild_trie(table) == ROFL_SUCCESS);
+	CU_ASSERT(trie->num_of_side_entries == 0);
+	CU_ASSERT(trie->dirty == false);
+	CU_ASSERT(check_lookups(&pkt, num_of_entries, NULL) == 0);
+
+	//Unchanged
+	pool = trie->pool;
+	CU_ASSERT(of1x_rebuild_trie(table) == ROFL_SUCCESS);
+	CU_ASSERT(trie->pool == pool);
+
+	//Emptied table releases the pool
+	for(j=0;j<num_of_entries;j++)
+		CU_ASSERT(__of1x_remove_specific_flow_entry_table(&sw->pipeline, 0, lookup_entries[j], OF1X_FLOW_REMOVE_NO_REASON, MUTEX_NOT_ACQUIRED) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(table->num_of_entries == 0);
+	CU_ASSERT(trie->pool == NULL);
+	CU_ASSERT(trie_lookup(&pkt) == NULL);
+}
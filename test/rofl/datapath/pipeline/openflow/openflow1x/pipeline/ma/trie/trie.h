@@ -26,5 +26,8 @@ void test_many_entries(void);
 void test_regressions(void);
 void test_regression1(void);
 void test_regression2(void);
+void test_lookups(void);
+void test_lazy_pool(void);
+void test_flow_stats_iter(void);
 
 #endif
@@ -30,7 +30,10 @@ int main(int args, char** argv){
 	(NULL == CU_add_test(pSuite, "Trie: test many entries", test_many_entries)) ||
 	(NULL == CU_add_test(pSuite, "Trie: test regressions", test_regressions)) ||
 	(NULL == CU_add_test(pSuite, "Trie: test regressions 1", test_regression1)) ||
-	(NULL == CU_add_test(pSuite, "Trie: test regressions 2", test_regression2)) //||
+	(NULL == CU_add_test(pSuite, "Trie: test regressions 2", test_regression2)) ||
+	(NULL == CU_add_test(pSuite, "Trie: test lookups", test_lookups)) ||
+	(NULL == CU_add_test(pSuite, "Trie: test lazy pool compilation", test_lazy_pool)) ||
+	(NULL == CU_add_test(pSuite, "Trie: test flow stats iterator", test_flow_stats_iter)) //||
 		)
 	{
 		fprintf(stderr,"ERROR WHILE ADDING TEST\n");
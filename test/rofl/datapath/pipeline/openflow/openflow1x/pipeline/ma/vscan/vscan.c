@@ -0,0 +1,227 @@
+#include "vscan.h"
+#include "rofl/datapath/pipeline/common/endianness.h"
+#include "rofl/datapath/pipeline/openflow/openflow1x/pipeline/matching_algorithms/vscan/of1x_vscan_ma_pp.h"
+
+#define NUM_OF_TEMPLATES 16
+
+static of1x_switch_t* sw = NULL;
+static of1x_flow_table_t* table = NULL;
+static datapacket_t pkt;
+
+//Packet templates
+static uint8_t templates[NUM_OF_TEMPLATES][16];
+
+//tmp val (all the packet getters of the empty packet point to it)
+extern uint128__t tmp_val;
+
+int set_up(){
+
+	unsigned int i, j;
+	uint16_t eth_types[] = {0x0800, 0x86dd, 0x0806, 0x8847};
+	uint8_t bytes[] = {0x00, 0x01, 0x06, 0x11, 0xff};
+
+	physical_switch_init();
+
+	enum of1x_matching_algorithm_available ma_list[4]={of1x_vscan_matching_algorithm, of1x_vscan_matching_algorithm,
+	of1x_vscan_matching_algorithm, of1x_vscan_matching_algorithm};
+
+	//Create instance
+	sw = of1x_init_switch("Test switch", OF_VERSION_12, 0x0101,4,ma_list);
+
+	if(!sw)
+		return EXIT_FAILURE;
+
+	table = &sw->pipeline.tables[0];
+
+	//Generate the packet templates (eth_type + random bytes from a small set)
+	for(i=0;i<NUM_OF_TEMPLATES;i++){
+		templates[i][0] = eth_types[i%4] >> 8;
+		templates[i][1] = eth_types[i%4] & 0xFF;
+		for(j=2;j<16;j++)
+			templates[i][j] = bytes[rand()%5];
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int tear_down(){
+	//Destroy the switch
+	if(__of1x_destroy_switch(sw) != ROFL_SUCCESS)
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
+
+static void clean_all(){
+	of1x_flow_entry_t *entry = of1x_init_flow_entry(false);
+	CU_ASSERT(entry != NULL);
+
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, false, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(table->num_of_entries == 0);
+
+	//Removals are compacted during the maintenance
+	CU_ASSERT(of1x_compact_vscan(table) == ROFL_SUCCESS);
+}
+
+static void set_pkt(unsigned int t){
+	memcpy(&tmp_val, templates[t], sizeof(tmp_val));
+	pkt.__metadata = rand()%2;
+
+	//Packet contents changed
+	__of1x_invalidate_packet_key(&pkt);
+}
+
+//Reference lookup (table order)
+static of1x_flow_entry_t* ref_lookup(){
+	of1x_flow_entry_t* entry;
+	of1x_match_t* it;
+
+	for(entry = table->entries; entry; entry = entry->next){
+		for(it = entry->matches.head; it; it = it->next){
+			if(!__of1x_check_match(&pkt, it))
+				break;
+		}
+		if(!it)
+			return entry;
+	}
+	return NULL;
+}
+
+static of1x_flow_entry_t* vscan_lookup(){
+	of1x_flow_entry_t* entry = of1x_find_best_match_vscan_ma(table, &pkt);
+
+#ifndef ROFL_PIPELINE_LOCKLESS
+	if(entry)
+		platform_rwlock_rdunlock(entry->rwlock);
+#endif
+	return entry;
+}
+
+//Compare against the reference over a random set of packets
+static void check_lookups(unsigned int num_of_pkts){
+	unsigned int i, errors = 0, hits = 0;
+	of1x_flow_entry_t* entry;
+
+	for(i=0;i<num_of_pkts;i++){
+		set_pkt(rand()%NUM_OF_TEMPLATES);
+		entry = vscan_lookup();
+		if(entry != ref_lookup())
+			errors++;
+		if(entry)
+			hits++;
+	}
+	CU_ASSERT(errors == 0);
+	CU_ASSERT(table->num_of_entries == 0 || hits > 0);
+}
+
+//Adds an entry matching (partially) one of the templates
+static void add_random_entry(){
+	unsigned int i, num_of_matches;
+	uint8_t* t = templates[rand()%NUM_OF_TEMPLATES];
+	of1x_flow_entry_t* entry = of1x_init_flow_entry(false);
+	CU_ASSERT(entry != NULL);
+
+	//Catch-all like entries get lower priorities
+	entry->priority = rand()%32;
+	num_of_matches = 1 + rand()%2;
+
+	//Always scoped to the eth_type of the template
+	of1x_add_match_to_entry(entry, of1x_init_eth_type_match(NTOHB16(*(uint16_t*)t)));
+
+	for(i=0;i<num_of_matches;i++){
+		switch(rand()%10){
+			case 0:
+			case 1: of1x_add_match_to_entry(entry, of1x_init_port_in_match(*(uint32_t*)t));
+				entry->priority |= 0x20;
+				break;
+			case 2: of1x_add_match_to_entry(entry, of1x_init_ip4_src_match(NTOHB32(*(uint32_t*)t), 0xFFFFFFFF << (rand()%17)));
+				entry->priority |= 0x20;
+				break;
+			case 3: of1x_add_match_to_entry(entry, of1x_init_ip4_dst_match(NTOHB32(*(uint32_t*)t), 0xFFFFFFFF << (rand()%17)));
+				entry->priority |= 0x20;
+				break;
+			case 4: of1x_add_match_to_entry(entry, of1x_init_ip_proto_match(t[0]));
+				entry->priority |= 0x20;
+				break;
+			case 5: of1x_add_match_to_entry(entry, of1x_init_arp_spa_match(NTOHB32(*(uint32_t*)t), 0xFFFF0000));
+				entry->priority |= 0x20;
+				break;
+			case 6: of1x_add_match_to_entry(entry, of1x_init_metadata_match(rand()%2, 0x1));
+				break;
+			case 7: of1x_add_match_to_entry(entry, of1x_init_vlan_vid_match(0, 0, (rand()%2)? OF1X_MATCH_VLAN_NONE : OF1X_MATCH_VLAN_ANY));
+				break;
+			case 8: of1x_add_match_to_entry(entry, of1x_init_ip_dscp_match(0));
+				break;
+			default:
+				//Not part of the key (full verification)
+				of1x_add_match_to_entry(entry, of1x_init_mpls_label_match(rand()%2));
+				entry->priority |= 0x20;
+				break;
+		}
+	}
+
+	CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+}
+
+void test_install_flowmods(){
+
+	unsigned int i;
+	vscan_state_t* state = (vscan_state_t*)table->matching_aux[0];
+
+	clean_all();
+	CU_ASSERT(state->vectors == NULL);
+	check_lookups(100);
+
+	for(i=0;i<40;i++)
+		add_random_entry();
+
+	CU_ASSERT(state->vectors != NULL);
+	CU_ASSERT(state->vectors->num_of_entries == table->num_of_entries);
+	CU_ASSERT(state->vectors->num_of_blocks == 1);
+	CU_ASSERT(state->vectors->words[0] == VSCAN_W_FLAGS);
+	CU_ASSERT(((uintptr_t)state->vectors->values % VSCAN_CACHE_LINE_SIZE) == 0);
+	CU_ASSERT(((uintptr_t)state->vectors->masks % VSCAN_CACHE_LINE_SIZE) == 0);
+	check_lookups(5000);
+}
+
+void test_multiple_blocks(){
+
+	unsigned int i;
+	vscan_state_t* state = (vscan_state_t*)table->matching_aux[0];
+
+	for(i=0;i<1000;i++)
+		add_random_entry();
+
+	CU_ASSERT(state->vectors->num_of_entries == table->num_of_entries);
+	CU_ASSERT(state->vectors->num_of_blocks == (table->num_of_entries+VSCAN_BLOCK_SIZE-1)/VSCAN_BLOCK_SIZE);
+	check_lookups(5000);
+}
+
+void test_remove_entries(){
+
+	unsigned int i, num_of_entries;
+	of1x_flow_entry_t* entry;
+	vscan_state_t* state = (vscan_state_t*)table->matching_aux[0];
+
+	//Remove some (non-strict)
+	num_of_entries = table->num_of_entries;
+	for(i=0;i<2;i++){
+		entry = of1x_init_flow_entry(false);
+		CU_ASSERT(of1x_add_match_to_entry(entry,of1x_init_eth_type_match(NTOHB16(*(uint16_t*)templates[rand()%NUM_OF_TEMPLATES]))) == ROFL_SUCCESS);
+		CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+		of1x_destroy_flow_entry(entry);
+	}
+	//Removed entries are only invalidated in the vectors
+	CU_ASSERT(table->num_of_entries == num_of_entries || state->dirty);
+	check_lookups(5000);
+
+	CU_ASSERT(of1x_compact_vscan(table) == ROFL_SUCCESS);
+	CU_ASSERT(!state->dirty);
+	CU_ASSERT(table->num_of_entries == 0 || state->vectors->num_of_entries == table->num_of_entries);
+	check_lookups(5000);
+
+	clean_all();
+	CU_ASSERT(state->vectors == NULL);
+	set_pkt(0);
+	CU_ASSERT(vscan_lookup() == NULL);
+}
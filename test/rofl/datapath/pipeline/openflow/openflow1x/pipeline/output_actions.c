@@ -1,7 +1,13 @@
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include "CUnit/Basic.h"
 #include "output_actions.h"
+#include "rofl/datapath/pipeline/openflow/openflow1x/pipeline/of1x_checksum_pp.h"
+#include "rofl/datapath/pipeline/openflow/openflow1x/pipeline/of1x_action_pp.h"
+#include "rofl/datapath/pipeline/openflow/openflow1x/pipeline/of1x_instruction_pp.h"
+#include "rofl/datapath/pipeline/openflow/openflow1x/pipeline/of1x_match_pp.h"
+#include "rofl/datapath/pipeline/openflow/openflow1x/pipeline/of1x_pipeline_pp.h"
 
 of1x_switch_t *sw=NULL;
 unsigned int port=2;
@@ -314,3 +320,344 @@ void oa_apply_and_group(void){
 	oa_tear_down();
 }
 
+
+void oa_compiled_actions(void){
+	of1x_action_group_t* ag;
+	oa_set_up();
+	wrap_uint_t field={0}; field.u32 = port;
+	wrap_uint_t field_flood={0}; field_flood.u32 = OF1X_PORT_FLOOD;
+	wrap_uint_t field_ctl={0}; field_ctl.u32 = OF1X_PORT_CONTROLLER;
+
+	of1x_push_packet_action_to_group(apply_actions,of1x_init_packet_action(OF1X_AT_DEC_NW_TTL,field,0x0));
+	of1x_push_packet_action_to_group(apply_actions,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	of1x_push_packet_action_to_group(apply_actions,of1x_init_packet_action(OF1X_AT_OUTPUT,field_flood,0x0));
+	of1x_push_packet_action_to_group(apply_actions,of1x_init_packet_action(OF1X_AT_OUTPUT,field_ctl,128));
+	of1x_add_instruction_to_group(&entry->inst_grp,OF1X_IT_APPLY_ACTIONS,apply_actions,NULL,NULL,0);
+
+	//Not yet validated
+	CU_ASSERT(apply_actions->ops == NULL);
+
+	//insert flow entry
+	of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false, false);
+	CU_ASSERT(sw->pipeline.tables[0].entries != NULL);
+
+	//Contiguous copy of the action list, with the output destinations classified
+	ag = sw->pipeline.tables[0].entries->inst_grp.instructions[OF1X_IT_APPLY_ACTIONS].apply_actions;
+	CU_ASSERT(ag->ops != NULL);
+	CU_ASSERT(ag->num_of_ops == 4);
+	CU_ASSERT(ag->ops[0].type == OF1X_AT_DEC_NW_TTL && ag->ops[0].next == &ag->ops[1]);
+	CU_ASSERT(ag->ops[1].type == OF1X_AT_OUTPUT && ag->ops[1].__field.u32 == port);
+	CU_ASSERT(ag->ops[1].__output_dst == OF1X_OUTPUT_DST_PORT);
+	CU_ASSERT(ag->ops[2].__output_dst == OF1X_OUTPUT_DST_FLOOD);
+	CU_ASSERT(ag->ops[3].__output_dst == OF1X_OUTPUT_DST_CONTROLLER && ag->ops[3].send_len == 128);
+	CU_ASSERT(ag->ops[3].next == NULL);
+	CU_ASSERT(ag->num_of_output_actions == 3);
+
+	oa_tear_down();
+}
+
+//Validates the instructions of a new entry (validation is not idempotent) and returns its shape
+static of1x_instruction_shape_t oa_get_shape(of1x_pipeline_t* pipeline, of1x_flow_entry_t* e){
+	of1x_instruction_shape_t shape;
+
+	CU_ASSERT(__of1x_validate_instructions(&e->inst_grp, pipeline, 0) == ROFL_SUCCESS);
+	shape = e->inst_grp.shape;
+	of1x_destroy_flow_entry(e);
+
+	return shape;
+}
+
+void oa_instruction_shapes(void){
+	of1x_switch_t* sw2;
+	of1x_flow_entry_t* e;
+	of1x_action_group_t* ag;
+	of1x_write_metadata_t metadata = {0x1, 0xFF};
+	enum of1x_matching_algorithm_available ma_list[2]={of1x_loop_matching_algorithm, of1x_loop_matching_algorithm};
+	wrap_uint_t field={0}; field.u32 = port;
+	wrap_uint_t field_vid={0}; field_vid.u16 = 0x10;
+	oa_set_up();
+
+	//Drop (no instructions)
+	CU_ASSERT(oa_get_shape(&sw->pipeline, entry) == OF1X_IS_DROP);
+
+	//Set-field + output
+	e = of1x_init_flow_entry(false);
+	of1x_push_packet_action_to_group(apply_actions,of1x_init_packet_action(OF1X_AT_SET_FIELD_VLAN_VID,field_vid,0x0));
+	of1x_push_packet_action_to_group(apply_actions,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_APPLY_ACTIONS,apply_actions,NULL,NULL,0);
+	CU_ASSERT(oa_get_shape(&sw->pipeline, e) == OF1X_IS_APPLY);
+
+	//Pending write actions; generic
+	e = of1x_init_flow_entry(false);
+	ag = of1x_init_action_group(0);
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_APPLY_ACTIONS,ag,NULL,NULL,0);
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_WRITE_ACTIONS,NULL,write_actions,NULL,0);
+	CU_ASSERT(oa_get_shape(&sw->pipeline, e) == OF1X_IS_GENERIC);
+
+	//Removed instructions must not be accounted
+	e = of1x_init_flow_entry(false);
+	ag = of1x_init_action_group(0);
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_APPLY_ACTIONS,ag,NULL,NULL,0);
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_WRITE_ACTIONS,NULL,of1x_init_write_actions(),NULL,0);
+	of1x_remove_instruction_from_the_group(&e->inst_grp,OF1X_IT_WRITE_ACTIONS);
+	CU_ASSERT(e->inst_grp.instructions[OF1X_IT_WRITE_ACTIONS].type == OF1X_IT_NO_INSTRUCTION);
+	CU_ASSERT(oa_get_shape(&sw->pipeline, e) == OF1X_IS_APPLY);
+
+	//Multiple outputs; last one consumes the packet
+	e = of1x_init_flow_entry(false);
+	ag = of1x_init_action_group(0);
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_APPLY_ACTIONS,ag,NULL,NULL,0);
+	CU_ASSERT(oa_get_shape(&sw->pipeline, e) == OF1X_IS_APPLY_MULTI);
+
+	//Multiple outputs, not ending with an output; generic
+	e = of1x_init_flow_entry(false);
+	ag = of1x_init_action_group(0);
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_SET_FIELD_VLAN_VID,field_vid,0x0));
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_APPLY_ACTIONS,ag,NULL,NULL,0);
+	CU_ASSERT(oa_get_shape(&sw->pipeline, e) == OF1X_IS_GENERIC);
+
+	//Goto shapes need a second table
+	sw2 = of1x_init_switch("Test switch 2", OF_VERSION_12, 0x0102,2,ma_list);
+	CU_ASSERT(sw2 != NULL);
+
+	//Goto only
+	e = of1x_init_flow_entry(false);
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_GOTO_TABLE,NULL,NULL,NULL,1);
+	CU_ASSERT(oa_get_shape(&sw2->pipeline, e) == OF1X_IS_GOTO);
+
+	//Write-metadata + goto
+	e = of1x_init_flow_entry(false);
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_WRITE_METADATA,NULL,NULL,&metadata,0);
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_GOTO_TABLE,NULL,NULL,NULL,1);
+	CU_ASSERT(oa_get_shape(&sw2->pipeline, e) == OF1X_IS_METADATA_GOTO);
+
+	__of1x_destroy_switch(sw2);
+	oa_tear_down();
+}
+
+//Full checksum (RFC 1071) of a buffer of 16 bit words
+static uint16_t oa_checksum(const uint16_t* words, unsigned int num_of_words){
+	uint32_t sum = 0;
+	unsigned int i;
+
+	for(i=0;i<num_of_words;i++)
+		sum += words[i];
+	return ~of1x_checksum_fold(sum);
+}
+
+void oa_incremental_checksums(void){
+	//IPv4 header (checksum at word 5) followed by the TCP ports
+	uint8_t hdr[24] = {0x45, 0x00, 0x00, 0x3c, 0x1c, 0x46, 0x40, 0x00, 0x40, 0x06, 0x00, 0x00,
+				0xac, 0x10, 0x0a, 0x63, 0xac, 0x10, 0x0a, 0x0c, 0x04, 0x00, 0x00, 0x50};
+	uint16_t* words = (uint16_t*)hdr;
+	uint16_t tp_csum, old_tp_csum;
+	uint32_t ip_src;
+	datapacket_t pkt;
+
+	words[5] = oa_checksum(words, 10);
+	CU_ASSERT(oa_checksum(words, 10) == 0x0);
+
+	//Pseudo-header checksum like (addresses + ports)
+	tp_csum = old_tp_csum = oa_checksum(&words[6], 6);
+
+	__of1x_init_checksum_deltas(&pkt);
+
+	//NAT like rewrite: ip src, tos, ttl decrement and src port
+	memcpy(&ip_src, &hdr[12], sizeof(ip_src));
+	__of1x_checksum_delta32(&pkt.checksum.of1x.l3, ip_src, HTONB32(0xc0a80001));
+	__of1x_checksum_delta32(&pkt.checksum.of1x.l4, ip_src, HTONB32(0xc0a80001));
+	ip_src = HTONB32(0xc0a80001);
+	memcpy(&hdr[12], &ip_src, sizeof(ip_src));
+
+	__of1x_checksum_delta16(&pkt.checksum.of1x.l3, HTONB16(0x00), HTONB16(0xb8));
+	hdr[1] = 0xb8;
+
+	__of1x_checksum_delta16(&pkt.checksum.of1x.l3, HTONB16(0x0100), 0x0);
+	hdr[8]--;
+
+	__of1x_checksum_delta16(&pkt.checksum.of1x.l4, words[10], HTONB16(0xFFFF));
+	words[10] = HTONB16(0xFFFF);
+
+	//Apply once
+	words[5] = of1x_checksum_apply_delta(words[5], of1x_checksum_fold(pkt.checksum.of1x.l3));
+	tp_csum = of1x_checksum_apply_delta(tp_csum, of1x_checksum_fold(pkt.checksum.of1x.l4));
+
+	CU_ASSERT(oa_checksum(words, 10) == 0x0);
+	CU_ASSERT(tp_csum != old_tp_csum);
+	CU_ASSERT(tp_csum == oa_checksum(&words[6], 6));
+}
+
+void oa_deferred_set_fields(void){
+	datapacket_t pkt;
+	of1x_packet_action_t* action;
+	of1x_match_t* match;
+	wrap_uint_t field={0}; field.u64 = 0x0000AABBCCDDEEFFULL;
+	oa_set_up();
+
+	memset(&pkt, 0, sizeof(pkt));
+	__of1x_invalidate_packet_key(&pkt);
+
+	action = of1x_init_packet_action(OF1X_AT_SET_FIELD_ETH_DST, field, 0x0);
+	match = of1x_init_eth_dst_match(0x0000AABBCCDDEEFFULL, 0x0000FFFFFFFFFFFFULL);
+	CU_ASSERT(action != NULL && match != NULL);
+
+	__of1x_process_packet_action(0, sw, 0, &pkt, action, false, NULL);
+
+#ifdef ROFL_PIPELINE_DEFERRED_SET_FIELDS
+	//Shadowed in the key, not yet written back
+	CU_ASSERT(pkt.key.of1x.dirty == OF1X_PKT_KEY_F_ETH_DST);
+	CU_ASSERT(pkt.key.of1x.eth_dst == action->__field.u64);
+
+	//Matches (subsequent tables) see the new value
+	CU_ASSERT(__of1x_check_match(&pkt, match));
+
+	//Written back before the packet is mangled otherwise
+	field.u16 = 0x8100;
+	of1x_destroy_packet_action(action);
+	action = of1x_init_packet_action(OF1X_AT_PUSH_VLAN, field, 0x0);
+	__of1x_process_packet_action(0, sw, 0, &pkt, action, false, NULL);
+	CU_ASSERT(pkt.key.of1x.dirty == 0x0ULL);
+	CU_ASSERT(pkt.key.of1x.layers == 0x0);
+#else
+	CU_ASSERT(pkt.key.of1x.dirty == 0x0ULL);
+#endif
+
+	of1x_destroy_packet_action(action);
+	of1x_destroy_match(match);
+	oa_tear_down();
+}
+
+//Experimenter handlers
+static unsigned int oa_exp_calls = 0;
+static uint64_t oa_exp_arg = 0x0;
+
+static rofl_result_t oa_exp_validate(const of1x_packet_action_t* action){
+	//Argument 0 is not valid
+	return (action->__field.u64 == 0x0)? ROFL_FAILURE : ROFL_SUCCESS;
+}
+static void oa_exp_process(const unsigned int tid, const struct of1x_switch* sw, const unsigned int table_id, datapacket_t* pkt, const of1x_packet_action_t* action){
+	oa_exp_calls++;
+	oa_exp_arg = action->__field.u64;
+}
+static void oa_exp_inst_process(const unsigned int tid, const struct of1x_switch* sw, const unsigned int table_id, datapacket_t* pkt, const of1x_instruction_t* inst){
+	oa_exp_calls++;
+	oa_exp_arg = inst->exp_field.u64;
+}
+
+void oa_experimenter(void){
+	datapacket_t pkt;
+	of1x_flow_entry_t* e;
+	of1x_action_group_t* ag;
+	wrap_uint_t field={0};
+	of1x_experimenter_action_t action_handler = {0x1234, 0x1, oa_exp_validate, oa_exp_process};
+	of1x_experimenter_instruction_t inst_handler = {0x1234, 0x2, NULL, oa_exp_inst_process};
+	oa_set_up();
+
+	memset(&pkt, 0, sizeof(pkt));
+	__of1x_init_packet_write_actions(&pkt.write_actions.of1x);
+	__of1x_invalidate_packet_key(&pkt);
+
+	//Not registered
+	field.u64 = 0x7;
+	e = of1x_init_flow_entry(false);
+	ag = of1x_init_action_group(0);
+	of1x_push_packet_action_to_group(ag,of1x_init_experimenter_action(0x1234,0x1,field));
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_APPLY_ACTIONS,ag,NULL,NULL,0);
+	CU_ASSERT(__of1x_validate_instructions(&e->inst_grp, &sw->pipeline, 0) == ROFL_FAILURE);
+	of1x_destroy_flow_entry(e);
+
+	//Never validated; skipped
+	ag = of1x_init_action_group(0);
+	of1x_push_packet_action_to_group(ag,of1x_init_experimenter_action(0x1234,0x1,field));
+	__of1x_process_packet_action(0, sw, 0, &pkt, ag->head, false, NULL);
+	CU_ASSERT(oa_exp_calls == 0);
+	of1x_destroy_action_group(ag);
+
+	//Valid packet-out; size cached by a previous pipeline run is dropped
+	ag = of1x_init_action_group(0);
+	field.u64 = 0;
+	field.u32 = port;
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	pkt.__size_bytes = 1500;
+	of1x_process_packet_out_pipeline(0, sw, &pkt, ag);
+	CU_ASSERT(pkt.__size_bytes == 0);
+	of1x_destroy_action_group(ag);
+
+	//Packet-out failing validation; dropped
+	ag = of1x_init_action_group(0);
+	field.u64 = 0;
+	field.u32 = port;
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	field.u64 = 0x7;
+	of1x_push_packet_action_to_group(ag,of1x_init_experimenter_action(0x1234,0x1,field));
+	of1x_process_packet_out_pipeline(0, sw, &pkt, ag);
+	CU_ASSERT(oa_exp_calls == 0);
+	of1x_destroy_action_group(ag);
+
+	//Register
+	CU_ASSERT(of1x_register_experimenter_action(&action_handler) == ROFL_SUCCESS);
+	CU_ASSERT(of1x_register_experimenter_action(&action_handler) == ROFL_FAILURE);
+
+	//Handler is stored in the compiled action
+	e = of1x_init_flow_entry(false);
+	ag = of1x_init_action_group(0);
+	of1x_push_packet_action_to_group(ag,of1x_init_experimenter_action(0x1234,0x1,field));
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_APPLY_ACTIONS,ag,NULL,NULL,0);
+	CU_ASSERT(__of1x_validate_instructions(&e->inst_grp, &sw->pipeline, 0) == ROFL_SUCCESS);
+	CU_ASSERT(ag->ops != NULL && ag->ops[0].__exp_fn == oa_exp_process);
+
+	__of1x_process_instructions(0, sw, 0, &pkt, &e->inst_grp);
+	CU_ASSERT(oa_exp_calls == 1);
+	CU_ASSERT(oa_exp_arg == 0x7);
+	of1x_destroy_flow_entry(e);
+
+	//Rejected by the validate hook
+	field.u64 = 0x0;
+	e = of1x_init_flow_entry(false);
+	ag = of1x_init_action_group(0);
+	of1x_push_packet_action_to_group(ag,of1x_init_experimenter_action(0x1234,0x1,field));
+	of1x_add_instruction_to_group(&e->inst_grp,OF1X_IT_APPLY_ACTIONS,ag,NULL,NULL,0);
+	CU_ASSERT(__of1x_validate_instructions(&e->inst_grp, &sw->pipeline, 0) == ROFL_FAILURE);
+	of1x_destroy_flow_entry(e);
+
+	//Instruction
+	field.u64 = 0x9;
+	e = of1x_init_flow_entry(false);
+	of1x_add_experimenter_instruction_to_group(&e->inst_grp, 0x1234, 0x2, field);
+	CU_ASSERT(__of1x_validate_instructions(&e->inst_grp, &sw->pipeline, 0) == ROFL_FAILURE);
+	CU_ASSERT(of1x_register_experimenter_instruction(&inst_handler) == ROFL_SUCCESS);
+	CU_ASSERT(__of1x_validate_instructions(&e->inst_grp, &sw->pipeline, 0) == ROFL_SUCCESS);
+	CU_ASSERT(e->inst_grp.shape == OF1X_IS_GENERIC);
+
+	__of1x_process_instructions(0, sw, 0, &pkt, &e->inst_grp);
+	CU_ASSERT(oa_exp_calls == 2);
+	CU_ASSERT(oa_exp_arg == 0x9);
+	of1x_destroy_flow_entry(e);
+
+	//Packet-out; processed from the action list (not compiled)
+	ag = of1x_init_action_group(0);
+	field.u64 = 0;
+	field.u32 = port;
+	of1x_push_packet_action_to_group(ag,of1x_init_packet_action(OF1X_AT_OUTPUT,field,0x0));
+	field.u64 = 0x5;
+	of1x_push_packet_action_to_group(ag,of1x_init_experimenter_action(0x1234,0x1,field));
+	of1x_process_packet_out_pipeline(0, sw, &pkt, ag);
+	CU_ASSERT(ag->ops == NULL);
+	CU_ASSERT(oa_exp_calls == 3);
+	CU_ASSERT(oa_exp_arg == 0x5);
+	of1x_destroy_action_group(ag);
+
+	//Unregister
+	CU_ASSERT(of1x_unregister_experimenter_action(0x1234,0x1) == ROFL_SUCCESS);
+	CU_ASSERT(of1x_unregister_experimenter_action(0x1234,0x1) == ROFL_FAILURE);
+	CU_ASSERT(of1x_unregister_experimenter_instruction(0x1234,0x2) == ROFL_SUCCESS);
+	CU_ASSERT(__of1x_get_experimenter_instruction(0x1234,0x2) == NULL);
+
+	oa_tear_down();
+}
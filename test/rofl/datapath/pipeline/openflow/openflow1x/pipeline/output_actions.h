@@ -22,6 +22,11 @@ void oa_two_outputs_apply(void);
 void oa_two_outputs_write(void);
 void oa_write_and_group(void);
 void oa_apply_and_group(void);
+void oa_compiled_actions(void);
+void oa_instruction_shapes(void);
+void oa_incremental_checksums(void);
+void oa_deferred_set_fields(void);
+void oa_experimenter(void);
 
 
 
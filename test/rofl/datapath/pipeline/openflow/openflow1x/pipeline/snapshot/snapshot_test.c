@@ -0,0 +1,113 @@
+#include "snapshot_test.h"
+
+static of1x_switch_t* sw=NULL;
+	
+int set_up(){
+
+	physical_switch_init();
+
+	enum of1x_matching_algorithm_available ma_list[4]={of1x_loop_matching_algorithm, of1x_loop_matching_algorithm,
+	of1x_loop_matching_algorithm, of1x_loop_matching_algorithm};
+
+	//Create instance	
+	sw = of1x_init_switch("Test switch", OF_VERSION_12, 0x0101,4,ma_list);
+	
+	if(!sw)
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
+
+int tear_down(){
+	//Destroy the switch
+	if(__of1x_destroy_switch(sw) != ROFL_SUCCESS)
+		return EXIT_FAILURE;
+	
+	return EXIT_SUCCESS;
+}
+
+void test_delta_snapshot(){
+
+	unsigned int port_num;
+	uint64_t lookups;
+	of1x_flow_entry_t* entry;
+	of1x_bucket_list_t* buckets;
+	switch_port_t* port1 = switch_port_init("port1", true, PORT_TYPE_VIRTUAL, PORT_STATE_NONE);
+	switch_port_t* port2 = switch_port_init("port2", true, PORT_TYPE_VIRTUAL, PORT_STATE_NONE);
+	of1x_switch_snapshot_t *base, *sn, *sn2;
+
+	CU_ASSERT(port1 != NULL && port2 != NULL);
+	CU_ASSERT(__of1x_attach_port_to_switch(sw, port1, &port_num) == ROFL_SUCCESS);
+	CU_ASSERT(__of1x_attach_port_to_switch(sw, port2, &port_num) == ROFL_SUCCESS);
+
+	//Full snapshot
+	base = __of1x_switch_get_delta_snapshot(sw, NULL);
+	CU_ASSERT(base != NULL);
+	CU_ASSERT(base->revision == sw->revision);
+	CU_ASSERT(base->logical_ports[1].port != NULL && base->logical_ports[2].port != NULL);
+
+	//Nothing changed; everything shared
+	sn = __of1x_switch_get_delta_snapshot(sw, base);
+	CU_ASSERT(sn != NULL);
+	CU_ASSERT(sn->logical_ports[1].port == base->logical_ports[1].port);
+	CU_ASSERT(sn->logical_ports[2].port == base->logical_ports[2].port);
+	CU_ASSERT(sn->pipeline.tables == base->pipeline.tables);
+	CU_ASSERT(sn->pipeline.groups == base->pipeline.groups);
+
+	//Port 2 and table 0 changed (table 1 only its counters)
+	switch_port_set_current_speed(port2, PORT_FEATURE_10GB_FD);
+	entry = of1x_init_flow_entry(false);
+	of1x_add_match_to_entry(entry,of1x_init_port_in_match(1));
+	CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+	lookups = base->pipeline.tables[1].stats.s.counters.lookup_count;
+	sw->pipeline.tables[1].stats.s.__internal[0].lookup_count += 10;
+	sw->pipeline.tables[0].stats.s.__internal[0].lookup_count += 10;
+
+	sn2 = __of1x_switch_get_delta_snapshot(sw, sn);
+	CU_ASSERT(sn2 != NULL);
+	CU_ASSERT(sn2->logical_ports[1].port == base->logical_ports[1].port);
+	CU_ASSERT(sn2->logical_ports[2].port != base->logical_ports[2].port);
+	CU_ASSERT(sn2->logical_ports[2].port->curr_speed == PORT_FEATURE_10GB_FD);
+	CU_ASSERT(sn2->pipeline.tables != base->pipeline.tables);
+	CU_ASSERT(sn2->pipeline.tables[0].num_of_entries == sw->pipeline.tables[0].num_of_entries);
+	CU_ASSERT(sn2->pipeline.tables[0].stats.s.counters.lookup_count == base->pipeline.tables[0].stats.s.counters.lookup_count + 10);
+	CU_ASSERT(sn2->pipeline.tables[1].stats.s.counters.lookup_count == lookups); //Reused from base
+	CU_ASSERT(sn2->pipeline.groups == base->pipeline.groups);
+	sw->pipeline.tables[1].stats.s.__internal[0].lookup_count -= 10;
+	sw->pipeline.tables[0].stats.s.__internal[0].lookup_count -= 10;
+
+	//Shared parts outlive base
+	of_switch_destroy_snapshot((of_switch_snapshot_t*)base);
+	CU_ASSERT(sn->logical_ports[1].port->refs.refs == 2);
+	of_switch_destroy_snapshot((of_switch_snapshot_t*)sn);
+	CU_ASSERT(sn2->logical_ports[1].port->refs.refs == 1);
+	CU_ASSERT(strncmp(sn2->logical_ports[1].port->name, "port1", SWITCH_PORT_MAX_LEN_NAME) == 0);
+
+	//Port detachment; no port is shared
+	CU_ASSERT(__of1x_detach_port_from_switch(sw, port1) == ROFL_SUCCESS);
+	sn = __of1x_switch_get_delta_snapshot(sw, sn2);
+	CU_ASSERT(sn->logical_ports[1].port == NULL);
+	CU_ASSERT(sn->logical_ports[2].port != sn2->logical_ports[2].port);
+	CU_ASSERT(sn->pipeline.tables == sn2->pipeline.tables);
+	CU_ASSERT(sn->pipeline.groups == sn2->pipeline.groups);
+	of_switch_destroy_snapshot((of_switch_snapshot_t*)sn2);
+
+	//Group table changed; not shared
+	buckets = of1x_init_bucket_list();
+	CU_ASSERT(of1x_group_add(sw->pipeline.groups, OF1X_GROUP_TYPE_ALL, 1, &buckets) == ROFL_OF1X_GM_SUCCESS);
+	sn2 = __of1x_switch_get_delta_snapshot(sw, sn);
+	CU_ASSERT(sn2->pipeline.tables == sn->pipeline.tables);
+	CU_ASSERT(sn2->pipeline.groups != sn->pipeline.groups);
+	CU_ASSERT(sn2->pipeline.groups->num_of_entries == 1);
+	CU_ASSERT(of1x_group_delete(&sw->pipeline, sw->pipeline.groups, 1) == ROFL_OF1X_GM_SUCCESS);
+	of_switch_destroy_snapshot((of_switch_snapshot_t*)sn2);
+	of_switch_destroy_snapshot((of_switch_snapshot_t*)sn);
+
+	CU_ASSERT(__of1x_detach_port_from_switch(sw, port2) == ROFL_SUCCESS);
+	switch_port_destroy(port1);
+	switch_port_destroy(port2);
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+}
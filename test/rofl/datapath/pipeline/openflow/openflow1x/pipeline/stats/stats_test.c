@@ -0,0 +1,405 @@
+#include "stats_test.h"
+
+#define FLOW_STATS_ENTRIES 100
+
+static of1x_switch_t* sw=NULL;
+	
+int set_up(){
+
+	physical_switch_init();
+
+	enum of1x_matching_algorithm_available ma_list[4]={of1x_loop_matching_algorithm, of1x_trie_matching_algorithm,
+	of1x_loop_matching_algorithm, of1x_loop_matching_algorithm};
+
+	//Create instance	
+	sw = of1x_init_switch("Test switch", OF_VERSION_12, 0x0101,4,ma_list);
+	
+	if(!sw)
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
+
+int tear_down(){
+	//Destroy the switch
+	if(__of1x_destroy_switch(sw) != ROFL_SUCCESS)
+		return EXIT_FAILURE;
+	
+	return EXIT_SUCCESS;
+}
+
+//Set the counters of all the entries of table 0
+static void set_flow_counters(uint64_t packet_count){
+
+	of1x_flow_entry_t* it;
+
+	for(it=sw->pipeline.tables[0].entries;it;it=it->next){
+		it->stats.s.__internal[0].packet_count = packet_count;
+		it->stats.s.__internal[0].byte_count = packet_count*100;
+	}
+}
+
+void test_stats_service(){
+
+	int i;
+	unsigned int port_num;
+	of1x_flow_entry_t* entry;
+	of1x_stats_snapshot_t snapshot;
+	of1x_flow_table_t* table = &sw->pipeline.tables[0];
+	switch_port_t* port = switch_port_init("port1", true, PORT_TYPE_VIRTUAL, PORT_STATE_NONE);
+
+	CU_ASSERT(port != NULL);
+	CU_ASSERT(switch_port_add_queue(port, 1, "queue1", 128, 0, 0) == ROFL_SUCCESS);
+	CU_ASSERT(__of1x_attach_port_to_switch(sw, port, &port_num) == ROFL_SUCCESS);
+	port->stats.__internal[0].rx_packets = 10;
+	port->stats.__internal[1].rx_packets = 10;
+	port->stats.__internal[0].rx_bytes = 2000;
+	port->stats.__internal[1].tx_packets = 5;
+	port->queues[1].stats.__internal[1].tx_packets = 4;
+	port->queues[1].stats.__internal[1].tx_bytes = 400;
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+
+	for(i=0;i<FLOW_STATS_ENTRIES;i++){
+		entry = of1x_init_flow_entry(false);
+		entry->priority = i;
+		of1x_add_match_to_entry(entry,of1x_init_port_in_match(i));
+		CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+	}
+	set_flow_counters(10);
+	table->stats.s.__internal[0].lookup_count = 100;
+	table->stats.s.__internal[1].lookup_count = 100;
+	table->stats.s.__internal[0].matched_count = 50;
+
+	//Disabled
+	__of1x_stats_service_run(&sw->pipeline, 1000);
+	CU_ASSERT(of1x_stats_flow_get_snapshot(&table->entries->stats, &snapshot) == false);
+
+	CU_ASSERT(of1x_stats_service_enable(&sw->pipeline, 1000, 500) == ROFL_FAILURE);
+	CU_ASSERT(of1x_stats_service_enable(&sw->pipeline, 1000, 2000) == ROFL_SUCCESS);
+
+	__of1x_stats_service_run(&sw->pipeline, 1000);
+	CU_ASSERT(of1x_stats_flow_get_snapshot(&table->entries->stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_count == 10);
+	CU_ASSERT(snapshot.byte_count == 1000);
+	CU_ASSERT(snapshot.packet_rate == 0);
+	CU_ASSERT(snapshot.timestamp_ms == 1000);
+
+	CU_ASSERT(of1x_stats_table_get_snapshot(&table->stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_count == 200);
+	CU_ASSERT(snapshot.byte_count == 50);
+
+	CU_ASSERT(port_stats_get_rx_snapshot(&port->stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_count == 20);
+	CU_ASSERT(snapshot.byte_count == 2000);
+	CU_ASSERT(port_stats_get_tx_snapshot(&port->stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_count == 5);
+	CU_ASSERT(queue_stats_get_snapshot(&port->queues[0].stats, &snapshot) == false);
+	CU_ASSERT(queue_stats_get_snapshot(&port->queues[1].stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_count == 4);
+	CU_ASSERT(snapshot.byte_count == 400);
+
+	//Within the period; not published
+	set_flow_counters(30);
+	__of1x_stats_service_run(&sw->pipeline, 1500);
+	CU_ASSERT(of1x_stats_flow_get_snapshot(&table->entries->stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_count == 10);
+
+	//Window not over; counters only
+	__of1x_stats_service_run(&sw->pipeline, 2000);
+	CU_ASSERT(of1x_stats_flow_get_snapshot(&table->entries->stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_count == 30);
+	CU_ASSERT(snapshot.packet_rate == 0);
+
+	//Rates over the window (20 pkts, 2000 bytes in 2s)
+	set_flow_counters(50);
+	__of1x_stats_service_run(&sw->pipeline, 3000);
+	CU_ASSERT(of1x_stats_flow_get_snapshot(&table->entries->stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_count == 50);
+	CU_ASSERT(snapshot.packet_rate == 20);
+	CU_ASSERT(snapshot.byte_rate == 2000);
+	CU_ASSERT(snapshot.timestamp_ms == 3000);
+
+	//Port rates (20 pkts, 4000 bytes in 2s)
+	CU_ASSERT(port_stats_get_rx_snapshot(&port->stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_rate == 0);
+	port->stats.__internal[2].rx_packets = 20;
+	port->stats.__internal[2].rx_bytes = 4000;
+	port->queues[1].stats.__internal[0].tx_packets = 10;
+	__of1x_stats_service_run(&sw->pipeline, 5000);
+	CU_ASSERT(port_stats_get_rx_snapshot(&port->stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_count == 40);
+	CU_ASSERT(snapshot.packet_rate == 10);
+	CU_ASSERT(snapshot.byte_rate == 2000);
+	CU_ASSERT(queue_stats_get_snapshot(&port->queues[1].stats, &snapshot) == true);
+	CU_ASSERT(snapshot.packet_count == 14);
+
+	CU_ASSERT(of1x_stats_service_disable(&sw->pipeline) == ROFL_SUCCESS);
+	CU_ASSERT(__of1x_detach_port_from_switch(sw, port) == ROFL_SUCCESS);
+	switch_port_destroy(port);
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+}
+
+void test_port_stats(){
+
+	unsigned int tid;
+	switch_port_snapshot_t* sn;
+	switch_port_t* port = switch_port_init("port1", true, PORT_TYPE_VIRTUAL, PORT_STATE_NONE);
+
+	CU_ASSERT(port != NULL);
+	CU_ASSERT(port->stats.__internal != NULL);
+	CU_ASSERT(((uintptr_t)port->stats.__internal % ROFL_PIPELINE_CACHE_LINE_SIZE) == 0);
+	CU_ASSERT(sizeof(__port_stats_tid_t) % ROFL_PIPELINE_CACHE_LINE_SIZE == 0);
+	CU_ASSERT(switch_port_add_queue(port, 1, "queue1", 128, 0, 0) == ROFL_SUCCESS);
+
+	//Per thread updates (including the locked tid)
+	for(tid=0;tid<ROFL_PIPELINE_MAX_TIDS;tid++){
+		__port_stats_rx_update(tid, &port->stats, 100);
+		__port_stats_tx_update(tid, &port->stats, 200);
+		__port_stats_tx_update(tid, &port->stats, 200);
+		__port_stats_rx_dropped_update(tid, &port->stats);
+		__queue_stats_tx_update(tid, &port->queues[1].stats, 200);
+		__queue_stats_overrun_update(tid, &port->queues[1].stats);
+	}
+
+	//Platform updated counters are kept
+	port->stats.rx_packets = 10;
+	port->stats.collisions = 3;
+
+	//Consolidated in the snapshot
+	sn = __switch_port_get_snapshot(port);
+	CU_ASSERT(sn != NULL);
+	CU_ASSERT(sn->stats.__internal == NULL);
+	CU_ASSERT(sn->queues[1].stats.__internal == NULL);
+	CU_ASSERT(sn->stats.rx_packets == ROFL_PIPELINE_MAX_TIDS+10);
+	CU_ASSERT(sn->stats.rx_bytes == ROFL_PIPELINE_MAX_TIDS*100);
+	CU_ASSERT(sn->stats.tx_packets == ROFL_PIPELINE_MAX_TIDS*2);
+	CU_ASSERT(sn->stats.tx_bytes == ROFL_PIPELINE_MAX_TIDS*400);
+	CU_ASSERT(sn->stats.rx_dropped == ROFL_PIPELINE_MAX_TIDS);
+	CU_ASSERT(sn->stats.tx_dropped == 0);
+	CU_ASSERT(sn->stats.collisions == 3);
+	CU_ASSERT(sn->queues[1].stats.tx_packets == ROFL_PIPELINE_MAX_TIDS);
+	CU_ASSERT(sn->queues[1].stats.tx_bytes == ROFL_PIPELINE_MAX_TIDS*200);
+	CU_ASSERT(sn->queues[1].stats.overrun == ROFL_PIPELINE_MAX_TIDS);
+	switch_port_destroy_snapshot(sn);
+
+	CU_ASSERT(switch_port_remove_queue(port, 1) == ROFL_SUCCESS);
+	switch_port_destroy(port);
+}
+
+//Number of times each entry (priority) has been visited
+static unsigned int walk_visited[FLOW_STATS_ENTRIES+1];
+
+static void walk_count_entry(of1x_flow_entry_t* entry, void* arg){
+	walk_visited[entry->priority]++;
+}
+
+static void walk_batches(unsigned int table_id){
+
+	int i;
+	unsigned int num_of_batches = 0;
+	of1x_flow_entry_t* entry;
+	of1x_flow_stats_iter_t iter;
+	of1x_flow_table_t* table = &sw->pipeline.tables[table_id];
+	of1x_matching_algorithms_functions_t* ma = &of1x_matching_algorithms[table->matching_algorithm];
+
+	for(i=0;i<FLOW_STATS_ENTRIES;i++){
+		entry = of1x_init_flow_entry(false);
+		entry->priority = i;
+		of1x_add_match_to_entry(entry,of1x_init_port_in_match(i+1));
+		CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, table_id, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+	}
+
+	memset(walk_visited, 0, sizeof(walk_visited));
+	memset(&iter, 0, sizeof(iter));
+
+	do{
+		CU_ASSERT(ma->walk_flow_entries_hook(table, &iter, 10, walk_count_entry, NULL) == ROFL_SUCCESS);
+		num_of_batches++;
+
+		//Modify the table in between batches
+		if(num_of_batches == 3){
+			entry = of1x_init_flow_entry(false);
+			entry->priority = FLOW_STATS_ENTRIES;
+			of1x_add_match_to_entry(entry,of1x_init_port_in_match(FLOW_STATS_ENTRIES+1));
+			CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, table_id, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+		}
+	}while(!iter.__table_done && num_of_batches < 2*FLOW_STATS_ENTRIES);
+
+	CU_ASSERT(iter.__table_done);
+	CU_ASSERT(num_of_batches >= FLOW_STATS_ENTRIES/10);
+
+	//Entries present during the whole walk are visited exactly once (loop: table order)
+	for(i=0;i<FLOW_STATS_ENTRIES;i++){
+		if(table->matching_algorithm == of1x_loop_matching_algorithm){
+			CU_ASSERT(walk_visited[i] == 1);
+		}else{
+			CU_ASSERT(walk_visited[i] >= 1);
+		}
+	}
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, table_id, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+}
+
+void test_stats_walk_batches(){
+	//Loop
+	walk_batches(0);
+
+	//Trie
+	walk_batches(1);
+}
+
+void test_flow_aggregates(){
+
+	int i;
+	of1x_flow_entry_t* entry;
+	of1x_match_group_t matches;
+	of1x_stats_flow_aggregate_msg_t* msg;
+	of1x_flow_table_t* table = &sw->pipeline.tables[0];
+
+	__of1x_init_match_group(&matches);
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+
+	for(i=0;i<FLOW_STATS_ENTRIES;i++){
+		entry = of1x_init_flow_entry(false);
+		entry->priority = i;
+		entry->cookie = i%4;
+		of1x_add_match_to_entry(entry,of1x_init_port_in_match(i));
+		CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+	}
+	set_flow_counters(1);
+
+	CU_ASSERT(of1x_stats_add_aggregate_cookie_class(&sw->pipeline, 0x1ULL, 0x3ULL) == ROFL_SUCCESS);
+	CU_ASSERT(of1x_stats_add_aggregate_cookie_class(&sw->pipeline, 0x1ULL, 0x3ULL) == ROFL_SUCCESS);
+	CU_ASSERT(table->aggregates.num_of_classes == 1);
+
+	//Not consolidated yet
+	msg = of1x_get_flow_aggregate_stats(&sw->pipeline, 0, 0x1, 0x3, OF1X_PORT_ANY, OF1X_GROUP_ANY, &matches);
+	CU_ASSERT(msg != NULL);
+	CU_ASSERT(msg->flow_count == FLOW_STATS_ENTRIES/4);
+	CU_ASSERT(msg->packet_count == FLOW_STATS_ENTRIES/4);
+	of1x_destroy_stats_flow_aggregate_msg(msg);
+
+	//Consolidate and update the counters; running aggregates are served
+	__of1x_stats_consolidate_flow_aggregates(table, 0);
+	CU_ASSERT(table->aggregates.valid == true);
+	set_flow_counters(2);
+
+	msg = of1x_get_flow_aggregate_stats(&sw->pipeline, 0, 0x1, 0x3, OF1X_PORT_ANY, OF1X_GROUP_ANY, &matches);
+	CU_ASSERT(msg->flow_count == FLOW_STATS_ENTRIES/4);
+	CU_ASSERT(msg->packet_count == FLOW_STATS_ENTRIES/4);
+	CU_ASSERT(msg->byte_count == FLOW_STATS_ENTRIES/4*100);
+	of1x_destroy_stats_flow_aggregate_msg(msg);
+
+	//Whole table class not registered; exact (walk)
+	msg = of1x_get_flow_aggregate_stats(&sw->pipeline, 0, 0x0, 0x0, OF1X_PORT_ANY, OF1X_GROUP_ANY, &matches);
+	CU_ASSERT(msg->flow_count == FLOW_STATS_ENTRIES);
+	CU_ASSERT(msg->packet_count == FLOW_STATS_ENTRIES*2);
+	of1x_destroy_stats_flow_aggregate_msg(msg);
+
+	//Registered; running aggregates are served
+	CU_ASSERT(of1x_stats_add_aggregate_cookie_class(&sw->pipeline, 0x0ULL, 0x0ULL) == ROFL_SUCCESS);
+	CU_ASSERT(table->aggregates.whole_table == true);
+	CU_ASSERT(table->aggregates.valid == false);
+	set_flow_counters(1);
+	__of1x_stats_consolidate_flow_aggregates(table, 0);
+	set_flow_counters(2);
+
+	msg = of1x_get_flow_aggregate_stats(&sw->pipeline, 0, 0x0, 0x0, OF1X_PORT_ANY, OF1X_GROUP_ANY, &matches);
+	CU_ASSERT(msg->flow_count == FLOW_STATS_ENTRIES);
+	CU_ASSERT(msg->packet_count == FLOW_STATS_ENTRIES);
+	of1x_destroy_stats_flow_aggregate_msg(msg);
+
+	//Unregistered class; walk
+	msg = of1x_get_flow_aggregate_stats(&sw->pipeline, 0, 0x1, 0x7, OF1X_PORT_ANY, OF1X_GROUP_ANY, &matches);
+	CU_ASSERT(msg->flow_count == FLOW_STATS_ENTRIES/4);
+	CU_ASSERT(msg->packet_count == FLOW_STATS_ENTRIES/4*2);
+	of1x_destroy_stats_flow_aggregate_msg(msg);
+
+	//Within the period; not consolidated
+	__of1x_stats_consolidate_flow_aggregates(table, OF1X_STATS_AGGREGATES_PERIOD_MS-1);
+	CU_ASSERT(table->aggregates.all.packet_count == FLOW_STATS_ENTRIES);
+
+	__of1x_stats_consolidate_flow_aggregates(table, OF1X_STATS_AGGREGATES_PERIOD_MS);
+	CU_ASSERT(table->aggregates.all.packet_count == FLOW_STATS_ENTRIES*2);
+	CU_ASSERT(table->aggregates.classes[0].packet_count == FLOW_STATS_ENTRIES/4*2);
+
+	//Counters reset (modify); the accounted counters are subtracted
+	entry = of1x_init_flow_entry(false);
+	entry->priority = 1;
+	of1x_add_match_to_entry(entry,of1x_init_port_in_match(1));
+	CU_ASSERT(of1x_modify_flow_entry_table(&sw->pipeline, 0, &entry, STRICT, true) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(table->aggregates.valid == true);
+	CU_ASSERT(table->aggregates.all.packet_count == (FLOW_STATS_ENTRIES-1)*2);
+
+	msg = of1x_get_flow_aggregate_stats(&sw->pipeline, 0, 0x1, 0x3, OF1X_PORT_ANY, OF1X_GROUP_ANY, &matches);
+	CU_ASSERT(msg->flow_count == FLOW_STATS_ENTRIES/4);
+	CU_ASSERT(msg->packet_count == (FLOW_STATS_ENTRIES/4-1)*2);
+	of1x_destroy_stats_flow_aggregate_msg(msg);
+
+	//Entry added; accounted (counters at the next consolidation)
+	entry = of1x_init_flow_entry(false);
+	entry->priority = FLOW_STATS_ENTRIES;
+	entry->cookie = 0x1;
+	of1x_add_match_to_entry(entry,of1x_init_port_in_match(FLOW_STATS_ENTRIES));
+	CU_ASSERT(of1x_add_flow_entry_table(&sw->pipeline, 0, &entry, false,false) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(table->aggregates.valid == true);
+	table->entries->stats.s.__internal[0].packet_count = 5;
+
+	msg = of1x_get_flow_aggregate_stats(&sw->pipeline, 0, 0x1, 0x3, OF1X_PORT_ANY, OF1X_GROUP_ANY, &matches);
+	CU_ASSERT(msg->flow_count == FLOW_STATS_ENTRIES/4+1);
+	CU_ASSERT(msg->packet_count == (FLOW_STATS_ENTRIES/4-1)*2);
+	of1x_destroy_stats_flow_aggregate_msg(msg);
+
+	__of1x_stats_consolidate_flow_aggregates(table, OF1X_STATS_AGGREGATES_PERIOD_MS*2);
+	CU_ASSERT(table->aggregates.classes[0].packet_count == (FLOW_STATS_ENTRIES/4-1)*2+5);
+
+	//Entries removed; their accounted counters are subtracted
+	entry = of1x_init_flow_entry(false);
+	entry->priority = FLOW_STATS_ENTRIES;
+	of1x_add_match_to_entry(entry,of1x_init_port_in_match(FLOW_STATS_ENTRIES));
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+	entry = of1x_init_flow_entry(false);
+	entry->priority = 5;
+	of1x_add_match_to_entry(entry,of1x_init_port_in_match(5));
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+	CU_ASSERT(table->aggregates.valid == true);
+
+	msg = of1x_get_flow_aggregate_stats(&sw->pipeline, 0, 0x1, 0x3, OF1X_PORT_ANY, OF1X_GROUP_ANY, &matches);
+	CU_ASSERT(msg->flow_count == FLOW_STATS_ENTRIES/4-1);
+	CU_ASSERT(msg->packet_count == (FLOW_STATS_ENTRIES/4-2)*2);
+	of1x_destroy_stats_flow_aggregate_msg(msg);
+	CU_ASSERT(table->aggregates.all.flow_count == FLOW_STATS_ENTRIES-1);
+	CU_ASSERT(table->aggregates.all.packet_count == (FLOW_STATS_ENTRIES-2)*2);
+
+	//Stats service enabled; consolidated within its pass
+	CU_ASSERT(of1x_stats_service_enable(&sw->pipeline, OF1X_STATS_AGGREGATES_PERIOD_MS, OF1X_STATS_AGGREGATES_PERIOD_MS) == ROFL_SUCCESS);
+	set_flow_counters(3);
+	__of1x_stats_consolidate_flow_aggregates(table, OF1X_STATS_AGGREGATES_PERIOD_MS*3);
+	CU_ASSERT(table->aggregates.all.packet_count == (FLOW_STATS_ENTRIES-2)*2);
+	__of1x_stats_service_run(&sw->pipeline, OF1X_STATS_AGGREGATES_PERIOD_MS*3);
+	CU_ASSERT(table->aggregates.all.packet_count == (FLOW_STATS_ENTRIES-1)*3);
+	CU_ASSERT(table->aggregates.last_consolidation_ms == OF1X_STATS_AGGREGATES_PERIOD_MS*3);
+	CU_ASSERT(of1x_stats_service_disable(&sw->pipeline) == ROFL_SUCCESS);
+
+	CU_ASSERT(of1x_stats_remove_aggregate_cookie_class(&sw->pipeline, 0x1ULL, 0x3ULL) == ROFL_SUCCESS);
+	CU_ASSERT(of1x_stats_remove_aggregate_cookie_class(&sw->pipeline, 0x1ULL, 0x3ULL) == ROFL_FAILURE);
+	CU_ASSERT(table->aggregates.num_of_classes == 0);
+	CU_ASSERT(of1x_stats_remove_aggregate_cookie_class(&sw->pipeline, 0x0ULL, 0x0ULL) == ROFL_SUCCESS);
+	CU_ASSERT(of1x_stats_remove_aggregate_cookie_class(&sw->pipeline, 0x0ULL, 0x0ULL) == ROFL_FAILURE);
+	CU_ASSERT(table->aggregates.whole_table == false);
+
+	//Remove all
+	entry = of1x_init_flow_entry(false);
+	CU_ASSERT(of1x_remove_flow_entry_table(&sw->pipeline, 0, entry, NOT_STRICT, OF1X_PORT_ANY, OF1X_GROUP_ANY) == ROFL_OF1X_FM_SUCCESS);
+}
@@ -11,31 +11,23 @@ int main(int args, char** argv){
 
 	int return_code;
 	//main to call all the other tests written in the oder files in this folder
-	CU_pSuite output_suite = NULL, timers_hard_suite=NULL;
+	CU_pSuite gt_suite = NULL, output_suite = NULL, timers_hard_suite=NULL;
 	CU_pSuite pp_isolation = NULL; 
 
 	/* initialize the CUnit test registry */
 	if (CUE_SUCCESS != CU_initialize_registry())
 		return CU_get_error();
-/*
-	// add a suite to the registry 
-	pSuite = CU_add_suite("Suite_group_table", gt_set_up, gt_tear_down);
-	if (NULL == pSuite) {
-	CU_cleanup_registry();
-	return CU_get_error();
+
+	//Group table
+	if((gt_suite = CU_add_suite("Suite_group_table", NULL, NULL))==NULL){
+		CU_cleanup_registry();
+		return CU_get_error();
 	}
-	// add the tests to the suite
-	// NOTE - ORDER IS IMPORTANT - MUST TEST fread() AFTER fprintf()
-	if ((NULL == CU_add_test(pSuite, "test basic", gt_basic_test)) ||
-	(NULL == CU_add_test(pSuite, "test expected errors", gt_expected_errors_test)) ||
-	(NULL == CU_add_test(pSuite, "test buckets", gt_add_and_delete_buckets_test)) || 
-		(NULL == CU_add_test(pSuite, "test threads concurrency", gt_concurrency_test)) || 
-		(NULL == CU_add_test(pSuite, "test references", gt_references_test)) )
-	{
-	CU_cleanup_registry();
-	return CU_get_error();
+	if ((CU_add_test(gt_suite,"group search",gt_group_search))==NULL ||
+		(CU_add_test(gt_suite,"group pool reuse",gt_group_pool_reuse))==NULL){
+		CU_cleanup_registry();
+		return CU_get_error();
 	}
-*/
 
 	if((output_suite = CU_add_suite("suite for the output actions", NULL, NULL))==NULL){
 		CU_cleanup_registry();
@@ -49,6 +41,11 @@ int main(int args, char** argv){
 		(CU_add_test(output_suite,"2 out write ",oa_two_outputs_write))==NULL ||
 		(CU_add_test(output_suite," write and group ",oa_write_and_group))==NULL ||
 		(CU_add_test(output_suite,"apply and group",oa_apply_and_group))==NULL ||
+		(CU_add_test(output_suite,"compiled actions",oa_compiled_actions))==NULL ||
+		(CU_add_test(output_suite,"instruction shapes",oa_instruction_shapes))==NULL ||
+		(CU_add_test(output_suite,"incremental checksums",oa_incremental_checksums))==NULL ||
+		(CU_add_test(output_suite,"deferred set-fields",oa_deferred_set_fields))==NULL ||
+		(CU_add_test(output_suite,"experimenter actions and instructions",oa_experimenter))==NULL ||
 			(CU_add_test(output_suite,"groups",oa_test_with_groups))==NULL){
 		CU_cleanup_registry();
 		return CU_get_error();
@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "CUnit/Basic.h"
+#include "../../../../../src/rofl/datapath/pipeline/physical_switch.h"
+#include "../../../../../src/rofl/datapath/pipeline/openflow/openflow1x/of1x_switch.h"
+
+#define INDEX_TEST_NUM_OF_PORTS 1000
+
+int set_up(){
+	physical_switch_init();
+	return 0;
+}
+
+int tear_down(){
+	fprintf(stderr,"Tearing down..\n");
+	physical_switch_destroy();
+	return 0;
+}
+
+void test_physical_switch_index(){
+
+	unsigned int i, port_num, max_ports, size;
+	char name[SWITCH_PORT_MAX_LEN_NAME];
+	switch_port_t* port;
+	switch_port_t** ports;
+	of1x_switch_t* lsi;
+	enum of1x_matching_algorithm_available ma_list[1]={of1x_loop_matching_algorithm};
+
+	//Ports (the table and the index grow)
+	for(i=0;i<INDEX_TEST_NUM_OF_PORTS;i++){
+		snprintf(name, SWITCH_PORT_MAX_LEN_NAME, "veth%u", i);
+		port = switch_port_init(name, true, PORT_TYPE_VIRTUAL, PORT_STATE_NONE);
+		CU_ASSERT(port != NULL);
+		CU_ASSERT(physical_switch_add_port(port) == ROFL_SUCCESS);
+		CU_ASSERT(port->psw_id == i);
+	}
+
+	ports = physical_switch_get_virtual_ports(&max_ports);
+	CU_ASSERT(max_ports >= INDEX_TEST_NUM_OF_PORTS);
+	CU_ASSERT(max_ports < PHYSICAL_SWITCH_MAX_NUM_VIR_PORTS);
+
+	//Duplicated
+	port = switch_port_init("veth7", true, PORT_TYPE_PHYSICAL, PORT_STATE_NONE);
+	CU_ASSERT(physical_switch_add_port(port) == ROFL_FAILURE);
+	switch_port_destroy(port);
+
+	for(i=0;i<INDEX_TEST_NUM_OF_PORTS;i++){
+		snprintf(name, SWITCH_PORT_MAX_LEN_NAME, "veth%u", i);
+		port = physical_switch_get_port_by_name(name);
+		CU_ASSERT(port != NULL);
+		CU_ASSERT(port && strncmp(port->name, name, SWITCH_PORT_MAX_LEN_NAME) == 0);
+		CU_ASSERT(port && ports[port->psw_id] == port);
+	}
+
+	//Remove every other port; the rest must still be found
+	for(i=0;i<INDEX_TEST_NUM_OF_PORTS;i+=2){
+		snprintf(name, SWITCH_PORT_MAX_LEN_NAME, "veth%u", i);
+		CU_ASSERT(physical_switch_remove_port(name) == ROFL_SUCCESS);
+		CU_ASSERT(physical_switch_get_port_by_name(name) == NULL);
+		CU_ASSERT(ports[i] == NULL);
+	}
+	CU_ASSERT(physical_switch_remove_port("veth0") == ROFL_FAILURE);
+	for(i=1;i<INDEX_TEST_NUM_OF_PORTS;i+=2){
+		snprintf(name, SWITCH_PORT_MAX_LEN_NAME, "veth%u", i);
+		CU_ASSERT(physical_switch_get_port_by_name(name) != NULL);
+	}
+
+	//Free ids are reused
+	port = switch_port_init("veth-reused", true, PORT_TYPE_VIRTUAL, PORT_STATE_NONE);
+	CU_ASSERT(physical_switch_add_port(port) == ROFL_SUCCESS);
+	CU_ASSERT(port->psw_id == 0);
+	CU_ASSERT(physical_switch_remove_port("veth-reused") == ROFL_SUCCESS);
+
+	//LSIs
+	lsi = of1x_init_switch("Index switch", OF_VERSION_12, 0x1234, 1, ma_list);
+	CU_ASSERT(lsi != NULL);
+	CU_ASSERT(physical_switch_add_logical_switch((of_switch_t*)lsi) == ROFL_SUCCESS);
+	CU_ASSERT(physical_switch_add_logical_switch((of_switch_t*)lsi) == ROFL_FAILURE);
+	CU_ASSERT(physical_switch_get_logical_switch_by_dpid(0x1234) == (of_switch_t*)lsi);
+	CU_ASSERT(physical_switch_get_logical_switch_by_dpid(0x1235) == NULL);
+	CU_ASSERT(physical_switch_get_logical_switches(&size)[lsi->psw_id] == (of_switch_t*)lsi);
+
+	//Port by (dpid, port_num)
+	port = physical_switch_get_port_by_name("veth1");
+	CU_ASSERT(physical_switch_attach_port_to_logical_switch(port, (of_switch_t*)lsi, &port_num) == ROFL_SUCCESS);
+	CU_ASSERT(physical_switch_get_port_by_num(0x1234, port_num) == port);
+	CU_ASSERT(physical_switch_get_port_by_num(0x1235, port_num) == NULL);
+	CU_ASSERT(physical_switch_detach_port_from_logical_switch(port, (of_switch_t*)lsi) == ROFL_SUCCESS);
+
+	i = lsi->psw_id;
+	CU_ASSERT(physical_switch_remove_logical_switch_by_dpid(0x1234) == ROFL_SUCCESS);
+	CU_ASSERT(physical_switch_get_logical_switches(&size)[i] == NULL);
+	CU_ASSERT(physical_switch_get_logical_switch_by_dpid(0x1234) == NULL);
+	CU_ASSERT(physical_switch_remove_logical_switch_by_dpid(0x1234) == ROFL_FAILURE);
+
+	for(i=1;i<INDEX_TEST_NUM_OF_PORTS;i+=2){
+		snprintf(name, SWITCH_PORT_MAX_LEN_NAME, "veth%u", i);
+		CU_ASSERT(physical_switch_remove_port(name) == ROFL_SUCCESS);
+	}
+}
+
+void test_physical_switch_growth(){
+
+	unsigned int i, size, old_size;
+	char name[SWITCH_PORT_MAX_LEN_NAME];
+	switch_port_t* port;
+	switch_port_t** ports;
+	switch_port_t** old_ports;
+	of_switch_t** lsis;
+	of_switch_t** old_lsis;
+	of1x_switch_t* lsi;
+	enum of1x_matching_algorithm_available ma_list[1]={of1x_loop_matching_algorithm};
+
+	//Ports; the table doubles beyond its initial size
+	port = switch_port_init("tun0", true, PORT_TYPE_TUNNEL, PORT_STATE_NONE);
+	CU_ASSERT(physical_switch_add_port(port) == ROFL_SUCCESS);
+	old_ports = physical_switch_get_tunnel_ports(&old_size);
+	CU_ASSERT(old_size == PHYSICAL_SWITCH_INITIAL_NUM_PORTS);
+	CU_ASSERT(old_ports[0] == port);
+
+	for(i=1;i<PHYSICAL_SWITCH_INITIAL_NUM_PORTS*2+1;i++){
+		snprintf(name, SWITCH_PORT_MAX_LEN_NAME, "tun%u", i);
+		port = switch_port_init(name, true, PORT_TYPE_TUNNEL, PORT_STATE_NONE);
+		CU_ASSERT(physical_switch_add_port(port) == ROFL_SUCCESS);
+		CU_ASSERT(port->psw_id == i);
+	}
+
+	ports = physical_switch_get_tunnel_ports(&size);
+	CU_ASSERT(size == PHYSICAL_SWITCH_INITIAL_NUM_PORTS*4);
+	CU_ASSERT(ports != old_ports);
+
+	//Replaced arrays remain readable
+	CU_ASSERT(old_ports[0] == ports[0]);
+	CU_ASSERT(physical_switch_get_port_by_name("tun0") == ports[0]);
+	CU_ASSERT(physical_switch_get_port_by_name("tun128") == ports[128]);
+
+	for(i=0;i<PHYSICAL_SWITCH_INITIAL_NUM_PORTS*2+1;i++){
+		snprintf(name, SWITCH_PORT_MAX_LEN_NAME, "tun%u", i);
+		CU_ASSERT(physical_switch_remove_port(name) == ROFL_SUCCESS);
+	}
+
+	//The table does not shrink
+	physical_switch_get_tunnel_ports(&size);
+	CU_ASSERT(size == PHYSICAL_SWITCH_INITIAL_NUM_PORTS*4);
+
+	//LSIs
+	old_lsis = physical_switch_get_logical_switches(&old_size);
+	CU_ASSERT(old_size == PHYSICAL_SWITCH_INITIAL_NUM_LS);
+
+	for(i=0;i<PHYSICAL_SWITCH_INITIAL_NUM_LS+1;i++){
+		snprintf(name, SWITCH_PORT_MAX_LEN_NAME, "lsi%u", i);
+		lsi = of1x_init_switch(name, OF_VERSION_12, 0x1000+i, 1, ma_list);
+		CU_ASSERT(lsi != NULL);
+		CU_ASSERT(physical_switch_add_logical_switch((of_switch_t*)lsi) == ROFL_SUCCESS);
+	}
+
+	lsis = physical_switch_get_logical_switches(&size);
+	CU_ASSERT(size == PHYSICAL_SWITCH_INITIAL_NUM_LS*2);
+	CU_ASSERT(lsis != old_lsis);
+	CU_ASSERT(get_physical_switch()->num_of_logical_switches == PHYSICAL_SWITCH_INITIAL_NUM_LS+1);
+
+	for(i=0;i<PHYSICAL_SWITCH_INITIAL_NUM_LS+1;i++){
+		CU_ASSERT(lsis[i] != NULL && lsis[i]->dpid == 0x1000+i);
+		CU_ASSERT(lsis[i] != NULL && lsis[i]->psw_id == i);
+		CU_ASSERT(physical_switch_get_logical_switch_by_dpid(0x1000+i) == lsis[i]);
+	}
+
+	for(i=0;i<PHYSICAL_SWITCH_INITIAL_NUM_LS+1;i++)
+		CU_ASSERT(physical_switch_remove_logical_switch_by_dpid(0x1000+i) == ROFL_SUCCESS);
+	CU_ASSERT(get_physical_switch()->num_of_logical_switches == 0);
+}
+
+int main(int args, char** argv){
+
+	int return_code;
+	//main to call all the other tests written in the oder files in this folder
+	CU_pSuite pSuite = NULL;
+
+	/* initialize the CUnit test registry */
+	if (CUE_SUCCESS != CU_initialize_registry())
+		return CU_get_error();
+
+	/* add a suite to the registry */
+	pSuite = CU_add_suite("Suite_Physical_switch", set_up, tear_down);
+
+	if (NULL == pSuite){
+		CU_cleanup_registry();
+		return CU_get_error();
+	}
+
+	/* add the tests to the suite */
+	if ((NULL == CU_add_test(pSuite, "test physical switch index", test_physical_switch_index)) ||
+	(NULL == CU_add_test(pSuite, "test physical switch growth", test_physical_switch_growth))
+		)
+	{
+		fprintf(stderr,"ERROR WHILE ADDING TEST\n");
+		return_code = CU_get_error();
+		CU_cleanup_registry();
+		return return_code;
+	}
+	
+	/* Run all tests using the CUnit Basic interface */
+	CU_basic_set_mode(CU_BRM_VERBOSE);
+	CU_basic_run_tests();
+	return_code = CU_get_number_of_failures();
+	CU_cleanup_registry();
+
+	return return_code;
+}
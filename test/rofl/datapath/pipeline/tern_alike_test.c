@@ -774,6 +774,44 @@ void test_get_alike_128_regression(){
 	CU_ASSERT(__utern_equals(&expec_common, &common) == true);
 }
 
+void test_compare(){
+
+	unsigned int i;
+	uint8_t val[16], mask[16], pkt[16];
+	uint32_t u32;
+	utern_t tern;
+
+	//Values are stored pre-masked
+	__init_utern32(&tern, 0x12345678, 0xFFFF0000);
+	CU_ASSERT(tern.value.u32 == 0x12340000);
+
+	u32 = 0x1234ABCD;
+	CU_ASSERT(__utern_compare32(&tern, &u32) == true);
+	u32 = 0x1235ABCD;
+	CU_ASSERT(__utern_compare32(&tern, &u32) == false);
+	CU_ASSERT(__utern_compare32(&tern, NULL) == false);
+
+	//128 bit; a /120 prefix
+	for(i=0;i<16;i++){
+		val[i] = 0xA0 + i;
+		mask[i] = (i < 15)? 0xFF : 0x00;
+	}
+	__init_utern128(&tern, *(uint128__t*)val, *(uint128__t*)mask);
+	CU_ASSERT(tern.value.u128.val[15] == 0x0);
+
+	memcpy(pkt, val, sizeof(pkt));
+	pkt[15] = 0x55;
+	CU_ASSERT(__utern_compare128(&tern, (uint128__t*)pkt) == true);
+
+	//Any bit of the prefix, in both halves
+	for(i=0;i<15;i++){
+		memcpy(pkt, val, sizeof(pkt));
+		pkt[i] ^= 0x01;
+		CU_ASSERT(__utern_compare128(&tern, (uint128__t*)pkt) == false);
+	}
+	CU_ASSERT(__utern_compare128(&tern, NULL) == false);
+}
+
 int main(int args, char** argv){
 
 	int return_code;
@@ -798,7 +836,8 @@ int main(int args, char** argv){
 		(NULL == CU_add_test(pSuite, "32 bit test", test_get_alike_32)) ||
 		(NULL == CU_add_test(pSuite, "64 bit test", test_get_alike_64)) ||
 		(NULL == CU_add_test(pSuite, "128 bit test", test_get_alike_128)) ||
-		(NULL == CU_add_test(pSuite, "128 bit test (regressions)", test_get_alike_128_regression)) //||
+		(NULL == CU_add_test(pSuite, "128 bit test (regressions)", test_get_alike_128_regression)) ||
+		(NULL == CU_add_test(pSuite, "compare test", test_compare)) //||
 		)
 	{
 		fprintf(stderr,"ERROR WHILE ADDING TEST\n");